@@ -80,6 +80,31 @@ namespace gz
                   unsigned int _height, unsigned int _depth,
                   const std::string &)> _subscriber) = 0;
 
+      /// \brief Subscribes a new listener to the raw gpu rays data as it
+      /// was read back from the GPU, before it is converted to the 3 channel
+      /// layout of ConnectNewGpuRaysFrame. No copy is made: the frame points
+      /// to the mapped readback memory and is only valid for the duration of
+      /// the callback. The callback function parameters are:
+      ///   _frame:   Image frame is an array of floats. Each gpu rays reading
+      ///             occupies 4 floats
+      ///             Index 0: depth value
+      ///             Index 1: retro value
+      ///             Index 2: 0. Not used
+      ///             Index 3: Not used
+      ///   _width:   Width of image, i.e. number of data in the horizonal scan
+      ///   _height:  Height o image, i.e. number of scans in vertical direction
+      ///   _channels: Number of channels, i.e. 4 floats per gpu rays reading
+      ///   _rowStride: Number of floats between the start of two consecutive
+      ///             rows. This may be larger than _width * _channels
+      ///   _format:  Pixel format of the image frame.
+      /// \return A pointer to the connection. This must be kept in scope.
+      /// Engines that do not support this return nullptr.
+      public: virtual common::ConnectionPtr ConnectNewGpuRaysRawFrame(
+                  std::function<void(const float *_frame, unsigned int _width,
+                  unsigned int _height, unsigned int _channels,
+                  unsigned int _rowStride,
+                  const std::string &_format)> _subscriber) = 0;
+
       /// \brief Set sensor horizontal or vertical
       /// \param[in] _horizontal True if horizontal, false if not
       public: virtual void SetIsHorizontal(const bool _horizontal) = 0;
@@ -190,6 +215,25 @@ namespace gz
       /// \return The vertical resolution.
       /// \sa VerticalRayCount()
       public: virtual double VerticalResolution() const = 0;
+
+      /// \brief Set the distance within which the origin of another gpu
+      /// rays sensor must be for this sensor to reuse the depth data that
+      /// sensor rendered in the same frame, instead of rendering its own.
+      /// This is useful when several sensors are mounted at nearly the same
+      /// place. Only sensors with the same clip planes, visibility mask and
+      /// values for out of range data share depth data. The ranges of a
+      /// sensor that reuses depth data are measured from the origin of the
+      /// other sensor, so they can be off by up to _tolerance. Not all
+      /// render engines support sharing depth data.
+      /// \param[in] _tolerance Max distance between the origins in meters.
+      /// 0, the default, disables sharing.
+      public: virtual void SetCubemapSharingTolerance(double _tolerance) = 0;
+
+      /// \brief Get the distance within which the origin of another gpu
+      /// rays sensor must be for this sensor to reuse its depth data
+      /// \return Max distance between the origins in meters
+      /// \sa SetCubemapSharingTolerance
+      public: virtual double CubemapSharingTolerance() const = 0;
     };
   }
   }
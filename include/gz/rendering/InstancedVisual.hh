@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_INSTANCEDVISUAL_HH_
+#define GZ_RENDERING_INSTANCEDVISUAL_HH_
+
+#include <cstddef>
+#include <vector>
+
+#include <gz/math/Color.hh>
+#include <gz/math/Pose3.hh>
+
+#include "gz/rendering/config.hh"
+#include "gz/rendering/MeshDescriptor.hh"
+#include "gz/rendering/Visual.hh"
+
+namespace gz
+{
+  namespace rendering
+  {
+    inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \class InstancedVisual InstancedVisual.hh
+    /// gz/rendering/InstancedVisual.hh
+    /// \brief A visual that renders many copies of one mesh with the
+    /// material of the visual. Each instance has its own pose relative to
+    /// the visual, and optionally its own color and label. Instances are
+    /// not visuals themselves, which makes them much cheaper than one
+    /// visual per copy, and render engines may draw them with hardware
+    /// instancing. Render engines may still keep per instance objects
+    /// internally, see their implementation for the cost per instance.
+    class GZ_RENDERING_VISIBLE InstancedVisual :
+      public virtual Visual
+    {
+      /// \brief Constructor
+      protected: InstancedVisual();
+
+      /// \brief Destructor
+      public: virtual ~InstancedVisual();
+
+      /// \brief Set the mesh rendered by every instance
+      /// \param[in] _desc Descriptor of the mesh
+      public: virtual void SetMesh(const MeshDescriptor &_desc) = 0;
+
+      /// \brief Get the descriptor of the mesh rendered by every instance
+      /// \return Mesh descriptor
+      public: virtual const MeshDescriptor &Descriptor() const = 0;
+
+      /// \brief Set the number of instances and all of their poses.
+      /// Colors and labels of the instances that are kept are unchanged.
+      /// \param[in] _poses Pose of each instance relative to the visual
+      public: virtual void SetInstancePoses(
+                  const std::vector<math::Pose3d> &_poses) = 0;
+
+      /// \brief Update the poses of a contiguous range of instances. Only
+      /// the given instances are updated by the render engine.
+      /// \param[in] _offset Index of the first instance to update
+      /// \param[in] _poses Pointer to _count poses relative to the visual
+      /// \param[in] _count Number of instances to update. The range must
+      /// be within InstanceCount().
+      public: virtual void UpdateInstancePoses(std::size_t _offset,
+                  const math::Pose3d *_poses, std::size_t _count) = 0;
+
+      /// \brief Get the number of instances
+      /// \return Number of instances
+      public: virtual std::size_t InstanceCount() const = 0;
+
+      /// \brief Get the pose of an instance
+      /// \param[in] _index Index of the instance
+      /// \return Pose of the instance relative to the visual
+      public: virtual math::Pose3d InstancePose(std::size_t _index) const = 0;
+
+      /// \brief Set the color of an instance. It replaces the diffuse color
+      /// of the visual material for this instance only.
+      /// \param[in] _index Index of the instance
+      /// \param[in] _color Color of the instance
+      public: virtual void SetInstanceColor(std::size_t _index,
+                  const math::Color &_color) = 0;
+
+      /// \brief Make an instance use the material of the visual again
+      /// \param[in] _index Index of the instance
+      public: virtual void ClearInstanceColor(std::size_t _index) = 0;
+
+      /// \brief Get the color of an instance
+      /// \param[in] _index Index of the instance
+      /// \return Color set with SetInstanceColor, or the diffuse color of
+      /// the visual material if the instance has none
+      public: virtual math::Color InstanceColor(std::size_t _index) const = 0;
+
+      /// \brief Set the label of an instance, used by segmentation cameras.
+      /// It replaces the "label" user data of the visual for this instance
+      /// only.
+      /// \param[in] _index Index of the instance
+      /// \param[in] _label Label of the instance
+      public: virtual void SetInstanceLabel(std::size_t _index,
+                  int _label) = 0;
+
+      /// \brief Make an instance use the label of the visual again
+      /// \param[in] _index Index of the instance
+      public: virtual void ClearInstanceLabel(std::size_t _index) = 0;
+
+      /// \brief Get whether an instance has a label of its own
+      /// \param[in] _index Index of the instance
+      /// \return True if SetInstanceLabel was called for the instance
+      public: virtual bool HasInstanceLabel(std::size_t _index) const = 0;
+
+      /// \brief Get the label of an instance
+      /// \param[in] _index Index of the instance
+      /// \return Label set with SetInstanceLabel, or 0 if the instance has
+      /// none
+      public: virtual int InstanceLabel(std::size_t _index) const = 0;
+    };
+    }
+  }
+}
+#endif
@@ -75,6 +75,16 @@ namespace gz
       public: virtual void SetPoints(const std::vector<double> &_points,
                         const std::vector<gz::math::Color> &_colors) = 0;
 
+      /// \brief Set lidar points to be visualised without converting them
+      /// to doubles first. It accepts the frame of
+      /// GpuRays::ConnectNewGpuRaysFrame directly.
+      /// \param[in] _points Pointer to the distance of each ray
+      /// \param[in] _count Number of rays
+      /// \param[in] _stride Number of floats from the distance of one ray
+      /// to the next, e.g. the number of channels of a GpuRays frame
+      public: virtual void SetPoints(const float *_points,
+                  unsigned int _count, unsigned int _stride) = 0;
+
       /// \brief Set minimum vertical angle
       /// \param[in] _minVerticalAngle Minimum vertical angle
       public: virtual void SetMinVerticalAngle(
@@ -17,6 +17,9 @@
 #ifndef GZ_RENDERING_MARKER_HH_
 #define GZ_RENDERING_MARKER_HH_
 
+#include <cstddef>
+#include <cstdint>
+
 #include <gz/math/Color.hh>
 #include <gz/math/Vector3.hh>
 #include "gz/rendering/config.hh"
@@ -140,6 +143,40 @@ namespace gz
       /// \param[in] _value The new positional vector of the point
       public: virtual void SetPoint(unsigned int _index,
                   const gz::math::Vector3d &_value) = 0;
+
+      /// \brief Replace all the points of the marker in one call. This is
+      /// much faster than adding points one by one for large point clouds
+      /// and polylines.
+      /// \param[in] _xyz Pointer to 3 * _count floats, the x, y and z
+      /// coordinates of each point
+      /// \param[in] _rgba Pointer to _count colors packed as in
+      /// gz::math::Color::AsRGBA, or null to make all points white
+      /// \param[in] _count Number of points
+      public: virtual void SetPoints(const float *_xyz,
+                  const uint32_t *_rgba, std::size_t _count) = 0;
+
+      /// \brief Change a contiguous range of existing points, e.g. the
+      /// oldest part of a trail used as a ring buffer. Render engines may
+      /// upload only the range.
+      /// \param[in] _offset Index of the first point to change
+      /// \param[in] _xyz Pointer to 3 * _count floats, or null to keep the
+      /// positions
+      /// \param[in] _rgba Pointer to _count colors packed as in
+      /// gz::math::Color::AsRGBA, or null to keep the colors
+      /// \param[in] _count Number of points to change
+      public: virtual void UpdatePoints(std::size_t _offset,
+                  const float *_xyz, const uint32_t *_rgba,
+                  std::size_t _count) = 0;
+
+      /// \brief Get the number of points of the marker
+      /// \return Number of points
+      public: virtual unsigned int PointCount() const = 0;
+
+      /// \brief Get the position of a point
+      /// \param[in] _index The index of the point
+      /// \return Position of the point, or infinite values if the index
+      /// is out of range
+      public: virtual gz::math::Vector3d Point(unsigned int _index) const = 0;
     };
     }
   }
@@ -77,6 +77,13 @@ namespace gz
 
       /// \brief Denotes if the loaded sub-mesh vertices should be centered
       public: bool centerSubMesh = false;
+
+      /// \brief Denotes if the loaded vertices should be stored in compact
+      /// formats to save GPU memory and bandwidth: half float positions when
+      /// their precision is sufficient, normals and tangents encoded as
+      /// QTangents, and 16-bit indices when the vertex count allows it.
+      /// Not all render engines support this option.
+      public: bool compactVertexFormat = false;
     };
     }
   }
@@ -17,6 +17,8 @@
 #ifndef GZ_RENDERING_RAYQUERY_HH_
 #define GZ_RENDERING_RAYQUERY_HH_
 
+#include <vector>
+
 #include <gz/utils/SuppressWarning.hh>
 #include <gz/math/Vector3.hh>
 
@@ -136,6 +138,24 @@ namespace gz
       /// \return A vector of intersection results
       public: virtual RayQueryResult ClosestPoint(
             bool _forceSceneUpdate = true) = 0;
+
+      /// \brief Compute the closest intersection of each ray in a batch.
+      /// This is equivalent to calling ClosestPoint() once per ray with
+      /// the corresponding origin and direction, but engines can share the
+      /// per query setup cost across the whole batch. The GPU is never
+      /// used for batched queries, and the origin and direction set on
+      /// this query are left unchanged.
+      /// \param[in] _origins Ray origins
+      /// \param[in] _directions Ray directions, same size as _origins
+      /// \param[out] _results Closest intersection of each ray. Resized to
+      /// the number of rays; reusing the same vector across calls avoids
+      /// reallocations.
+      /// \param[in] _forceSceneUpdate See ClosestPoint()
+      public: virtual void ClosestPoints(
+            const std::vector<math::Vector3d> &_origins,
+            const std::vector<math::Vector3d> &_directions,
+            std::vector<RayQueryResult> &_results,
+            bool _forceSceneUpdate = true) = 0;
     };
     }
   }
@@ -67,6 +67,7 @@ namespace gz
     class Heightmap;
     class Image;
     class InertiaVisual;
+    class InstancedVisual;
     class LensFlarePass;
     class Light;
     class LightVisual;
@@ -206,6 +207,10 @@ namespace gz
     /// \brief Shared pointer to LidarVisual
     typedef shared_ptr<LidarVisual> LidarVisualPtr;
 
+    /// \typedef InstancedVisualPtr
+    /// \brief Shared pointer to InstancedVisual
+    typedef shared_ptr<InstancedVisual> InstancedVisualPtr;
+
     /// \typedef MaterialPtr
     /// \brief Shared pointer to Material
     typedef shared_ptr<Material> MaterialPtr;
@@ -384,6 +389,10 @@ namespace gz
     /// \brief Shared pointer to const LidarVisual
     typedef shared_ptr<const LidarVisual> ConstLidarVisualPtr;
 
+    /// \typedef const InstancedVisualPtr
+    /// \brief Shared pointer to const InstancedVisual
+    typedef shared_ptr<const InstancedVisual> ConstInstancedVisualPtr;
+
     /// \typedef const MaterialPtr
     /// \brief Shared pointer to const Material
     typedef shared_ptr<const Material> ConstMaterialPtr;
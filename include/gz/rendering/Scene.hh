@@ -18,8 +18,10 @@
 #define GZ_RENDERING_SCENE_HH_
 
 #include <array>
+#include <future>
 #include <string>
 #include <limits>
+#include <vector>
 
 #include <gz/common/Material.hh>
 #include <gz/common/Mesh.hh>
@@ -44,6 +46,26 @@ namespace gz
     class RenderEngine;
     class SceneExt;
 
+    /// \brief Policy deciding when rendering waits for textures that are
+    /// still being streamed in. Engines that do not stream textures
+    /// asynchronously ignore it.
+    enum GZ_RENDERING_VISIBLE TextureResidencyPolicy
+    {
+      /// \brief Every camera render waits until all pending textures are
+      /// loaded. Frames are always complete.
+      TRP_BLOCK_ALWAYS = 0,
+
+      /// \brief Camera renders wait for all pending textures only during
+      /// the first frames. See Scene::SetTextureWarmUpFrameCount. After
+      /// that, textures that are not loaded yet are rendered with a
+      /// placeholder until they are ready.
+      TRP_BLOCK_WARM_UP = 1,
+
+      /// \brief Every camera render waits only for the pending textures
+      /// used by the objects that are in view of the camera.
+      TRP_BLOCK_VISIBLE = 2
+    };
+
     /// \class Scene Scene.hh gz/rendering/Scene.hh
     /// \brief Manages a single scene-graph. This class updates scene-wide
     /// properties and holds the root scene node. A Scene also serves as a
@@ -1067,6 +1089,23 @@ namespace gz
       /// \return The created mesh
       public: virtual MeshPtr CreateMesh(const MeshDescriptor &_desc) = 0;
 
+      /// \brief Create new mesh geometry without blocking rendering. The
+      /// CPU side work needed to load the mesh runs on worker threads. This
+      /// includes parsing the mesh file if the descriptor names a file that
+      /// the common::MeshManager did not load yet, and packing the vertex
+      /// and index data. The common::MeshManager is not thread safe, so the
+      /// parsed mesh is only added to it on the render thread. The GPU
+      /// upload and the creation of the mesh also happen on the render
+      /// thread, during a later call to PreRender. The future
+      /// must therefore not be waited on from the render thread before that
+      /// call. Meshes with a skeleton are packed on the render thread too.
+      /// Render engines that don't support this load and create the mesh
+      /// immediately.
+      /// \param[in] _desc Descriptor of the mesh to load
+      /// \return Future holding the created mesh, or null on failure
+      public: virtual std::future<MeshPtr> CreateMeshAsync(
+                  const MeshDescriptor &_desc) = 0;
+
       /// \brief Create new grid geometry.
       /// \return The created grid
       public: virtual GridPtr CreateGrid() = 0;
@@ -1107,6 +1146,36 @@ namespace gz
       public: virtual LidarVisualPtr CreateLidarVisual(
                   unsigned int _id, const std::string &_name) = 0;
 
+      /// \brief Create new instanced visual. A unique ID and name will
+      /// automatically be assigned to the visual.
+      /// \return The created instanced visual, or nullptr if the render
+      /// engine does not support instanced visuals
+      public: virtual InstancedVisualPtr CreateInstancedVisual() = 0;
+
+      /// \brief Create new instanced visual with the given ID. A unique
+      /// name will automatically be assigned to the visual. If the given ID
+      /// is already in use, NULL will be returned.
+      /// \param[in] _id ID of the new instanced visual
+      /// \return The created instanced visual
+      public: virtual InstancedVisualPtr CreateInstancedVisual(
+                  unsigned int _id) = 0;
+
+      /// \brief Create new instanced visual with the given name. A unique
+      /// ID will automatically be assigned to the visual. If the given name
+      /// is already in use, NULL will be returned.
+      /// \param[in] _name Name of the new instanced visual
+      /// \return The created instanced visual
+      public: virtual InstancedVisualPtr CreateInstancedVisual(
+                  const std::string &_name) = 0;
+
+      /// \brief Create new instanced visual with the given name. If either
+      /// the given ID or name is already in use, NULL will be returned.
+      /// \param[in] _id ID of the new instanced visual
+      /// \param[in] _name Name of the new instanced visual
+      /// \return The created instanced visual
+      public: virtual InstancedVisualPtr CreateInstancedVisual(
+                  unsigned int _id, const std::string &_name) = 0;
+
       /// \brief Create new heightmap geomerty. The rendering::Heightmap will be
       /// created from the given HeightmapDescriptor.
       /// \param[in] _desc Data about the heightmap
@@ -1393,6 +1462,80 @@ namespace gz
       /// SetCameraPassCountPerGpuFlush
       public: virtual bool LegacyAutoGpuFlush() const = 0;
 
+      /// \brief Render a set of cameras as a single frame. This follows the
+      /// ideal render loop described in SetCameraPassCountPerGpuFlush: the
+      /// scene graph is prepared once with PreRender, every camera is
+      /// rendered, every camera is then post-rendered (where image data is
+      /// read back and new frame events are emitted) and finally the scene
+      /// PostRender is called, unless LegacyAutoGpuFlush is true.
+      ///
+      /// Compared to calling Camera::Update on each camera, this avoids
+      /// repeating the scene graph update for every camera and lets GPU
+      /// work be flushed according to CameraPassCountPerGpuFlush.
+      /// \param[in] _cameras Cameras to render. Null cameras and cameras
+      /// that do not belong to this scene are skipped.
+      /// \see Scene::SetCameraPassCountPerGpuFlush
+      public: virtual void RenderCameras(
+                  const std::vector<CameraPtr> &_cameras) = 0;
+
+      /// \brief Set the policy deciding when camera renders wait for
+      /// textures that are still being loaded. The default is
+      /// TRP_BLOCK_ALWAYS.
+      /// \remarks Not all rendering engines care about this.
+      /// ogre2 plugin does.
+      /// \param[in] _policy Texture residency policy
+      /// \sa PreloadTextures
+      public: virtual void SetTextureResidencyPolicy(
+                  enum TextureResidencyPolicy _policy) = 0;
+
+      /// \brief Get the texture residency policy
+      /// \return Texture residency policy. ALWAYS returns TRP_BLOCK_ALWAYS
+      /// for plugins that ignore SetTextureResidencyPolicy
+      public: virtual enum TextureResidencyPolicy TextureResidencyPolicy()
+                  const = 0;
+
+      /// \brief Set the number of frames during which camera renders wait
+      /// for all pending textures when the policy is TRP_BLOCK_WARM_UP.
+      /// Frames are counted by calls to PreRender, starting from the first
+      /// one made after this function is called.
+      /// \param[in] _frames Number of warm-up frames
+      public: virtual void SetTextureWarmUpFrameCount(
+                  unsigned int _frames) = 0;
+
+      /// \brief Get the number of warm-up frames used by TRP_BLOCK_WARM_UP
+      /// \return Number of warm-up frames
+      public: virtual unsigned int TextureWarmUpFrameCount() const = 0;
+
+      /// \brief Load all the textures used by the objects of this scene
+      /// and block until they are all resident. Materials that are not
+      /// assigned to any object are skipped. Loading is done by the
+      /// engine's streaming worker threads, so it is much faster than
+      /// letting each camera render wait for the textures it needs. Call
+      /// this once the world is loaded, before the first frame, to get
+      /// complete frames without having to block on every render.
+      public: virtual void PreloadTextures() = 0;
+
+      /// \brief Let the scene make visuals static once they have not moved
+      /// for a number of frames. Static visuals are skipped by the engine
+      /// when updating transforms and bounding boxes every frame, which
+      /// saves a lot of time in worlds where most of the geometry never
+      /// moves. A visual made static this way becomes dynamic again as soon
+      /// as it, or one of its ancestors, moves. Visuals made static with
+      /// Visual::SetStatic are not affected.
+      /// Frames are counted by calls to PreRender.
+      /// \remarks Not all rendering engines care about this.
+      /// ogre2 plugin does.
+      /// \param[in] _frames Number of frames a visual must stay still before
+      /// being made static. 0, the default, disables this feature.
+      /// \sa Visual::SetStatic
+      public: virtual void SetAutoStaticFrameCount(unsigned int _frames) = 0;
+
+      /// \brief Get the number of frames a visual must stay still before
+      /// the scene makes it static
+      /// \return Number of frames. 0 if the feature is disabled.
+      /// ALWAYS returns 0 for plugins that ignore SetAutoStaticFrameCount
+      public: virtual unsigned int AutoStaticFrameCount() const = 0;
+
       /// \brief Remove and destroy all objects from the scene graph. This does
       /// not completely destroy scene resources, so new objects can be created
       /// and added to the scene afterwards.
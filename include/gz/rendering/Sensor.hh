@@ -42,6 +42,23 @@ namespace gz
       /// \brief Get visibility mask
       /// \return visibility mask
       public: virtual uint32_t VisibilityMask() const = 0;
+
+      /// \brief Set the number of frames by which data read back from the
+      /// GPU may lag behind rendering. With a latency of N, the readback of
+      /// a frame is started asynchronously when it finishes rendering and
+      /// its data is delivered N updates later, so the CPU does not stall
+      /// waiting for the GPU. No data is delivered for the first N updates.
+      /// A latency of 0 (default) reads data back synchronously.
+      /// Not all render engines support asynchronous readback, in which case
+      /// the latency is ignored.
+      /// \param[in] _latency Readback latency in frames
+      public: virtual void SetReadbackLatency(unsigned int _latency) = 0;
+
+      /// \brief Get the number of frames by which data read back from the
+      /// GPU may lag behind rendering.
+      /// \return Readback latency in frames
+      /// \sa SetReadbackLatency
+      public: virtual unsigned int ReadbackLatency() const = 0;
     };
     }
   }
@@ -17,6 +17,7 @@
 #ifndef GZ_RENDERING_BASE_BASEGPURAYS_HH_
 #define GZ_RENDERING_BASE_BASEGPURAYS_HH_
 
+#include <algorithm>
 #include <string>
 
 #include <gz/common/Event.hh>
@@ -68,6 +69,13 @@ namespace gz
                   unsigned int _height, unsigned int _depth,
                   const std::string &_format)> _subscriber) override;
 
+      // Documentation inherited.
+      public: virtual common::ConnectionPtr ConnectNewGpuRaysRawFrame(
+                  std::function<void(const float *_frame, unsigned int _width,
+                  unsigned int _height, unsigned int _channels,
+                  unsigned int _rowStride,
+                  const std::string &_format)> _subscriber) override;
+
       /// \brief Pointer to the render target
       public: virtual RenderTargetPtr RenderTarget() const override = 0;
 
@@ -151,6 +159,13 @@ namespace gz
       // Documentation inherited.
       public: virtual double VerticalResolution() const override;
 
+      // Documentation inherited.
+      public: virtual void SetCubemapSharingTolerance(double _tolerance)
+                  override;
+
+      // Documentation inherited.
+      public: virtual double CubemapSharingTolerance() const override;
+
       /// \brief maximum value used for data outside sensor range
       public: float dataMaxVal = gz::math::INF_D;
 
@@ -200,6 +215,10 @@ namespace gz
       /// \brief Number of channels used to store the data
       protected: unsigned int channels = 1u;
 
+      /// \brief Max distance to another sensor whose depth data can be
+      /// reused
+      protected: double cubemapSharingTolerance = 0.0;
+
       private: friend class OgreScene;
     };
 
@@ -265,6 +284,15 @@ namespace gz
       return nullptr;
     }
 
+    //////////////////////////////////////////////////
+    template <class T>
+    gz::common::ConnectionPtr BaseGpuRays<T>::ConnectNewGpuRaysRawFrame(
+          std::function<void(const float *, unsigned int, unsigned int,
+          unsigned int, unsigned int, const std::string &)>)
+    {
+      return nullptr;
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     void BaseGpuRays<T>::SetIsHorizontal(const bool _horizontal)
@@ -446,6 +474,20 @@ namespace gz
     {
       return this->vResolution;
     }
+
+    template <class T>
+    //////////////////////////////////////////////////
+    void BaseGpuRays<T>::SetCubemapSharingTolerance(double _tolerance)
+    {
+      this->cubemapSharingTolerance = std::max(0.0, _tolerance);
+    }
+
+    template <class T>
+    //////////////////////////////////////////////////
+    double BaseGpuRays<T>::CubemapSharingTolerance() const
+    {
+      return this->cubemapSharingTolerance;
+    }
     }
   }
 }
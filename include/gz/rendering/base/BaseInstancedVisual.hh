@@ -0,0 +1,340 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_BASEINSTANCEDVISUAL_HH_
+#define GZ_RENDERING_BASEINSTANCEDVISUAL_HH_
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include <gz/common/Console.hh>
+
+#include "gz/rendering/InstancedVisual.hh"
+#include "gz/rendering/Material.hh"
+#include "gz/rendering/base/BaseObject.hh"
+#include "gz/rendering/base/BaseRenderTypes.hh"
+
+namespace gz
+{
+  namespace rendering
+  {
+    inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Base implementation of an instanced visual. It stores the
+    /// state of the instances and what changed since the render engine
+    /// last applied it.
+    template <class T>
+    class BaseInstancedVisual :
+      public virtual InstancedVisual,
+      public virtual T
+    {
+      /// \brief Constructor
+      protected: BaseInstancedVisual();
+
+      /// \brief Destructor
+      public: virtual ~BaseInstancedVisual();
+
+      // Documentation inherited
+      public: virtual void Destroy() override;
+
+      // Documentation inherited
+      public: virtual void SetMesh(const MeshDescriptor &_desc) override;
+
+      // Documentation inherited
+      public: virtual const MeshDescriptor &Descriptor() const override;
+
+      // Documentation inherited
+      public: virtual void SetInstancePoses(
+                  const std::vector<math::Pose3d> &_poses) override;
+
+      // Documentation inherited
+      public: virtual void UpdateInstancePoses(std::size_t _offset,
+                  const math::Pose3d *_poses, std::size_t _count) override;
+
+      // Documentation inherited
+      public: virtual std::size_t InstanceCount() const override;
+
+      // Documentation inherited
+      public: virtual math::Pose3d InstancePose(std::size_t _index) const
+                  override;
+
+      // Documentation inherited
+      public: virtual void SetInstanceColor(std::size_t _index,
+                  const math::Color &_color) override;
+
+      // Documentation inherited
+      public: virtual void ClearInstanceColor(std::size_t _index) override;
+
+      // Documentation inherited
+      public: virtual math::Color InstanceColor(std::size_t _index) const
+                  override;
+
+      // Documentation inherited
+      public: virtual void SetInstanceLabel(std::size_t _index,
+                  int _label) override;
+
+      // Documentation inherited
+      public: virtual void ClearInstanceLabel(std::size_t _index) override;
+
+      // Documentation inherited
+      public: virtual bool HasInstanceLabel(std::size_t _index) const
+                  override;
+
+      // Documentation inherited
+      public: virtual int InstanceLabel(std::size_t _index) const override;
+
+      /// \brief Check that an instance index is valid and print an error
+      /// if it is not
+      /// \param[in] _index Index of the instance
+      /// \return True if the index is valid
+      protected: bool ValidInstance(std::size_t _index) const;
+
+      /// \brief Grow a range of dirty instances so that it includes
+      /// another range
+      /// \param[in, out] _begin First instance of the dirty range
+      /// \param[in, out] _end One past the last instance of the dirty range
+      /// \param[in] _offset First instance to include
+      /// \param[in] _count Number of instances to include
+      protected: static void MarkDirty(std::size_t &_begin,
+                     std::size_t &_end, std::size_t _offset,
+                     std::size_t _count);
+
+      /// \brief Descriptor of the mesh rendered by every instance
+      protected: MeshDescriptor descriptor;
+
+      /// \brief True if the mesh changed
+      protected: bool meshDirty = false;
+
+      /// \brief Pose of every instance relative to the visual
+      protected: std::vector<math::Pose3d> poses;
+
+      /// \brief First instance whose pose changed
+      protected: std::size_t dirtyPosesBegin = 0u;
+
+      /// \brief One past the last instance whose pose changed
+      protected: std::size_t dirtyPosesEnd = 0u;
+
+      /// \brief Color of every instance, if it has one
+      protected: std::vector<std::optional<math::Color>> colors;
+
+      /// \brief First instance whose color changed
+      protected: std::size_t dirtyColorsBegin = 0u;
+
+      /// \brief One past the last instance whose color changed
+      protected: std::size_t dirtyColorsEnd = 0u;
+
+      /// \brief Label of every instance, if it has one
+      protected: std::vector<std::optional<int>> labels;
+
+      /// \brief First instance whose label changed
+      protected: std::size_t dirtyLabelsBegin = 0u;
+
+      /// \brief One past the last instance whose label changed
+      protected: std::size_t dirtyLabelsEnd = 0u;
+    };
+
+    /////////////////////////////////////////////////
+    // BaseInstancedVisual
+    /////////////////////////////////////////////////
+    template <class T>
+    BaseInstancedVisual<T>::BaseInstancedVisual()
+    {
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    BaseInstancedVisual<T>::~BaseInstancedVisual()
+    {
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::Destroy()
+    {
+      this->poses.clear();
+      this->colors.clear();
+      this->labels.clear();
+      T::Destroy();
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::SetMesh(const MeshDescriptor &_desc)
+    {
+      this->descriptor = _desc;
+      this->descriptor.Load();
+      this->meshDirty = true;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    const MeshDescriptor &BaseInstancedVisual<T>::Descriptor() const
+    {
+      return this->descriptor;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::SetInstancePoses(
+        const std::vector<math::Pose3d> &_poses)
+    {
+      this->poses = _poses;
+      this->colors.resize(_poses.size());
+      this->labels.resize(_poses.size());
+      this->dirtyPosesBegin = 0u;
+      this->dirtyPosesEnd = _poses.size();
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::UpdateInstancePoses(std::size_t _offset,
+        const math::Pose3d *_poses, std::size_t _count)
+    {
+      if (_count == 0u)
+        return;
+
+      if (!_poses || _offset + _count > this->poses.size())
+      {
+        gzerr << "Unable to update instances [" << _offset << ", "
+              << _offset + _count << ") of instanced visual [" << this->Name()
+              << "], it has " << this->poses.size() << " instances"
+              << std::endl;
+        return;
+      }
+
+      std::copy(_poses, _poses + _count, this->poses.begin() + _offset);
+      MarkDirty(this->dirtyPosesBegin, this->dirtyPosesEnd, _offset, _count);
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    std::size_t BaseInstancedVisual<T>::InstanceCount() const
+    {
+      return this->poses.size();
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    math::Pose3d BaseInstancedVisual<T>::InstancePose(std::size_t _index) const
+    {
+      if (!this->ValidInstance(_index))
+        return math::Pose3d::Zero;
+      return this->poses[_index];
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::SetInstanceColor(std::size_t _index,
+        const math::Color &_color)
+    {
+      if (!this->ValidInstance(_index))
+        return;
+      this->colors[_index] = _color;
+      MarkDirty(this->dirtyColorsBegin, this->dirtyColorsEnd, _index, 1u);
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::ClearInstanceColor(std::size_t _index)
+    {
+      if (!this->ValidInstance(_index))
+        return;
+      this->colors[_index].reset();
+      MarkDirty(this->dirtyColorsBegin, this->dirtyColorsEnd, _index, 1u);
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    math::Color BaseInstancedVisual<T>::InstanceColor(std::size_t _index) const
+    {
+      if (this->ValidInstance(_index) && this->colors[_index])
+        return *this->colors[_index];
+
+      MaterialPtr mat = this->Material();
+      return mat ? mat->Diffuse() : math::Color::White;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::SetInstanceLabel(std::size_t _index,
+        int _label)
+    {
+      if (!this->ValidInstance(_index))
+        return;
+      this->labels[_index] = _label;
+      MarkDirty(this->dirtyLabelsBegin, this->dirtyLabelsEnd, _index, 1u);
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::ClearInstanceLabel(std::size_t _index)
+    {
+      if (!this->ValidInstance(_index))
+        return;
+      this->labels[_index].reset();
+      MarkDirty(this->dirtyLabelsBegin, this->dirtyLabelsEnd, _index, 1u);
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    bool BaseInstancedVisual<T>::HasInstanceLabel(std::size_t _index) const
+    {
+      return this->ValidInstance(_index) && this->labels[_index].has_value();
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    int BaseInstancedVisual<T>::InstanceLabel(std::size_t _index) const
+    {
+      if (!this->HasInstanceLabel(_index))
+        return 0;
+      return *this->labels[_index];
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    bool BaseInstancedVisual<T>::ValidInstance(std::size_t _index) const
+    {
+      if (_index < this->poses.size())
+        return true;
+
+      gzerr << "Instance index [" << _index << "] out of range for instanced "
+            << "visual [" << this->Name() << "] with " << this->poses.size()
+            << " instances" << std::endl;
+      return false;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseInstancedVisual<T>::MarkDirty(std::size_t &_begin,
+        std::size_t &_end, std::size_t _offset, std::size_t _count)
+    {
+      if (_begin == _end)
+      {
+        _begin = _offset;
+        _end = _offset + _count;
+      }
+      else
+      {
+        _begin = std::min(_begin, _offset);
+        _end = std::max(_end, _offset + _count);
+      }
+    }
+    }
+  }
+}
+#endif
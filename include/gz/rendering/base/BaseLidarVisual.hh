@@ -17,8 +17,11 @@
 #ifndef GZ_RENDERING_BASELIDARVISUAL_HH_
 #define GZ_RENDERING_BASELIDARVISUAL_HH_
 
+#include <algorithm>
 #include <vector>
 
+#include <gz/common/Console.hh>
+
 #include "gz/rendering/LidarVisual.hh"
 #include "gz/rendering/base/BaseObject.hh"
 #include "gz/rendering/base/BaseRenderTypes.hh"
@@ -59,6 +62,10 @@ namespace gz
                             const std::vector<gz::math::Color> &_colors)
                             override;
 
+      // Documentation inherited
+      public: virtual void SetPoints(const float *_points,
+                  unsigned int _count, unsigned int _stride) override;
+
       // Documentation inherited
       public: virtual void Update() override;
 
@@ -269,6 +276,25 @@ namespace gz
       // no op
     }
 
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseLidarVisual<T>::SetPoints(const float *_points,
+                                unsigned int _count, unsigned int _stride)
+    {
+      if (_count > 0u && !_points)
+      {
+        gzerr << "Unable to set [" << _count << "] lidar points from null "
+              << "data" << std::endl;
+        return;
+      }
+
+      std::vector<double> points(_count);
+      const unsigned int stride = std::max(_stride, 1u);
+      for (unsigned int i = 0u; i < _count; ++i)
+        points[i] = _points[i * stride];
+      this->SetPoints(points);
+    }
+
     /////////////////////////////////////////////////
     template <class T>
     void BaseLidarVisual<T>::Init()
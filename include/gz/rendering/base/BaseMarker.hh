@@ -88,6 +88,22 @@ namespace gz
       public: virtual void SetPoint(unsigned int _index,
                   const gz::math::Vector3d &_value) override;
 
+      // Documentation inherited
+      public: virtual void SetPoints(const float *_xyz,
+                  const uint32_t *_rgba, std::size_t _count) override;
+
+      // Documentation inherited
+      public: virtual void UpdatePoints(std::size_t _offset,
+                  const float *_xyz, const uint32_t *_rgba,
+                  std::size_t _count) override;
+
+      // Documentation inherited
+      public: virtual unsigned int PointCount() const override;
+
+      // Documentation inherited
+      public: virtual gz::math::Vector3d Point(unsigned int _index) const
+                  override;
+
       /// \brief Life time of a marker
       GZ_UTILS_WARN_IGNORE__DLL_INTERFACE_MISSING
       protected: std::chrono::steady_clock::duration lifetime =
@@ -227,6 +243,57 @@ namespace gz
     {
       // no op
     }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseMarker<T>::SetPoints(const float *_xyz,
+                  const uint32_t *_rgba, std::size_t _count)
+    {
+      // fall back to adding the points one by one
+      this->ClearPoints();
+      if (!_xyz)
+        return;
+
+      gz::math::Color color = gz::math::Color::White;
+      for (std::size_t i = 0u; i < _count; ++i)
+      {
+        if (_rgba)
+          color.SetFromRGBA(_rgba[i]);
+        this->AddPoint(_xyz[i*3], _xyz[i*3+1], _xyz[i*3+2], color);
+      }
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    void BaseMarker<T>::UpdatePoints(std::size_t _offset,
+                  const float *_xyz, const uint32_t *, std::size_t _count)
+    {
+      // fall back to setting the points one by one, the Marker interface
+      // has no way to change the color of a single point
+      if (!_xyz)
+        return;
+
+      for (std::size_t i = 0u; i < _count; ++i)
+      {
+        this->SetPoint(static_cast<unsigned int>(_offset + i),
+            gz::math::Vector3d(_xyz[i*3], _xyz[i*3+1], _xyz[i*3+2]));
+      }
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    unsigned int BaseMarker<T>::PointCount() const
+    {
+      return 0u;
+    }
+
+    /////////////////////////////////////////////////
+    template <class T>
+    gz::math::Vector3d BaseMarker<T>::Point(unsigned int) const
+    {
+      return gz::math::Vector3d(gz::math::INF_D, gz::math::INF_D,
+          gz::math::INF_D);
+    }
     }
   }
 }
@@ -17,6 +17,9 @@
 #ifndef GZ_RENDERING_BASE_BASERAYQUERY_HH_
 #define GZ_RENDERING_BASE_BASERAYQUERY_HH_
 
+#include <vector>
+
+#include <gz/common/Console.hh>
 #include <gz/math/Matrix4.hh>
 #include <gz/math/Vector3.hh>
 
@@ -69,6 +72,13 @@ namespace gz
       public: virtual RayQueryResult ClosestPoint(
             bool _forceSceneUpdate = true) override;
 
+      // Documentation inherited
+      public: virtual void ClosestPoints(
+            const std::vector<math::Vector3d> &_origins,
+            const std::vector<math::Vector3d> &_directions,
+            std::vector<RayQueryResult> &_results,
+            bool _forceSceneUpdate = true) override;
+
       /// \brief Ray origin
       protected: math::Vector3d origin;
 
@@ -170,6 +180,38 @@ namespace gz
       result.distance = -1;
       return result;
     }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseRayQuery<T>::ClosestPoints(
+        const std::vector<math::Vector3d> &_origins,
+        const std::vector<math::Vector3d> &_directions,
+        std::vector<RayQueryResult> &_results,
+        bool _forceSceneUpdate)
+    {
+      _results.clear();
+      if (_origins.size() != _directions.size())
+      {
+        gzerr << "Number of ray origins [" << _origins.size()
+              << "] does not match number of directions ["
+              << _directions.size() << "]" << std::endl;
+        return;
+      }
+      _results.resize(_origins.size());
+
+      // fall back to one query per ray, restoring the single ray state
+      // when done
+      const math::Vector3d savedOrigin = this->origin;
+      const math::Vector3d savedDirection = this->direction;
+      for (std::size_t i = 0u; i < _origins.size(); ++i)
+      {
+        this->origin = _origins[i];
+        this->direction = _directions[i];
+        _results[i] = this->ClosestPoint(_forceSceneUpdate && i == 0u);
+      }
+      this->origin = savedOrigin;
+      this->direction = savedDirection;
+    }
     }
   }
 }
@@ -18,8 +18,10 @@
 #define GZ_RENDERING_BASE_BASESCENE_HH_
 
 #include <array>
+#include <future>
 #include <set>
 #include <string>
+#include <vector>
 
 #include <gz/common/Console.hh>
 #include <gz/utils/SuppressWarning.hh>
@@ -513,6 +515,10 @@ namespace gz
 
       public: virtual MeshPtr CreateMesh(const MeshDescriptor &_desc) override;
 
+      // Documentation inherited.
+      public: virtual std::future<MeshPtr> CreateMeshAsync(
+                  const MeshDescriptor &_desc) override;
+
       // Documentation inherited.
       public: virtual CapsulePtr CreateCapsule() override;
 
@@ -537,6 +543,21 @@ namespace gz
       public: virtual LidarVisualPtr CreateLidarVisual(unsigned int _id,
                                             const std::string &_name) override;
 
+      // Documentation inherited.
+      public: virtual InstancedVisualPtr CreateInstancedVisual() override;
+
+      // Documentation inherited.
+      public: virtual InstancedVisualPtr CreateInstancedVisual(
+                  unsigned int _id) override;
+
+      // Documentation inherited.
+      public: virtual InstancedVisualPtr CreateInstancedVisual(
+                  const std::string &_name) override;
+
+      // Documentation inherited.
+      public: virtual InstancedVisualPtr CreateInstancedVisual(
+                  unsigned int _id, const std::string &_name) override;
+
       // Documentation inherited.
       public: virtual HeightmapPtr CreateHeightmap(
           const HeightmapDescriptor &_desc) override;
@@ -651,6 +672,35 @@ namespace gz
       // Documentation inherited.
       public: virtual bool LegacyAutoGpuFlush() const override;
 
+      // Documentation inherited.
+      public: virtual void SetTextureResidencyPolicy(
+            enum TextureResidencyPolicy _policy) override;
+
+      // Documentation inherited.
+      public: virtual enum TextureResidencyPolicy TextureResidencyPolicy()
+            const override;
+
+      // Documentation inherited.
+      public: virtual void SetTextureWarmUpFrameCount(
+            unsigned int _frames) override;
+
+      // Documentation inherited.
+      public: virtual unsigned int TextureWarmUpFrameCount() const override;
+
+      // Documentation inherited.
+      public: virtual void PreloadTextures() override;
+
+      // Documentation inherited.
+      public: virtual void SetAutoStaticFrameCount(
+            unsigned int _frames) override;
+
+      // Documentation inherited.
+      public: virtual unsigned int AutoStaticFrameCount() const override;
+
+      // Documentation inherited.
+      public: virtual void RenderCameras(
+            const std::vector<CameraPtr> &_cameras) override;
+
       protected: virtual unsigned int CreateObjectId();
 
       protected: virtual std::string CreateObjectName(unsigned int _id,
@@ -820,6 +870,20 @@ namespace gz
       protected: virtual LidarVisualPtr CreateLidarVisualImpl(unsigned int _id,
                      const std::string &_name) = 0;
 
+      /// \brief Implementation for creating an instanced visual
+      /// \param[in] _id Unique object id.
+      /// \param[in] _name Unique object name.
+      /// \return Pointer to an instanced visual
+      protected: virtual InstancedVisualPtr CreateInstancedVisualImpl(
+                     unsigned int _id, const std::string &_name)
+                 {
+                   (void)_id;
+                   (void)_name;
+                   gzerr << "InstancedVisual not supported by: "
+                          << this->Engine()->Name() << std::endl;
+                   return InstancedVisualPtr();
+                 }
+
       /// \brief Implementation for creating a heightmap geometry
       /// \param[in] _id Unique object id.
       /// \param[in] _name Unique object name.
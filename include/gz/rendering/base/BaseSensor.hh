@@ -40,8 +40,17 @@ namespace gz
       // Documentation inherited.
       public: virtual uint32_t VisibilityMask() const override;
 
+      // Documentation inherited.
+      public: virtual void SetReadbackLatency(unsigned int _latency) override;
+
+      // Documentation inherited.
+      public: virtual unsigned int ReadbackLatency() const override;
+
       /// \brief Camera's visibility mask
       protected: uint32_t visibilityMask = GZ_VISIBILITY_ALL;
+
+      /// \brief Number of frames by which GPU readback may lag rendering
+      protected: unsigned int readbackLatency = 0u;
     };
 
     //////////////////////////////////////////////////
@@ -69,6 +78,20 @@ namespace gz
     {
       return this->visibilityMask;
     }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    void BaseSensor<T>::SetReadbackLatency(unsigned int _latency)
+    {
+      this->readbackLatency = _latency;
+    }
+
+    //////////////////////////////////////////////////
+    template <class T>
+    unsigned int BaseSensor<T>::ReadbackLatency() const
+    {
+      return this->readbackLatency;
+    }
     }
   }
 }
@@ -17,9 +17,14 @@
 #ifndef GZ_RENDERING_BASE_BASESTORAGE_HH_
 #define GZ_RENDERING_BASE_BASESTORAGE_HH_
 
+#include <atomic>
+#include <cstddef>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <gz/common/Console.hh>
@@ -94,7 +99,8 @@ namespace gz
 
       typedef std::shared_ptr<U> UPtr;
 
-      typedef std::map<std::string, int> UStoreMap;
+      typedef std::unordered_map<std::string, std::size_t> UStoreMap;
+      typedef std::unordered_map<unsigned int, std::size_t> UStoreIdMap;
       typedef std::vector<UPtr> UStore;
 
       typedef typename UStore::iterator UIter;
@@ -232,8 +238,46 @@ namespace gz
 
       protected: virtual UIter RemoveConstness(ConstUIter _iter);
 
-      protected: UStore store;
-      protected: UStoreMap storeMap;
+      /// \brief Find an object by pointer without compacting the store.
+      /// Used by the mutating paths, which must not pay for a compaction on
+      /// every removal.
+      /// \param[in] _object Object pointer
+      /// \return Iterator to the object
+      protected: ConstUIter FindObject(ConstTPtr _object) const;
+
+      /// \brief Find an object by id without compacting the store.
+      /// \param[in] _id Object id
+      /// \return Iterator to the object
+      protected: ConstUIter FindById(unsigned int _id) const;
+
+      /// \brief Find an object by name without compacting the store.
+      /// \param[in] _name Object name
+      /// \return Iterator to the object
+      protected: ConstUIter FindByName(const std::string &_name) const;
+
+      /// \brief Remove the empty slots left behind by objects removed from
+      /// the middle of the store and update the id and name indices of the
+      /// objects that moved. Insertion order is preserved.
+      /// This is called from const accessors, so it is guarded: concurrent
+      /// readers wait for a single compaction and then only read.
+      protected: virtual void Compact() const;
+
+      /// \brief Objects in insertion order. Removing an object that is not
+      /// the last one leaves an empty slot which is reclaimed by Compact()
+      /// the next time the store is read.
+      protected: mutable UStore store;
+
+      /// \brief Map of object name to its slot in the store
+      protected: mutable UStoreMap storeMap;
+
+      /// \brief Map of object id to its slot in the store
+      protected: mutable UStoreIdMap storeIdMap;
+
+      /// \brief Number of empty slots in the store
+      protected: mutable std::atomic<std::size_t> emptySlotCount{0u};
+
+      /// \brief Serializes compactions triggered by concurrent const reads
+      protected: mutable std::mutex compactMutex;
     };
 
     //////////////////////////////////////////////////
@@ -603,6 +647,7 @@ namespace gz
     template <class T, class U>
     unsigned int BaseStore<T, U>::Size() const
     {
+      this->Compact();
       return this->store.size();
     }
 
@@ -611,6 +656,7 @@ namespace gz
     typename BaseStore<T, U>::UIter
     BaseStore<T, U>::Begin()
     {
+      this->Compact();
       return this->store.begin();
     }
 
@@ -619,6 +665,7 @@ namespace gz
     typename BaseStore<T, U>::UIter
     BaseStore<T, U>::End()
     {
+      this->Compact();
       return this->store.end();
     }
 
@@ -732,6 +779,8 @@ namespace gz
     {
       this->store.clear();
       this->storeMap.clear();
+      this->storeIdMap.clear();
+      this->emptySlotCount = 0u;
     }
 
     //////////////////////////////////////////////////
@@ -859,66 +908,86 @@ namespace gz
     typename BaseStore<T, U>::ConstUIter
     BaseStore<T, U>::ConstIter(ConstTPtr _object) const
     {
-      auto begin = this->store.begin();
-      auto end = this->store.end();
+      this->Compact();
+      return this->FindObject(_object);
+    }
 
-      for (auto iter = begin; iter != end; ++iter)
+    //////////////////////////////////////////////////
+    template <class T, class U>
+    typename BaseStore<T, U>::ConstUIter
+    BaseStore<T, U>::ConstIterById(unsigned int _id) const
+    {
+      this->Compact();
+      return this->FindById(_id);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T, class U>
+    typename BaseStore<T, U>::ConstUIter
+    BaseStore<T, U>::ConstIterByName(const std::string &_name) const
+    {
+      this->Compact();
+      return this->FindByName(_name);
+    }
+
+    //////////////////////////////////////////////////
+    template <class T, class U>
+    typename BaseStore<T, U>::ConstUIter
+    BaseStore<T, U>::ConstIterByIndex(unsigned int _index) const
+    {
+      this->Compact();
+      if (_index >= this->store.size())
       {
-        if (*iter == _object)
-        {
-          return iter;
-        }
+        gzerr << "Invalid index: " << _index << std::endl;
+        return this->store.end();
       }
 
-      return end;
+      return this->store.begin() + _index;
     }
 
     //////////////////////////////////////////////////
     template <class T, class U>
     typename BaseStore<T, U>::ConstUIter
-    BaseStore<T, U>::ConstIterById(unsigned int _id) const
+    BaseStore<T, U>::FindObject(ConstTPtr _object) const
     {
-      auto begin = this->store.begin();
-      auto end = this->store.end();
+      if (!_object)
+      {
+        return this->store.end();
+      }
 
-      for (auto iter = begin; iter != end; ++iter)
+      auto iter = this->FindById(_object->Id());
+      if (this->IsValidIter(iter) && *iter == _object)
       {
-        if ((*iter)->Id() == _id)
-        {
-          return iter;
-        }
+        return iter;
       }
 
-      return end;
+      return this->store.end();
     }
 
     //////////////////////////////////////////////////
     template <class T, class U>
     typename BaseStore<T, U>::ConstUIter
-    BaseStore<T, U>::ConstIterByName(const std::string &_name) const
+    BaseStore<T, U>::FindById(unsigned int _id) const
     {
-      auto idx = this->storeMap.find(_name);
-      if (idx == this->storeMap.end())
+      auto idx = this->storeIdMap.find(_id);
+      if (idx == this->storeIdMap.end())
       {
         return this->store.end();
       }
-      return ConstIterByIndex(idx->second);
+      return this->store.begin() + idx->second;
     }
 
     //////////////////////////////////////////////////
     template <class T, class U>
     typename BaseStore<T, U>::ConstUIter
-    BaseStore<T, U>::ConstIterByIndex(unsigned int _index) const
+    BaseStore<T, U>::FindByName(const std::string &_name) const
     {
-      if (_index >= this->Size())
+      auto idx = this->storeMap.find(_name);
+      if (idx == this->storeMap.end())
       {
-        gzerr << "Invalid index: " << _index << std::endl;
         return this->store.end();
       }
-
-      auto iter = this->store.begin();
-      std::advance(iter, _index);
-      return iter;
+      return this->store.begin() + idx->second;
     }
 
     //////////////////////////////////////////////////
@@ -926,7 +995,7 @@ namespace gz
     typename BaseStore<T, U>::UIter
     BaseStore<T, U>::Iter(ConstTPtr _object)
     {
-      auto iter = this->ConstIter(_object);
+      auto iter = this->FindObject(_object);
       return this->RemoveConstness(iter);
     }
 
@@ -935,7 +1004,7 @@ namespace gz
     typename BaseStore<T, U>::UIter
     BaseStore<T, U>::IterById(unsigned int _id)
     {
-      auto iter = this->ConstIterById(_id);
+      auto iter = this->FindById(_id);
       return this->RemoveConstness(iter);
     }
 
@@ -944,7 +1013,7 @@ namespace gz
     typename BaseStore<T, U>::UIter
     BaseStore<T, U>::IterByName(const std::string &_name)
     {
-      auto iter = this->ConstIterByName(_name);
+      auto iter = this->FindByName(_name);
       return this->RemoveConstness(iter);
     }
 
@@ -964,20 +1033,22 @@ namespace gz
       unsigned int id = _object->Id();
       std::string name = _object->Name();
 
-      if (this->ContainsId(id))
+      if (this->IsValidIter(this->FindById(id)))
       {
         gzerr << "Another item already exists with id: " << id << std::endl;
         return false;
       }
 
-      if (this->ContainsName(name))
+      if (this->IsValidIter(this->FindByName(name)))
       {
         gzerr << "Another item already exists with name: " << name
             << std::endl;
         return false;
       }
 
-      this->storeMap[name] = this->store.size();
+      std::size_t idx = this->store.size();
+      this->storeMap[name] = idx;
+      this->storeIdMap[id] = idx;
       this->store.emplace_back(_object);
       return true;
     }
@@ -992,21 +1063,27 @@ namespace gz
         return nullptr;
       }
 
+      UPtr result = std::move(*_iter);
+      this->storeIdMap.erase(result->Id());
+      this->storeMap.erase(result->Name());
 
-      auto idx = std::distance(this->store.begin(), _iter);
-      std::string nameToErase;
-      for (auto &[name, objIdx] : this->storeMap)
+      if (_iter + 1 == this->store.end())
       {
-        if (objIdx == idx)
-          nameToErase = name;
-
-        if (objIdx >= idx)
-          objIdx--;
+        // removing the last object, also drop any empty slots before it
+        this->store.pop_back();
+        while (!this->store.empty() && !this->store.back())
+        {
+          this->store.pop_back();
+          --this->emptySlotCount;
+        }
+      }
+      else
+      {
+        // leave an empty slot so that the indices of the other objects
+        // remain valid until the next Compact()
+        ++this->emptySlotCount;
       }
-      this->storeMap.erase(nameToErase);
 
-      UPtr result = *_iter;
-      this->store.erase(_iter);
       return result;
     }
 
@@ -1034,6 +1111,40 @@ namespace gz
           this->store.erase(_iter, _iter) : this->store.end();
     }
 
+    //////////////////////////////////////////////////
+    template <class T, class U>
+    void BaseStore<T, U>::Compact() const
+    {
+      if (this->emptySlotCount.load(std::memory_order_acquire) == 0u)
+      {
+        return;
+      }
+
+      std::lock_guard<std::mutex> lock(this->compactMutex);
+      if (this->emptySlotCount.load(std::memory_order_relaxed) == 0u)
+      {
+        return;
+      }
+
+      std::size_t next = 0u;
+      for (std::size_t i = 0u; i < this->store.size(); ++i)
+      {
+        if (!this->store[i])
+          continue;
+
+        if (i != next)
+        {
+          this->store[next] = std::move(this->store[i]);
+          this->storeIdMap[this->store[next]->Id()] = next;
+          this->storeMap[this->store[next]->Name()] = next;
+        }
+        ++next;
+      }
+
+      this->store.resize(next);
+      this->emptySlotCount.store(0u, std::memory_order_release);
+    }
+
     //////////////////////////////////////////////////
     template <class T>
     BaseCompositeStore<T>::BaseCompositeStore()
@@ -65,6 +65,13 @@ namespace gz
       public: virtual void SetPoint(unsigned int _index,
                            const gz::math::Vector3d &_value) override;
 
+      // Documentation inherited
+      public: virtual unsigned int PointCount() const override;
+
+      // Documentation inherited
+      public: virtual gz::math::Vector3d Point(unsigned int _index) const
+                           override;
+
       // Documentation inherited
       public: virtual void AddPoint(const gz::math::Vector3d &_pt,
                            const gz::math::Color &_color) override;
@@ -228,6 +228,18 @@ void OgreMarker::SetPoint(unsigned int _index,
   this->dataPtr->dynamicRenderable->SetPoint(_index, _value);
 }
 
+//////////////////////////////////////////////////
+unsigned int OgreMarker::PointCount() const
+{
+  return this->dataPtr->dynamicRenderable->PointCount();
+}
+
+//////////////////////////////////////////////////
+math::Vector3d OgreMarker::Point(unsigned int _index) const
+{
+  return this->dataPtr->dynamicRenderable->Point(_index);
+}
+
 //////////////////////////////////////////////////
 void OgreMarker::AddPoint(const math::Vector3d &_pt,
     const math::Color &_color)
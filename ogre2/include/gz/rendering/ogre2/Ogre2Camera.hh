@@ -135,6 +135,10 @@ namespace gz
       // Documentation inherited.
       public: virtual void SetVisibilityMask(uint32_t _mask) override;
 
+      // Documentation inherited.
+      public: virtual void SetReadbackLatency(unsigned int _latency)
+          override;
+
       /// \brief Get the selection buffer object
       /// \return the selection buffer object
       public: Ogre2SelectionBuffer *SelectionBuffer() const;
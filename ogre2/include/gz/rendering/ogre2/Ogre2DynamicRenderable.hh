@@ -17,6 +17,8 @@
 #ifndef GZ_RENDERING_OGRE2_OGRE2DYNAMICRENDERABLE_HH_
 #define GZ_RENDERING_OGRE2_OGRE2DYNAMICRENDERABLE_HH_
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -101,6 +103,29 @@ namespace gz
       public: void SetColor(unsigned int _index,
                             const gz::math::Color &_color);
 
+      /// \brief Replace all the points of the point list. Points are stored
+      /// and uploaded in single precision.
+      /// \param[in] _xyz Pointer to 3 * _count floats, the x, y and z
+      /// coordinates of each point
+      /// \param[in] _rgba Pointer to _count colors packed as in
+      /// gz::math::Color::AsRGBA, or null to make all points white
+      /// \param[in] _count Number of points
+      public: void SetPoints(const float *_xyz, const uint32_t *_rgba,
+                             std::size_t _count);
+
+      /// \brief Change a contiguous range of existing points. Only the
+      /// range is uploaded on the next update, e.g. the oldest part of a
+      /// trail used as a ring buffer.
+      /// \param[in] _offset Index of the first point to change
+      /// \param[in] _xyz Pointer to 3 * _count floats, or null to keep the
+      /// positions
+      /// \param[in] _rgba Pointer to _count colors packed as in
+      /// gz::math::Color::AsRGBA, or null to keep the colors
+      /// \param[in] _count Number of points to change. The range must be
+      /// within PointCount().
+      public: void UpdatePoints(std::size_t _offset, const float *_xyz,
+                                const uint32_t *_rgba, std::size_t _count);
+
       /// \brief Return the position of an existing point in the point list
       /// \param[in] _index Get the point at this index
       /// \return position of point. A vector of
@@ -130,20 +155,27 @@ namespace gz
       /// \brief Update vertex buffer if vertices have changes
       private: void UpdateBuffer();
 
+      /// \brief Mark a range of vertices as changed
+      /// \param[in] _begin First vertex that changed
+      /// \param[in] _end One past the last vertex that changed
+      private: void MarkDirty(std::size_t _begin, std::size_t _end);
+
       /// \brief Helper function to generate normals
       /// \param[in] _opType Ogre render operation type
-      /// \param[in] _vertices a list of vertices
+      /// \param[in] _vertices x, y and z coordinates of each vertex
       /// \param[in,out] _vbuffer vertex buffer to be filled
       private: void GenerateNormals(Ogre::OperationType _opType,
-          const std::vector<math::Vector3d> &_vertices, float *_vbuffer);
+          const std::vector<float> &_vertices, float *_vbuffer);
 
       /// \brief Helper function to generate colors per-vertex. Only applies
       /// to points. The colors fill the normal slots on the vertex buffer.
       /// \param[in] _opType Ogre render operation type
-      /// \param[in] _vertices a list of vertices
-      /// \param[in,out] _vbuffer vertex buffer to be filled
+      /// \param[in] _begin First vertex to fill
+      /// \param[in] _end One past the last vertex to fill
+      /// \param[in,out] _vbuffer vertex buffer to be filled, starting at
+      /// vertex _begin
       private: void GenerateColors(Ogre::OperationType _opType,
-          const std::vector<math::Vector3d> &_vertices, float *_vbuffer);
+          std::size_t _begin, std::size_t _end, float *_vbuffer);
 
       /// \brief Destroy the vertex buffer
       private: void DestroyBuffer();
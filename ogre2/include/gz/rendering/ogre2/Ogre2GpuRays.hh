@@ -18,6 +18,7 @@
 #ifndef GZ_RENDERING_OGRE2_OGRE2GPURAYS_HH_
 #define GZ_RENDERING_OGRE2_OGRE2GPURAYS_HH_
 
+#include <set>
 #include <string>
 #include <memory>
 
@@ -62,6 +63,10 @@ namespace gz
     /// min/max angles and no. of samples. Each ray is a direction vector that
     /// is used to sample/lookup the range data stored in the faces of the
     /// cubemap.
+    /// Sensors with a cubemap sharing tolerance skip the 1st pass when
+    /// another sensor close enough to them already rendered a compatible
+    /// cubemap in the current frame, and sample that cubemap in their 2nd
+    /// pass instead.
     class GZ_RENDERING_OGRE2_VISIBLE Ogre2GpuRays :
       public BaseGpuRays<Ogre2Sensor>
     {
@@ -98,6 +103,13 @@ namespace gz
                   unsigned int _height, unsigned int _channels,
                   const std::string &_format)> _subscriber) override;
 
+      // Documentation inherited.
+      public: virtual common::ConnectionPtr ConnectNewGpuRaysRawFrame(
+                  std::function<void(const float *_frame, unsigned int _width,
+                  unsigned int _height, unsigned int _channels,
+                  unsigned int _rowStride,
+                  const std::string &_format)> _subscriber) override;
+
       // Documentation inherited.
       public: virtual RenderTargetPtr RenderTarget() const override;
 
@@ -137,12 +149,46 @@ namespace gz
       /// cubemap face index data
       private: void CreateSampleTexture();
 
+      /// \brief Compute the cubemap uv coordinates and face index of every
+      /// ray
+      /// \param[in] _rot Rotation of this sensor relative to the sensor
+      /// that rendered the cubemap
+      /// \param[out] _data Four floats per ray as packed in the sample
+      /// texture. Can be nullptr to only compute _faceIdx.
+      /// \param[out] _faceIdx Indices of the cubemap faces sampled by the
+      /// rays
+      private: void ComputeSampleData(const math::Quaterniond &_rot,
+          float *_data, std::set<unsigned int> &_faceIdx);
+
+      /// \brief Upload data to the texture created by CreateSampleTexture
+      /// \param[in] _data Four floats per ray, see ComputeSampleData
+      private: void UploadSampleTexture(const float *_data);
+
       /// \brief Set up 1st pass material, texture, and compositor
       private: void Setup1stPass();
 
       /// \brief Set up 2nd pass material, texture, and compositor
       private: void Setup2ndPass();
 
+      /// \brief Create the 2nd pass compositor workspace, sampling the
+      /// cubemap of the sensor set with SetFirstPassSource
+      private: void CreateWorkspace2nd();
+
+      /// \brief Find another sensor of the scene that rendered a cubemap
+      /// this sensor can sample in the current frame
+      /// \param[out] _rot Rotation of this sensor relative to the sensor
+      /// found
+      /// \return The sensor found, or nullptr if this sensor has to render
+      /// its own cubemap
+      private: Ogre2GpuRays *FindFirstPassSource(math::Quaterniond &_rot);
+
+      /// \brief Set the sensor whose cubemap the 2nd pass samples
+      /// \param[in] _source Sensor whose cubemap to sample, or nullptr to
+      /// sample the cubemap of this sensor
+      /// \param[in] _rot Rotation of this sensor relative to _source
+      private: void SetFirstPassSource(Ogre2GpuRays *_source,
+          const math::Quaterniond &_rot);
+
       /// \brief Helper function to convert a direction vector to the
       /// index number of a cubemap face and texture uv coordinates on that face
       /// \param[in] _v Direction vector
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_OGRE2_OGRE2INSTANCEDVISUAL_HH_
+#define GZ_RENDERING_OGRE2_OGRE2INSTANCEDVISUAL_HH_
+
+#include <memory>
+
+#include "gz/rendering/base/BaseInstancedVisual.hh"
+#include "gz/rendering/ogre2/Ogre2Visual.hh"
+
+namespace gz
+{
+  namespace rendering
+  {
+    inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+    //
+    // Forward declaration
+    class Ogre2InstancedVisualPrivate;
+
+    /// \brief Ogre 2.x implementation of an instanced visual. Every
+    /// instance is still its own Ogre item in its own child scene node of
+    /// the visual, so the CPU cost of culling and updating the instances
+    /// grows with their number like for plain items. What is saved is the
+    /// gz::rendering visual, geometry and material of each copy. The items
+    /// share their mesh and datablocks, so OgreNext batches them into
+    /// instanced draw calls. Having one item per instance is what lets
+    /// segmentation cameras give each instance its own label.
+    class GZ_RENDERING_OGRE2_VISIBLE Ogre2InstancedVisual
+      : public BaseInstancedVisual<Ogre2Visual>
+    {
+      /// \brief Constructor
+      protected: Ogre2InstancedVisual();
+
+      /// \brief Destructor
+      public: virtual ~Ogre2InstancedVisual();
+
+      // Documentation inherited.
+      public: virtual void PreRender() override;
+
+      // Documentation inherited.
+      public: virtual void Destroy() override;
+
+      // Documentation inherited.
+      public: virtual void SetStatic(bool _static) override;
+
+      // Documentation inherited.
+      public: virtual void SetVisibilityFlags(uint32_t _flags) override;
+
+      // Documentation inherited.
+      public: virtual math::AxisAlignedBox BoundingBox() const override;
+
+      // Documentation inherited.
+      public: virtual math::AxisAlignedBox LocalBoundingBox() const override;
+
+      /// \brief Create the prototype mesh and the instance items, and
+      /// apply the poses, colors and labels that changed
+      private: void UpdateInstances();
+
+      /// \brief Bind the datablocks of a range of instances
+      /// \param[in] _begin First instance to update
+      /// \param[in] _end One past the last instance to update
+      private: void UpdateDatablocks(std::size_t _begin, std::size_t _end);
+
+      /// \brief Destroy the items and scene nodes of the instances from
+      /// index _count on
+      /// \param[in] _count Number of instances to keep
+      private: void DestroyInstances(std::size_t _count);
+
+      /// \brief Merge the bounds of every instance into a box
+      /// \param[in, out] _box Box to merge the bounds into
+      /// \param[in] _pose Pose of the visual in the frame of the box
+      private: void InstancesBounds(math::AxisAlignedBox &_box,
+                   const math::Pose3d &_pose) const;
+
+      /// \brief Only an ogre scene can create an ogre instanced visual
+      private: friend class Ogre2Scene;
+
+      /// \brief Pointer to private data
+      private: std::unique_ptr<Ogre2InstancedVisualPrivate> dataPtr;
+    };
+    }
+  }
+}
+#endif
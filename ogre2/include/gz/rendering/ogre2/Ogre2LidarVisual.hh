@@ -33,7 +33,10 @@ namespace gz
     // Forward declaration
     class Ogre2LidarVisualPrivate;
 
-    /// \brief Ogre 2.x implementation of a Lidar Visual.
+    /// \brief Ogre 2.x implementation of a Lidar Visual. The directions of
+    /// the rays are uploaded once, and each update only uploads the range
+    /// of every ray. The points, rays and triangles are built from them in
+    /// a vertex shader.
     class GZ_RENDERING_OGRE2_VISIBLE Ogre2LidarVisual
       : public BaseLidarVisual<Ogre2Visual>
     {
@@ -59,6 +62,10 @@ namespace gz
       public: virtual void SetPoints(
               const std::vector<double> &_points) override;
 
+      // Documentation inherited
+      public: virtual void SetPoints(const float *_points,
+              unsigned int _count, unsigned int _stride) override;
+
       // Documentation inherited
       public: virtual void ClearPoints() override;
 
@@ -71,9 +78,17 @@ namespace gz
       /// \brief Create the Lidar Visual in ogre
       private: void Create();
 
-      /// \brief Clear data stored by dynamiclines
+      /// \brief Destroy the ogre items of the visual
       private: void ClearVisualData();
 
+      /// \brief Create the vertex and index buffers shared by the ogre
+      /// items for the current angles, ray counts and offset, if they
+      /// changed
+      private: void UpdateBuffers();
+
+      /// \brief Destroy the ogre items, meshes and buffers
+      private: void DestroyBuffers();
+
       // Documentation inherited
       public: virtual void SetVisible(bool _visible) override;
 
@@ -64,10 +64,26 @@ namespace gz
       public: virtual void SetPoint(unsigned int _index,
                            const gz::math::Vector3d &_value) override;
 
+      // Documentation inherited
+      public: virtual unsigned int PointCount() const override;
+
+      // Documentation inherited
+      public: virtual gz::math::Vector3d Point(unsigned int _index) const
+                           override;
+
       // Documentation inherited
       public: virtual void AddPoint(const gz::math::Vector3d &_pt,
                            const gz::math::Color &_color) override;
 
+      // Documentation inherited
+      public: virtual void SetPoints(const float *_xyz,
+                           const uint32_t *_rgba, std::size_t _count) override;
+
+      // Documentation inherited
+      public: virtual void UpdatePoints(std::size_t _offset,
+                           const float *_xyz, const uint32_t *_rgba,
+                           std::size_t _count) override;
+
       // Documentation inherited
       public: virtual void ClearPoints() override;
 
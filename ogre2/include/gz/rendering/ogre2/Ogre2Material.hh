@@ -17,6 +17,7 @@
 #ifndef GZ_RENDERING_OGRE2_OGRE2MATERIAL_HH_
 #define GZ_RENDERING_OGRE2_OGRE2MATERIAL_HH_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -256,6 +257,20 @@ namespace gz
       public: virtual void FillUnlitDatablock(
           Ogre::HlmsUnlitDatablock *_datablock) const;
 
+      /// \internal
+      /// \brief Get a counter that is incremented every time the pbs
+      /// datablock of this material is modified. Submeshes compare it to
+      /// detect when a material they share a datablock for has changed.
+      /// \return Datablock revision
+      public: uint64_t DatablockRevision() const;
+
+      /// \internal
+      /// \brief Tell the material that a submesh is rendering it through a
+      /// shared datablock. The next modification to the material marks the
+      /// scene visuals dirty so the submesh can detach from it.
+      /// \sa Ogre2Scene::AcquireSharedDatablock
+      public: void SetDatablockShared();
+
       // Documentation inherited.
       // \sa BaseMaterial::PreRender()
       public: virtual void PreRender() override;
@@ -325,6 +340,11 @@ namespace gz
       /// based on transparency and diffuse alpha values
       protected: virtual void UpdateTransparency();
 
+      /// \brief Must be called whenever the pbs datablock is modified.
+      /// Increments the datablock revision and, if the material is being
+      /// rendered through a shared datablock, marks the visuals dirty.
+      protected: void DatablockChanged();
+
       // Documentation inherited.
       protected: virtual void Init() override;
 
@@ -129,6 +129,15 @@ namespace gz
       /// \brief Get internal ogre subitem created from this submesh
       public: virtual Ogre::SubItem *Ogre2SubItem() const;
 
+      // Documentation inherited
+      public: virtual void PreRender() override;
+
+      /// \internal
+      /// \brief Render the submesh with the datablock of its own material
+      /// instead of the datablock shared with identical materials. Must be
+      /// called before modifying the subitem datablock directly.
+      public: void DetachSharedDatablock();
+
       /// \brief Helper function for setting the material to use
       /// \param[in] _material Material to be assigned to the submesh
       protected: virtual void SetMaterialImpl(MaterialPtr _material) override;
@@ -61,6 +61,16 @@ namespace gz
       /// factory
       public: virtual void Clear();
 
+      /// \brief Do the CPU side work needed to load a mesh ahead of time,
+      /// such as packing its vertex and index data. The result is used by
+      /// the next call to Create with the same descriptor. Unlike Create,
+      /// this function doesn't call into Ogre and can be called from any
+      /// thread.
+      /// \param[in] _desc Mesh descriptor
+      /// \return False if the mesh can't be prepared ahead of time, e.g.
+      /// because it has a skeleton. Create will then do all the work.
+      public: bool Prepare(const MeshDescriptor &_desc);
+
       /// \brief Get the ogre item based on the mesh descriptor
       /// \param[in] _desc Descriptor describing the target mesh
       protected: virtual Ogre::Item *OgreItem(
@@ -79,6 +89,13 @@ namespace gz
       /// \param[in] _desc Input mesh descriptor
       protected: virtual bool LoadImpl(const MeshDescriptor &_desc);
 
+      /// \brief Build the ogre v2 mesh directly from the common::Mesh,
+      /// without going through an intermediate v1 mesh. Used by LoadImpl
+      /// for meshes that have no skeleton.
+      /// \param[in] _desc Input mesh descriptor
+      /// \return True if the mesh was created
+      private: bool LoadV2Impl(const MeshDescriptor &_desc);
+
       /// \brief Get the mesh name from the mesh descriptor
       /// \param[in] _desc Mesh descriptor containing the mesh name
       protected: virtual std::string MeshName(const MeshDescriptor &_desc);
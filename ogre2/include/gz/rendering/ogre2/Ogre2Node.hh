@@ -64,6 +64,10 @@ namespace gz
       // Documentation inherited.
       public: virtual void SetInheritScale(bool _inherit) override;
 
+      // Documentation inherited.
+      public: virtual void SetUserData(const std::string &_key,
+                  Variant _value) override;
+
       // Documentation inherited.
       protected: virtual void SetLocalScaleImpl(
                      const math::Vector3d &_scale) override;
@@ -18,6 +18,7 @@
 #define GZ_RENDERING_OGRE2_OGRE2RAYQUERY_HH_
 
 #include <memory>
+#include <vector>
 
 #include "gz/rendering/base/BaseRayQuery.hh"
 #include "gz/rendering/ogre2/Ogre2Object.hh"
@@ -63,6 +64,13 @@ namespace gz
       public: virtual RayQueryResult ClosestPoint(
             bool _forceSceneUpdate = true) override;
 
+      // Documentation inherited
+      public: virtual void ClosestPoints(
+            const std::vector<math::Vector3d> &_origins,
+            const std::vector<math::Vector3d> &_directions,
+            std::vector<RayQueryResult> &_results,
+            bool _forceSceneUpdate = true) override;
+
       /// \brief Get closest point by selection buffer.
       /// This is executed on the GPU.
       private: RayQueryResult ClosestPointBySelectionBuffer();
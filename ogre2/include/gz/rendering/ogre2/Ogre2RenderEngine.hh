@@ -138,7 +138,16 @@ namespace gz
       /// \return list of scenes
       protected: virtual SceneStorePtr Scenes() const override;
 
-      // Documentation Inherited.
+      /// \brief Engine implementation of Load function.
+      /// \param[in] _params Parameters to be passed to the render engine.
+      /// Besides the graphics API and context parameters, accepts:
+      /// "shaderCachePath" : Folder where compiled shaders are saved when
+      /// the engine is destroyed and loaded from on the next start, to
+      /// avoid compiling them again. Caches are kept per GPU, driver and
+      /// library version. Disabled if not set.
+      /// "meshCachePath" : Folder where meshes are cached after being packed
+      /// into GPU vertex and index buffers, so later loads of the same
+      /// source file skip the packing. Disabled if not set.
       protected: virtual bool LoadImpl(
           const std::map<std::string, std::string> &_params) override;
 
@@ -176,6 +185,14 @@ namespace gz
       /// \brief Create the resources needed by ogre
       private: void CreateResources();
 
+      /// \brief Load the HLMS and shader microcode caches from the folder
+      /// given by the "shaderCachePath" parameter, if any
+      private: void LoadShaderCache();
+
+      /// \brief Save the HLMS and shader microcode caches to the folder
+      /// given by the "shaderCachePath" parameter, if any
+      private: void SaveShaderCache();
+
       /// \brief Attempt to initialize engine and catch exeption if they occur
       private: void InitAttempt();
 
@@ -228,6 +245,12 @@ namespace gz
       public: Ogre::CompositorWorkspaceListener
           *TerraWorkspaceListener() const;
 
+      /// \internal
+      /// \brief Get the folder packed meshes are cached in, given by the
+      /// "meshCachePath" parameter.
+      /// \return Path to the mesh cache folder, empty if disabled.
+      public: std::string MeshCachePath() const;
+
       /// \brief Get a pointer to the render engine
       /// \return a pointer to the render engine
       public: static Ogre2RenderEngine *Instance();
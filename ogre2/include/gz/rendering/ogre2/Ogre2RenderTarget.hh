@@ -164,6 +164,20 @@ namespace gz
       /// \param[in] _mask Visibility mask
       public: virtual void SetVisibilityMask(uint32_t _mask);
 
+      /// \brief Set the number of frames by which Copy() lags behind
+      /// rendering. When greater than 0, the render target is downloaded
+      /// asynchronously in PostRender() and Copy() returns the frame
+      /// rendered _latency updates earlier, leaving the image untouched
+      /// until that many frames have been rendered.
+      /// \param[in] _latency Readback latency in frames
+      /// \sa Sensor::SetReadbackLatency
+      public: void SetReadbackLatency(unsigned int _latency);
+
+      /// \brief Get the number of frames by which Copy() lags behind
+      /// rendering.
+      /// \return Readback latency in frames
+      public: unsigned int ReadbackLatency() const;
+
       /// \brief Update the render pass chain
       public: static void UpdateRenderPassChain(
           Ogre::CompositorWorkspace *_workspace,
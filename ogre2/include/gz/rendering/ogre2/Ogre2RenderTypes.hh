@@ -47,6 +47,7 @@ namespace gz
     class Ogre2JointVisual;
     class Ogre2Light;
     class Ogre2LightVisual;
+    class Ogre2InstancedVisual;
     class Ogre2LidarVisual;
     class Ogre2Marker;
     class Ogre2Material;
@@ -101,6 +102,7 @@ namespace gz
     typedef shared_ptr<Ogre2JointVisual>          Ogre2JointVisualPtr;
     typedef shared_ptr<Ogre2Light>                Ogre2LightPtr;
     typedef shared_ptr<Ogre2LightVisual>          Ogre2LightVisualPtr;
+    typedef shared_ptr<Ogre2InstancedVisual>      Ogre2InstancedVisualPtr;
     typedef shared_ptr<Ogre2LidarVisual>          Ogre2LidarVisualPtr;
     typedef shared_ptr<Ogre2Marker>               Ogre2MarkerPtr;
     typedef shared_ptr<Ogre2Material>             Ogre2MaterialPtr;
@@ -17,6 +17,7 @@
 #ifndef GZ_RENDERING_OGRE2_OGRE2SCENE_HH_
 #define GZ_RENDERING_OGRE2_OGRE2SCENE_HH_
 
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -40,6 +41,7 @@
 
 namespace Ogre
 {
+  class HlmsPbsDatablock;
   class Root;
   class SceneManager;
 }
@@ -96,6 +98,10 @@ namespace gz
       // Documentation inherited
       public: virtual void Destroy() override;
 
+      // Documentation inherited.
+      public: virtual std::future<MeshPtr> CreateMeshAsync(
+                  const MeshDescriptor &_desc) override;
+
       // Documentation inherited
       public: virtual void SetSkyEnabled(bool _enabled) override;
 
@@ -121,6 +127,31 @@ namespace gz
       // Documentation inherited.
       public: virtual bool LegacyAutoGpuFlush() const override;
 
+      // Documentation inherited.
+      public: virtual void SetTextureResidencyPolicy(
+            enum TextureResidencyPolicy _policy) override;
+
+      // Documentation inherited.
+      public: virtual enum TextureResidencyPolicy TextureResidencyPolicy()
+            const override;
+
+      // Documentation inherited.
+      public: virtual void SetTextureWarmUpFrameCount(
+            unsigned int _frames) override;
+
+      // Documentation inherited.
+      public: virtual unsigned int TextureWarmUpFrameCount() const override;
+
+      // Documentation inherited.
+      public: virtual void PreloadTextures() override;
+
+      // Documentation inherited.
+      public: virtual void SetAutoStaticFrameCount(
+            unsigned int _frames) override;
+
+      // Documentation inherited.
+      public: virtual unsigned int AutoStaticFrameCount() const override;
+
       /// \brief Get a pointer to the ogre scene manager
       /// \return Pointer to the ogre scene manager
       public: virtual Ogre::SceneManager *OgreSceneManager() const;
@@ -191,6 +222,17 @@ namespace gz
       /// call when in LegacyAutoGpuFlush == false
       protected: void EndFrame();
 
+      /// \internal
+      /// \brief Make static the visuals that have not moved for
+      /// AutoStaticFrameCount frames. Called once per frame in PreRender.
+      /// \sa SetAutoStaticFrameCount
+      private: void UpdateAutoStatic();
+
+      /// \internal
+      /// \brief Create the meshes requested with CreateMeshAsync whose CPU
+      /// side work is done. Called once per frame in PreRender.
+      private: void CreatePendingMeshes();
+
       /// \internal
       /// \brief Mark shadows dirty to rebuild compostior shadow node
       /// This is set when the number of shadow casting lighst changes
@@ -203,6 +245,65 @@ namespace gz
       /// \return True if the number of shadow casting lights changed
       /// \sa ShadowsDirty
       public: bool ShadowsDirty() const;
+
+      /// \internal
+      /// \brief Informs that geometries were attached to or detached from
+      /// visuals, that nodes were reparented, or that materials or user
+      /// data changed. Per item data derived from them (e.g. segmentation
+      /// colors) must be recomputed.
+      public: void SetVisualsDirty();
+
+      /// \internal
+      /// \brief Informs that the datablock of a material, e.g. its textures
+      /// or colors, may have changed. Caches of the textures used by the
+      /// scene and of material state must be rebuilt.
+      public: void SetTexturesDirty();
+
+      /// \internal
+      /// \brief Get a counter incremented on every SetTexturesDirty call.
+      /// \return Current revision of the materials' datablocks
+      /// \sa VisualsRevision
+      public: uint64_t TexturesRevision() const;
+
+      /// \internal
+      /// \brief Get a counter incremented on every SetVisualsDirty call.
+      /// Caches store the value they were built with and compare it to
+      /// know if they are stale.
+      /// \return Current revision of the visuals
+      public: uint64_t VisualsRevision() const;
+
+      /// \internal
+      /// \brief Get the number of PreRender calls so far. Sensors that
+      /// reuse what another sensor rendered compare it to know if the data
+      /// belongs to the current frame.
+      /// \return Current frame number
+      public: uint64_t FrameCount() const;
+
+      /// \internal
+      /// \brief Informs that the local transform of a node changed. Static
+      /// nodes are flagged dirty so OgreNext updates them in the next
+      /// frame, and visuals made static by SetAutoStaticFrameCount are made
+      /// dynamic again.
+      /// \param[in] _node Node that moved
+      public: void NodeMoved(Ogre2Node *_node);
+
+      /// \internal
+      /// \brief Get a datablock with the same state as the pbs datablock of
+      /// the given material, shared by every submesh whose material is
+      /// identical. Each call must be matched by a ReleaseSharedDatablock
+      /// call.
+      /// \param[in] _material Material to find a shared datablock for
+      /// \return Shared datablock, or nullptr if the material can not be
+      /// shared (e.g. it uses custom shaders)
+      public: Ogre::HlmsPbsDatablock *AcquireSharedDatablock(
+                  Ogre2Material &_material);
+
+      /// \internal
+      /// \brief Release a datablock returned by AcquireSharedDatablock. It
+      /// is destroyed once no submesh uses it anymore, which marks the
+      /// visuals dirty so that caches referencing it are rebuilt.
+      /// \param[in] _datablock Shared datablock to release
+      public: void ReleaseSharedDatablock(Ogre::HlmsPbsDatablock *_datablock);
       /// \endcond
 
       // Documentation inherited
@@ -335,6 +436,10 @@ namespace gz
       protected: virtual LidarVisualPtr CreateLidarVisualImpl(unsigned int _id,
                      const std::string &_name) override;
 
+      // Documentation inherited
+      protected: virtual InstancedVisualPtr CreateInstancedVisualImpl(
+                     unsigned int _id, const std::string &_name) override;
+
       // Documentation inherited
       protected: virtual WireBoxPtr CreateWireBoxImpl(unsigned int _id,
                      const std::string &_name) override;
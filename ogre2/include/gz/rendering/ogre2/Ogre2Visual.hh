@@ -90,6 +90,16 @@ namespace gz
       // Documentation inherited.
       protected: virtual GeometryStorePtr Geometries() const override;
 
+      /// \brief Pre-render the children of this visual. Children whose
+      /// whole subtree has nothing to update are skipped until the
+      /// scene's visuals change (see Ogre2Scene::VisualsRevision).
+      protected: virtual void PreRenderChildren() override;
+
+      /// \brief Pre-render the geometries of this visual. Plain meshes
+      /// without custom shader parameters are skipped until the scene's
+      /// visuals change (see Ogre2Scene::VisualsRevision).
+      protected: virtual void PreRenderGeometries() override;
+
       // Documentation inherited.
       protected: virtual bool AttachGeometry(GeometryPtr _geometry) override;
 
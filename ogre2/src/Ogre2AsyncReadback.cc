@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "gz/rendering/ogre2/Ogre2Includes.hh"
+#include "gz/rendering/ogre2/Ogre2RenderEngine.hh"
+
+#include "Ogre2AsyncReadback.hh"
+
+using namespace gz;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+Ogre2AsyncReadback::~Ogre2AsyncReadback()
+{
+  // Reset() should have been called by the owner before the engine is
+  // shutdown. Only release the tickets here if the engine is still alive.
+  if (!this->tickets.empty() && Ogre2RenderEngine::Instance()->OgreRoot())
+    this->Reset();
+}
+
+//////////////////////////////////////////////////
+void Ogre2AsyncReadback::SetLatency(unsigned int _latency)
+{
+  if (this->latency == _latency)
+    return;
+
+  this->Reset();
+  this->latency = _latency;
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2AsyncReadback::Latency() const
+{
+  return this->latency;
+}
+
+//////////////////////////////////////////////////
+void Ogre2AsyncReadback::Download(Ogre::TextureGpu *_texture)
+{
+  if (!_texture)
+    return;
+
+  // recreate tickets if the texture changed
+  if (this->width != _texture->getInternalWidth() ||
+      this->height != _texture->getInternalHeight() ||
+      this->format != _texture->getPixelFormat())
+  {
+    this->Reset();
+    this->width = _texture->getInternalWidth();
+    this->height = _texture->getInternalHeight();
+    this->format = _texture->getPixelFormat();
+  }
+
+  if (this->tickets.empty())
+    this->tickets.resize(this->latency + 1u, nullptr);
+
+  // the consumer has not kept up, drop the oldest frame
+  if (this->pending == this->tickets.size())
+  {
+    this->oldest = (this->oldest + 1u) % this->tickets.size();
+    --this->pending;
+  }
+
+  std::size_t slot = (this->oldest + this->pending) % this->tickets.size();
+  if (!this->tickets[slot])
+  {
+    Ogre::TextureGpuManager *textureMgr =
+        Ogre2RenderEngine::Instance()->OgreRoot()->getRenderSystem()->
+        getTextureGpuManager();
+    this->tickets[slot] = textureMgr->createAsyncTextureTicket(
+        this->width, this->height, _texture->getDepthOrSlices(),
+        _texture->getTextureType(),
+        Ogre::PixelFormatGpuUtils::getFamily(this->format));
+  }
+
+  this->tickets[slot]->download(_texture, 0u, true);
+  ++this->pending;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2AsyncReadback::FrameReady() const
+{
+  return this->pending > this->latency;
+}
+
+//////////////////////////////////////////////////
+Ogre::TextureBox Ogre2AsyncReadback::MapFrame()
+{
+  return this->tickets[this->oldest]->map(0u);
+}
+
+//////////////////////////////////////////////////
+void Ogre2AsyncReadback::UnmapFrame()
+{
+  this->tickets[this->oldest]->unmap();
+  this->oldest = (this->oldest + 1u) % this->tickets.size();
+  --this->pending;
+}
+
+//////////////////////////////////////////////////
+void Ogre2AsyncReadback::Reset()
+{
+  if (!this->tickets.empty())
+  {
+    Ogre::TextureGpuManager *textureMgr =
+        Ogre2RenderEngine::Instance()->OgreRoot()->getRenderSystem()->
+        getTextureGpuManager();
+    for (auto ticket : this->tickets)
+    {
+      if (ticket)
+        textureMgr->destroyAsyncTextureTicket(ticket);
+    }
+  }
+
+  this->tickets.clear();
+  this->oldest = 0u;
+  this->pending = 0u;
+  this->width = 0u;
+  this->height = 0u;
+  this->format = Ogre::PFG_UNKNOWN;
+}
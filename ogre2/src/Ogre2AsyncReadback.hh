@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_OGRE2_OGRE2ASYNCREADBACK_HH_
+#define GZ_RENDERING_OGRE2_OGRE2ASYNCREADBACK_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gz/rendering/config.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreAsyncTextureTicket.h>
+#include <OgrePixelFormatGpu.h>
+#include <OgreTextureBox.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+namespace Ogre
+{
+  class TextureGpu;
+}
+
+namespace gz
+{
+  namespace rendering
+  {
+    inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Helper class for reading back sensor textures from the GPU
+    /// without stalling the CPU. It keeps a ring of Ogre::AsyncTextureTicket
+    /// objects so that the data of frame k can be mapped while frames
+    /// k+1 .. k+N are still being rendered, where N is the latency.
+    class Ogre2AsyncReadback
+    {
+      /// \brief Constructor
+      public: Ogre2AsyncReadback() = default;
+
+      /// \brief Destructor
+      public: ~Ogre2AsyncReadback();
+
+      /// \brief Set the number of frames the readback lags behind
+      /// rendering. Changing the latency discards pending downloads.
+      /// \param[in] _latency Latency in frames. 0 means synchronous
+      public: void SetLatency(unsigned int _latency);
+
+      /// \brief Get the number of frames the readback lags behind rendering
+      /// \return Latency in frames
+      public: unsigned int Latency() const;
+
+      /// \brief Start an asynchronous download of the texture. This should
+      /// be called once per frame after the texture has been rendered.
+      /// If the consumer did not map the oldest pending frame, it is
+      /// dropped to make room for the new one.
+      /// \param[in] _texture Texture to download
+      public: void Download(Ogre::TextureGpu *_texture);
+
+      /// \brief Check if the oldest pending download is old enough to be
+      /// mapped, i.e. more than Latency() downloads are pending.
+      /// \return True if MapFrame() can be called
+      public: bool FrameReady() const;
+
+      /// \brief Map the oldest pending download. Blocks if the GPU has not
+      /// finished the transfer yet. UnmapFrame() must be called when done.
+      /// \return Box pointing to the mapped CPU memory
+      public: Ogre::TextureBox MapFrame();
+
+      /// \brief Unmap the frame mapped by MapFrame() and release its ticket
+      /// for reuse.
+      public: void UnmapFrame();
+
+      /// \brief Destroy all tickets and discard pending downloads
+      public: void Reset();
+
+      /// \brief Ring of tickets, Latency() + 1 in size
+      private: std::vector<Ogre::AsyncTextureTicket *> tickets;
+
+      /// \brief Index of the oldest pending ticket in the ring
+      private: std::size_t oldest = 0u;
+
+      /// \brief Number of pending downloads
+      private: std::size_t pending = 0u;
+
+      /// \brief Readback latency in frames
+      private: unsigned int latency = 0u;
+
+      /// \brief Width of the texture the tickets were created for
+      private: uint32_t width = 0u;
+
+      /// \brief Height of the texture the tickets were created for
+      private: uint32_t height = 0u;
+
+      /// \brief Pixel format of the texture the tickets were created for
+      private: Ogre::PixelFormatGpu format = Ogre::PFG_UNKNOWN;
+    };
+    }
+  }
+}
+
+#endif
@@ -15,13 +15,20 @@
  *
  */
 
+#include <algorithm>
 #include <limits>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable:5033)
 #endif
 #include <OgreBitwise.h>
+#include <Threading/OgreUniformScalableTask.h>
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
@@ -50,6 +57,404 @@
 using namespace gz;
 using namespace rendering;
 
+/// \brief Compute the vertices of the 3D convex hull of a set of points
+/// using the quickhull algorithm. Degenerate (flat) sets are returned as is.
+/// \param[in] _points Points to compute the hull of
+/// \return The points that are vertices of the hull, in no particular order
+static std::vector<Ogre::Vector3> ConvexHullVertices(
+    const std::vector<Ogre::Vector3> &_points)
+{
+  if (_points.size() <= 4u)
+    return _points;
+
+  std::vector<math::Vector3d> pts;
+  pts.reserve(_points.size());
+  double scale = 0.0;
+  for (const Ogre::Vector3 &p : _points)
+  {
+    pts.emplace_back(p.x, p.y, p.z);
+    scale = std::max(scale, pts.back().Abs().Max());
+  }
+
+  // Points closer than this to a face are considered to lie on it
+  const double eps = std::max(scale, 1.0) * 1e-6;
+
+  struct Face
+  {
+    uint32_t v[3];
+    math::Vector3d normal;
+    double offset;
+    std::vector<uint32_t> outside;
+    bool alive;
+  };
+  std::vector<Face> faces;
+
+  // Directed edge (a, b) to the face that has it, used to find the
+  // neighbor across an edge as the face owning (b, a)
+  std::unordered_map<uint64_t, uint32_t> edges;
+  auto edgeKey = [](uint32_t _a, uint32_t _b)
+  {
+    return (static_cast<uint64_t>(_a) << 32u) | _b;
+  };
+
+  auto distance = [&](const Face &_f, uint32_t _p)
+  {
+    return _f.normal.Dot(pts[_p]) - _f.offset;
+  };
+
+  auto addFace = [&](uint32_t _a, uint32_t _b, uint32_t _c)
+  {
+    Face f;
+    f.v[0] = _a;
+    f.v[1] = _b;
+    f.v[2] = _c;
+    f.normal = (pts[_b] - pts[_a]).Cross(pts[_c] - pts[_a]);
+    const double length = f.normal.Length();
+    if (length > 0.0)
+      f.normal /= length;
+    f.offset = f.normal.Dot(pts[_a]);
+    f.alive = true;
+    const uint32_t idx = static_cast<uint32_t>(faces.size());
+    edges[edgeKey(_a, _b)] = idx;
+    edges[edgeKey(_b, _c)] = idx;
+    edges[edgeKey(_c, _a)] = idx;
+    faces.push_back(std::move(f));
+    return idx;
+  };
+
+  // Initial tetrahedron: the two points furthest apart along x, y or z,
+  // then the points furthest from the line and from the plane they span
+  uint32_t ext[6] = {0u, 0u, 0u, 0u, 0u, 0u};
+  for (uint32_t i = 0; i < pts.size(); ++i)
+  {
+    for (int a = 0; a < 3; ++a)
+    {
+      if (pts[i][a] < pts[ext[2 * a]][a])
+        ext[2 * a] = i;
+      if (pts[i][a] > pts[ext[2 * a + 1]][a])
+        ext[2 * a + 1] = i;
+    }
+  }
+  uint32_t i0 = ext[0];
+  uint32_t i1 = ext[1];
+  for (int a = 1; a < 3; ++a)
+  {
+    if (pts[ext[2 * a + 1]][a] - pts[ext[2 * a]][a] > pts[i1].Distance(pts[i0]))
+    {
+      i0 = ext[2 * a];
+      i1 = ext[2 * a + 1];
+    }
+  }
+  if (pts[i0].Distance(pts[i1]) <= eps)
+    return _points;
+
+  const math::Vector3d lineDir = (pts[i1] - pts[i0]).Normalized();
+  uint32_t i2 = i0;
+  double best = eps;
+  for (uint32_t i = 0; i < pts.size(); ++i)
+  {
+    const double d = (pts[i] - pts[i0]).Cross(lineDir).Length();
+    if (d > best)
+    {
+      best = d;
+      i2 = i;
+    }
+  }
+  if (i2 == i0)
+    return _points;
+
+  const math::Vector3d planeNormal =
+      (pts[i1] - pts[i0]).Cross(pts[i2] - pts[i0]).Normalized();
+  uint32_t i3 = i0;
+  best = eps;
+  for (uint32_t i = 0; i < pts.size(); ++i)
+  {
+    const double d = std::abs(planeNormal.Dot(pts[i] - pts[i0]));
+    if (d > best)
+    {
+      best = d;
+      i3 = i;
+    }
+  }
+  if (i3 == i0)
+    return _points;
+
+  // Orient the faces outwards
+  if (planeNormal.Dot(pts[i3] - pts[i0]) > 0.0)
+    std::swap(i1, i2);
+  addFace(i0, i1, i2);
+  addFace(i0, i3, i1);
+  addFace(i1, i3, i2);
+  addFace(i2, i3, i0);
+
+  // Assign every point to a face it is outside of
+  for (uint32_t i = 0; i < pts.size(); ++i)
+  {
+    for (Face &f : faces)
+    {
+      if (distance(f, i) > eps)
+      {
+        f.outside.push_back(i);
+        break;
+      }
+    }
+  }
+
+  std::vector<uint32_t> visible;
+  std::vector<std::pair<uint32_t, uint32_t>> horizon;
+  std::vector<uint32_t> orphans;
+  for (uint32_t faceIdx = 0; faceIdx < faces.size(); ++faceIdx)
+  {
+    if (!faces[faceIdx].alive || faces[faceIdx].outside.empty())
+      continue;
+
+    // Furthest point of the face is the next hull vertex
+    uint32_t eye = faces[faceIdx].outside[0];
+    double eyeDist = distance(faces[faceIdx], eye);
+    for (uint32_t p : faces[faceIdx].outside)
+    {
+      const double d = distance(faces[faceIdx], p);
+      if (d > eyeDist)
+      {
+        eyeDist = d;
+        eye = p;
+      }
+    }
+
+    // Flood the faces the eye can see and collect the horizon, the edges
+    // between visible and hidden faces
+    visible.clear();
+    horizon.clear();
+    faces[faceIdx].alive = false;
+    visible.push_back(faceIdx);
+    for (size_t v = 0; v < visible.size(); ++v)
+    {
+      const Face &f = faces[visible[v]];
+      for (int e = 0; e < 3; ++e)
+      {
+        const uint32_t a = f.v[e];
+        const uint32_t b = f.v[(e + 1) % 3];
+        auto it = edges.find(edgeKey(b, a));
+        if (it == edges.end())
+          continue;
+        Face &neighbor = faces[it->second];
+        if (!neighbor.alive)
+          continue;
+        if (distance(neighbor, eye) > eps)
+        {
+          neighbor.alive = false;
+          visible.push_back(it->second);
+        }
+        else
+        {
+          horizon.emplace_back(a, b);
+        }
+      }
+    }
+
+    orphans.clear();
+    for (uint32_t v : visible)
+    {
+      Face &f = faces[v];
+      for (int e = 0; e < 3; ++e)
+        edges.erase(edgeKey(f.v[e], f.v[(e + 1) % 3]));
+      for (uint32_t p : f.outside)
+      {
+        if (p != eye)
+          orphans.push_back(p);
+      }
+      f.outside.clear();
+      f.outside.shrink_to_fit();
+    }
+
+    // Cone from the horizon to the eye
+    const uint32_t firstNew = static_cast<uint32_t>(faces.size());
+    for (const auto &edge : horizon)
+      addFace(edge.first, edge.second, eye);
+
+    for (uint32_t p : orphans)
+    {
+      for (uint32_t f = firstNew; f < faces.size(); ++f)
+      {
+        if (distance(faces[f], p) > eps)
+        {
+          faces[f].outside.push_back(p);
+          break;
+        }
+      }
+    }
+  }
+
+  std::vector<bool> onHull(pts.size(), false);
+  for (const Face &f : faces)
+  {
+    if (!f.alive)
+      continue;
+    for (uint32_t v : f.v)
+      onHull[v] = true;
+  }
+
+  std::vector<Ogre::Vector3> hull;
+  for (uint32_t i = 0; i < pts.size(); ++i)
+  {
+    if (onHull[i])
+      hull.push_back(_points[i]);
+  }
+  return hull;
+}
+
+/// \brief Pixel extents of an object in the ogre ids buffer
+struct Ogre2BoundingBoxExtents
+{
+  /// \brief Label of the object
+  uint32_t label;
+
+  /// \brief Minimum x coordinate of the object's pixels
+  uint32_t minX;
+
+  /// \brief Minimum y coordinate of the object's pixels
+  uint32_t minY;
+
+  /// \brief Maximum x coordinate of the object's pixels
+  uint32_t maxX;
+
+  /// \brief Maximum y coordinate of the object's pixels
+  uint32_t maxY;
+};
+
+/// \brief Extents of the objects found in (part of) the ogre ids buffer.
+/// Objects are stored densely in order of first appearance, and looked up
+/// through a table indexed by their 16 bit ogre id
+struct Ogre2BoundingBoxScan
+{
+  /// \brief Value of slots for ogre ids that have not been found
+  static constexpr uint32_t kNoSlot = std::numeric_limits<uint32_t>::max();
+
+  /// \brief Index in extents of each ogre id, or kNoSlot
+  std::vector<uint32_t> slots =
+      std::vector<uint32_t>(std::numeric_limits<uint16_t>::max() + 1u,
+                            kNoSlot);
+
+  /// \brief Ogre ids of the objects found, in order of first appearance
+  std::vector<uint32_t> ogreIds;
+
+  /// \brief Extents of the objects found, matching ogreIds
+  std::vector<Ogre2BoundingBoxExtents> extents;
+
+  /// \brief Forget all the objects found, keeping the memory allocated
+  void Clear()
+  {
+    for (uint32_t ogreId : this->ogreIds)
+      this->slots[ogreId] = kNoSlot;
+    this->ogreIds.clear();
+    this->extents.clear();
+  }
+
+  /// \brief Grow the extents of an object, adding it if not found yet
+  /// \param[in] _ogreId Ogre id of the object
+  /// \param[in] _extents Extents to add
+  void Add(uint32_t _ogreId, const Ogre2BoundingBoxExtents &_extents)
+  {
+    uint32_t &slot = this->slots[_ogreId];
+    if (slot == kNoSlot)
+    {
+      slot = static_cast<uint32_t>(this->extents.size());
+      this->ogreIds.push_back(_ogreId);
+      this->extents.push_back(_extents);
+      return;
+    }
+
+    Ogre2BoundingBoxExtents &extents = this->extents[slot];
+    extents.minX = std::min(extents.minX, _extents.minX);
+    extents.minY = std::min(extents.minY, _extents.minY);
+    extents.maxX = std::max(extents.maxX, _extents.maxX);
+    extents.maxY = std::max(extents.maxY, _extents.maxY);
+  }
+};
+
+/// \brief Finds the extents of the objects in the ogre ids buffer. Each
+/// worker thread scans a band of rows into its own Ogre2BoundingBoxScan,
+/// which are merged afterwards.
+class GZ_RENDERING_OGRE2_HIDDEN Ogre2BoundingBoxScanTask final
+  : public Ogre::UniformScalableTask
+{
+  /// \brief Ogre ids buffer, 3 channels per pixel
+  private: const uint8_t *buffer;
+
+  /// \brief Width of the buffer in pixels
+  private: const uint32_t width;
+
+  /// \brief Height of the buffer in pixels
+  private: const uint32_t height;
+
+  /// \brief Label of the background pixels
+  private: const uint32_t backgroundLabel;
+
+  /// \brief Objects found by each thread
+  private: std::vector<Ogre2BoundingBoxScan> &threadScans;
+
+  /// \brief Constructor
+  /// \param[in] _buffer Ogre ids buffer, 3 channels per pixel
+  /// \param[in] _width Width of the buffer in pixels
+  /// \param[in] _height Height of the buffer in pixels
+  /// \param[in] _backgroundLabel Label of the background pixels
+  /// \param[in, out] _threadScans Objects found by each thread, must be
+  /// cleared and have one entry per worker thread
+  public: Ogre2BoundingBoxScanTask(const uint8_t *_buffer, uint32_t _width,
+              uint32_t _height, uint32_t _backgroundLabel,
+              std::vector<Ogre2BoundingBoxScan> &_threadScans) :
+      buffer(_buffer),
+      width(_width),
+      height(_height),
+      backgroundLabel(_backgroundLabel),
+      threadScans(_threadScans)
+  {
+  }
+
+  // Documentation inherited
+  public: void execute(size_t _threadId, size_t _numThreads) override;
+};
+
+/////////////////////////////////////////////////
+void Ogre2BoundingBoxScanTask::execute(size_t _threadId, size_t _numThreads)
+{
+  const uint32_t channelCount = 3u;
+  const uint32_t firstRow =
+      static_cast<uint32_t>(this->height * _threadId / _numThreads);
+  const uint32_t lastRow =
+      static_cast<uint32_t>(this->height * (_threadId + 1u) / _numThreads);
+  Ogre2BoundingBoxScan &scan = this->threadScans[_threadId];
+
+  for (uint32_t y = firstRow; y < lastRow; ++y)
+  {
+    const uint8_t *row = this->buffer + y * this->width * channelCount;
+    uint32_t x = 0u;
+    while (x < this->width)
+    {
+      // Objects cover runs of identical pixels, so every run only needs
+      // a single lookup
+      const uint8_t *pixel = row + x * channelCount;
+      uint32_t runEnd = x + 1u;
+      const uint8_t *next = pixel + channelCount;
+      while (runEnd < this->width && next[0] == pixel[0] &&
+             next[1] == pixel[1] && next[2] == pixel[2])
+      {
+        ++runEnd;
+        next += channelCount;
+      }
+
+      const uint32_t label = pixel[2];
+      if (label != this->backgroundLabel)
+      {
+        // get the ogre id encoded in 16 bit value
+        const uint32_t ogreId = pixel[1] * 256u + pixel[0];
+        scan.Add(ogreId, {label, x, y, runEnd - 1u, y});
+      }
+      x = runEnd;
+    }
+  }
+}
+
 class gz::rendering::Ogre2BoundingBoxCameraPrivate
 {
   /// \brief Merge a vector of 2D boxes. Used in multi-links model.
@@ -65,6 +470,38 @@ class gz::rendering::Ogre2BoundingBoxCameraPrivate
   public: void MeshVertices(const std::vector<uint32_t> &_ogreIds,
               std::vector<math::Vector3d> &_vertices);
 
+  /// \brief Get the unique vertex positions of a mesh in its local space.
+  /// Positions are read from the vertex buffers of the first LOD the first
+  /// time a mesh is seen and cached afterwards, unless its buffers are
+  /// dynamic.
+  /// \param[in] _mesh Mesh to get the vertices of
+  /// \return Vertex positions in mesh local space
+  public: const std::vector<Ogre::Vector3> &LocalMeshPoints(
+              const Ogre::MeshPtr &_mesh);
+
+  /// \brief Get the vertices of the convex hull of a mesh in its local
+  /// space. They are enough to find the extents of the mesh under any
+  /// projection, and are computed once along with the cached points.
+  /// Meshes with dynamic buffers return all of their points instead.
+  /// \param[in] _mesh Mesh to get the hull of
+  /// \return Hull vertex positions in mesh local space
+  public: const std::vector<Ogre::Vector3> &LocalMeshHull(
+              const Ogre::MeshPtr &_mesh);
+
+  /// \brief Find the extents of the objects in the ogre ids buffer and
+  /// store them in the scan member variable. The work is spread over
+  /// the worker threads of the scene manager.
+  /// \param[in] _sceneManager Scene manager owning the worker threads
+  /// \param[in] _width Width of the buffer in pixels
+  /// \param[in] _height Height of the buffer in pixels
+  public: void ScanBuffer(Ogre::SceneManager *_sceneManager,
+              uint32_t _width, uint32_t _height);
+
+  /// \brief Drop the cached vertices of meshes that no longer exist
+  /// \param[in] _revision Current Ogre2Scene::VisualsRevision. Nothing is
+  /// done if the visuals have not changed since the last call
+  public: void PruneMeshPoints(uint64_t _revision);
+
   /// \brief Add a line to the viewport. If the line's endpoints are not inside
   /// the viewport, the added line will be a clipped line that fits in the
   /// viewport. If the line to be added doesn't intersect the viewport at all,
@@ -161,9 +598,44 @@ class gz::rendering::Ogre2BoundingBoxCameraPrivate
   /// Key: ogre id, value: ogre item pointer
   public: std::map<uint32_t, Ogre::Item *> ogreIdToItem;
 
+  /// \brief Local space vertices of a mesh read from its vertex buffers
+  public: struct MeshPoints
+  {
+    /// \brief Vertex arrays the points were read from. Used to detect
+    /// meshes whose buffers have been recreated
+    std::vector<const Ogre::VertexArrayObject *> vaos;
+
+    /// \brief Unique vertex positions
+    std::vector<Ogre::Vector3> points;
+
+    /// \brief Vertices of the convex hull of points
+    std::vector<Ogre::Vector3> hull;
+
+    /// \brief True once hull has been computed from points
+    bool hullValid = false;
+
+    /// \brief True if any of the vertex buffers is dynamic, in which case
+    /// the points are read again every time
+    bool dynamic = false;
+  };
+
+  /// \brief Cached local space vertices of the meshes seen so far
+  /// Key: Ogre mesh name, value: its vertices
+  public: std::unordered_map<std::string, MeshPoints> meshPoints;
+
+  /// \brief Value of Ogre2Scene::VisualsRevision when meshPoints was last
+  /// pruned
+  public: uint64_t meshPointsRevision = 0u;
+
   /// \brief Output bounding boxes to notify listeners
   public: std::vector<BoundingBox> outputBoxes;
 
+  /// \brief Objects found in the ogre ids buffer by the last ScanBuffer
+  public: Ogre2BoundingBoxScan scan;
+
+  /// \brief Objects found by each worker thread in ScanBuffer
+  public: std::vector<Ogre2BoundingBoxScan> threadScans;
+
   /// \brief Bounding Box type
   public: BoundingBoxType type {BoundingBoxType::BBT_VISIBLEBOX2D};
 
@@ -634,6 +1106,7 @@ void Ogre2BoundingBoxCamera::PostRender()
   this->dataPtr->itemVertices.clear();
   this->dataPtr->ogreIdToItem.clear();
   this->dataPtr->materialSwitcher->ogreIdName.clear();
+  this->dataPtr->PruneMeshPoints(this->scene->VisualsRevision());
 
   this->dataPtr->newBoundingBoxes(this->dataPtr->outputBoxes);
 }
@@ -647,31 +1120,36 @@ void Ogre2BoundingBoxCamera::MarkVisibleBoxes()
     return;
   }
 
-  uint32_t width = this->ImageWidth();
-  uint32_t height = this->ImageHeight();
-  uint32_t channelCount = 3;
+  // Filter bounding boxes by finding the ogre ids present in the buffer
+  this->dataPtr->ScanBuffer(this->scene->OgreSceneManager(),
+      this->ImageWidth(), this->ImageHeight());
 
-  // Filter bounding boxes by looping over all pixels in ogre ids map
-  for (uint32_t y = 0; y < height; ++y)
-  {
-    for (uint32_t x = 0; x < width; ++x)
-    {
-      auto index = (y * width + x) * channelCount;
+  // mark the ogreIds as visible not to filter their bbox
+  const Ogre2BoundingBoxScan &scan = this->dataPtr->scan;
+  for (size_t i = 0; i < scan.ogreIds.size(); ++i)
+    this->dataPtr->visibleBoxesLabel[scan.ogreIds[i]] = scan.extents[i].label;
+}
 
-      uint32_t label = this->dataPtr->buffer[index + 2];
+/////////////////////////////////////////////////
+void Ogre2BoundingBoxCameraPrivate::ScanBuffer(
+    Ogre::SceneManager *_sceneManager, uint32_t _width, uint32_t _height)
+{
+  this->scan.Clear();
 
-      if (label == this->dataPtr->materialSwitcher->backgroundLabel)
-        continue;
+  const size_t numThreads = _sceneManager->getNumWorkerThreads();
+  this->threadScans.resize(numThreads);
 
-      // get the ogre id encoded in 16 bit value
-      uint32_t ogreId1 = this->dataPtr->buffer[index + 1];
-      uint32_t ogreId2 = this->dataPtr->buffer[index + 0];
-      uint32_t ogreId = ogreId1 * 256 + ogreId2;
+  Ogre2BoundingBoxScanTask task(this->buffer, _width, _height,
+      this->materialSwitcher->backgroundLabel, this->threadScans);
+  _sceneManager->executeUserScalableTask(&task, true);
 
-      // mark the ogreId as visible not to filter its bbox
-      if (!this->dataPtr->visibleBoxesLabel.count(ogreId))
-        this->dataPtr->visibleBoxesLabel[ogreId] = label;
-    }
+  // Threads scan bands of rows from top to bottom, so merging them in order
+  // keeps the objects in the order they appear in the buffer
+  for (Ogre2BoundingBoxScan &threadScan : this->threadScans)
+  {
+    for (size_t i = 0; i < threadScan.ogreIds.size(); ++i)
+      this->scan.Add(threadScan.ogreIds[i], threadScan.extents[i]);
+    threadScan.Clear();
   }
 }
 
@@ -685,76 +1163,167 @@ void Ogre2BoundingBoxCameraPrivate::MeshVertices(
   for (auto ogreId : _ogreIds)
   {
     Ogre::Item *item = this->ogreIdToItem[ogreId];
-    Ogre::MeshPtr mesh = item->getMesh();
     Ogre::Node *node = item->getParentNode();
 
-    Ogre::Vector3 position = node->_getDerivedPosition();
-    Ogre::Quaternion oreintation = node->_getDerivedOrientation();
-    Ogre::Vector3 scale = node->_getDerivedScale();
+    // Local to camera view coordinates
+    Ogre::Matrix4 worldMatrix;
+    worldMatrix.makeTransform(node->_getDerivedPosition(),
+        node->_getDerivedScale(), node->_getDerivedOrientation());
+    const Ogre::Matrix4 transform = viewMatrix * worldMatrix;
+
+    const auto &points = this->LocalMeshPoints(item->getMesh());
+    _vertices.reserve(_vertices.size() + points.size());
+    for (const Ogre::Vector3 &point : points)
+    {
+      Ogre::Vector4 vec4 =
+          transform * Ogre::Vector4(point.x, point.y, point.z, 1);
+
+      // Add the vertex to the vertices of all items that
+      // belongs to the same parent
+      _vertices.push_back(math::Vector3d(vec4.x, vec4.y, vec4.z));
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+const std::vector<Ogre::Vector3> &
+Ogre2BoundingBoxCameraPrivate::LocalMeshPoints(const Ogre::MeshPtr &_mesh)
+{
+  MeshPoints &entry = this->meshPoints[_mesh->getName()];
+  const auto &subMeshes = _mesh->getSubMeshes();
+
+  // Reuse the cached points if they were read from the current buffers
+  bool valid = !entry.dynamic && entry.vaos.size() == subMeshes.size();
+  for (size_t i = 0; valid && i < subMeshes.size(); ++i)
+  {
+    const Ogre::VertexArrayObjectArray &vaos = subMeshes[i]->mVao[0];
+    valid = entry.vaos[i] == (vaos.empty() ? nullptr : vaos[0]);
+  }
+  if (valid)
+    return entry.points;
+
+  entry.vaos.clear();
+  entry.points.clear();
+  entry.hull.clear();
+  entry.hullValid = false;
+  entry.dynamic = false;
 
-    auto subMeshes = mesh->getSubMeshes();
+  for (const auto &subMesh : subMeshes)
+  {
+    Ogre::VertexArrayObjectArray vaos = subMesh->mVao[0];
+    if (vaos.empty())
+    {
+      entry.vaos.push_back(nullptr);
+      continue;
+    }
+
+    // Get the first LOD level
+    Ogre::VertexArrayObject *vao = vaos[0];
+    entry.vaos.push_back(vao);
 
-    for (const auto &subMesh : subMeshes)
+    for (const Ogre::VertexBufferPacked *vertexBuffer :
+        vao->getVertexBuffers())
     {
-      Ogre::VertexArrayObjectArray vaos = subMesh->mVao[0];
+      if (vertexBuffer->getBufferType() >= Ogre::BT_DYNAMIC_DEFAULT)
+        entry.dynamic = true;
+    }
+
+    // request async read from buffer
+    Ogre::VertexArrayObject::ReadRequestsArray requests;
+    requests.push_back(Ogre::VertexArrayObject::ReadRequests(
+      Ogre::VES_POSITION));
+    vao->readRequests(requests);
+    vao->mapAsyncTickets(requests);
 
-      if (!vaos.empty())
+    if (requests[0].type != Ogre::VET_HALF4 &&
+        requests[0].type != Ogre::VET_FLOAT3)
+    {
+      gzerr << "Vertex Buffer type error" << std::endl;
+      vao->unmapAsyncTickets(requests);
+      continue;
+    }
+
+    size_t subMeshVerticiesNum = requests[0].vertexBuffer->getNumElements();
+    size_t bytesPerElement = requests[0].vertexBuffer->getBytesPerElement();
+    entry.points.reserve(entry.points.size() + subMeshVerticiesNum);
+    for (size_t i = 0; i < subMeshVerticiesNum; ++i)
+    {
+      Ogre::Vector3 vec;
+      if (requests[0].type == Ogre::VET_HALF4)
       {
-        // Get the first LOD level
-        Ogre::VertexArrayObject *vao = vaos[0];
-
-        // request async read from buffer
-        Ogre::VertexArrayObject::ReadRequestsArray requests;
-        requests.push_back(Ogre::VertexArrayObject::ReadRequests(
-          Ogre::VES_POSITION));
-        vao->readRequests(requests);
-        vao->mapAsyncTickets(requests);
-
-        unsigned int subMeshVerticiesNum =
-          requests[0].vertexBuffer->getNumElements();
-        for (size_t i = 0; i < subMeshVerticiesNum; ++i)
-        {
-          Ogre::Vector3 vec;
-          if (requests[0].type == Ogre::VET_HALF4)
-          {
-            const Ogre::uint16* vertex = reinterpret_cast<const Ogre::uint16*>
-              (requests[0].data);
-            vec.x = Ogre::Bitwise::halfToFloat(vertex[0]);
-            vec.y = Ogre::Bitwise::halfToFloat(vertex[1]);
-            vec.z = Ogre::Bitwise::halfToFloat(vertex[2]);
-          }
-          else if (requests[0].type == Ogre::VET_FLOAT3)
-          {
-            const float* vertex =
-              reinterpret_cast<const float*>(requests[0].data);
-            vec.x = *vertex++;
-            vec.y = *vertex++;
-            vec.z = *vertex++;
-          }
-          else
-            gzerr << "Vertex Buffer type error" << std::endl;
-
-          // Convert to world coordinates
-          vec = (oreintation * (vec * scale)) + position;
-
-          // Convert to camera view coordiantes
-          Ogre::Vector4 vec4(vec.x, vec.y, vec.z, 1);
-          vec4 = viewMatrix * vec4;
-
-          vec.x = vec4.x;
-          vec.y = vec4.y;
-          vec.z = vec4.z;
-
-          // Add the vertex to the vertices of all items that
-          // belongs to the same parent
-          _vertices.push_back(Ogre2Conversions::Convert(vec));
-
-          // get the next element
-          requests[0].data += requests[0].vertexBuffer->getBytesPerElement();
-        }
-        vao->unmapAsyncTickets(requests);
+        const Ogre::uint16* vertex = reinterpret_cast<const Ogre::uint16*>
+          (requests[0].data);
+        vec.x = Ogre::Bitwise::halfToFloat(vertex[0]);
+        vec.y = Ogre::Bitwise::halfToFloat(vertex[1]);
+        vec.z = Ogre::Bitwise::halfToFloat(vertex[2]);
       }
+      else
+      {
+        const float* vertex =
+          reinterpret_cast<const float*>(requests[0].data);
+        vec.x = vertex[0];
+        vec.y = vertex[1];
+        vec.z = vertex[2];
+      }
+      entry.points.push_back(vec);
+
+      // get the next element
+      requests[0].data += bytesPerElement;
     }
+    vao->unmapAsyncTickets(requests);
+  }
+
+  // Vertices are usually duplicated for each normal / uv they are used
+  // with. Only their positions matter here.
+  auto lexicographic = [](const Ogre::Vector3 &_a, const Ogre::Vector3 &_b)
+  {
+    return std::tie(_a.x, _a.y, _a.z) < std::tie(_b.x, _b.y, _b.z);
+  };
+  std::sort(entry.points.begin(), entry.points.end(), lexicographic);
+  entry.points.erase(
+      std::unique(entry.points.begin(), entry.points.end()),
+      entry.points.end());
+  entry.points.shrink_to_fit();
+
+  return entry.points;
+}
+
+/////////////////////////////////////////////////
+const std::vector<Ogre::Vector3> &
+Ogre2BoundingBoxCameraPrivate::LocalMeshHull(const Ogre::MeshPtr &_mesh)
+{
+  const std::vector<Ogre::Vector3> &points = this->LocalMeshPoints(_mesh);
+  MeshPoints &entry = this->meshPoints[_mesh->getName()];
+
+  // Dynamic meshes are read again every frame, don't pay for a hull that
+  // would be thrown away
+  if (entry.dynamic)
+    return points;
+
+  if (!entry.hullValid)
+  {
+    entry.hull = ConvexHullVertices(points);
+    entry.hull.shrink_to_fit();
+    entry.hullValid = true;
+  }
+  return entry.hull;
+}
+
+/////////////////////////////////////////////////
+void Ogre2BoundingBoxCameraPrivate::PruneMeshPoints(uint64_t _revision)
+{
+  // Meshes can only be removed along with the visuals using them
+  if (this->meshPointsRevision == _revision)
+    return;
+  this->meshPointsRevision = _revision;
+
+  auto &meshManager = Ogre::MeshManager::getSingleton();
+  for (auto it = this->meshPoints.begin(); it != this->meshPoints.end();)
+  {
+    if (!meshManager.resourceExists(it->first))
+      it = this->meshPoints.erase(it);
+    else
+      ++it;
   }
 }
 
@@ -962,79 +1531,25 @@ void Ogre2BoundingBoxCamera::VisibleBoundingBoxes()
     return;
   }
 
-  uint32_t width = this->ImageWidth();
-  uint32_t height = this->ImageHeight();
-  uint32_t channelCount = 3;
-
-  struct BoxBoundary
-  {
-    uint32_t minX;
-    uint32_t minY;
-    uint32_t maxX;
-    uint32_t maxY;
-  };
-
-  std::unordered_map<uint32_t, std::shared_ptr<BoxBoundary>> boxesBoundary;
-
   // find item's boundaries from panoptic BoundingBox
-  for (uint32_t y = 0; y < height; y++)
-  {
-    for (uint32_t x = 0; x < width; x++)
-    {
-      auto index = (y * width + x) * channelCount;
-
-      uint32_t label = this->dataPtr->buffer[index + 2];
-      uint32_t ogreId1 = this->dataPtr->buffer[index + 1];
-      uint32_t ogreId2 = this->dataPtr->buffer[index + 0];
-
-      if (label != this->dataPtr->materialSwitcher->backgroundLabel)
-      {
-        // get the OGRE id of 16 bit value
-        uint32_t ogreId = ogreId1 * 256 + ogreId2;
-
-        std::shared_ptr<BoundingBox> box;
-        std::shared_ptr<BoxBoundary> boundary;
-
-        // create new boxes when its first pixel appears
-        if (!this->dataPtr->boundingboxes.count(ogreId))
-        {
-          box = std::make_shared<BoundingBox>();
-          box->SetLabel(label);
-
-          boundary = std::make_shared<BoxBoundary>();
-          boundary->minX = width;
-          boundary->minY = height;
-          boundary->maxX = 0;
-          boundary->maxY = 0;
-
-          boxesBoundary[ogreId] = boundary;
-          this->dataPtr->boundingboxes[ogreId] = box;
-        }
-        else
-        {
-          boundary = boxesBoundary[ogreId];
-        }
-
-        boundary->minX = std::min<uint32_t>(boundary->minX, x);
-        boundary->minY = std::min<uint32_t>(boundary->minY, y);
-        boundary->maxX = std::max<uint32_t>(boundary->maxX, x);
-        boundary->maxY = std::max<uint32_t>(boundary->maxY, y);
-      }
-    }
-  }
+  this->dataPtr->ScanBuffer(this->scene->OgreSceneManager(),
+      this->ImageWidth(), this->ImageHeight());
 
-  for (const auto &box : this->dataPtr->boundingboxes)
+  const Ogre2BoundingBoxScan &scan = this->dataPtr->scan;
+  for (size_t i = 0; i < scan.ogreIds.size(); ++i)
   {
     // Get the box's boundary
-    auto ogreId = box.first;
-    auto boundary = boxesBoundary[ogreId];
-    auto boxWidth = boundary->maxX - boundary->minX;
-    auto boxHeight = boundary->maxY - boundary->minY;
+    const Ogre2BoundingBoxExtents &boundary = scan.extents[i];
+    auto boxWidth = boundary.maxX - boundary.minX;
+    auto boxHeight = boundary.maxY - boundary.minY;
 
-    box.second->SetCenter({boundary->minX + boxWidth * 0.5,
-        boundary->minY + boxHeight * 0.5, 0});
-    box.second->SetSize(
+    auto box = std::make_shared<BoundingBox>();
+    box->SetLabel(boundary.label);
+    box->SetCenter({boundary.minX + boxWidth * 0.5,
+        boundary.minY + boxHeight * 0.5, 0});
+    box->SetSize(
         {static_cast<double>(boxWidth), static_cast<double>(boxHeight), 0.0});
+    this->dataPtr->boundingboxes[scan.ogreIds[i]] = box;
   }
 
   // Combine boxes of multi-links model if exists
@@ -1153,71 +1668,28 @@ void Ogre2BoundingBoxCamera::MeshMinimalBox(
   _maxVertex.y = -std::numeric_limits<float>::max();
   _maxVertex.z = -std::numeric_limits<float>::max();
 
-  auto subMeshes = _mesh->getSubMeshes();
+  // Local to clip space
+  Ogre::Matrix4 worldMatrix;
+  worldMatrix.makeTransform(_position, _scale, _orientation);
+  const Ogre::Matrix4 transform = _projMatrix * _viewMatrix * worldMatrix;
 
-  for (auto subMesh : subMeshes)
+  // The projected extents of a mesh are reached at vertices of its convex
+  // hull, so only those need to be transformed
+  for (const Ogre::Vector3 &point : this->dataPtr->LocalMeshHull(_mesh))
   {
-    Ogre::VertexArrayObjectArray vaos = subMesh->mVao[0];
+    Ogre::Vector4 vec4 =
+        transform * Ogre::Vector4(point.x, point.y, point.z, 1);
 
-    if (!vaos.empty())
-    {
-      // Get the first LOD level
-      Ogre::VertexArrayObject *vao = vaos[0];
-
-      // request async read from buffer
-      Ogre::VertexArrayObject::ReadRequestsArray requests;
-      requests.push_back(Ogre::VertexArrayObject::ReadRequests(
-        Ogre::VES_POSITION));
-      vao->readRequests(requests);
-      vao->mapAsyncTickets(requests);
-
-      unsigned int subMeshVerticiesNum =
-        requests[0].vertexBuffer->getNumElements();
-      for (size_t i = 0; i < subMeshVerticiesNum; ++i)
-      {
-        Ogre::Vector3 vec;
-        if (requests[0].type == Ogre::VET_HALF4)
-        {
-          const Ogre::uint16* vertex = reinterpret_cast<const Ogre::uint16*>
-            (requests[0].data);
-          vec.x = Ogre::Bitwise::halfToFloat(vertex[0]);
-          vec.y = Ogre::Bitwise::halfToFloat(vertex[1]);
-          vec.z = Ogre::Bitwise::halfToFloat(vertex[2]);
-        }
-        else if (requests[0].type == Ogre::VET_FLOAT3)
-        {
-          const float* vertex =
-            reinterpret_cast<const float*>(requests[0].data);
-          vec.x = *vertex++;
-          vec.y = *vertex++;
-          vec.z = *vertex++;
-        }
-        else
-          gzerr << "Vertex Buffer type error" << std::endl;
+    // homogenous
+    Ogre::Vector3 vec(vec4.x / vec4.w, vec4.y / vec4.w, vec4.z);
 
-        vec = (_orientation * (vec * _scale)) + _position;
+    _minVertex.x = std::min(_minVertex.x, vec.x);
+    _minVertex.y = std::min(_minVertex.y, vec.y);
+    _minVertex.z = std::min(_minVertex.z, vec.z);
 
-        Ogre::Vector4 vec4(vec.x, vec.y, vec.z, 1);
-        vec4 =  _projMatrix * _viewMatrix * vec4;
-
-        // homogenous
-        vec.x = vec4.x / vec4.w;
-        vec.y = vec4.y / vec4.w;
-        vec.z = vec4.z;
-
-        _minVertex.x = std::min(_minVertex.x, vec.x);
-        _minVertex.y = std::min(_minVertex.y, vec.y);
-        _minVertex.z = std::min(_minVertex.z, vec.z);
-
-        _maxVertex.x = std::max(_maxVertex.x, vec.x);
-        _maxVertex.y = std::max(_maxVertex.y, vec.y);
-        _maxVertex.z = std::max(_maxVertex.z, vec.z);
-
-        // get the next element
-        requests[0].data += requests[0].vertexBuffer->getBytesPerElement();
-      }
-      vao->unmapAsyncTickets(requests);
-    }
+    _maxVertex.x = std::max(_maxVertex.x, vec.x);
+    _maxVertex.y = std::max(_maxVertex.y, vec.y);
+    _maxVertex.z = std::max(_maxVertex.z, vec.z);
   }
 }
 
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#include <gz/common/Filesystem.hh>
+
+#include "Ogre2CacheFile.hh"
+
+namespace gz
+{
+namespace rendering
+{
+inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+//
+//////////////////////////////////////////////////
+void Ogre2CacheHash::Update(const void *_data, std::size_t _size)
+{
+  const unsigned char *bytes = static_cast<const unsigned char *>(_data);
+  for (std::size_t i = 0u; i < _size; ++i)
+  {
+    this->value ^= bytes[i];
+    this->value *= 1099511628211ull;
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2CacheHash::Update(const std::string &_str)
+{
+  this->Update(_str.data(), _str.size());
+}
+
+//////////////////////////////////////////////////
+uint64_t Ogre2CacheHash::Value() const
+{
+  return this->value;
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2CacheHash::Hex() const
+{
+  std::ostringstream str;
+  str << std::hex << std::setw(16) << std::setfill('0') << this->value;
+  return str.str();
+}
+
+//////////////////////////////////////////////////
+bool Ogre2WriteCacheFile(const std::string &_path,
+    const std::function<bool(std::fstream &)> &_write)
+{
+  const std::string tmpPath = _path + "." + std::to_string(
+      std::chrono::steady_clock::now().time_since_epoch().count()) + "." +
+      std::to_string(std::hash<std::thread::id>()(
+      std::this_thread::get_id())) + ".tmp";
+  {
+    std::fstream file(tmpPath, std::ios::out | std::ios::binary);
+    if (!file.is_open())
+      return false;
+
+    if (!_write(file) || !file)
+    {
+      file.close();
+      common::removeFile(tmpPath);
+      return false;
+    }
+  }
+
+  if (!common::moveFile(tmpPath, _path))
+  {
+    common::removeFile(tmpPath);
+    return false;
+  }
+  return true;
+}
+}
+}
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_OGRE2_OGRE2CACHEFILE_HH_
+#define GZ_RENDERING_OGRE2_OGRE2CACHEFILE_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+
+#include "gz/rendering/config.hh"
+
+namespace gz
+{
+  namespace rendering
+  {
+    inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief 64 bit FNV-1a hash, used to name the files of the shader and
+    /// mesh caches. It is not collision free, so cache files also store
+    /// the full description of their contents.
+    class Ogre2CacheHash
+    {
+      /// \brief Add bytes to the hash
+      /// \param[in] _data Bytes to add
+      /// \param[in] _size Number of bytes
+      public: void Update(const void *_data, std::size_t _size);
+
+      /// \brief Add the characters of a string to the hash
+      /// \param[in] _str String to add
+      public: void Update(const std::string &_str);
+
+      /// \brief Get the hash of all the bytes added so far
+      /// \return Hash value
+      public: uint64_t Value() const;
+
+      /// \brief Get the hash as a file name friendly string
+      /// \return 16 lowercase hexadecimal digits
+      public: std::string Hex() const;
+
+      /// \brief Current hash value
+      private: uint64_t value = 14695981039346656037ull;
+    };
+
+    /// \brief Write a cache file. Data is written to a temporary file that
+    /// then replaces the destination, so that processes sharing the cache
+    /// never read a partially written file. The temporary file name is
+    /// unique per thread, so the same file can be written concurrently.
+    /// \param[in] _path Path to the file. Its folder must exist.
+    /// \param[in] _write Function writing the data to the given stream,
+    /// returning false on failure
+    /// \return True on success
+    bool Ogre2WriteCacheFile(const std::string &_path,
+        const std::function<bool(std::fstream &)> &_write);
+    }
+  }
+}
+
+#endif
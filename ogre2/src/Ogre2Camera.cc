@@ -215,6 +215,7 @@ void Ogre2Camera::CreateRenderTexture()
   this->renderTexture->SetHeight(this->ImageHeight());
   this->renderTexture->SetBackgroundColor(this->scene->BackgroundColor());
   this->renderTexture->SetVisibilityMask(this->visibilityMask);
+  this->renderTexture->SetReadbackLatency(this->readbackLatency);
 }
 
 //////////////////////////////////////////////////
@@ -429,6 +430,14 @@ void Ogre2Camera::SetVisibilityMask(uint32_t _mask)
     this->renderTexture->SetVisibilityMask(_mask);
 }
 
+//////////////////////////////////////////////////
+void Ogre2Camera::SetReadbackLatency(unsigned int _latency)
+{
+  BaseSensor::SetReadbackLatency(_latency);
+  if (this->renderTexture)
+    this->renderTexture->SetReadbackLatency(_latency);
+}
+
 //////////////////////////////////////////////////
 Ogre::Camera *Ogre2Camera::OgreCamera() const
 {
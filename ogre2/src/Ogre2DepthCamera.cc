@@ -38,6 +38,7 @@
 #include "gz/rendering/ogre2/Ogre2Scene.hh"
 #include "gz/rendering/ogre2/Ogre2Sensor.hh"
 
+#include "Ogre2AsyncReadback.hh"
 #include "Ogre2ParticleNoiseListener.hh"
 
 #ifdef _MSC_VER
@@ -91,14 +92,28 @@ class Ogre2DepthGaussianNoisePass : public Ogre2GaussianNoisePass
 /// \brief Private data for the Ogre2DepthCamera class
 class gz::rendering::Ogre2DepthCameraPrivate
 {
-  /// \brief The depth buffer
+  /// \brief Copy of the depth texture, used when the downloaded data
+  /// can't be handed out directly
   public: float *depthBuffer = nullptr;
 
+  /// \brief Latest depth data returned by DepthData(). Each pixel holds the
+  /// xyz position and packed rgb color output by the compositor, so this is
+  /// also the outgoing point cloud data used by the newRgbPointCloud event.
+  /// Points into depthImageData when it holds a tightly packed copy of the
+  /// depth texture, and into depthBuffer otherwise.
+  public: const float *depthData = nullptr;
+
+  /// \brief Image the depth texture is downloaded to when the readback
+  /// latency is 0. Kept between frames so that its data can be handed to
+  /// listeners without another copy.
+  public: Ogre::Image2 depthImageData;
+
   /// \brief Outgoing depth data, used by newDepthFrame event.
   public: float *depthImage = nullptr;
 
-  /// \brief Outgoing point cloud data, used by newRgbPointCloud event.
-  public: float *pointCloudImage = nullptr;
+  /// \brief Asynchronous readback of the depth texture, used when the
+  /// sensor readback latency is greater than 0
+  public: Ogre2AsyncReadback readback;
 
   /// \brief maximum value used for data outside sensor range
   public: float dataMaxVal = gz::math::INF_D;
@@ -308,6 +323,8 @@ void Ogre2DepthCamera::Destroy()
     delete [] this->dataPtr->depthBuffer;
     this->dataPtr->depthBuffer = nullptr;
   }
+  this->dataPtr->depthImageData.freeMemory();
+  this->dataPtr->depthData = nullptr;
 
   if (this->dataPtr->depthImage)
   {
@@ -315,15 +332,11 @@ void Ogre2DepthCamera::Destroy()
     this->dataPtr->depthImage = nullptr;
   }
 
-  if (this->dataPtr->pointCloudImage)
-  {
-    delete [] this->dataPtr->pointCloudImage;
-    this->dataPtr->pointCloudImage = nullptr;
-  }
-
   if (!this->ogreCamera)
     return;
 
+  this->dataPtr->readback.Reset();
+
   auto engine = Ogre2RenderEngine::Instance();
   auto ogreRoot = engine->OgreRoot();
   Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
@@ -1158,54 +1171,86 @@ void Ogre2DepthCamera::PostRender()
   unsigned int channelCount = PixelUtil::ChannelCount(format);
   unsigned int bytesPerChannel = PixelUtil::BytesPerChannel(format);
 
-  Ogre::Image2 image;
-  image.convertFromTexture(this->dataPtr->ogreDepthTexture[1], 0u, 0u);
-  Ogre::TextureBox box = image.getData(0);
-  float *depthBufferTmp = static_cast<float *>(box.data);
-  if (!this->dataPtr->depthBuffer)
+  Ogre::TextureBox box;
+  Ogre2AsyncReadback &readback = this->dataPtr->readback;
+  readback.SetLatency(this->ReadbackLatency());
+  if (readback.Latency() > 0u)
   {
-    this->dataPtr->depthBuffer = new float[len * channelCount];
+    readback.Download(this->dataPtr->ogreDepthTexture[1]);
+    if (!readback.FrameReady())
+      return;
+    box = readback.MapFrame();
   }
-
-  // copy data row by row. The texture box may not be a contiguous region of
-  // a texture
-  for (unsigned int i = 0; i < height; ++i)
+  else
   {
-    unsigned int rawDataRowIdx = i * box.bytesPerRow / bytesPerChannel;
-    unsigned int rowIdx = i * width * channelCount;
-    memcpy(&this->dataPtr->depthBuffer[rowIdx], &depthBufferTmp[rawDataRowIdx],
-        width * channelCount * bytesPerChannel);
+    this->dataPtr->depthImageData.convertFromTexture(
+        this->dataPtr->ogreDepthTexture[1], 0u, 0u);
+    box = this->dataPtr->depthImageData.getData(0);
   }
+  float *depthBufferTmp = static_cast<float *>(box.data);
 
-  if (!this->dataPtr->depthImage)
+  // The downloaded image is already a copy of the texture owned by this
+  // camera. When it is tightly packed it is used as is, otherwise the data
+  // is copied row by row since the box may not be a contiguous region of a
+  // texture. Mapped readback frames are recycled, so they are always
+  // copied.
+  const size_t rowSize = width * channelCount * bytesPerChannel;
+  if (readback.Latency() == 0u && box.bytesPerRow == rowSize)
   {
-    this->dataPtr->depthImage = new float[len];
+    this->dataPtr->depthData = depthBufferTmp;
   }
-  if (!this->dataPtr->pointCloudImage)
+  else
   {
-    this->dataPtr->pointCloudImage = new float[len * channelCount];
+    if (!this->dataPtr->depthBuffer)
+    {
+      this->dataPtr->depthBuffer = new float[len * channelCount];
+    }
+
+    if (box.bytesPerRow == rowSize)
+    {
+      memcpy(this->dataPtr->depthBuffer, depthBufferTmp, rowSize * height);
+    }
+    else
+    {
+      for (unsigned int i = 0; i < height; ++i)
+      {
+        unsigned int rawDataRowIdx = i * box.bytesPerRow / bytesPerChannel;
+        unsigned int rowIdx = i * width * channelCount;
+        memcpy(&this->dataPtr->depthBuffer[rowIdx],
+            &depthBufferTmp[rawDataRowIdx], rowSize);
+      }
+    }
+    this->dataPtr->depthData = this->dataPtr->depthBuffer;
   }
 
-  // fill depth data
-  for (unsigned int i = 0; i < height; ++i)
+  if (readback.Latency() > 0u)
+    readback.UnmapFrame();
+
+  // fill depth data. Only needed if someone is listening, DepthData()
+  // returns the full buffer
+  if (this->dataPtr->newDepthFrame.ConnectionCount() > 0u)
   {
-    unsigned int step = i*width*channelCount;
-    for (unsigned int j = 0; j < width; ++j)
+    if (!this->dataPtr->depthImage)
+    {
+      this->dataPtr->depthImage = new float[len];
+    }
+
+    const float *src = this->dataPtr->depthData;
+    float *dst = this->dataPtr->depthImage;
+    for (int i = 0; i < len; ++i)
     {
-      float x = this->dataPtr->depthBuffer[step + j*channelCount];
-      this->dataPtr->depthImage[i*width + j] = x;
+      dst[i] = src[i * channelCount];
     }
+    this->dataPtr->newDepthFrame(
+          this->dataPtr->depthImage, width, height, 1, "FLOAT32");
   }
-  this->dataPtr->newDepthFrame(
-        this->dataPtr->depthImage, width, height, 1, "FLOAT32");
 
-  // point cloud data
+  // point cloud data. The depth data already holds packed xyz + rgb
+  // values so it is handed to listeners as is
   if (this->dataPtr->newRgbPointCloud.ConnectionCount() > 0u)
   {
-    memcpy(this->dataPtr->pointCloudImage,
-      this->dataPtr->depthBuffer, len * channelCount * sizeof(float));
     this->dataPtr->newRgbPointCloud(
-        this->dataPtr->pointCloudImage, width, height, channelCount,
+        this->dataPtr->depthData, width, height, channelCount,
         "PF_FLOAT32_RGBA");
 
     // Uncomment to debug color output
@@ -1215,7 +1260,7 @@ void Ogre2DepthCamera::PostRender()
     //   for (unsigned int j = 0; j < width; ++j)
     //   {
     //     float color =
-    //         this->dataPtr->pointCloudImage[step + j*channelCount + 3];
+    //         this->dataPtr->depthData[step + j*channelCount + 3];
     //     // unpack rgb data
     //     uint32_t *rgba = reinterpret_cast<uint32_t *>(&color);
     //     unsigned int r = *rgba >> 24 & 0xFF;
@@ -1232,9 +1277,9 @@ void Ogre2DepthCamera::PostRender()
     // {
     //   for (unsigned int j = 0; j < width; ++j)
     //   {
-    //     gzdbg << "[" << this->dataPtr->pointCloudImage[i*width*4+j*4] << "]"
-    //       << "[" << this->dataPtr->pointCloudImage[i*width*4+j*4+1] << "]"
-    //       << "[" << this->dataPtr->pointCloudImage[i*width*4+j*4+2] << "],";
+    //     gzdbg << "[" << this->dataPtr->depthData[i*width*4+j*4] << "]"
+    //       << "[" << this->dataPtr->depthData[i*width*4+j*4+1] << "]"
+    //       << "[" << this->dataPtr->depthData[i*width*4+j*4+2] << "],";
     //   }
     //   gzdbg << std::endl;
     // }
@@ -1255,7 +1300,7 @@ void Ogre2DepthCamera::PostRender()
 //////////////////////////////////////////////////
 const float *Ogre2DepthCamera::DepthData() const
 {
-  return this->dataPtr->depthBuffer;
+  return this->dataPtr->depthData;
 }
 
 //////////////////////////////////////////////////
@@ -26,6 +26,11 @@
 #pragma warning(pop)
 #endif
 
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <utility>
+
 #include "gz/common/Console.hh"
 #include "gz/rendering/ogre2/Ogre2Conversions.hh"
 #include "gz/rendering/ogre2/Ogre2DynamicRenderable.hh"
@@ -49,15 +54,30 @@
 /// \brief Private implementation
 class gz::rendering::Ogre2DynamicRenderablePrivate
 {
-  /// \brief list of colors at each point
-  public: std::vector<gz::math::Color> colors;
+  /// \brief RGB color of each point, 3 floats per point
+  public: std::vector<float> colors;
 
-  /// \brief List of vertices for the mesh
-  public: std::vector<gz::math::Vector3d> vertices;
+  /// \brief Position of each vertex of the mesh, 3 floats per vertex
+  public: std::vector<float> vertices;
 
   /// \brief Used to indicate if the lines require an update
   public: bool dirty = false;
 
+  /// \brief First vertex that changed since the last update
+  public: std::size_t dirtyBegin = 0u;
+
+  /// \brief One past the last vertex that changed since the last update
+  public: std::size_t dirtyEnd = 0u;
+
+  /// \brief Vertices written by the previous updates, most recent last.
+  /// A dynamic buffer has one copy per frame in flight and each map
+  /// moves on to the next copy, so the copy mapped next missed the
+  /// vertices written since it was last mapped.
+  public: std::deque<std::pair<std::size_t, std::size_t>> pendingRanges;
+
+  /// \brief Bounds of the vertices
+  public: Ogre::Aabb bounds;
+
   /// \brief Render operation type
   public: Ogre::OperationType operationType;
 
@@ -91,12 +111,27 @@ class gz::rendering::Ogre2DynamicRenderablePrivate
 
   /// \brief Pointer to the ogre scene manager
   public: Ogre::SceneManager *sceneManager = nullptr;
+
+  /// \brief Pointer to the ogre2 scene, used to notify that the ogre item
+  /// changed
+  public: Ogre2Scene *ogreScene = nullptr;
 };
 
 
 using namespace gz;
 using namespace rendering;
 
+/// \brief Unpack a color in the format of math::Color::AsRGBA into 3
+/// floats
+/// \param[in] _rgba Packed color
+/// \param[out] _rgb Red, green and blue components
+static void unpackRGBA(uint32_t _rgba, float *_rgb)
+{
+  _rgb[0] = ((_rgba >> 24) & 0xFF) / 255.0f;
+  _rgb[1] = ((_rgba >> 16) & 0xFF) / 255.0f;
+  _rgb[2] = ((_rgba >> 8) & 0xFF) / 255.0f;
+}
+
 //////////////////////////////////////////////////
 Ogre2DynamicRenderable::Ogre2DynamicRenderable(
     ScenePtr _scene)
@@ -106,6 +141,7 @@ Ogre2DynamicRenderable::Ogre2DynamicRenderable(
 
   Ogre2ScenePtr s = std::dynamic_pointer_cast<Ogre2Scene>(this->dataPtr->scene);
   this->dataPtr->sceneManager = s->OgreSceneManager();
+  this->dataPtr->ogreScene = s.get();
 
   this->SetOperationType(MT_LINE_STRIP);
   this->CreateDynamicMesh();
@@ -131,6 +167,7 @@ void Ogre2DynamicRenderable::Destroy()
   // destroy ogre item
   this->dataPtr->sceneManager->destroyItem(this->dataPtr->ogreItem);
   this->dataPtr->ogreItem = nullptr;
+  this->dataPtr->ogreScene->SetVisualsDirty();
 
   // remove mesh from mesh manager
   if (this->dataPtr->subMesh &&
@@ -226,7 +263,7 @@ void Ogre2DynamicRenderable::UpdateBuffer()
   // Prepare vertex buffer
   unsigned int newVertCapacity = this->dataPtr->vertexBufferCapacity;
 
-  unsigned int vertexCount = this->dataPtr->vertices.size();
+  unsigned int vertexCount = this->PointCount();
   if ((vertexCount > this->dataPtr->vertexBufferCapacity) ||
       (!this->dataPtr->vertexBufferCapacity))
   {
@@ -253,6 +290,7 @@ void Ogre2DynamicRenderable::UpdateBuffer()
   }
 
   // recreate vao if needed
+  bool recreated = false;
   if (newVertCapacity != this->dataPtr->vertexBufferCapacity)
   {
     this->dataPtr->vertexBufferCapacity = newVertCapacity;
@@ -290,62 +328,129 @@ void Ogre2DynamicRenderable::UpdateBuffer()
     this->dataPtr->subMesh->mVao[Ogre::VpNormal].push_back(this->dataPtr->vao);
     // Use the same geometry for shadow casting.
     this->dataPtr->subMesh->mVao[Ogre::VpShadow].push_back(this->dataPtr->vao);
-  }
 
-  // map buffer and update the geometry
-  Ogre::Aabb bbox;
-  float * RESTRICT_ALIAS vertices = reinterpret_cast<float * RESTRICT_ALIAS>(
-      this->dataPtr->vertexBuffer->map(
-      0, this->dataPtr->vertexBuffer->getNumElements()));
+    // every copy of the new buffer needs all the vertices
+    this->dataPtr->pendingRanges.assign(
+        vaoManager->getDynamicBufferMultiplier() - 1u,
+        std::make_pair(std::size_t(0u), std::size_t(newVertCapacity)));
+    recreated = true;
+  }
 
-  // fill vertices
-  for (unsigned int i = 0; i < vertexCount; ++i)
+  // Find the vertices to write: the ones that changed since the last update
+  // and the ones the previous updates wrote to the other copies of the
+  // buffer. Normals of triangles depend on their neighbours, so only
+  // points and lines are written partially.
+  const std::size_t capacity = this->dataPtr->vertexBufferCapacity;
+  std::size_t begin = this->dataPtr->dirtyBegin;
+  std::size_t end = this->dataPtr->dirtyEnd;
+  if (recreated ||
+      (this->dataPtr->operationType != Ogre::OperationType::OT_POINT_LIST &&
+       this->dataPtr->operationType != Ogre::OperationType::OT_LINE_LIST &&
+       this->dataPtr->operationType != Ogre::OperationType::OT_LINE_STRIP))
+  {
+    begin = 0u;
+    end = capacity;
+  }
+  // the rest of the buffer repeats the last vertex
+  if (end >= vertexCount)
+    end = capacity;
+  const std::size_t changedBegin = begin;
+  const std::size_t changedEnd = end;
+  for (const auto &range : this->dataPtr->pendingRanges)
   {
-    unsigned int idx = i*6;
-    Ogre::Vector3 v = Ogre2Conversions::Convert(this->dataPtr->vertices[i]);
-    vertices[idx] = v.x;
-    vertices[idx+1] = v.y;
-    vertices[idx+2] = v.z;
+    if (range.first == range.second)
+      continue;
+    if (begin == end)
+    {
+      begin = range.first;
+      end = range.second;
+    }
+    else
+    {
+      begin = std::min(begin, range.first);
+      end = std::max(end, range.second);
+    }
+  }
+  end = std::min(end, capacity);
 
-    bbox.merge(v);
+  // remember what this update changed for the copies of the next frames
+  if (!this->dataPtr->pendingRanges.empty())
+  {
+    this->dataPtr->pendingRanges.pop_front();
+    this->dataPtr->pendingRanges.emplace_back(changedBegin, changedEnd);
   }
 
-  // fill the rest of the buffer with the position of the last vertex to avoid
-  // the geometry connecting back to 0, 0, 0
-  if (vertexCount > 0 && vertexCount < this->dataPtr->vertexBufferCapacity)
+  if (begin < end)
   {
-    math::Vector3d lastVertex = this->dataPtr->vertices[vertexCount-1];
-    for (unsigned int i = vertexCount; i < this->dataPtr->vertexBufferCapacity;
-        ++i)
+    // map the range of the buffer and update the geometry
+    float * RESTRICT_ALIAS vertices = reinterpret_cast<float * RESTRICT_ALIAS>(
+        this->dataPtr->vertexBuffer->map(begin, end - begin));
+
+    const float *src = this->dataPtr->vertices.data();
+    const std::size_t filled = std::min<std::size_t>(end, vertexCount);
+
+    // fill vertices
+    for (std::size_t i = begin; i < filled; ++i)
     {
-      unsigned int idx = i * 6;
-      vertices[idx] = lastVertex.X();
-      vertices[idx+1] = lastVertex.Y();
-      vertices[idx+2] = lastVertex.Z();
-
-      vertices[idx+3] = 0;
-      vertices[idx+4] = 0;
-      vertices[idx+5] = 1;
+      float *dst = vertices + (i - begin) * 6;
+      dst[0] = src[i*3];
+      dst[1] = src[i*3+1];
+      dst[2] = src[i*3+2];
+      dst[3] = 0;
+      dst[4] = 0;
+      dst[5] = 0;
+    }
+
+    // fill the rest of the buffer with the position of the last vertex to
+    // avoid the geometry connecting back to 0, 0, 0
+    if (vertexCount > 0)
+    {
+      const float *lastVertex = src + (vertexCount - 1) * 3;
+      for (std::size_t i = std::max<std::size_t>(begin, vertexCount);
+          i < end; ++i)
+      {
+        float *dst = vertices + (i - begin) * 6;
+        dst[0] = lastVertex[0];
+        dst[1] = lastVertex[1];
+        dst[2] = lastVertex[2];
+
+        dst[3] = 0;
+        dst[4] = 0;
+        dst[5] = 1;
+      }
     }
-  }
 
-  // fill normals
-  this->GenerateNormals(this->dataPtr->operationType, this->dataPtr->vertices,
-      vertices);
+    if (begin == 0u && end == capacity)
+    {
+      // fill normals
+      this->GenerateNormals(this->dataPtr->operationType,
+          this->dataPtr->vertices, vertices);
+    }
 
-  // fill colors for points
-  this->GenerateColors(this->dataPtr->operationType, this->dataPtr->vertices,
-      vertices);
+    // fill colors for points
+    this->GenerateColors(this->dataPtr->operationType, begin, end, vertices);
 
-  // unmap buffer
-  this->dataPtr->vertexBuffer->unmap(Ogre::UO_KEEP_PERSISTENT);
+    // unmap buffer
+    this->dataPtr->vertexBuffer->unmap(Ogre::UO_KEEP_PERSISTENT);
+  }
 
-  // Set the bounds to get frustum culling and LOD to work correctly.
+  // Update the bounds to get frustum culling and LOD to work correctly.
+  // Points that moved out of the bounds grow them, the bounds are only
+  // recomputed when all the points changed
+  const std::size_t boundsEnd = std::min<std::size_t>(changedEnd, vertexCount);
+  if (changedBegin == 0u && boundsEnd == vertexCount)
+    this->dataPtr->bounds = Ogre::Aabb();
+  const float *src = this->dataPtr->vertices.data();
+  for (std::size_t i = changedBegin; i < boundsEnd; ++i)
+  {
+    this->dataPtr->bounds.merge(
+        Ogre::Vector3(src[i*3], src[i*3+1], src[i*3+2]));
+  }
   Ogre::Mesh *mesh = this->dataPtr->subMesh->mParent;
-  mesh->_setBounds(bbox, true);
+  mesh->_setBounds(this->dataPtr->bounds, true);
 
-  // update item aabb
-  if (this->dataPtr->ogreItem)
+  // update item
+  if (this->dataPtr->ogreItem && recreated)
   {
     bool castShadows = this->dataPtr->ogreItem->getCastShadows();
     auto lowLevelMat = this->dataPtr->ogreItem->getSubItem(0)->getMaterial();
@@ -371,8 +476,18 @@ void Ogre2DynamicRenderable::UpdateBuffer()
       this->dataPtr->ogreItem->getSubItem(0)->setMaterial(lowLevelMat);
       this->dataPtr->ogreItem->setCastShadows(castShadows);
     }
+
+    // sub items were recreated
+    this->dataPtr->ogreScene->SetVisualsDirty();
+  }
+  else if (this->dataPtr->ogreItem)
+  {
+    // the sub items are still valid, only the bounds changed
+    this->dataPtr->ogreItem->setLocalAabb(this->dataPtr->bounds);
   }
 
+  this->dataPtr->dirtyBegin = 0u;
+  this->dataPtr->dirtyEnd = 0u;
   this->dataPtr->dirty = false;
 }
 
@@ -450,15 +565,20 @@ MarkerType Ogre2DynamicRenderable::OperationType() const
 void Ogre2DynamicRenderable::AddPoint(const math::Vector3d &_pt,
                                       const math::Color &_color)
 {
-  this->dataPtr->vertices.push_back(_pt);
+  this->dataPtr->vertices.push_back(static_cast<float>(_pt.X()));
+  this->dataPtr->vertices.push_back(static_cast<float>(_pt.Y()));
+  this->dataPtr->vertices.push_back(static_cast<float>(_pt.Z()));
 
   // todo(anyone)
   // setting material works but vertex coloring only works for points
   // It requires using an unlit datablock:
   // https://forums.ogre3d.org/viewtopic.php?t=93627#p539276
-  this->dataPtr->colors.push_back(_color);
+  this->dataPtr->colors.push_back(_color.R());
+  this->dataPtr->colors.push_back(_color.G());
+  this->dataPtr->colors.push_back(_color.B());
 
-  this->dataPtr->dirty = true;
+  const std::size_t count = this->PointCount();
+  this->MarkDirty(count - 1u, count);
 }
 
 /////////////////////////////////////////////////
@@ -472,26 +592,29 @@ void Ogre2DynamicRenderable::AddPoint(double _x, double _y, double _z,
 void Ogre2DynamicRenderable::SetPoint(unsigned int _index,
                                       const math::Vector3d &_value)
 {
-  if (_index >= this->dataPtr->vertices.size())
+  if (_index >= this->PointCount())
   {
     gzerr << "Point index[" << _index << "] is out of bounds[0-"
-           << this->dataPtr->vertices.size()-1 << "]\n";
+           << static_cast<int>(this->PointCount()) - 1 << "]\n";
     return;
   }
 
-  this->dataPtr->vertices[_index] = _value;
+  float *vertex = this->dataPtr->vertices.data() + _index * 3u;
+  vertex[0] = static_cast<float>(_value.X());
+  vertex[1] = static_cast<float>(_value.Y());
+  vertex[2] = static_cast<float>(_value.Z());
 
-  this->dataPtr->dirty = true;
+  this->MarkDirty(_index, _index + 1u);
 }
 
 /////////////////////////////////////////////////
 void Ogre2DynamicRenderable::SetColor(unsigned int _index,
                                       const math::Color &_color)
 {
-  if (_index >= this->dataPtr->colors.size())
+  if (_index >= this->PointCount())
   {
     gzerr << "Point color index[" << _index << "] is out of bounds[0-"
-           << this->dataPtr->colors.size()-1 << "]\n";
+           << static_cast<int>(this->PointCount()) - 1 << "]\n";
     return;
   }
 
@@ -500,32 +623,93 @@ void Ogre2DynamicRenderable::SetColor(unsigned int _index,
   // vertex coloring only works for points.
   // Full implementation requires using an unlit datablock:
   // https://forums.ogre3d.org/viewtopic.php?t=93627#p539276
-  this->dataPtr->colors[_index] = _color;
+  float *color = this->dataPtr->colors.data() + _index * 3u;
+  color[0] = _color.R();
+  color[1] = _color.G();
+  color[2] = _color.B();
 
-  this->dataPtr->dirty = true;
+  this->MarkDirty(_index, _index + 1u);
+}
+
+/////////////////////////////////////////////////
+void Ogre2DynamicRenderable::SetPoints(const float *_xyz,
+    const uint32_t *_rgba, std::size_t _count)
+{
+  if (_count > 0u && !_xyz)
+  {
+    gzerr << "Unable to set [" << _count << "] points from null positions"
+          << std::endl;
+    return;
+  }
+
+  this->dataPtr->vertices.assign(_xyz, _xyz + _count * 3u);
+  this->dataPtr->colors.resize(_count * 3u);
+  if (_rgba)
+  {
+    for (std::size_t i = 0u; i < _count; ++i)
+      unpackRGBA(_rgba[i], this->dataPtr->colors.data() + i * 3u);
+  }
+  else
+  {
+    std::fill(this->dataPtr->colors.begin(), this->dataPtr->colors.end(),
+        1.0f);
+  }
+
+  this->MarkDirty(0u, _count);
+}
+
+/////////////////////////////////////////////////
+void Ogre2DynamicRenderable::UpdatePoints(std::size_t _offset,
+    const float *_xyz, const uint32_t *_rgba, std::size_t _count)
+{
+  if (_count == 0u)
+    return;
+
+  if (_offset + _count > this->PointCount())
+  {
+    gzerr << "Unable to update points [" << _offset << ", "
+          << _offset + _count << "), there are " << this->PointCount()
+          << " points" << std::endl;
+    return;
+  }
+
+  if (_xyz)
+  {
+    std::copy(_xyz, _xyz + _count * 3u,
+        this->dataPtr->vertices.begin() + _offset * 3u);
+  }
+  if (_rgba)
+  {
+    float *colors = this->dataPtr->colors.data() + _offset * 3u;
+    for (std::size_t i = 0u; i < _count; ++i)
+      unpackRGBA(_rgba[i], colors + i * 3u);
+  }
+
+  this->MarkDirty(_offset, _offset + _count);
 }
 
 /////////////////////////////////////////////////
 math::Vector3d Ogre2DynamicRenderable::Point(
     const unsigned int _index) const
 {
-  if (_index >= this->dataPtr->vertices.size())
+  if (_index >= this->PointCount())
   {
     gzerr << "Point index[" << _index << "] is out of bounds[0-"
-           << this->dataPtr->vertices.size()-1 << "]\n";
+           << static_cast<int>(this->PointCount()) - 1 << "]\n";
 
     return math::Vector3d(math::INF_D,
                                     math::INF_D,
                                     math::INF_D);
   }
 
-  return this->dataPtr->vertices[_index];
+  const float *vertex = this->dataPtr->vertices.data() + _index * 3u;
+  return math::Vector3d(vertex[0], vertex[1], vertex[2]);
 }
 
 /////////////////////////////////////////////////
 unsigned int Ogre2DynamicRenderable::PointCount() const
 {
-  return this->dataPtr->vertices.size();
+  return this->dataPtr->vertices.size() / 3u;
 }
 
 /////////////////////////////////////////////////
@@ -536,6 +720,23 @@ void Ogre2DynamicRenderable::Clear()
 
   this->dataPtr->vertices.clear();
   this->dataPtr->colors.clear();
+  this->MarkDirty(0u, 0u);
+}
+
+/////////////////////////////////////////////////
+void Ogre2DynamicRenderable::MarkDirty(std::size_t _begin, std::size_t _end)
+{
+  if (!this->dataPtr->dirty ||
+      this->dataPtr->dirtyBegin == this->dataPtr->dirtyEnd)
+  {
+    this->dataPtr->dirtyBegin = _begin;
+    this->dataPtr->dirtyEnd = _end;
+  }
+  else
+  {
+    this->dataPtr->dirtyBegin = std::min(this->dataPtr->dirtyBegin, _begin);
+    this->dataPtr->dirtyEnd = std::max(this->dataPtr->dirtyEnd, _end);
+  }
   this->dataPtr->dirty = true;
 }
 
@@ -567,13 +768,21 @@ void Ogre2DynamicRenderable::SetMaterial(MaterialPtr _material, bool _unique)
 
   // set cast shadows
   this->dataPtr->ogreItem->setCastShadows(_material->CastShadows());
+
+  this->dataPtr->ogreScene->SetVisualsDirty();
 }
 
 //////////////////////////////////////////////////
 void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
-  const std::vector<math::Vector3d> &_vertices, float *_vbuffer)
+  const std::vector<float> &_vertices, float *_vbuffer)
 {
-  unsigned int vertexCount = _vertices.size();
+  unsigned int vertexCount = _vertices.size() / 3u;
+  auto vertex = [&_vertices](unsigned int _i)
+  {
+    return math::Vector3d(
+        _vertices[_i*3], _vertices[_i*3+1], _vertices[_i*3+2]);
+  };
+
   // Each vertex occupies 6 elements in the vbuffer float array:
   // vbuffer[i]   : position x
   // vbuffer[i+1] : position y
@@ -598,9 +807,9 @@ void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
         unsigned int idx1 = idx * 6;
         unsigned int idx2 = idx1 + 6;
         unsigned int idx3 = idx2 + 6;
-        math::Vector3d v1 = _vertices[idx];
-        math::Vector3d v2 = _vertices[idx+1];
-        math::Vector3d v3 = _vertices[idx+2];
+        math::Vector3d v1 = vertex(idx);
+        math::Vector3d v2 = vertex(idx+1);
+        math::Vector3d v3 = vertex(idx+2);
         math::Vector3d n = (v1 - v2).Cross((v1 - v3));
 
         _vbuffer[idx1+3] = n.X();
@@ -626,7 +835,7 @@ void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
       {
         math::Vector3d v1;
         math::Vector3d v2;
-        math::Vector3d v3 = _vertices[i+2];
+        math::Vector3d v3 = vertex(i+2);
 
         // For odd n, vertices n, n+1, and n+2 define triangle n.
         // For even n, vertices n+1, n, and n+2 define triangle n.
@@ -635,15 +844,15 @@ void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
         unsigned int idx3 = (i+2) * 6;
         if (even)
         {
-          v1 = _vertices[i+1];
-          v2 = _vertices[i];
+          v1 = vertex(i+1);
+          v2 = vertex(i);
           idx1 = (i+1) * 6;
           idx2 = i*6;
         }
         else
         {
-          v1 = _vertices[i];
-          v2 = _vertices[i+1];
+          v1 = vertex(i);
+          v2 = vertex(i+1);
           idx1 = i*6;
           idx2 = (i+1) * 6;
         }
@@ -680,14 +889,14 @@ void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
         return;
 
       unsigned int idx1 = 0;
-      math::Vector3d v1 = _vertices[0];
+      math::Vector3d v1 = vertex(0);
 
       for (unsigned int i = 0; i < vertexCount - 2; ++i)
       {
         unsigned int idx2 = (i+1) * 6;
         unsigned int idx3 = idx2 + 6;
-        math::Vector3d v2 = _vertices[i+1];
-        math::Vector3d v3 = _vertices[i+2];
+        math::Vector3d v2 = vertex(i+1);
+        math::Vector3d v3 = vertex(i+2);
         math::Vector3d n = (v1 - v2).Cross((v1 - v3));
 
         math::Vector3d n1(_vbuffer[idx1+3], _vbuffer[idx1+4], _vbuffer[idx1+5]);
@@ -721,10 +930,10 @@ void Ogre2DynamicRenderable::GenerateNormals(Ogre::OperationType _opType,
 
 //////////////////////////////////////////////////
 void Ogre2DynamicRenderable::GenerateColors(Ogre::OperationType _opType,
-  const std::vector<math::Vector3d> &_vertices, float *_vbuffer)
+  std::size_t _begin, std::size_t _end, float *_vbuffer)
 {
-  // Skip if colors haven't been setup per-vertex correctly.
-  if (_vertices.size() != this->dataPtr->colors.size())
+  // Skip if there are no points to take the colors from.
+  if (this->dataPtr->colors.empty())
     return;
 
   // Each vertex occupies 6 elements in the vbuffer float array. Normally,
@@ -740,15 +949,16 @@ void Ogre2DynamicRenderable::GenerateColors(Ogre::OperationType _opType,
   {
     case Ogre::OperationType::OT_POINT_LIST:
     {
-      for (unsigned int i = 0; i < this->dataPtr->vertexBufferCapacity; ++i)
+      const std::size_t colorCount = this->dataPtr->colors.size() / 3u;
+      for (std::size_t i = _begin; i < _end; ++i)
       {
-        math::Color color = i < this->dataPtr->colors.size() ?
-            this->dataPtr->colors[i] : this->dataPtr->colors.back();
+        const float *color = this->dataPtr->colors.data() +
+            std::min(i, colorCount - 1u) * 3u;
 
-        unsigned int idx = i * 6;
-        _vbuffer[idx+3] = color.R();
-        _vbuffer[idx+4] = color.G();
-        _vbuffer[idx+5] = color.B();
+        std::size_t idx = (i - _begin) * 6;
+        _vbuffer[idx+3] = color[0];
+        _vbuffer[idx+4] = color[1];
+        _vbuffer[idx+5] = color[2];
       }
 
       break;
@@ -15,6 +15,16 @@
  *
 */
 
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <vector>
+
+#include <gz/math/Pose3.hh>
 #include <gz/math/Vector2.hh>
 #include <gz/math/Vector3.hh>
 
@@ -34,6 +44,7 @@
 #include "gz/rendering/ogre2/Ogre2Sensor.hh"
 #include "gz/rendering/ogre2/Ogre2Visual.hh"
 
+#include "Ogre2AsyncReadback.hh"
 #include "Ogre2GzHlmsSphericalClipMinDistance.hh"
 #include "Ogre2ParticleNoiseListener.hh"
 #include "Terra/Hlms/PbsListener/OgreHlmsPbsTerraShadows.h"
@@ -127,12 +138,24 @@ class GZ_RENDERING_OGRE2_HIDDEN gz::rendering::Ogre2GpuRaysPrivate
                unsigned int, unsigned int, unsigned int,
                const std::string &)> newGpuRaysFrame;
 
-  /// \brief Raw buffer of gpu rays data.
-  public: float *gpuRaysBuffer = nullptr;
+  /// \brief Event triggered when new raw RGBA gpu rays data are available.
+  /// \param[in] _frame Mapped gpu rays data, only valid during the event.
+  /// \param[in] _width Width of frame.
+  /// \param[in] _height Height of frame.
+  /// \param[in] _channel Number of channels
+  /// \param[in] _rowStride Number of floats between consecutive rows
+  /// \param[in] _format Format of frame.
+  public: gz::common::EventT<void(const float *,
+               unsigned int, unsigned int, unsigned int, unsigned int,
+               const std::string &)> newGpuRaysRawFrame;
 
   /// \brief Outgoing gpu rays data, used by newGpuRaysFrame event.
   public: float *gpuRaysScan = nullptr;
 
+  /// \brief Asynchronous readback of the 2nd pass texture, used when the
+  /// sensor readback latency is greater than 0
+  public: Ogre2AsyncReadback readback;
+
   /// \brief Cubemap cameras
   public: Ogre::Camera *cubeCam[6];
 
@@ -215,6 +238,24 @@ class GZ_RENDERING_OGRE2_HIDDEN gz::rendering::Ogre2GpuRaysPrivate
 
   /// \brief Pointer to the particle target definition in the workspace
   public: Ogre::CompositorTargetDef *particleTargetDef{nullptr};
+
+  /// \brief Sensor whose cubemap the 2nd pass samples instead of the
+  /// cubemap of this sensor. nullptr if this sensor renders its own.
+  public: Ogre2GpuRays *firstPassSource = nullptr;
+
+  /// \brief Rotation of this sensor relative to firstPassSource that the
+  /// sample texture was computed with
+  public: math::Quaterniond firstPassSourceRot;
+
+  /// \brief Sensors whose 2nd pass samples the cubemap of this sensor
+  public: std::set<Ogre2GpuRays *> firstPassSharers;
+
+  /// \brief Value of Ogre2Scene::FrameCount when this sensor last rendered
+  /// its own cubemap
+  public: uint64_t firstPassFrame = 0u;
+
+  /// \brief World pose of this sensor when it last rendered its own cubemap
+  public: math::Pose3d firstPassPose;
 };
 
 using namespace gz;
@@ -227,6 +268,54 @@ static const uint32_t kLaserRetro1stPassQuad = 9526u;
 /// \brief standard deviation of particle noise
 static const double kParticleStddev = 0.01;
 
+/// \brief Copy _count RGBA float pixels to RGB, dropping the alpha channel
+/// \param[in] _src Source RGBA pixels
+/// \param[out] _dst Destination RGB pixels, must hold _count * 3 floats
+/// \param[in] _count Number of pixels
+static void RgbaToRgb(const float *_src, float *_dst, unsigned int _count)
+{
+  unsigned int i = 0u;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  // deinterleave 4 pixels and interleave back without the alpha channel
+  for (; i + 4u <= _count; i += 4u)
+  {
+    float32x4x4_t rgba = vld4q_f32(&_src[i * 4u]);
+    float32x4x3_t rgb;
+    rgb.val[0] = rgba.val[0];
+    rgb.val[1] = rgba.val[1];
+    rgb.val[2] = rgba.val[2];
+    vst3q_f32(&_dst[i * 3u], rgb);
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  // store each whole RGBA pixel 3 floats apart, the alpha value is
+  // overwritten by the next pixel. Stop one pixel short so that the last
+  // store does not write past the end of the destination row.
+  for (; i + 1u < _count; ++i)
+  {
+    _mm_storeu_ps(&_dst[i * 3u], _mm_loadu_ps(&_src[i * 4u]));
+  }
+#endif
+  for (; i < _count; ++i)
+  {
+    _dst[i * 3u] = _src[i * 4u];
+    _dst[i * 3u + 1u] = _src[i * 4u + 1u];
+    _dst[i * 3u + 2u] = _src[i * 4u + 2u];
+  }
+}
+
+/// \brief Check if two quaternions represent the same rotation
+/// \param[in] _a First quaternion
+/// \param[in] _b Second quaternion
+/// \return True if the rotations are equal within a small tolerance
+static bool SameRotation(const math::Quaterniond &_a,
+    const math::Quaterniond &_b)
+{
+  // q and -q represent the same rotation
+  const double dot = _a.W() * _b.W() + _a.X() * _b.X() + _a.Y() * _b.Y() +
+      _a.Z() * _b.Z();
+  return std::abs(dot) > 1.0 - 1e-9;
+}
+
 //////////////////////////////////////////////////
 Ogre2LaserRetroMaterialSwitcher::Ogre2LaserRetroMaterialSwitcher(
   Ogre2ScenePtr _scene, Ogre2GpuRays *_gpuRays, Ogre::Camera *_ogreCamera)
@@ -598,18 +687,25 @@ void Ogre2GpuRays::Destroy()
   if (!this->dataPtr->ogreCamera)
     return;
 
-  if (this->dataPtr->gpuRaysBuffer)
-  {
-    delete [] this->dataPtr->gpuRaysBuffer;
-    this->dataPtr->gpuRaysBuffer = nullptr;
-  }
-
   if (this->dataPtr->gpuRaysScan)
   {
     delete [] this->dataPtr->gpuRaysScan;
     this->dataPtr->gpuRaysScan = nullptr;
   }
 
+  this->dataPtr->readback.Reset();
+
+  // stop sampling the cubemap of another sensor, and make the sensors that
+  // sample the cubemap of this one render their own
+  if (this->dataPtr->firstPassSource)
+  {
+    this->dataPtr->firstPassSource->dataPtr->firstPassSharers.erase(this);
+    this->dataPtr->firstPassSource = nullptr;
+  }
+  const std::set<Ogre2GpuRays *> sharers = this->dataPtr->firstPassSharers;
+  for (auto sharer : sharers)
+    sharer->SetFirstPassSource(nullptr, math::Quaterniond::Identity);
+
   auto engine = Ogre2RenderEngine::Instance();
   auto ogreRoot = engine->OgreRoot();
   auto textureGpuManager = ogreRoot->getRenderSystem()->getTextureGpuManager();
@@ -835,7 +931,8 @@ math::Vector2d Ogre2GpuRays::SampleCubemap(const math::Vector3d &_v,
 }
 
 /////////////////////////////////////////////////////////
-void Ogre2GpuRays::CreateSampleTexture()
+void Ogre2GpuRays::ComputeSampleData(const math::Quaterniond &_rot,
+    float *_data, std::set<unsigned int> &_faceIdx)
 {
   double min = this->AngleMin().Radian();
   double max = this->AngleMax().Radian();
@@ -852,6 +949,57 @@ void Ogre2GpuRays::CreateSampleTexture()
   if (this->dataPtr->h2nd > 1)
     vStep = vAngle / static_cast<double>(this->dataPtr->h2nd-1);
 
+  // the yaw of a ray only depends on its column
+  std::vector<math::Quaterniond> yaws(this->dataPtr->w2nd);
+  double h = min;
+  for (unsigned int j = 0; j < this->dataPtr->w2nd; ++j)
+  {
+    yaws[j] = math::Quaterniond(math::Vector3d(0, 1, 0), -h);
+    h += hStep;
+  }
+
+  double v = vmin;
+  int index = 0;
+  for (unsigned int i = 0; i < this->dataPtr->h2nd; ++i)
+  {
+    math::Quaterniond pitch(math::Vector3d(1, 0, 0), -v);
+    for (unsigned int j = 0; j < this->dataPtr->w2nd; ++j)
+    {
+      // set up dir vector to sample from a standard Y up cubemap
+      math::Vector3d ray(0, 0, 1);
+      math::Vector3d dir = yaws[j] * pitch * ray;
+
+      // the cubemap axes x, y and z are the sensor axes -y, z and x.
+      // Express the ray in the frame of the sensor that rendered the
+      // cubemap.
+      math::Vector3d sensorDir = _rot * math::Vector3d(
+          dir.Z(), -dir.X(), dir.Y());
+      dir.Set(-sensorDir.Y(), sensorDir.Z(), sensorDir.X());
+
+      unsigned int faceIdx;
+      math::Vector2d uv = this->SampleCubemap(dir, faceIdx);
+      _faceIdx.insert(faceIdx);
+      // gzdbg << "p(" << pitch << ") y(" << yaws[j] << "): " << dir << " | "
+      //       << uv << " | " << faceIdx << std::endl;
+      if (_data)
+      {
+        // u
+        _data[index++] = uv.X();
+        // v
+        _data[index++] = uv.Y();
+        // face
+        _data[index++] = static_cast<float>(faceIdx);
+        // unused
+        _data[index++] = 1.0;
+      }
+    }
+    v += vStep;
+  }
+}
+
+/////////////////////////////////////////////////////////
+void Ogre2GpuRays::CreateSampleTexture()
+{
   // create an RGB texture (cubeUVTex) to pack info that tells the shaders how
   // to sample from the cubemap textures.
   // Each pixel packs the follow data:
@@ -889,44 +1037,31 @@ void Ogre2GpuRays::CreateSampleTexture()
     this->dataPtr->cubeUVTexture->getPixelFormat(),
     rowAlignment);
 
-  const size_t bytesPerRow =
-    this->dataPtr->cubeUVTexture->_getSysRamCopyBytesPerRow( 0 );
   float *pDest = reinterpret_cast<float*>(
     OGRE_MALLOC_SIMD(dataSize, Ogre::MEMCATEGORY_RESOURCE));
 
-  double v = vmin;
-  int index = 0;
-  for (unsigned int i = 0; i < this->dataPtr->h2nd; ++i)
-  {
-    double h = min;
-    for (unsigned int j = 0; j < this->dataPtr->w2nd; ++j)
-    {
-      // set up dir vector to sample from a standard Y up cubemap
-      math::Vector3d ray(0, 0, 1);
-      ray.Normalize();
-      math::Quaterniond pitch(math::Vector3d(1, 0, 0), -v);
-      math::Quaterniond yaw(math::Vector3d(0, 1, 0), -h);
-      math::Vector3d dir = yaw * pitch * ray;
-      unsigned int faceIdx;
-      math::Vector2d uv = this->SampleCubemap(dir, faceIdx);
-      this->dataPtr->cubeFaceIdx.insert(faceIdx);
-      // gzdbg << "p(" << pitch << ") y(" << yaw << "): " << dir << " | "
-      //       << uv << " | " << faceIdx << std::endl;
-      // u
-      pDest[index++] = uv.X();
-      // v
-      pDest[index++] = uv.Y();
-      // face
-      pDest[index++] = static_cast<float>(faceIdx);
-      // unused
-      pDest[index++] = 1.0;
-      h += hStep;
-    }
-    v += vStep;
-  }
+  this->ComputeSampleData(math::Quaterniond::Identity, pDest,
+      this->dataPtr->cubeFaceIdx);
+
   this->dataPtr->cubeUVTexture->_transitionTo(
     Ogre::GpuResidency::Resident,
     reinterpret_cast<Ogre::uint8*>(pDest) );
+  this->UploadSampleTexture(pDest);
+  // Do not free the pointer if texture's paging strategy is
+  // GpuPageOutStrategy::AlwaysKeepSystemRamCopy
+}
+
+/////////////////////////////////////////////////////////
+void Ogre2GpuRays::UploadSampleTexture(const float *_data)
+{
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::TextureGpuManager *textureMgr =
+    ogreRoot->getRenderSystem()->getTextureGpuManager();
+
+  const size_t bytesPerRow =
+    this->dataPtr->cubeUVTexture->_getSysRamCopyBytesPerRow( 0 );
+
   // We have to upload the data via a StagingTexture, which acts as an
   // intermediate stash memory that is both visible to CPU and GPU.
   Ogre::StagingTexture *stagingTexture = textureMgr->getStagingTexture(
@@ -946,7 +1081,7 @@ void Ogre2GpuRays::CreateSampleTexture()
     this->dataPtr->cubeUVTexture->getPixelFormat());
 
   texBox.copyFrom(
-    pDest,
+    _data,
     this->dataPtr->cubeUVTexture->getWidth(),
     this->dataPtr->cubeUVTexture->getHeight(),
     bytesPerRow);
@@ -956,8 +1091,6 @@ void Ogre2GpuRays::CreateSampleTexture()
   // Otherwise it will leak.
   textureMgr->removeStagingTexture(stagingTexture);
   stagingTexture = 0;
-  // Do not free the pointer if texture's paging strategy is
-  // GpuPageOutStrategy::AlwaysKeepSystemRamCopy
 }
 
 /////////////////////////////////////////////////////////
@@ -1156,6 +1289,26 @@ void Ogre2GpuRays::Setup2ndPass()
   this->dataPtr->secondPassTexture->scheduleTransitionTo(
     Ogre::GpuResidency::Resident);
 
+  this->CreateWorkspace2nd();
+}
+
+/////////////////////////////////////////////////////////
+void Ogre2GpuRays::CreateWorkspace2nd()
+{
+  auto engine = Ogre2RenderEngine::Instance();
+  auto ogreRoot = engine->OgreRoot();
+  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
+
+  if (this->dataPtr->ogreCompositorWorkspace2nd)
+  {
+    ogreCompMgr->removeWorkspace(this->dataPtr->ogreCompositorWorkspace2nd);
+    this->dataPtr->ogreCompositorWorkspace2nd = nullptr;
+  }
+
+  // sample the cubemap of the sensor we share the 1st pass with, if any
+  Ogre2GpuRaysPrivate *source = this->dataPtr->firstPassSource ?
+      this->dataPtr->firstPassSource->dataPtr.get() : this->dataPtr.get();
+
   Ogre::CompositorChannelVec compoChannels;
 
   // The compositor will plug all these textures into the material
@@ -1165,9 +1318,9 @@ void Ogre2GpuRays::Setup2ndPass()
   compoChannels.push_back(this->dataPtr->cubeUVTexture);
   for (size_t i = 0u; i < 6u; ++i)
   {
-    if(this->dataPtr->firstPassTextures[i])
+    if(source->firstPassTextures[i])
     {
-      compoChannels.push_back(this->dataPtr->firstPassTextures[i]);
+      compoChannels.push_back(source->firstPassTextures[i]);
     }
     else
     {
@@ -1175,13 +1328,11 @@ void Ogre2GpuRays::Setup2ndPass()
       // Ogre complaining. The material pass won't be accessing those
       // indices anyway
       compoChannels.push_back(
-        this->dataPtr->firstPassTextures[*this->dataPtr->cubeFaceIdx.begin()]);
+        source->firstPassTextures[*source->cubeFaceIdx.begin()]);
     }
   }
 
   // create 2nd pass compositor
-  Ogre::CompositorManager2 *ogreCompMgr = ogreRoot->getCompositorManager2();
-
   const std::string wsDefName = "GpuRays2ndPassWorkspace";
   Ogre::CompositorWorkspaceDef *wsDef =
       ogreCompMgr->getWorkspaceDefinition(wsDefName);
@@ -1260,11 +1411,119 @@ void Ogre2GpuRays::UpdateRenderTarget2ndPass()
   this->dataPtr->ogreCompositorWorkspace2nd->_swapFinalTarget(swappedTargets);
 }
 
+//////////////////////////////////////////////////
+Ogre2GpuRays *Ogre2GpuRays::FindFirstPassSource(math::Quaterniond &_rot)
+{
+  // frames are only delimited by Scene::PreRender when not in legacy mode,
+  // otherwise we can't tell if another cubemap is up to date
+  const double tolerance = this->CubemapSharingTolerance();
+  if (tolerance <= 0.0 || this->scene->LegacyAutoGpuFlush())
+    return nullptr;
+
+  const uint64_t frame = this->scene->FrameCount();
+  const math::Pose3d pose = this->WorldPose();
+
+  auto canShare = [&](Ogre2GpuRays *_other)
+  {
+    const Ogre2GpuRaysPrivate &other = *_other->dataPtr;
+    if (_other == this || other.firstPassSource ||
+        other.firstPassFrame != frame)
+    {
+      return false;
+    }
+
+    // the 1st pass clamps ranges using the clip planes and data range of
+    // the sensor that renders it
+    if (other.w1st != this->dataPtr->w1st ||
+        other.h1st != this->dataPtr->h1st ||
+        _other->NearClipPlane() != this->NearClipPlane() ||
+        _other->FarClipPlane() != this->FarClipPlane() ||
+        _other->dataMinVal != this->dataMinVal ||
+        _other->dataMaxVal != this->dataMaxVal ||
+        _other->VisibilityMask() != this->VisibilityMask())
+    {
+      return false;
+    }
+
+    if (other.firstPassPose.Pos().Distance(pose.Pos()) > tolerance)
+      return false;
+
+    _rot = other.firstPassPose.Rot().Inverse() * pose.Rot();
+    if (_other == this->dataPtr->firstPassSource &&
+        SameRotation(_rot, this->dataPtr->firstPassSourceRot))
+    {
+      return true;
+    }
+
+    // the other sensor must have rendered every face our rays sample
+    std::set<unsigned int> faceIdx;
+    this->ComputeSampleData(_rot, nullptr, faceIdx);
+    return std::includes(other.cubeFaceIdx.begin(), other.cubeFaceIdx.end(),
+        faceIdx.begin(), faceIdx.end());
+  };
+
+  // keep sampling the same sensor as long as we can
+  if (this->dataPtr->firstPassSource &&
+      canShare(this->dataPtr->firstPassSource))
+  {
+    return this->dataPtr->firstPassSource;
+  }
+
+  for (unsigned int i = 0; i < this->scene->SensorCount(); ++i)
+  {
+    auto other = std::dynamic_pointer_cast<Ogre2GpuRays>(
+        this->scene->SensorByIndex(i));
+    if (other && canShare(other.get()))
+      return other.get();
+  }
+  return nullptr;
+}
+
+//////////////////////////////////////////////////
+void Ogre2GpuRays::SetFirstPassSource(Ogre2GpuRays *_source,
+    const math::Quaterniond &_rot)
+{
+  const math::Quaterniond rot = _source ? _rot : math::Quaterniond::Identity;
+  const bool sourceChanged = _source != this->dataPtr->firstPassSource;
+  const bool rotChanged =
+      !SameRotation(rot, this->dataPtr->firstPassSourceRot);
+  if (!sourceChanged && !rotChanged)
+    return;
+
+  if (sourceChanged)
+  {
+    if (this->dataPtr->firstPassSource)
+      this->dataPtr->firstPassSource->dataPtr->firstPassSharers.erase(this);
+    if (_source)
+      _source->dataPtr->firstPassSharers.insert(this);
+    this->dataPtr->firstPassSource = _source;
+  }
+
+  // point the rays at the faces of the cubemap in the frame of the sensor
+  // that renders it
+  if (rotChanged)
+  {
+    this->dataPtr->firstPassSourceRot = rot;
+    std::vector<float> data(4u * this->dataPtr->w2nd * this->dataPtr->h2nd);
+    std::set<unsigned int> faceIdx;
+    this->ComputeSampleData(rot, data.data(), faceIdx);
+    this->UploadSampleTexture(data.data());
+  }
+
+  if (sourceChanged)
+    this->CreateWorkspace2nd();
+}
+
 //////////////////////////////////////////////////
 void Ogre2GpuRays::Render()
 {
   this->scene->StartRendering(this->dataPtr->ogreCamera);
 
+  // reuse the cubemap of a sensor at the same place if there's one
+  math::Quaterniond sourceRot;
+  Ogre2GpuRays *source = this->FindFirstPassSource(sourceRot);
+  this->SetFirstPassSource(source, sourceRot);
+
   auto engine = Ogre2RenderEngine::Instance();
 
   // The Hlms customizations add a "spherical" clipping; which ignores depth
@@ -1277,11 +1536,18 @@ void Ogre2GpuRays::Render()
 
   hlmsCustomizations.minDistanceClip =
       static_cast<float>(this->NearClipPlane());
-  this->UpdateRenderTarget1stPass();
+  if (!source)
+  {
+    this->UpdateRenderTarget1stPass();
+    this->dataPtr->firstPassFrame = this->scene->FrameCount();
+    this->dataPtr->firstPassPose = this->WorldPose();
+  }
   this->UpdateRenderTarget2ndPass();
   hlmsCustomizations.minDistanceClip = -1;
 
-  this->scene->FlushGpuCommandsAndStartNewFrame(6u, false);
+  // only the 1st pass renders the scene
+  this->scene->FlushGpuCommandsAndStartNewFrame(
+      static_cast<uint8_t>(source ? 0u : 6u), false);
 }
 
 //////////////////////////////////////////////////
@@ -1321,30 +1587,34 @@ void Ogre2GpuRays::PostRender()
   PixelFormat format = PF_FLOAT32_RGBA;
   unsigned int rawChannelCount = PixelUtil::ChannelCount(format);
   unsigned int bytesPerChannel = PixelUtil::BytesPerChannel(format);
-  int rawLen = width * height * rawChannelCount;
-
-  if (!this->dataPtr->gpuRaysBuffer)
-  {
-    this->dataPtr->gpuRaysBuffer = new float[rawLen];
-  }
 
   // blit data from gpu to cpu
   Ogre::Image2 image;
-  image.convertFromTexture(this->dataPtr->secondPassTexture, 0u, 0u);
-  Ogre::TextureBox box = image.getData(0u);
-  float *bufferTmp = static_cast<float *>(box.data);
-
-  // TODO(anyone): It seems wasteful to have gpuRaysBuffer at all
-  // We should be able to convert directly from bufferTmp to gpuRaysScan
+  Ogre::TextureBox box;
+  Ogre2AsyncReadback &readback = this->dataPtr->readback;
+  readback.SetLatency(this->ReadbackLatency());
+  if (readback.Latency() > 0u)
+  {
+    readback.Download(this->dataPtr->secondPassTexture);
+    if (!readback.FrameReady())
+      return;
+    box = readback.MapFrame();
+  }
+  else
+  {
+    image.convertFromTexture(this->dataPtr->secondPassTexture, 0u, 0u);
+    box = image.getData(0u);
+  }
+  const float *bufferTmp = static_cast<const float *>(box.data);
+  // the texture box step size could be larger than our image buffer step
+  // size
+  unsigned int rawRowStride = box.bytesPerRow / bytesPerChannel;
 
-  // copy data row by row. The texture box may not be a contiguous region of
-  // a texture
-  for (unsigned int i = 0; i < height; ++i)
+  // let listeners that can consume the RGBA data read it in place
+  if (this->dataPtr->newGpuRaysRawFrame.ConnectionCount() > 0u)
   {
-    unsigned int rawDataRowIdx = i * box.bytesPerRow / bytesPerChannel;
-    unsigned int rowIdx = i * width * rawChannelCount;
-    memcpy(&this->dataPtr->gpuRaysBuffer[rowIdx], &bufferTmp[rawDataRowIdx],
-        width * rawChannelCount * bytesPerChannel);
+    this->dataPtr->newGpuRaysRawFrame(bufferTmp, width, height,
+        rawChannelCount, rawRowStride, "PF_FLOAT32_RGBA");
   }
 
   // Metal does not support RGB32_FLOAT so the internal texture format is
@@ -1356,27 +1626,18 @@ void Ogre2GpuRays::PostRender()
     this->dataPtr->gpuRaysScan = new float[outputLen];
   }
 
-  // copy data from RGBA buffer to RGB buffer
+  // drop the alpha channel while copying straight out of the texture box,
+  // row by row since the texture box may not be a contiguous region of a
+  // texture
   for (unsigned int row = 0; row < height; ++row)
   {
-    // the texture box step size could be larger than our image buffer step
-    // size
-    for (unsigned int column = 0; column < width; ++column)
-    {
-      unsigned int idx = (row * width * this->Channels()) +
-          column * this->Channels();
-      unsigned int rawIdx = (row * width * rawChannelCount) +
-          column * rawChannelCount;
-
-      this->dataPtr->gpuRaysScan[idx] =
-          this->dataPtr->gpuRaysBuffer[rawIdx];
-      this->dataPtr->gpuRaysScan[idx + 1] =
-          this->dataPtr->gpuRaysBuffer[rawIdx + 1];
-      this->dataPtr->gpuRaysScan[idx + 2] =
-          this->dataPtr->gpuRaysBuffer[rawIdx + 2];
-    }
+    RgbaToRgb(&bufferTmp[row * rawRowStride],
+        &this->dataPtr->gpuRaysScan[row * width * this->Channels()], width);
   }
 
+  if (readback.Latency() > 0u)
+    readback.UnmapFrame();
+
   this->dataPtr->newGpuRaysFrame(this->dataPtr->gpuRaysScan,
       width, height, this->Channels(), "PF_FLOAT32_RGB");
 
@@ -1440,6 +1701,15 @@ common::ConnectionPtr Ogre2GpuRays::ConnectNewGpuRaysFrame(
   return this->dataPtr->newGpuRaysFrame.Connect(_subscriber);
 }
 
+//////////////////////////////////////////////////
+common::ConnectionPtr Ogre2GpuRays::ConnectNewGpuRaysRawFrame(
+    std::function<void(const float *_frame, unsigned int _width,
+    unsigned int _height, unsigned int _channels, unsigned int _rowStride,
+    const std::string &_format)> _subscriber)
+{
+  return this->dataPtr->newGpuRaysRawFrame.Connect(_subscriber);
+}
+
 //////////////////////////////////////////////////
 RenderTargetPtr Ogre2GpuRays::RenderTarget() const
 {
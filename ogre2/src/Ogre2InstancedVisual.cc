@@ -0,0 +1,418 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <gz/common/Console.hh>
+
+#include "gz/rendering/Utils.hh"
+#include "gz/rendering/ogre2/Ogre2Conversions.hh"
+#include "gz/rendering/ogre2/Ogre2InstancedVisual.hh"
+#include "gz/rendering/ogre2/Ogre2Material.hh"
+#include "gz/rendering/ogre2/Ogre2Mesh.hh"
+#include "gz/rendering/ogre2/Ogre2ParticleEmitter.hh"
+#include "gz/rendering/ogre2/Ogre2Scene.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <Hlms/Pbs/OgreHlmsPbsDatablock.h>
+#include <OgreItem.h>
+#include <OgreSceneManager.h>
+#include <OgreSceneNode.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+/// \brief Private data for the Ogre2InstancedVisual class
+class gz::rendering::Ogre2InstancedVisualPrivate
+{
+  /// \brief Mesh the instances are created from. It is never attached to
+  /// a node, its submesh materials are used by instances when the visual
+  /// has no material.
+  public: Ogre2MeshPtr prototype;
+
+  /// \brief Scene node of every instance
+  public: std::vector<Ogre::SceneNode *> nodes;
+
+  /// \brief Item of every instance
+  public: std::vector<Ogre::Item *> items;
+
+  /// \brief Materials of the instances with a color, one per submesh,
+  /// indexed by the RGBA color. Instances with the same color share them.
+  public: std::unordered_map<uint32_t, std::vector<MaterialPtr>>
+      colorMaterials;
+
+  /// \brief Visual material the datablocks were bound for
+  public: MaterialPtr boundMaterial;
+
+  /// \brief Datablock revision of boundMaterial when the color materials
+  /// were cloned from it
+  public: uint64_t boundRevision = 0u;
+};
+
+using namespace gz;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+Ogre2InstancedVisual::Ogre2InstancedVisual()
+  : dataPtr(std::make_unique<Ogre2InstancedVisualPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+Ogre2InstancedVisual::~Ogre2InstancedVisual()
+{
+}
+
+//////////////////////////////////////////////////
+void Ogre2InstancedVisual::PreRender()
+{
+  BaseInstancedVisual::PreRender();
+  this->UpdateInstances();
+}
+
+//////////////////////////////////////////////////
+void Ogre2InstancedVisual::Destroy()
+{
+  if (this->scene && this->scene->IsInitialized())
+  {
+    // items must be destroyed before the datablocks they use
+    this->DestroyInstances(0u);
+    for (auto &entry : this->dataPtr->colorMaterials)
+    {
+      for (auto &material : entry.second)
+        this->scene->DestroyMaterial(material);
+    }
+    if (this->dataPtr->prototype)
+      this->dataPtr->prototype->Destroy();
+  }
+  this->dataPtr->colorMaterials.clear();
+  this->dataPtr->prototype.reset();
+  this->dataPtr->boundMaterial.reset();
+
+  BaseInstancedVisual::Destroy();
+}
+
+//////////////////////////////////////////////////
+void Ogre2InstancedVisual::SetStatic(bool _static)
+{
+  BaseInstancedVisual::SetStatic(_static);
+
+  if (!this->ogreNode)
+    return;
+
+  for (Ogre::SceneNode *node : this->dataPtr->nodes)
+    node->setStatic(_static);
+  if (_static && !this->dataPtr->nodes.empty())
+    this->scene->OgreSceneManager()->notifyStaticDirty(this->ogreNode);
+}
+
+//////////////////////////////////////////////////
+void Ogre2InstancedVisual::SetVisibilityFlags(uint32_t _flags)
+{
+  BaseInstancedVisual::SetVisibilityFlags(_flags);
+
+  for (Ogre::Item *item : this->dataPtr->items)
+  {
+    item->setVisibilityFlags(_flags
+        & ~Ogre2ParticleEmitter::kParticleVisibilityFlags);
+  }
+}
+
+//////////////////////////////////////////////////
+math::AxisAlignedBox Ogre2InstancedVisual::BoundingBox() const
+{
+  math::AxisAlignedBox box = BaseInstancedVisual::BoundingBox();
+  this->InstancesBounds(box, this->WorldPose());
+  return box;
+}
+
+//////////////////////////////////////////////////
+math::AxisAlignedBox Ogre2InstancedVisual::LocalBoundingBox() const
+{
+  math::AxisAlignedBox box = BaseInstancedVisual::LocalBoundingBox();
+  this->InstancesBounds(box, math::Pose3d::Zero);
+  return box;
+}
+
+//////////////////////////////////////////////////
+void Ogre2InstancedVisual::InstancesBounds(math::AxisAlignedBox &_box,
+    const math::Pose3d &_pose) const
+{
+  if (!this->dataPtr->prototype || this->poses.empty())
+    return;
+
+  const Ogre::Aabb aabb = this->dataPtr->prototype->OgreObject()->
+      getLocalAabb();
+  const math::Vector3d scale = this->WorldScale();
+  const math::AxisAlignedBox meshBox(
+      scale * Ogre2Conversions::Convert(aabb.getMinimum()),
+      scale * Ogre2Conversions::Convert(aabb.getMaximum()));
+
+  for (const math::Pose3d &pose : this->poses)
+  {
+    const math::Pose3d instancePose(
+        _pose.Pos() + _pose.Rot() * (scale * pose.Pos()),
+        _pose.Rot() * pose.Rot());
+    _box.Merge(transformAxisAlignedBox(meshBox, instancePose));
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2InstancedVisual::UpdateInstances()
+{
+  Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+  bool itemsChanged = false;
+
+  if (this->meshDirty)
+  {
+    this->meshDirty = false;
+    this->DestroyInstances(0u);
+    for (auto &entry : this->dataPtr->colorMaterials)
+    {
+      for (auto &material : entry.second)
+        this->scene->DestroyMaterial(material);
+    }
+    this->dataPtr->colorMaterials.clear();
+    if (this->dataPtr->prototype)
+      this->dataPtr->prototype->Destroy();
+
+    this->dataPtr->prototype = std::dynamic_pointer_cast<Ogre2Mesh>(
+        this->scene->CreateMesh(this->descriptor));
+    if (!this->dataPtr->prototype)
+    {
+      gzerr << "Unable to create the mesh of instanced visual ["
+            << this->Name() << "]" << std::endl;
+    }
+
+    // every instance is created again below
+    itemsChanged = true;
+  }
+
+  if (!this->dataPtr->prototype)
+    return;
+
+  auto &nodes = this->dataPtr->nodes;
+  auto &items = this->dataPtr->items;
+  const std::size_t count = this->poses.size();
+
+  if (items.size() > count)
+  {
+    this->DestroyInstances(count);
+    itemsChanged = true;
+  }
+  else if (items.size() < count)
+  {
+    // the new items need their pose, datablocks and label
+    const std::size_t first = items.size();
+    MarkDirty(this->dirtyPosesBegin, this->dirtyPosesEnd, first,
+        count - first);
+    MarkDirty(this->dirtyColorsBegin, this->dirtyColorsEnd, first,
+        count - first);
+    MarkDirty(this->dirtyLabelsBegin, this->dirtyLabelsEnd, first,
+        count - first);
+
+    auto prototypeItem =
+        static_cast<Ogre::Item *>(this->dataPtr->prototype->OgreObject());
+    const Ogre::SceneMemoryMgrTypes memoryType =
+        this->ogreNode->isStatic() ? Ogre::SCENE_STATIC : Ogre::SCENE_DYNAMIC;
+    const uint32_t visibilityFlags = this->visibilityFlags &
+        ~Ogre2ParticleEmitter::kParticleVisibilityFlags;
+
+    nodes.reserve(count);
+    items.reserve(count);
+    for (std::size_t i = items.size(); i < count; ++i)
+    {
+      Ogre::SceneNode *node = this->ogreNode->createChildSceneNode(memoryType);
+      Ogre::Item *item =
+          sceneManager->createItem(prototypeItem->getMesh(), memoryType);
+      item->setName(this->Name() + "::Instance" + std::to_string(i));
+      item->setCastShadows(prototypeItem->getCastShadows());
+      item->setVisibilityFlags(visibilityFlags);
+
+      // set user data for mouse queries and sensors
+      item->getUserObjectBindings().setUserAny(Ogre::Any(this->Id()));
+      node->attachObject(item);
+
+      nodes.push_back(node);
+      items.push_back(item);
+    }
+    itemsChanged = true;
+  }
+
+  // poses
+  const std::size_t posesEnd = std::min(this->dirtyPosesEnd, count);
+  for (std::size_t i = this->dirtyPosesBegin; i < posesEnd; ++i)
+  {
+    nodes[i]->setPosition(Ogre2Conversions::Convert(this->poses[i].Pos()));
+    nodes[i]->setOrientation(Ogre2Conversions::Convert(this->poses[i].Rot()));
+  }
+  if (this->dirtyPosesBegin < posesEnd && this->ogreNode->isStatic())
+    sceneManager->notifyStaticDirty(this->ogreNode);
+  this->dirtyPosesBegin = 0u;
+  this->dirtyPosesEnd = 0u;
+
+  // materials. Color materials are clones of the visual material, so they
+  // are cloned again whenever it changes.
+  MaterialPtr material = this->Material();
+  auto derived = std::dynamic_pointer_cast<Ogre2Material>(material);
+  const uint64_t revision = derived ? derived->DatablockRevision() : 0u;
+  if (material != this->dataPtr->boundMaterial ||
+      revision != this->dataPtr->boundRevision)
+  {
+    auto oldColorMaterials = std::move(this->dataPtr->colorMaterials);
+    this->dataPtr->colorMaterials.clear();
+    this->dataPtr->boundMaterial = material;
+    this->dataPtr->boundRevision = revision;
+    this->UpdateDatablocks(0u, count);
+
+    // no item uses them anymore
+    for (auto &entry : oldColorMaterials)
+    {
+      for (auto &colorMaterial : entry.second)
+        this->scene->DestroyMaterial(colorMaterial);
+    }
+    itemsChanged = true;
+  }
+  else if (this->dirtyColorsBegin < std::min(this->dirtyColorsEnd, count))
+  {
+    this->UpdateDatablocks(this->dirtyColorsBegin,
+        std::min(this->dirtyColorsEnd, count));
+    itemsChanged = true;
+  }
+  this->dirtyColorsBegin = 0u;
+  this->dirtyColorsEnd = 0u;
+
+  // labels
+  const std::size_t labelsEnd = std::min(this->dirtyLabelsEnd, count);
+  for (std::size_t i = this->dirtyLabelsBegin; i < labelsEnd; ++i)
+  {
+    Ogre::UserObjectBindings &bindings = items[i]->getUserObjectBindings();
+    if (this->labels[i])
+      bindings.setUserAny("label", Ogre::Any(*this->labels[i]));
+    else
+      bindings.eraseUserAny("label");
+    itemsChanged = true;
+  }
+  this->dirtyLabelsBegin = 0u;
+  this->dirtyLabelsEnd = 0u;
+
+  // segmentation and thermal cameras cache per item data
+  if (itemsChanged)
+    this->scene->SetVisualsDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2InstancedVisual::UpdateDatablocks(std::size_t _begin,
+    std::size_t _end)
+{
+  Ogre2MeshPtr prototype = this->dataPtr->prototype;
+  auto prototypeItem = static_cast<Ogre::Item *>(prototype->OgreObject());
+  auto material =
+      std::dynamic_pointer_cast<Ogre2Material>(this->dataPtr->boundMaterial);
+
+  // low level material with custom shaders
+  const bool lowLevel = material && !material->VertexShader().empty() &&
+      !material->FragmentShader().empty();
+
+  for (std::size_t i = _begin; i < _end; ++i)
+  {
+    Ogre::Item *item = this->dataPtr->items[i];
+
+    // clone the materials of a color the first time it is used
+    std::vector<MaterialPtr> *colorMaterials = nullptr;
+    if (this->colors[i] && !lowLevel)
+    {
+      colorMaterials =
+          &this->dataPtr->colorMaterials[this->colors[i]->AsRGBA()];
+      if (colorMaterials->empty())
+      {
+        for (unsigned int j = 0; j < prototype->SubMeshCount(); ++j)
+        {
+          MaterialPtr base = material ? MaterialPtr(material) :
+              prototype->SubMeshByIndex(j)->Material();
+          MaterialPtr colorMaterial =
+              base ? base->Clone() : this->scene->CreateMaterial();
+          colorMaterial->SetDiffuse(*this->colors[i]);
+          colorMaterials->push_back(colorMaterial);
+        }
+      }
+    }
+
+    bool transparent = false;
+    for (size_t j = 0; j < item->getNumSubItems(); ++j)
+    {
+      Ogre::SubItem *subItem = item->getSubItem(j);
+      if (lowLevel)
+      {
+        subItem->setMaterial(material->Material());
+        continue;
+      }
+
+      Ogre::HlmsDatablock *datablock = nullptr;
+      if (colorMaterials && j < colorMaterials->size())
+      {
+        datablock = std::static_pointer_cast<Ogre2Material>(
+            (*colorMaterials)[j])->Datablock();
+      }
+      else if (material)
+      {
+        datablock = material->Datablock();
+      }
+      else
+      {
+        // the datablocks of the submesh materials, shared between
+        // identical materials
+        datablock = prototypeItem->getSubItem(j)->getDatablock();
+      }
+      subItem->setDatablock(datablock);
+
+      auto pbs = dynamic_cast<Ogre::HlmsPbsDatablock *>(datablock);
+      if (pbs && pbs->getTransparencyMode() != Ogre::HlmsPbsDatablock::None)
+        transparent = true;
+    }
+
+    // see Ogre2SubMesh::SetMaterialImpl
+    item->setRenderQueueGroup(transparent ? 200u : 10u);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2InstancedVisual::DestroyInstances(std::size_t _count)
+{
+  auto &nodes = this->dataPtr->nodes;
+  auto &items = this->dataPtr->items;
+  if (items.size() <= _count)
+    return;
+
+  Ogre::SceneManager *sceneManager = this->scene->OgreSceneManager();
+  while (items.size() > _count)
+  {
+    sceneManager->destroyItem(items.back());
+    sceneManager->destroySceneNode(nodes.back());
+    items.pop_back();
+    nodes.pop_back();
+  }
+
+  // segmentation and thermal cameras, and the scene's pending textures,
+  // may still reference the destroyed items
+  this->scene->SetVisualsDirty();
+}
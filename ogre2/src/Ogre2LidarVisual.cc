@@ -14,7 +14,6 @@
  * limitations under the License.
  *
  */
-
 #ifdef __APPLE__
   #define GL_SILENCE_DEPRECATION
   #include <OpenGL/gl.h>
@@ -25,54 +24,81 @@
 #endif
 #endif
 
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
 #include <gz/common/Console.hh>
 
 #include "gz/rendering/ogre2/Ogre2Conversions.hh"
-#include "gz/rendering/ogre2/Ogre2DynamicRenderable.hh"
 #include "gz/rendering/ogre2/Ogre2LidarVisual.hh"
 #include "gz/rendering/ogre2/Ogre2RenderEngine.hh"
 #include "gz/rendering/ogre2/Ogre2Scene.hh"
-#include "gz/rendering/ogre2/Ogre2Marker.hh"
-#include "gz/rendering/ogre2/Ogre2Geometry.hh"
 
 #ifdef _MSC_VER
   #pragma warning(push, 0)
 #endif
 #include <OgreItem.h>
 #include <OgreMaterialManager.h>
+#include <OgreMesh2.h>
+#include <OgreMeshManager2.h>
 #include <OgreRoot.h>
+#include <OgreSceneManager.h>
 #include <OgreSceneNode.h>
-#include <OgreTechnique.h>
+#include <OgreSubMesh2.h>
+#include <Vao/OgreIndexBufferPacked.h>
+#include <Vao/OgreVaoManager.h>
+#include <Vao/OgreVertexArrayObject.h>
 #ifdef _MSC_VER
   #pragma warning(pop)
 #endif
 
-class gz::rendering::Ogre2LidarVisualPrivate
+namespace
 {
-  /// \brief Non Hitting DynamicLines Object to display
-  public: std::vector<std::shared_ptr<Ogre2DynamicRenderable>> noHitRayStrips;
+/// \brief Primitives drawn from the vertex buffers of a lidar visual
+enum LidarPrimitive
+{
+  /// \brief Line from the min range to the end of each ray
+  LP_RAYS = 0,
+
+  /// \brief Triangles between neighbour rays, up to where they hit
+  LP_HIT_STRIPS,
 
-  /// \brief Hitting DynamicLines Object to display
-  public: std::vector<std::shared_ptr<Ogre2DynamicRenderable>> rayStrips;
+  /// \brief Triangles between neighbour rays, up to the max range for
+  /// rays that hit nothing
+  LP_NO_HIT_STRIPS,
 
-  /// \brief Dead Zone Geometry DynamicLines Object to display
-  public: std::vector<std::shared_ptr<Ogre2DynamicRenderable>> deadZoneRayFans;
+  /// \brief Triangles between the origin and the min range of the rays
+  LP_DEAD_ZONE,
 
-  /// \brief Lidar Ray DynamicLines Object to display
-  public: std::vector<std::shared_ptr<Ogre2DynamicRenderable>> rayLines;
+  /// \brief Point at the end of each ray
+  LP_POINTS,
 
-  /// \brief Lidar Points DynamicLines Object to display
-  public: std::vector<std::shared_ptr<Ogre2DynamicRenderable>> points;
+  /// \brief Number of primitives
+  LP_COUNT
+};
 
-  /// \brief Lidar visual type
+/// \brief Custom parameter of the sub items with the color
+const size_t kColorParam = 20u;
+
+/// \brief Custom parameter of the sub items with the origin of the rays
+/// and what to draw for rays that hit nothing
+const size_t kOriginParam = 21u;
+
+/// \brief Custom parameter of the sub items with the min range, max range
+/// and point size
+const size_t kRangeParam = 22u;
+}
+
+class gz::rendering::Ogre2LidarVisualPrivate
+{
+  /// \brief Lidar visual type the ogre items were created for
   public: LidarVisualType lidarVisType =
             LidarVisualType::LVT_TRIANGLE_STRIPS;
 
-  /// \brief Current value of DisplayNonHitting parameter
-  public: bool currentDisplayNonHitting = true;
-
   /// \brief The current lidar points data
-  public: std::vector<double> lidarPoints;
+  public: std::vector<float> lidarPoints;
 
   /// \brief True if new points data is received
   public: bool receivedData = false;
@@ -80,9 +106,28 @@ class gz::rendering::Ogre2LidarVisualPrivate
   /// \brief The visibility of the visual
   public: bool visible = true;
 
-  /// \brief Pointer to point cloud material.
-  /// Used when LidarVisualType = LVT_POINTS.
-  public: Ogre::MaterialPtr pointsMat;
+  /// \brief Ray counts, angles and rotation the buffers were created for
+  public: std::vector<double> layout;
+
+  /// \brief Direction of the ray of each vertex, and which point of the
+  /// ray the vertex is
+  public: Ogre::VertexBufferPacked *directionBuffer = nullptr;
+
+  /// \brief Range of the ray of each vertex, uploaded on every update
+  public: Ogre::VertexBufferPacked *rangeBuffer = nullptr;
+
+  /// \brief Index buffers shared by the vertex array objects
+  public: std::vector<Ogre::IndexBufferPacked *> indexBuffers;
+
+  /// \brief Vertex array object of each primitive, null if there are not
+  /// enough rays to draw it
+  public: std::array<Ogre::VertexArrayObject *, LP_COUNT> vaos{};
+
+  /// \brief Mesh of each primitive
+  public: std::array<Ogre::MeshPtr, LP_COUNT> meshes;
+
+  /// \brief Ogre item of each primitive shown by the current type
+  public: std::array<Ogre::Item *, LP_COUNT> items{};
 };
 
 using namespace gz;
@@ -109,39 +154,9 @@ void Ogre2LidarVisual::PreRender()
 //////////////////////////////////////////////////
 void Ogre2LidarVisual::Destroy()
 {
+  this->DestroyBuffers();
   BaseLidarVisual::Destroy();
-  for (auto ray : this->dataPtr->noHitRayStrips)
-  {
-    ray->Clear();
-    ray.reset();
-  }
-
-  for (auto ray : this->dataPtr->rayStrips)
-  {
-    ray->Clear();
-    ray.reset();
-  }
-
-  for (auto ray : this->dataPtr->rayLines)
-  {
-    ray->Clear();
-    ray.reset();
-  }
-
-  for (auto ray : this->dataPtr->deadZoneRayFans)
-  {
-    ray->Clear();
-    ray.reset();
-  }
-
-  for (auto ray : this->dataPtr->points)
-  {
-    ray->Clear();
-    ray.reset();
-  }
-
   this->dataPtr->lidarPoints.clear();
-  this->dataPtr->pointsMat.setNull();
 }
 
 //////////////////////////////////////////////////
@@ -168,9 +183,6 @@ void Ogre2LidarVisual::Create()
 #endif
 #endif
   }
-  this->dataPtr->pointsMat =
-      Ogre::MaterialManager::getSingleton().getByName(
-      "PointCloudPoint");
 
   this->ClearPoints();
   this->dataPtr->receivedData = false;
@@ -187,60 +199,271 @@ void Ogre2LidarVisual::ClearPoints()
 //////////////////////////////////////////////////
 void Ogre2LidarVisual::ClearVisualData()
 {
-  this->dataPtr->noHitRayStrips.clear();
-  this->dataPtr->deadZoneRayFans.clear();
-  this->dataPtr->rayLines.clear();
-  this->dataPtr->rayStrips.clear();
-  this->dataPtr->points.clear();
+  bool destroyed = false;
+  for (Ogre::Item *&item : this->dataPtr->items)
+  {
+    if (!item)
+      continue;
+
+    this->ogreNode->detachObject(item);
+    this->scene->OgreSceneManager()->destroyItem(item);
+    item = nullptr;
+    destroyed = true;
+  }
+
+  if (destroyed)
+    this->scene->SetVisualsDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2LidarVisual::DestroyBuffers()
+{
+  if (!this->scene || !this->scene->OgreSceneManager())
+    return;
+
+  this->ClearVisualData();
+
+  // the vertex array objects share their buffers, so they are destroyed
+  // here instead of by the meshes
+  for (Ogre::MeshPtr &mesh : this->dataPtr->meshes)
+  {
+    if (mesh.isNull())
+      continue;
+
+    Ogre::SubMesh *subMesh = mesh->getSubMesh(0);
+    subMesh->mVao[Ogre::VpNormal].clear();
+    subMesh->mVao[Ogre::VpShadow].clear();
+    Ogre::MeshManager::getSingleton().remove(mesh->getName());
+    mesh.setNull();
+  }
+
+  Ogre::VaoManager *vaoManager = this->scene->OgreSceneManager()->
+      getDestinationRenderSystem()->getVaoManager();
+  if (!vaoManager)
+    return;
+
+  for (Ogre::VertexArrayObject *&vao : this->dataPtr->vaos)
+  {
+    if (vao)
+      vaoManager->destroyVertexArrayObject(vao);
+    vao = nullptr;
+  }
+
+  for (Ogre::IndexBufferPacked *indexBuffer : this->dataPtr->indexBuffers)
+    vaoManager->destroyIndexBuffer(indexBuffer);
+  this->dataPtr->indexBuffers.clear();
+
+  if (this->dataPtr->directionBuffer)
+  {
+    vaoManager->destroyVertexBuffer(this->dataPtr->directionBuffer);
+    this->dataPtr->directionBuffer = nullptr;
+  }
+
+  if (this->dataPtr->rangeBuffer)
+  {
+    if (this->dataPtr->rangeBuffer->getMappingState() != Ogre::MS_UNMAPPED)
+      this->dataPtr->rangeBuffer->unmap(Ogre::UO_UNMAP_ALL);
+    vaoManager->destroyVertexBuffer(this->dataPtr->rangeBuffer);
+    this->dataPtr->rangeBuffer = nullptr;
+  }
+
+  this->dataPtr->layout.clear();
 }
 
 //////////////////////////////////////////////////
 void Ogre2LidarVisual::SetPoints(const std::vector<double> &_points)
 {
-  this->dataPtr->lidarPoints = _points;
+  this->dataPtr->lidarPoints.assign(_points.begin(), _points.end());
   this->dataPtr->receivedData = true;
 }
 
 //////////////////////////////////////////////////
-void Ogre2LidarVisual::Update()
+void Ogre2LidarVisual::SetPoints(const float *_points, unsigned int _count,
+    unsigned int _stride)
 {
-  if (this->lidarVisualType == LidarVisualType::LVT_NONE)
+  if (_count > 0u && !_points)
   {
-    this->ClearVisualData();
+    gzerr << "Unable to set [" << _count << "] lidar points from null data"
+          << std::endl;
     return;
   }
 
-  if (!this->dataPtr->receivedData || this->dataPtr->lidarPoints.size() == 0)
+  if (_stride <= 1u)
   {
-    gzwarn << "New lidar data not received. Exiting update function"
-            << std::endl;
+    this->dataPtr->lidarPoints.assign(_points, _points + _count);
+  }
+  else
+  {
+    this->dataPtr->lidarPoints.resize(_count);
+    for (unsigned int i = 0u; i < _count; ++i)
+      this->dataPtr->lidarPoints[i] = _points[i * _stride];
+  }
+  this->dataPtr->receivedData = true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2LidarVisual::UpdateBuffers()
+{
+  const math::Quaterniond &rot = this->offset.Rot();
+  std::vector<double> layout = {
+      static_cast<double>(this->verticalCount),
+      static_cast<double>(this->horizontalCount),
+      this->minVerticalAngle, this->verticalAngleStep,
+      this->minHorizontalAngle, this->horizontalAngleStep,
+      rot.W(), rot.X(), rot.Y(), rot.Z()};
+  if (this->dataPtr->directionBuffer && layout == this->dataPtr->layout)
     return;
+
+  this->DestroyBuffers();
+
+  Ogre::VaoManager *vaoManager = this->scene->OgreSceneManager()->
+      getDestinationRenderSystem()->getVaoManager();
+  if (!vaoManager)
+    return;
+
+  this->dataPtr->layout = layout;
+
+  // Each ray has a vertex at its start and one at its end, followed by a
+  // vertex at the origin of the rays for the dead zone.
+  const uint32_t rayCount = this->verticalCount * this->horizontalCount;
+  const uint32_t vertexCount = rayCount * 2u + 1u;
+  std::vector<float> directions(vertexCount * 4u, 0.0f);
+  double verticalAngle = this->minVerticalAngle;
+  for (unsigned int j = 0; j < this->verticalCount; ++j)
+  {
+    double horizontalAngle = this->minHorizontalAngle;
+    for (unsigned int i = 0; i < this->horizontalCount; ++i)
+    {
+      math::Quaterniond ray(
+          math::Vector3d(0.0, -verticalAngle, horizontalAngle));
+      math::Vector3d axis = rot * ray * math::Vector3d(1.0, 0.0, 0.0);
+
+      float *vertex = directions.data() +
+          (j * this->horizontalCount + i) * 8u;
+      for (unsigned int k = 0; k < 2u; ++k)
+      {
+        vertex[k*4] = static_cast<float>(axis.X());
+        vertex[k*4+1] = static_cast<float>(axis.Y());
+        vertex[k*4+2] = static_cast<float>(axis.Z());
+        vertex[k*4+3] = static_cast<float>(k);
+      }
+      horizontalAngle += this->horizontalAngleStep;
+    }
+    verticalAngle += this->verticalAngleStep;
+  }
+  directions[rayCount * 8u + 3u] = 2.0f;
+
+  Ogre::VertexElement2Vec directionElements;
+  directionElements.push_back(
+      Ogre::VertexElement2(Ogre::VET_FLOAT4, Ogre::VES_POSITION));
+  this->dataPtr->directionBuffer = vaoManager->createVertexBuffer(
+      directionElements, vertexCount, Ogre::BT_IMMUTABLE,
+      directions.data(), false);
+
+  Ogre::VertexElement2Vec rangeElements;
+  rangeElements.push_back(
+      Ogre::VertexElement2(Ogre::VET_FLOAT1, Ogre::VES_TEXTURE_COORDINATES));
+  this->dataPtr->rangeBuffer = vaoManager->createVertexBuffer(
+      rangeElements, vertexCount, Ogre::BT_DYNAMIC_PERSISTENT, nullptr,
+      false);
+
+  // indices of the points, and of the triangles between neighbour rays of
+  // the same scan
+  const uint32_t origin = rayCount * 2u;
+  std::vector<uint32_t> pointIndices(rayCount);
+  std::vector<uint32_t> stripIndices;
+  std::vector<uint32_t> deadZoneIndices;
+  for (uint32_t k = 0; k < rayCount; ++k)
+    pointIndices[k] = k * 2u + 1u;
+  for (uint32_t j = 0; j < this->verticalCount; ++j)
+  {
+    for (uint32_t i = 0; i + 1u < this->horizontalCount; ++i)
+    {
+      const uint32_t start = (j * this->horizontalCount + i) * 2u;
+      const uint32_t end = start + 1u;
+      const uint32_t nextStart = start + 2u;
+      const uint32_t nextEnd = start + 3u;
+      stripIndices.insert(stripIndices.end(),
+          {start, end, nextStart, end, nextEnd, nextStart});
+      deadZoneIndices.insert(deadZoneIndices.end(),
+          {origin, start, nextStart});
+    }
   }
 
-  bool clearVisuals = false;
+  auto createIndexBuffer = [&](std::vector<uint32_t> &_indices)
+  {
+    Ogre::IndexBufferPacked *indexBuffer = vaoManager->createIndexBuffer(
+        Ogre::IndexBufferPacked::IT_32BIT, _indices.size(),
+        Ogre::BT_IMMUTABLE, _indices.data(), false);
+    this->dataPtr->indexBuffers.push_back(indexBuffer);
+    return indexBuffer;
+  };
+
+  auto createVao = [&](LidarPrimitive _primitive,
+      Ogre::IndexBufferPacked *_indexBuffer, Ogre::OperationType _opType)
+  {
+    Ogre::VertexBufferPackedVec vertexBuffers;
+    vertexBuffers.push_back(this->dataPtr->directionBuffer);
+    vertexBuffers.push_back(this->dataPtr->rangeBuffer);
+    this->dataPtr->vaos[_primitive] = vaoManager->createVertexArrayObject(
+        vertexBuffers, _indexBuffer, _opType);
+  };
+
+  createVao(LP_RAYS, nullptr, Ogre::OperationType::OT_LINE_LIST);
+  this->dataPtr->vaos[LP_RAYS]->setPrimitiveRange(0u, rayCount * 2u);
+  createVao(LP_POINTS, createIndexBuffer(pointIndices),
+      Ogre::OperationType::OT_POINT_LIST);
+  if (!stripIndices.empty())
+  {
+    Ogre::IndexBufferPacked *stripBuffer = createIndexBuffer(stripIndices);
+    createVao(LP_HIT_STRIPS, stripBuffer,
+        Ogre::OperationType::OT_TRIANGLE_LIST);
+    createVao(LP_NO_HIT_STRIPS, stripBuffer,
+        Ogre::OperationType::OT_TRIANGLE_LIST);
+    createVao(LP_DEAD_ZONE, createIndexBuffer(deadZoneIndices),
+        Ogre::OperationType::OT_TRIANGLE_LIST);
+  }
+
+  static int lidarMeshId = 0;
+  for (unsigned int p = 0; p < LP_COUNT; ++p)
+  {
+    if (!this->dataPtr->vaos[p])
+      continue;
+
+    Ogre::MeshPtr mesh = Ogre::MeshManager::getSingleton().createManual(
+        "lidar_visual_" + std::to_string(lidarMeshId++),
+        Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    Ogre::SubMesh *subMesh = mesh->createSubMesh();
+    subMesh->mVao[Ogre::VpNormal].push_back(this->dataPtr->vaos[p]);
+    subMesh->mVao[Ogre::VpShadow].push_back(this->dataPtr->vaos[p]);
+    this->dataPtr->meshes[p] = mesh;
+  }
+}
 
-  if (this->lidarVisualType != this->dataPtr->lidarVisType
-        || !this->displayNonHitting)
+//////////////////////////////////////////////////
+void Ogre2LidarVisual::Update()
+{
+  if (this->lidarVisualType == LidarVisualType::LVT_NONE)
   {
-    clearVisuals = true;
+    this->ClearVisualData();
+    return;
   }
 
-  if (this->displayNonHitting != this->dataPtr->currentDisplayNonHitting)
+  if (!this->dataPtr->receivedData || this->dataPtr->lidarPoints.size() == 0)
   {
-    clearVisuals = true;
-    this->dataPtr->currentDisplayNonHitting = this->displayNonHitting;
+    gzwarn << "New lidar data not received. Exiting update function"
+            << std::endl;
+    return;
   }
 
-  // if visual type is changed, clear all DynamicLines
-  if (clearVisuals)
+  // if visual type is changed, clear all items
+  if (this->lidarVisualType != this->dataPtr->lidarVisType)
   {
     this->ClearVisualData();
   }
   this->dataPtr->lidarVisType = this->lidarVisualType;
 
   this->dataPtr->receivedData = false;
-  double horizontalAngle = this->minHorizontalAngle;
-  double verticalAngle = this->minVerticalAngle;
 
   if (this->horizontalCount > 1)
   {
@@ -265,241 +488,96 @@ void Ogre2LidarVisual::Update()
     return;
   }
 
-  // Process each point from received data
-  // Every line segment, and every triangle is saved separately,
-  // as a pointer to a DynamicLine
-  // This initializes and updates only the selected DynamicLine variables
-  for (unsigned int j = 0; j < this->verticalCount; ++j)
-  {
-    horizontalAngle = this->minHorizontalAngle;
-
-    if (this->dataPtr->lidarVisType == LidarVisualType::LVT_RAY_LINES ||
-        this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS)
-    {
-      if (j+1 > this->dataPtr->rayLines.size())
-      {
-        std::shared_ptr<Ogre2DynamicRenderable> renderable =
-                        std::shared_ptr<Ogre2DynamicRenderable>(
-                                    new Ogre2DynamicRenderable(this->Scene()));
-
-        renderable->SetOperationType(MT_LINE_LIST);
-        MaterialPtr mat = this->Scene()->Material("Lidar/BlueRay");
-        renderable->SetMaterial(mat, false);
-
-        this->ogreNode->attachObject(renderable->OgreObject());
-        this->dataPtr->rayLines.push_back(renderable);
-
-        if (this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS)
-        {
-          renderable = std::shared_ptr<Ogre2DynamicRenderable>(
-                                  new Ogre2DynamicRenderable(this->Scene()));
-
-          renderable->SetOperationType(MT_TRIANGLE_STRIP);
-          mat = this->Scene()->Material("Lidar/LightBlueStrips");
-
-          renderable->SetMaterial(mat, false);
-
-          this->ogreNode->attachObject(renderable->OgreObject());
-          this->dataPtr->noHitRayStrips.push_back(renderable);
-
-          renderable = std::shared_ptr<Ogre2DynamicRenderable>(
-                                  new Ogre2DynamicRenderable(this->Scene()));
-
-          renderable->SetOperationType(MT_TRIANGLE_FAN);
-          mat = this->Scene()->Material("Lidar/TransBlack");
-
-          renderable->SetMaterial(mat, false);
-
-          this->ogreNode->attachObject(renderable->OgreObject());
-          this->dataPtr->deadZoneRayFans.push_back(renderable);
-          this->dataPtr->deadZoneRayFans[j]->AddPoint(
-                      gz::math::Vector3d::Zero);
-
-          renderable = std::shared_ptr<Ogre2DynamicRenderable>(
-                                  new Ogre2DynamicRenderable(this->Scene()));
-
-          renderable->SetOperationType(MT_TRIANGLE_STRIP);
-          mat = this->Scene()->Material("Lidar/BlueStrips");
-
-          renderable->SetMaterial(mat, false);
-
-          this->ogreNode->attachObject(renderable->OgreObject());
-          this->dataPtr->rayStrips.push_back(renderable);
-        }
-      }
-    }
-
-    else if (this->dataPtr->lidarVisType ==
-                  LidarVisualType::LVT_POINTS)
-    {
-      if (j+1 > this->dataPtr->points.size())
-      {
-        std::shared_ptr<Ogre2DynamicRenderable> renderable =
-                        std::shared_ptr<Ogre2DynamicRenderable>(
-                                    new Ogre2DynamicRenderable(this->Scene()));
-
-        renderable->SetOperationType(MT_POINTS);
-
-        // use low level programmable material so we can customize point size
-        Ogre::Item *item = dynamic_cast<Ogre::Item *>(renderable->OgreObject());
-        item->setCastShadows(false);
-        item->getSubItem(0)->setMaterial(this->dataPtr->pointsMat);
-
-        this->ogreNode->attachObject(renderable->OgreObject());
-        this->dataPtr->points.push_back(renderable);
-      }
-    }
+  this->UpdateBuffers();
+  if (!this->dataPtr->rangeBuffer)
+    return;
 
-    if (this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS)
+  // Upload the range of each ray to both of its vertices. The points, rays
+  // and triangles are built from them in the vertex shader.
+  const size_t rayCount = this->dataPtr->lidarPoints.size();
+  float * RESTRICT_ALIAS ranges = reinterpret_cast<float * RESTRICT_ALIAS>(
+      this->dataPtr->rangeBuffer->map(
+      0, this->dataPtr->rangeBuffer->getNumElements()));
+  for (size_t k = 0; k < rayCount; ++k)
+  {
+    ranges[k*2] = this->dataPtr->lidarPoints[k];
+    ranges[k*2+1] = this->dataPtr->lidarPoints[k];
+  }
+  ranges[rayCount*2] = 0.0f;
+  this->dataPtr->rangeBuffer->unmap(Ogre::UO_KEEP_PERSISTENT);
+
+  // What to draw at the end of a ray that hit nothing, see
+  // lidar_visual_vs.glsl: the start of the ray, the max range or nothing
+  const float noHitEnd = this->displayNonHitting ? 1.0f : 0.0f;
+  const float noHitPoint = this->displayNonHitting ? 1.0f : 2.0f;
+
+  const std::array<const char *, LP_COUNT> materialNames = {
+      "Lidar/BlueRay", "Lidar/BlueStrips", "Lidar/LightBlueStrips",
+      "Lidar/TransBlack", "Lidar/BlueRay"};
+  const std::array<float, LP_COUNT> noHitModes = {
+      noHitEnd, 0.0f, noHitEnd, 0.0f, noHitPoint};
+
+  const Ogre::Vector3 origin = Ogre2Conversions::Convert(this->offset.Pos());
+  const Ogre::Vector4 rangeParam(
+      static_cast<float>(this->minRange), static_cast<float>(this->maxRange),
+      static_cast<float>(this->size), 0.0f);
+  const Ogre::Aabb bounds(origin,
+      Ogre::Vector3(static_cast<float>(this->maxRange)));
+
+  for (unsigned int p = 0; p < LP_COUNT; ++p)
+  {
+    bool shown = false;
+    switch (this->dataPtr->lidarVisType)
     {
-      this->dataPtr->deadZoneRayFans[j]->SetPoint(0, this->offset.Pos());
+      case LidarVisualType::LVT_RAY_LINES:
+        shown = p == LP_RAYS;
+        break;
+      case LidarVisualType::LVT_TRIANGLE_STRIPS:
+        shown = p != LP_POINTS;
+        break;
+      case LidarVisualType::LVT_POINTS:
+        shown = p == LP_POINTS;
+        break;
+      default:
+        break;
     }
+    if (!shown || this->dataPtr->meshes[p].isNull())
+      continue;
 
-    auto pointMat = this->Scene()->Material("Lidar/BlueRay");
-
-    unsigned count = this->horizontalCount;
-    // Process each ray in current scan
-    for (unsigned int i = 0; i < count; ++i)
+    Ogre::Item *&item = this->dataPtr->items[p];
+    if (!item)
     {
-      // calculate range of the ray
-      double r = this->dataPtr->lidarPoints[ j * this->horizontalCount + i];
-
-      bool inf = (std::isinf(r) || r >= this->maxRange);
-      gz::math::Quaterniond ray(
-        gz::math::Vector3d(0.0, -verticalAngle, horizontalAngle));
-
-      gz::math::Vector3d axis = this->offset.Rot() * ray *
-        gz::math::Vector3d(1.0, 0.0, 0.0);
-
-      // Check for infinite range, which indicates the ray did not
-      // intersect an object.
-      double hitRange = inf ? 0 : r;
-
-      // Compute the start point of the ray
-      gz::math::Vector3d startPt =
-                  (axis * this->minRange) + this->offset.Pos();
-
-      // Compute the end point of the ray
-      gz::math::Vector3d pt =
-                  (axis * hitRange) + this->offset.Pos();
-
-      double noHitRange = inf ? this->maxRange : hitRange;
-
-      // Compute the end point of the no-hit ray
-      gz::math::Vector3d noHitPt =
-                  (axis * noHitRange) + this->offset.Pos();
-
-      // Update the lines and strips that represent each simulated ray.
-
-      // For TRIANGLE_STRIPS Lidar Visual to be displayed
-      if (this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS
-        || this->dataPtr->lidarVisType == LidarVisualType::LVT_RAY_LINES)
-      {
-        if (i >= this->dataPtr->rayLines[j]->PointCount()/2)
-        {
-          if (this->displayNonHitting || !inf)
-          {
-            this->dataPtr->rayLines[j]->AddPoint(startPt);
-            this->dataPtr->rayLines[j]->AddPoint(inf ? noHitPt: pt);
-          }
-
-          if (this->dataPtr->lidarVisType ==
-                LidarVisualType::LVT_TRIANGLE_STRIPS)
-          {
-            this->dataPtr->rayStrips[j]->AddPoint(startPt);
-            this->dataPtr->rayStrips[j]->AddPoint(inf ? startPt : pt);
-
-            this->dataPtr->noHitRayStrips[j]->AddPoint(startPt);
-            this->dataPtr->noHitRayStrips[j]->AddPoint(
-                inf ? (this->displayNonHitting? noHitPt: startPt) : pt);
-          }
-        }
-        else
-        {
-          if (this->displayNonHitting || !inf)
-          {
-            this->dataPtr->rayLines[j]->SetPoint(i*2, startPt);
-            this->dataPtr->rayLines[j]->SetPoint(i*2+1, inf ? noHitPt: pt);
-          }
-
-          if (this->dataPtr->lidarVisType ==
-                LidarVisualType::LVT_TRIANGLE_STRIPS)
-          {
-            this->dataPtr->rayStrips[j]->SetPoint(i*2, startPt);
-            this->dataPtr->rayStrips[j]->SetPoint(i*2+1, inf? startPt : pt);
-
-            this->dataPtr->noHitRayStrips[j]->SetPoint(i*2, startPt);
-            this->dataPtr->noHitRayStrips[j]->SetPoint(i*2+1,
-                inf ? (this->displayNonHitting? noHitPt: startPt) : pt);
-          }
-        }
-        if (this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS)
-        {
-          // Draw the triangle fan that indicates the dead zone.
-          if (i+1 >= this->dataPtr->deadZoneRayFans[j]->PointCount())
-            this->dataPtr->deadZoneRayFans[j]->AddPoint(startPt);
-          else
-            this->dataPtr->deadZoneRayFans[j]->SetPoint(i+1, startPt);
-        }
-      }
-
-      // For POINTS Lidar Visual to be displayed
-      else if (this->dataPtr->lidarVisType ==
-                LidarVisualType::LVT_POINTS)
-      {
-        if (i >= this->dataPtr->points[j]->PointCount())
-        {
-          if (this->displayNonHitting || !inf)
-          {
-            this->dataPtr->points[j]->AddPoint(inf ? noHitPt : pt,
-                pointMat->Diffuse());
-          }
-        }
-        else
-        {
-          if (this->displayNonHitting || !inf)
-          {
-            this->dataPtr->points[j]->SetPoint(i, inf ? noHitPt : pt);
-            this->dataPtr->points[j]->SetColor(i, pointMat->Diffuse());
-          }
-        }
-      }
-      horizontalAngle += this->horizontalAngleStep;
+      const bool strips = p == LP_HIT_STRIPS || p == LP_NO_HIT_STRIPS ||
+          p == LP_DEAD_ZONE;
+      item = this->scene->OgreSceneManager()->createItem(
+          this->dataPtr->meshes[p], Ogre::SCENE_DYNAMIC);
+      item->setCastShadows(false);
+      item->getSubItem(0)->setMaterial(
+          Ogre::MaterialManager::getSingleton().getByName(
+          strips ? "LidarVisual/Strips" : "LidarVisual/Rays"));
+      this->ogreNode->attachObject(item);
+      this->scene->SetVisualsDirty();
     }
 
-    // Update the DynamicLines pointers after adding points based on type
-    if (this->dataPtr->lidarVisType == LidarVisualType::LVT_TRIANGLE_STRIPS
-      || this->dataPtr->lidarVisType == LidarVisualType::LVT_RAY_LINES)
-    {
-      this->dataPtr->rayLines[j]->Update();
-      if (this->dataPtr->lidarVisType ==
-                      LidarVisualType::LVT_TRIANGLE_STRIPS)
-      {
-        this->dataPtr->rayStrips[j]->Update();
-        this->dataPtr->noHitRayStrips[j]->Update();
-        this->dataPtr->deadZoneRayFans[j]->Update();
-      }
-    }
-    else if (this->dataPtr->lidarVisType == LidarVisualType::LVT_POINTS)
+    Ogre::Vector4 color(1.0f, 1.0f, 1.0f, 1.0f);
+    MaterialPtr mat = this->Scene()->Material(materialNames[p]);
+    if (mat)
     {
-      this->dataPtr->points[j]->Update();
+      color = Ogre::Vector4(mat->Diffuse().R(), mat->Diffuse().G(),
+          mat->Diffuse().B(), 1.0f - static_cast<float>(mat->Transparency()));
     }
-    verticalAngle += this->verticalAngleStep;
-  }
 
-  if (this->dataPtr->lidarVisType == LidarVisualType::LVT_POINTS &&
-      !this->dataPtr->points.empty())
-  {
-    // point renderables use low level materials
-    // get the material and set size uniform variable
-    auto pass = this->dataPtr->pointsMat->getTechnique(0)->getPass(0);
-    auto vertParams = pass->getVertexProgramParameters();
-    vertParams->setNamedConstant("size", static_cast<Ogre::Real>(this->size));
+    Ogre::SubItem *subItem = item->getSubItem(0);
+    subItem->setCustomParameter(kColorParam, color);
+    subItem->setCustomParameter(kOriginParam,
+        Ogre::Vector4(origin.x, origin.y, origin.z, noHitModes[p]));
+    subItem->setCustomParameter(kRangeParam, rangeParam);
+    item->setLocalAabb(bounds);
   }
 
-  // The newly created dynamic lines are having default visibility as true.
+  // The newly created items are having default visibility as true.
   // The visibility needs to be set as per the current value after the new
-  // renderables are created.
+  // items are created.
   this->SetVisible(this->dataPtr->visible);
 }
 
@@ -512,7 +590,8 @@ unsigned int Ogre2LidarVisual::PointCount() const
 //////////////////////////////////////////////////
 std::vector<double> Ogre2LidarVisual::Points() const
 {
-  return this->dataPtr->lidarPoints;
+  return std::vector<double>(this->dataPtr->lidarPoints.begin(),
+      this->dataPtr->lidarPoints.end());
 }
 
 //////////////////////////////////////////////////
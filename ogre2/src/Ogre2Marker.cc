@@ -110,6 +110,7 @@ void Ogre2Marker::PreRender()
           Ogre::MaterialManager::getSingleton().getByName(
           "PointCloudPoint");
       item->getSubItem(0)->setMaterial(pointsMat);
+      this->scene->SetVisualsDirty();
     }
 
     // point renderables use low level materials
@@ -292,6 +293,18 @@ void Ogre2Marker::SetPoint(unsigned int _index,
   this->dataPtr->dynamicRenderable->SetPoint(_index, _value);
 }
 
+//////////////////////////////////////////////////
+unsigned int Ogre2Marker::PointCount() const
+{
+  return this->dataPtr->dynamicRenderable->PointCount();
+}
+
+//////////////////////////////////////////////////
+math::Vector3d Ogre2Marker::Point(unsigned int _index) const
+{
+  return this->dataPtr->dynamicRenderable->Point(_index);
+}
+
 //////////////////////////////////////////////////
 void Ogre2Marker::AddPoint(const math::Vector3d &_pt,
     const math::Color &_color)
@@ -300,6 +313,21 @@ void Ogre2Marker::AddPoint(const math::Vector3d &_pt,
   this->dataPtr->dynamicRenderable->AddPoint(_pt, _color);
 }
 
+//////////////////////////////////////////////////
+void Ogre2Marker::SetPoints(const float *_xyz, const uint32_t *_rgba,
+    std::size_t _count)
+{
+  this->dataPtr->dynamicRenderable->SetPoints(_xyz, _rgba, _count);
+}
+
+//////////////////////////////////////////////////
+void Ogre2Marker::UpdatePoints(std::size_t _offset, const float *_xyz,
+    const uint32_t *_rgba, std::size_t _count)
+{
+  this->dataPtr->dynamicRenderable->UpdatePoints(_offset, _xyz, _rgba,
+      _count);
+}
+
 //////////////////////////////////////////////////
 void Ogre2Marker::ClearPoints()
 {
@@ -113,6 +113,13 @@ class gz::rendering::Ogre2MaterialPrivate
   /// Used in ogreSolidColorMat
   public: Ogre::HighLevelGpuProgramPtr ogreSolidColorShader;
 
+  /// \brief See Ogre2Material::DatablockRevision
+  public: uint64_t datablockRevision = 0u;
+
+  /// \brief True if a submesh renders this material through a shared
+  /// datablock. Cleared on the first modification after that.
+  public: bool datablockShared = false;
+
   /// \brief Returns the shader language code.
   /// \param[in] _graphicsAPI The graphic API.
   /// \return The shader language code string.
@@ -308,6 +315,7 @@ void Ogre2Material::SetSpecular(const math::Color &_color)
 {
   this->ogreDatablock->setSpecular(
       Ogre::Vector3(_color.R(), _color.G(), _color.B()));
+  this->DatablockChanged();
 }
 
 //////////////////////////////////////////////////
@@ -323,6 +331,7 @@ void Ogre2Material::SetEmissive(const math::Color &_color)
 {
   this->ogreDatablock->setEmissive(
       Ogre::Vector3(_color.R(), _color.G(), _color.B()));
+  this->DatablockChanged();
 }
 
 //////////////////////////////////////////////////
@@ -344,6 +353,7 @@ void Ogre2Material::UpdateTransparency()
 
   // from ogre documentation: 0 = full transparency and 1 = fully opaque
   this->ogreDatablock->setTransparency(opacity, mode);
+  this->DatablockChanged();
 
   // set transparent objects to be in a higher render queue group
   // so they blend properly with heightmaps (render queue 11)
@@ -388,6 +398,7 @@ void Ogre2Material::SetAlphaFromTexture(bool _enabled,
   }
   this->ogreDatablock->setAlphaTestThreshold(_alpha);
   this->ogreDatablock->setTwoSidedLighting(_twoSided);
+  this->DatablockChanged();
 }
 
 //////////////////////////////////////////////////
@@ -421,6 +432,7 @@ void Ogre2Material::SetRenderOrder(const float _renderOrder)
     macroblock.mDepthBiasConstant = _renderOrder;
   }
   this->ogreDatablock->setMacroblock(macroblock);
+  this->DatablockChanged();
 }
 
 //////////////////////////////////////////////////
@@ -433,6 +445,7 @@ bool Ogre2Material::ReceiveShadows() const
 void Ogre2Material::SetReceiveShadows(const bool _receiveShadows)
 {
   this->ogreDatablock->setReceiveShadows(_receiveShadows);
+  this->DatablockChanged();
 }
 
 //////////////////////////////////////////////////
@@ -476,6 +489,7 @@ void Ogre2Material::ClearTexture()
   this->textureName = "";
   this->dataPtr->textureData = nullptr;
   this->ogreDatablock->setTexture(Ogre::PBSM_DIFFUSE, this->textureName);
+  this->DatablockChanged();
 }
 
 //////////////////////////////////////////////////
@@ -520,6 +534,7 @@ void Ogre2Material::ClearNormalMap()
   this->normalMapName = "";
   this->dataPtr->normalMapData = nullptr;
   this->ogreDatablock->setTexture(Ogre::PBSM_NORMAL, this->normalMapName);
+  this->DatablockChanged();
 }
 
 //////////////////////////////////////////////////
@@ -569,6 +584,7 @@ void Ogre2Material::ClearRoughnessMap()
   this->roughnessMapName = "";
   this->dataPtr->roughnessMapData = nullptr;
   this->ogreDatablock->setTexture(Ogre::PBSM_ROUGHNESS, this->roughnessMapName);
+  this->DatablockChanged();
 }
 
 //////////////////////////////////////////////////
@@ -618,6 +634,7 @@ void Ogre2Material::ClearMetalnessMap()
   this->metalnessMapName = "";
   this->dataPtr->metalnessMapData = nullptr;
   this->ogreDatablock->setTexture(Ogre::PBSM_METALLIC, this->metalnessMapName);
+  this->DatablockChanged();
 }
 
 //////////////////////////////////////////////////
@@ -669,6 +686,7 @@ void Ogre2Material::ClearEnvironmentMap()
   this->dataPtr->environmentMapData = nullptr;
   this->ogreDatablock->setTexture(
     Ogre::PBSM_REFLECTION, this->environmentMapName);
+  this->DatablockChanged();
 }
 
 //////////////////////////////////////////////////
@@ -718,6 +736,7 @@ void Ogre2Material::ClearEmissiveMap()
   this->emissiveMapName = "";
   this->dataPtr->emissiveMapData = nullptr;
   this->ogreDatablock->setTexture(Ogre::PBSM_EMISSIVE, this->emissiveMapName);
+  this->DatablockChanged();
 }
 
 //////////////////////////////////////////////////
@@ -769,6 +788,7 @@ void Ogre2Material::SetLightMap(const std::string &_name,
     this->SetTextureMapDataImpl(this->lightMapName, _img, type);
   this->ogreDatablock->setTextureUvSource(type, this->lightMapUvSet);
   this->ogreDatablock->setUseEmissiveAsLightmap(true);
+  this->DatablockChanged();
 }
 
 //////////////////////////////////////////////////
@@ -788,12 +808,14 @@ void Ogre2Material::ClearLightMap()
   if (this->ogreDatablock->getUseEmissiveAsLightmap())
     this->ogreDatablock->setTexture(Ogre::PBSM_EMISSIVE, this->lightMapName);
   this->ogreDatablock->setUseEmissiveAsLightmap(false);
+  this->DatablockChanged();
 }
 
 //////////////////////////////////////////////////
 void Ogre2Material::SetRoughness(const float _roughness)
 {
   this->ogreDatablock->setRoughness(_roughness);
+  this->DatablockChanged();
 }
 
 //////////////////////////////////////////////////
@@ -806,6 +828,7 @@ float Ogre2Material::Roughness() const
 void Ogre2Material::SetMetalness(const float _metalness)
 {
   this->ogreDatablock->setMetalness(_metalness);
+  this->DatablockChanged();
 }
 
 //////////////////////////////////////////////////
@@ -1054,6 +1077,33 @@ Ogre::HlmsPbsDatablock *Ogre2Material::Datablock() const
   return this->ogreDatablock;
 }
 
+//////////////////////////////////////////////////
+uint64_t Ogre2Material::DatablockRevision() const
+{
+  return this->dataPtr->datablockRevision;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Material::SetDatablockShared()
+{
+  this->dataPtr->datablockShared = true;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Material::DatablockChanged()
+{
+  ++this->dataPtr->datablockRevision;
+  this->scene->SetTexturesDirty();
+
+  // Submeshes sharing a datablock for this material detach from it in
+  // PreRender, which is skipped for visuals that have not changed
+  if (this->dataPtr->datablockShared)
+  {
+    this->dataPtr->datablockShared = false;
+    this->scene->SetVisualsDirty();
+  }
+}
+
 //////////////////////////////////////////////////
 void Ogre2Material::SetTextureMapImpl(const std::string &_texture,
   Ogre::PbsTextureTypes _type)
@@ -1170,6 +1220,7 @@ void Ogre2Material::SetTextureMapImpl(const std::string &_texture,
   samplerBlockRef.mW = Ogre::TAM_WRAP;
 
   this->ogreDatablock->setTexture(_type, baseName, &samplerBlockRef);
+  this->DatablockChanged();
   auto tex = textureMgr->findTextureNoThrow(baseName);
 
   if (tex)
@@ -1257,6 +1308,7 @@ void Ogre2Material::SetTextureMapDataImpl(const std::string& _name,
   samplerBlockRef.mW = Ogre::TAM_WRAP;
 
   this->ogreDatablock->setTexture(_type, _name, &samplerBlockRef);
+  this->DatablockChanged();
 
   auto tex = textureMgr->findTextureNoThrow(_name);
 
@@ -1326,6 +1378,7 @@ void Ogre2Material::SetDepthCheckEnabled(bool _enabled)
       *this->ogreDatablock->getMacroblock());
   macroblock.mDepthCheck = _enabled;
   this->ogreDatablock->setMacroblock(macroblock);
+  this->DatablockChanged();
 }
 
 //////////////////////////////////////////////////
@@ -1342,6 +1395,7 @@ void Ogre2Material::SetDepthWriteEnabled(bool _enabled)
       *this->ogreDatablock->getMacroblock());
   macroblock.mDepthWrite = _enabled;
   this->ogreDatablock->setMacroblock(macroblock);
+  this->DatablockChanged();
 }
 
 //////////////////////////////////////////////////
@@ -1482,6 +1536,9 @@ void Ogre2Material::SetVertexShader(const std::string &_path)
 
   this->dataPtr->vertexShaderPath = _path;
   this->dataPtr->vertexShaderParams.reset(new ShaderParams);
+
+  // Visuals using this material now need to update its parameters
+  this->scene->SetVisualsDirty();
 }
 
 //////////////////////////////////////////////////
@@ -1550,6 +1607,9 @@ void Ogre2Material::SetFragmentShader(const std::string &_path)
   mat->load();
   this->dataPtr->fragmentShaderPath = _path;
   this->dataPtr->fragmentShaderParams.reset(new ShaderParams);
+
+  // Visuals using this material now need to update its parameters
+  this->scene->SetVisualsDirty();
 }
 
 //////////////////////////////////////////////////
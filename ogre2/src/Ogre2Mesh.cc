@@ -38,8 +38,11 @@
 #include "gz/rendering/ogre2/Ogre2Conversions.hh"
 #include "gz/rendering/ogre2/Ogre2Mesh.hh"
 #include "gz/rendering/ogre2/Ogre2Material.hh"
+#include "gz/rendering/ogre2/Ogre2Scene.hh"
 #include "gz/rendering/ogre2/Ogre2Storage.hh"
 
+#include "Ogre2MeshBvh.hh"
+
 /// brief Private implementation of the Ogre2Mesh class
 class gz::rendering::Ogre2MeshPrivate
 {
@@ -51,11 +54,44 @@ class gz::rendering::Ogre2SubMeshPrivate
   /// \brief name of the mesh inside the mesh manager to be able to
   /// remove it
   public: std::string subMeshName;
+
+  /// \brief Datablock shared with identical materials the subitem is
+  /// rendered with, or nullptr if it uses the datablock of its material
+  public: Ogre::HlmsPbsDatablock *sharedDatablock = nullptr;
+
+  /// \brief Datablock revision of the material when the shared datablock
+  /// was acquired
+  public: uint64_t sharedRevision = 0u;
 };
 
 using namespace gz;
 using namespace rendering;
 
+//////////////////////////////////////////////////
+/// \brief Render a subitem with a pbs datablock
+/// \param[in] _subItem Subitem to update
+/// \param[in] _datablock Datablock to render the subitem with
+static void BindDatablock(Ogre::SubItem *_subItem,
+    Ogre::HlmsPbsDatablock *_datablock)
+{
+  _subItem->setDatablock(_datablock);
+
+  // update render queue group based on material transparency setting
+  if (_datablock->getTransparencyMode() == Ogre::HlmsPbsDatablock::None)
+  {
+    // by default, ogre items are in render queue 10
+    // these are hardcoded in ogre-next and there does not seem to be
+    // an enum of function to retrieve this default render queue group
+    _subItem->getParent()->setRenderQueueGroup(10);
+  }
+  else
+  {
+    // put in render queue group 200
+    // v2 entities can be placed in groups 0-99 or 200-224
+    _subItem->getParent()->setRenderQueueGroup(200);
+  }
+}
+
 //////////////////////////////////////////////////
 Ogre2Mesh::Ogre2Mesh()
   : dataPtr(new Ogre2MeshPrivate)
@@ -86,6 +122,10 @@ void Ogre2Mesh::Destroy()
   auto ogreScene = std::dynamic_pointer_cast<Ogre2Scene>(this->Scene());
   ogreScene->OgreSceneManager()->destroyItem(this->ogreItem);
   this->ogreItem = nullptr;
+  // the scene may hold on to the item while its textures load, and the
+  // segmentation and thermal cameras cache its sub items
+  ogreScene->SetTexturesDirty();
+  ogreScene->SetVisualsDirty();
 
   // destroy submeshes (ogre subitems)
   this->SubMeshes()->DestroyAll();
@@ -317,6 +357,7 @@ void Ogre2SubMesh::Destroy()
       {
         if (res->getName() == this->dataPtr->subMeshName)
         {
+          Ogre2MeshBvh::Evict(this->dataPtr->subMeshName);
           Ogre::v1::MeshManager::getSingleton().remove(
             this->dataPtr->subMeshName);
           Ogre::MeshManager::getSingleton().remove(this->dataPtr->subMeshName);
@@ -326,6 +367,12 @@ void Ogre2SubMesh::Destroy()
       ++i;
     }
   }
+
+  // the ogre item is already destroyed, so only the reference is dropped
+  if (this->dataPtr->sharedDatablock && this->scene)
+    this->scene->ReleaseSharedDatablock(this->dataPtr->sharedDatablock);
+  this->dataPtr->sharedDatablock = nullptr;
+
   BaseSubMesh::Destroy();
 }
 
@@ -349,6 +396,10 @@ void Ogre2SubMesh::SetMaterialImpl(MaterialPtr _material)
     return;
   }
 
+  // released once the subitem no longer uses it
+  Ogre::HlmsPbsDatablock *prevShared = this->dataPtr->sharedDatablock;
+  this->dataPtr->sharedDatablock = nullptr;
+
   // low level material with custom shaders
   if (!derived->FragmentShader().empty() && !derived->VertexShader().empty())
   {
@@ -361,27 +412,62 @@ void Ogre2SubMesh::SetMaterialImpl(MaterialPtr _material)
         static_cast<Ogre::HlmsPbsDatablock *>(derived->Datablock());
     if (datablock)
     {
-      this->ogreSubItem->setDatablock(datablock);
-
-      // update render queue group based on material transparency setting
-      if (datablock->getTransparencyMode() == Ogre::HlmsPbsDatablock::None)
+      // Materials are cloned per visual by default. Render identical ones
+      // with the same datablock so OgreNext can batch them. The submesh
+      // switches to the datablock of its material once it is modified.
+      if (this->scene)
       {
-        // by default, ogre items are in render queue 10
-        // these are hardcoded in ogre-next and there does not seem to be
-        // an enum of function to retrieve this default render queue group
-        this->ogreSubItem->getParent()->setRenderQueueGroup(10);
-      }
-      else
-      {
-        // put in render queue group 200
-        // v2 entities can be placed in groups 0-99 or 200-224
-        this->ogreSubItem->getParent()->setRenderQueueGroup(200);
+        this->dataPtr->sharedDatablock =
+            this->scene->AcquireSharedDatablock(*derived);
+        this->dataPtr->sharedRevision = derived->DatablockRevision();
       }
+
+      BindDatablock(this->ogreSubItem, this->dataPtr->sharedDatablock ?
+          this->dataPtr->sharedDatablock : datablock);
     }
   }
 
+  if (prevShared)
+    this->scene->ReleaseSharedDatablock(prevShared);
+
   // set cast shadows
   this->ogreSubItem->getParent()->setCastShadows(_material->CastShadows());
+
+  if (this->scene)
+    this->scene->SetVisualsDirty();
+}
+
+//////////////////////////////////////////////////
+void Ogre2SubMesh::PreRender()
+{
+  if (this->dataPtr->sharedDatablock)
+  {
+    auto derived = dynamic_cast<Ogre2Material *>(this->material.get());
+    if (derived &&
+        derived->DatablockRevision() != this->dataPtr->sharedRevision)
+    {
+      this->DetachSharedDatablock();
+    }
+  }
+
+  BaseSubMesh::PreRender();
+}
+
+//////////////////////////////////////////////////
+void Ogre2SubMesh::DetachSharedDatablock()
+{
+  if (!this->dataPtr->sharedDatablock)
+    return;
+
+  auto derived = dynamic_cast<Ogre2Material *>(this->material.get());
+  if (!derived || !derived->Datablock())
+    return;
+
+  BindDatablock(this->ogreSubItem, derived->Datablock());
+  this->scene->ReleaseSharedDatablock(this->dataPtr->sharedDatablock);
+  this->dataPtr->sharedDatablock = nullptr;
+
+  this->scene->SetVisualsDirty();
 }
 
 //////////////////////////////////////////////////
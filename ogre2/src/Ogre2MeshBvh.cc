@@ -0,0 +1,571 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#if defined(__SSE__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+  #include <xmmintrin.h>
+  #define GZ_OGRE2_MESHBVH_SSE
+#endif
+
+#include <gz/common/Mesh.hh>
+#include <gz/common/MeshManager.hh>
+#include <gz/common/SubMesh.hh>
+
+#include "Ogre2MeshBvh.hh"
+
+#ifdef _MSC_VER
+  #pragma warning(push, 0)
+#endif
+#include <OgreMesh2.h>
+#ifdef _MSC_VER
+  #pragma warning(pop)
+#endif
+
+using namespace gz;
+using namespace rendering;
+
+/// \brief Maximum number of triangles in a leaf
+static constexpr std::uint32_t kMaxLeafSize = 4u;
+
+/// \brief Number of bins per axis used to evaluate the SAH while building
+static constexpr unsigned int kBinCount = 16u;
+
+/// \brief Maximum depth of the hierarchy. Bounds the traversal stack.
+static constexpr unsigned int kMaxDepth = 64u;
+
+/// \brief Axis aligned box used while building the hierarchy
+struct Ogre2MeshBvhBounds
+{
+  /// \brief Minimum corner
+  float min[3] = {std::numeric_limits<float>::max(),
+                  std::numeric_limits<float>::max(),
+                  std::numeric_limits<float>::max()};
+
+  /// \brief Maximum corner
+  float max[3] = {std::numeric_limits<float>::lowest(),
+                  std::numeric_limits<float>::lowest(),
+                  std::numeric_limits<float>::lowest()};
+
+  /// \brief Grow the box to contain a point
+  /// \param[in] _p Point
+  void Grow(const float _p[3])
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      this->min[i] = std::min(this->min[i], _p[i]);
+      this->max[i] = std::max(this->max[i], _p[i]);
+    }
+  }
+
+  /// \brief Grow the box to contain another box
+  /// \param[in] _b Box
+  void Grow(const Ogre2MeshBvhBounds &_b)
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      this->min[i] = std::min(this->min[i], _b.min[i]);
+      this->max[i] = std::max(this->max[i], _b.max[i]);
+    }
+  }
+
+  /// \brief Half of the surface area of the box. 0 if empty.
+  /// \return Half area
+  float HalfArea() const
+  {
+    const float dx = this->max[0] - this->min[0];
+    const float dy = this->max[1] - this->min[1];
+    const float dz = this->max[2] - this->min[2];
+    if (dx < 0.0f || dy < 0.0f || dz < 0.0f)
+      return 0.0f;
+    return dx * dy + dy * dz + dz * dx;
+  }
+};
+
+/// \brief Triangle as read from the mesh, with its bounds and centroid
+struct Ogre2MeshBvhBuildTri
+{
+  /// \brief Vertices
+  float v[3][3];
+
+  /// \brief Bounds of the vertices
+  Ogre2MeshBvhBounds bounds;
+
+  /// \brief Centroid of the bounds
+  float centroid[3];
+};
+
+/// \brief Möller-Trumbore ray / triangle test accepting front faces only,
+/// i.e. the same triangles Ogre::Math::intersects(ray, a, b, c, true, false)
+/// accepts.
+/// \param[in] _o Ray origin
+/// \param[in] _d Ray direction
+/// \param[in] _v0 First vertex
+/// \param[in] _e1 Second vertex minus first vertex
+/// \param[in] _e2 Third vertex minus first vertex
+/// \param[in, out] _t Closest distance so far, updated on hit
+/// \return True if the triangle is hit closer than _t
+static inline bool IntersectTriangle(const float _o[3], const float _d[3],
+    const float _v0[3], const float _e1[3], const float _e2[3], float &_t)
+{
+  // p = d x e2
+  const float px = _d[1] * _e2[2] - _d[2] * _e2[1];
+  const float py = _d[2] * _e2[0] - _d[0] * _e2[2];
+  const float pz = _d[0] * _e2[1] - _d[1] * _e2[0];
+  const float det = _e1[0] * px + _e1[1] * py + _e1[2] * pz;
+  // a positive determinant means the ray is facing against the triangle
+  // normal (e1 x e2)
+  if (det <= 1e-12f)
+    return false;
+  const float invDet = 1.0f / det;
+
+  const float sx = _o[0] - _v0[0];
+  const float sy = _o[1] - _v0[1];
+  const float sz = _o[2] - _v0[2];
+  const float u = (sx * px + sy * py + sz * pz) * invDet;
+  if (u < 0.0f || u > 1.0f)
+    return false;
+
+  // q = s x e1
+  const float qx = sy * _e1[2] - sz * _e1[1];
+  const float qy = sz * _e1[0] - sx * _e1[2];
+  const float qz = sx * _e1[1] - sy * _e1[0];
+  const float v = (_d[0] * qx + _d[1] * qy + _d[2] * qz) * invDet;
+  if (v < 0.0f || u + v > 1.0f)
+    return false;
+
+  const float t = (_e2[0] * qx + _e2[1] * qy + _e2[2] * qz) * invDet;
+  if (t < 0.0f || t >= _t)
+    return false;
+
+  _t = t;
+  return true;
+}
+
+//////////////////////////////////////////////////
+Ogre2MeshBvh::Ogre2MeshBvh(const common::Mesh &_mesh)
+{
+  std::vector<Ogre2MeshBvhBuildTri> tris;
+  for (unsigned int i = 0u; i < _mesh.SubMeshCount(); ++i)
+  {
+    auto submesh = _mesh.SubMeshByIndex(i).lock();
+    if (!submesh || submesh->VertexCount() < 3u)
+      continue;
+
+    const math::Vector3d *vertices = submesh->VertexPtr();
+    const unsigned int *indices = submesh->IndexPtr();
+    const unsigned int vertexCount = submesh->VertexCount();
+    const unsigned int indexCount = submesh->IndexCount();
+    tris.reserve(tris.size() + indexCount / 3u);
+    for (unsigned int k = 0u; k + 2u < indexCount; k += 3u)
+    {
+      if (indices[k] >= vertexCount || indices[k + 1u] >= vertexCount ||
+          indices[k + 2u] >= vertexCount)
+      {
+        continue;
+      }
+      Ogre2MeshBvhBuildTri tri;
+      for (unsigned int c = 0u; c < 3u; ++c)
+      {
+        const math::Vector3d &v = vertices[indices[k + c]];
+        tri.v[c][0] = static_cast<float>(v.X());
+        tri.v[c][1] = static_cast<float>(v.Y());
+        tri.v[c][2] = static_cast<float>(v.Z());
+        tri.bounds.Grow(tri.v[c]);
+      }
+      for (int a = 0; a < 3; ++a)
+        tri.centroid[a] = 0.5f * (tri.bounds.min[a] + tri.bounds.max[a]);
+      tris.push_back(tri);
+    }
+  }
+
+  if (tris.empty())
+    return;
+
+  // Build top-down. Every node owns a contiguous range of tris, which is
+  // partitioned in place when the node is split. Children are always
+  // allocated in pairs so the right child is left + 1.
+  this->nodes.reserve(2u * tris.size() / kMaxLeafSize + 1u);
+  this->nodes.push_back(Node());
+  this->nodes[0].leftFirst = 0u;
+  this->nodes[0].count = static_cast<std::uint32_t>(tris.size());
+
+  std::vector<std::pair<std::uint32_t, unsigned int>> buildStack;
+  buildStack.emplace_back(0u, 1u);
+  while (!buildStack.empty())
+  {
+    const std::uint32_t nodeIdx = buildStack.back().first;
+    const unsigned int depth = buildStack.back().second;
+    buildStack.pop_back();
+
+    const std::uint32_t first = this->nodes[nodeIdx].leftFirst;
+    const std::uint32_t count = this->nodes[nodeIdx].count;
+
+    Ogre2MeshBvhBounds bounds;
+    Ogre2MeshBvhBounds centroidBounds;
+    for (std::uint32_t i = first; i < first + count; ++i)
+    {
+      bounds.Grow(tris[i].bounds);
+      centroidBounds.Grow(tris[i].centroid);
+    }
+    for (int a = 0; a < 3; ++a)
+    {
+      this->nodes[nodeIdx].boundsMin[a] = bounds.min[a];
+      this->nodes[nodeIdx].boundsMax[a] = bounds.max[a];
+    }
+
+    if (count <= kMaxLeafSize || depth >= kMaxDepth)
+      continue;
+
+    // Binned SAH: find the axis and bin boundary with the lowest cost
+    int bestAxis = -1;
+    unsigned int bestSplit = 0u;
+    float bestCost = std::numeric_limits<float>::max();
+    for (int a = 0; a < 3; ++a)
+    {
+      const float extent = centroidBounds.max[a] - centroidBounds.min[a];
+      if (extent <= 0.0f)
+        continue;
+      const float scale = kBinCount / extent;
+
+      Ogre2MeshBvhBounds binBounds[kBinCount];
+      std::uint32_t binCount[kBinCount] = {0u};
+      for (std::uint32_t i = first; i < first + count; ++i)
+      {
+        unsigned int b = static_cast<unsigned int>(
+            (tris[i].centroid[a] - centroidBounds.min[a]) * scale);
+        b = std::min(b, kBinCount - 1u);
+        ++binCount[b];
+        binBounds[b].Grow(tris[i].bounds);
+      }
+
+      // sweep from the right to get the cost of every right partition
+      float rightArea[kBinCount - 1u];
+      std::uint32_t rightCount[kBinCount - 1u];
+      Ogre2MeshBvhBounds acc;
+      std::uint32_t accCount = 0u;
+      for (unsigned int b = kBinCount - 1u; b > 0u; --b)
+      {
+        acc.Grow(binBounds[b]);
+        accCount += binCount[b];
+        rightArea[b - 1u] = acc.HalfArea();
+        rightCount[b - 1u] = accCount;
+      }
+
+      acc = Ogre2MeshBvhBounds();
+      accCount = 0u;
+      for (unsigned int b = 0u; b < kBinCount - 1u; ++b)
+      {
+        acc.Grow(binBounds[b]);
+        accCount += binCount[b];
+        if (accCount == 0u || rightCount[b] == 0u)
+          continue;
+        const float cost = accCount * acc.HalfArea() +
+            rightCount[b] * rightArea[b];
+        if (cost < bestCost)
+        {
+          bestCost = cost;
+          bestAxis = a;
+          bestSplit = b;
+        }
+      }
+    }
+
+    // stop if splitting is not cheaper than testing every triangle
+    if (bestAxis < 0 || bestCost >= count * bounds.HalfArea())
+      continue;
+
+    const float splitMin = centroidBounds.min[bestAxis];
+    const float splitScale =
+        kBinCount / (centroidBounds.max[bestAxis] - splitMin);
+    auto mid = std::partition(tris.begin() + first,
+        tris.begin() + first + count,
+        [&](const Ogre2MeshBvhBuildTri &_tri)
+        {
+          unsigned int b = static_cast<unsigned int>(
+              (_tri.centroid[bestAxis] - splitMin) * splitScale);
+          return std::min(b, kBinCount - 1u) <= bestSplit;
+        });
+    const std::uint32_t leftCount =
+        static_cast<std::uint32_t>(mid - (tris.begin() + first));
+    if (leftCount == 0u || leftCount == count)
+      continue;
+
+    const std::uint32_t leftIdx = static_cast<std::uint32_t>(
+        this->nodes.size());
+    this->nodes.push_back(Node());
+    this->nodes.push_back(Node());
+    this->nodes[leftIdx].leftFirst = first;
+    this->nodes[leftIdx].count = leftCount;
+    this->nodes[leftIdx + 1u].leftFirst = first + leftCount;
+    this->nodes[leftIdx + 1u].count = count - leftCount;
+    this->nodes[nodeIdx].leftFirst = leftIdx;
+    this->nodes[nodeIdx].count = 0u;
+
+    buildStack.emplace_back(leftIdx + 1u, depth + 1u);
+    buildStack.emplace_back(leftIdx, depth + 1u);
+  }
+  this->nodes.shrink_to_fit();
+
+  this->triangles.resize(tris.size());
+  for (std::size_t i = 0u; i < tris.size(); ++i)
+  {
+    Triangle &tri = this->triangles[i];
+    for (int a = 0; a < 3; ++a)
+    {
+      tri.v0[a] = tris[i].v[0][a];
+      tri.e1[a] = tris[i].v[1][a] - tris[i].v[0][a];
+      tri.e2[a] = tris[i].v[2][a] - tris[i].v[0][a];
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MeshBvh::Intersect(const float _origin[3], const float _dir[3],
+    float &_distance) const
+{
+  if (this->nodes.empty())
+    return false;
+
+  // Avoid infinities in the inverse direction so that the slab test never
+  // computes 0 * inf
+  float invDir[3];
+  for (int a = 0; a < 3; ++a)
+  {
+    const float d = std::fabs(_dir[a]) > 1e-20f ? _dir[a] :
+        std::copysign(1e-20f, _dir[a]);
+    invDir[a] = 1.0f / d;
+  }
+
+#ifdef GZ_OGRE2_MESHBVH_SSE
+  const __m128 origin4 = _mm_setr_ps(_origin[0], _origin[1], _origin[2], 0.0f);
+  const __m128 invDir4 = _mm_setr_ps(invDir[0], invDir[1], invDir[2], 0.0f);
+#endif
+
+  // Slab test. Returns the entry distance or max float on miss
+  auto intersectBox = [&](const Node &_node, float _tMax) -> float
+  {
+#ifdef GZ_OGRE2_MESHBVH_SSE
+    // lane 3 holds leftFirst / count and is ignored below
+    const __m128 t0 = _mm_mul_ps(
+        _mm_sub_ps(_mm_loadu_ps(_node.boundsMin), origin4), invDir4);
+    const __m128 t1 = _mm_mul_ps(
+        _mm_sub_ps(_mm_loadu_ps(_node.boundsMax), origin4), invDir4);
+    const __m128 tNear4 = _mm_min_ps(t0, t1);
+    const __m128 tFar4 = _mm_max_ps(t0, t1);
+    const float tNear = _mm_cvtss_f32(_mm_max_ss(_mm_max_ss(tNear4,
+        _mm_shuffle_ps(tNear4, tNear4, _MM_SHUFFLE(1, 1, 1, 1))),
+        _mm_shuffle_ps(tNear4, tNear4, _MM_SHUFFLE(2, 2, 2, 2))));
+    const float tFar = _mm_cvtss_f32(_mm_min_ss(_mm_min_ss(tFar4,
+        _mm_shuffle_ps(tFar4, tFar4, _MM_SHUFFLE(1, 1, 1, 1))),
+        _mm_shuffle_ps(tFar4, tFar4, _MM_SHUFFLE(2, 2, 2, 2))));
+#else
+    float tNear = 0.0f;
+    float tFar = std::numeric_limits<float>::max();
+    for (int a = 0; a < 3; ++a)
+    {
+      const float t0 = (_node.boundsMin[a] - _origin[a]) * invDir[a];
+      const float t1 = (_node.boundsMax[a] - _origin[a]) * invDir[a];
+      tNear = std::max(tNear, std::min(t0, t1));
+      tFar = std::min(tFar, std::max(t0, t1));
+    }
+#endif
+    if (tFar >= std::max(tNear, 0.0f) && tNear < _tMax)
+      return tNear;
+    return std::numeric_limits<float>::max();
+  };
+
+  bool hit = false;
+  std::uint32_t stack[kMaxDepth * 2u];
+  unsigned int stackSize = 0u;
+
+  if (intersectBox(this->nodes[0], _distance) ==
+      std::numeric_limits<float>::max())
+  {
+    return false;
+  }
+  stack[stackSize++] = 0u;
+
+  while (stackSize > 0u)
+  {
+    const Node &node = this->nodes[stack[--stackSize]];
+    if (node.count > 0u)
+    {
+      for (std::uint32_t i = node.leftFirst; i < node.leftFirst + node.count;
+           ++i)
+      {
+        const Triangle &tri = this->triangles[i];
+        hit |= IntersectTriangle(_origin, _dir, tri.v0, tri.e1, tri.e2,
+                                 _distance);
+      }
+      continue;
+    }
+
+    // visit the nearest child first so that farther ones can be culled
+    // by the distance of its hits
+    std::uint32_t nearIdx = node.leftFirst;
+    std::uint32_t farIdx = node.leftFirst + 1u;
+    float nearT = intersectBox(this->nodes[nearIdx], _distance);
+    float farT = intersectBox(this->nodes[farIdx], _distance);
+    if (farT < nearT)
+    {
+      std::swap(nearIdx, farIdx);
+      std::swap(nearT, farT);
+    }
+    if (farT != std::numeric_limits<float>::max())
+      stack[stackSize++] = farIdx;
+    if (nearT != std::numeric_limits<float>::max())
+      stack[stackSize++] = nearIdx;
+  }
+
+  return hit;
+}
+
+//////////////////////////////////////////////////
+bool Ogre2MeshBvh::IntersectTransformed(const float _transform[16],
+    const float _origin[3], const float _dir[3], float &_distance) const
+{
+  auto transformPoint = [&_transform](const float _p[3], float _out[3])
+  {
+    float w = _transform[12] * _p[0] + _transform[13] * _p[1] +
+        _transform[14] * _p[2] + _transform[15];
+    w = (w != 0.0f) ? 1.0f / w : 1.0f;
+    for (int r = 0; r < 3; ++r)
+    {
+      _out[r] = (_transform[r * 4] * _p[0] + _transform[r * 4 + 1] * _p[1] +
+          _transform[r * 4 + 2] * _p[2] + _transform[r * 4 + 3]) * w;
+    }
+  };
+
+  bool hit = false;
+  for (const Triangle &tri : this->triangles)
+  {
+    float p1[3], p2[3];
+    for (int a = 0; a < 3; ++a)
+    {
+      p1[a] = tri.v0[a] + tri.e1[a];
+      p2[a] = tri.v0[a] + tri.e2[a];
+    }
+    float w0[3], w1[3], w2[3];
+    transformPoint(tri.v0, w0);
+    transformPoint(p1, w1);
+    transformPoint(p2, w2);
+    float e1[3], e2[3];
+    for (int a = 0; a < 3; ++a)
+    {
+      e1[a] = w1[a] - w0[a];
+      e2[a] = w2[a] - w0[a];
+    }
+    hit |= IntersectTriangle(_origin, _dir, w0, e1, e2, _distance);
+  }
+  return hit;
+}
+
+//////////////////////////////////////////////////
+std::size_t Ogre2MeshBvh::TriangleCount() const
+{
+  return this->triangles.size();
+}
+
+/// \brief Cached hierarchy of an Ogre mesh
+struct Ogre2MeshBvhCacheEntry
+{
+  /// \brief Name of the Ogre mesh, to detect a different mesh being
+  /// allocated at the address of a removed one
+  std::string ogreMeshName;
+
+  /// \brief The hierarchy
+  std::shared_ptr<const Ogre2MeshBvh> bvh;
+};
+
+/// \brief Cache of hierarchies, keyed by Ogre mesh
+struct Ogre2MeshBvhCache
+{
+  /// \brief Mutex protecting the entries, queries run on worker threads
+  std::mutex mutex;
+
+  /// \brief Cached hierarchies
+  std::unordered_map<const Ogre::Mesh *, Ogre2MeshBvhCacheEntry> entries;
+};
+
+/// \brief Get the process wide hierarchy cache
+/// \return The cache
+static Ogre2MeshBvhCache &MeshBvhCache()
+{
+  static Ogre2MeshBvhCache cache;
+  return cache;
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<const Ogre2MeshBvh> Ogre2MeshBvh::Cached(
+    const Ogre::Mesh *_ogreMesh)
+{
+  if (!_ogreMesh)
+    return nullptr;
+
+  Ogre2MeshBvhCache &cache = MeshBvhCache();
+  const std::string &ogreMeshName = _ogreMesh->getName();
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto it = cache.entries.find(_ogreMesh);
+    if (it != cache.entries.end() && it->second.ogreMeshName == ogreMeshName)
+      return it->second.bvh;
+  }
+
+  // mesh factory creates name with ::CENTER or ::ORIGINAL depending on
+  // the params passed in the MeshDescriptor when loading the mesh
+  // so strip off the suffix
+  std::string meshName = ogreMeshName;
+  const std::size_t idx = meshName.find("::");
+  if (idx != std::string::npos)
+    meshName = meshName.substr(0, idx);
+
+  const common::Mesh *mesh =
+      common::MeshManager::Instance()->MeshByName(meshName);
+
+  // Build outside of the lock. Meshes without a common::Mesh are cached
+  // as nullptr so the lookup is not repeated on every query.
+  std::shared_ptr<const Ogre2MeshBvh> bvh;
+  if (mesh)
+    bvh = std::make_shared<const Ogre2MeshBvh>(*mesh);
+
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  Ogre2MeshBvhCacheEntry &entry = cache.entries[_ogreMesh];
+  entry.ogreMeshName = ogreMeshName;
+  entry.bvh = bvh;
+  return bvh;
+}
+
+//////////////////////////////////////////////////
+void Ogre2MeshBvh::Evict(const std::string &_ogreMeshName)
+{
+  Ogre2MeshBvhCache &cache = MeshBvhCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  for (auto it = cache.entries.begin(); it != cache.entries.end();)
+  {
+    if (it->second.ogreMeshName == _ogreMeshName)
+      it = cache.entries.erase(it);
+    else
+      ++it;
+  }
+}
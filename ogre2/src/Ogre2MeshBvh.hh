@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef GZ_RENDERING_OGRE2_OGRE2MESHBVH_HH_
+#define GZ_RENDERING_OGRE2_OGRE2MESHBVH_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gz/rendering/config.hh"
+
+namespace gz
+{
+  namespace common
+  {
+    class Mesh;
+  }
+}
+
+namespace Ogre
+{
+  class Mesh;
+}
+
+namespace gz
+{
+  namespace rendering
+  {
+    inline namespace GZ_RENDERING_VERSION_NAMESPACE {
+    //
+    /// \brief Bounding volume hierarchy over the triangles of a mesh, used
+    /// to accelerate CPU ray queries. The hierarchy is built once in mesh
+    /// local space using the surface area heuristic and stored as a flat
+    /// array of nodes, so queries only visit the triangles whose bounding
+    /// boxes are crossed by the ray.
+    class Ogre2MeshBvh
+    {
+      /// \brief Constructor. Builds the hierarchy from all the submeshes
+      /// of the given mesh.
+      /// \param[in] _mesh Mesh to build the hierarchy for
+      public: explicit Ogre2MeshBvh(const common::Mesh &_mesh);
+
+      /// \brief Find the closest front facing triangle hit by a ray
+      /// \param[in] _origin Ray origin, in mesh local space
+      /// \param[in] _dir Ray direction, in mesh local space. It does not
+      /// need to be normalized; the returned distance is expressed in
+      /// multiples of its length.
+      /// \param[in, out] _distance On input, the maximum distance to look
+      /// for hits. On output, the distance to the closest hit if any.
+      /// \return True if a triangle closer than _distance was hit
+      public: bool Intersect(const float _origin[3], const float _dir[3],
+                             float &_distance) const;
+
+      /// \brief Same as Intersect() but transforms every triangle by the
+      /// given matrix before testing it against the ray. This does not use
+      /// the hierarchy and is meant for the rare case of non-affine
+      /// transforms.
+      /// \param[in] _transform Row major 4x4 transform from mesh local space
+      /// to ray space
+      /// \param[in] _origin Ray origin
+      /// \param[in] _dir Ray direction
+      /// \param[in, out] _distance See Intersect()
+      /// \return True if a triangle closer than _distance was hit
+      public: bool IntersectTransformed(const float _transform[16],
+                                        const float _origin[3],
+                                        const float _dir[3],
+                                        float &_distance) const;
+
+      /// \brief Get the number of triangles in the hierarchy
+      /// \return Number of triangles
+      public: std::size_t TriangleCount() const;
+
+      /// \brief Get the hierarchy built for an Ogre mesh, building it on
+      /// first use. The geometry is taken from the common::Mesh of the
+      /// same name registered in the common::MeshManager.
+      /// This function is thread safe.
+      /// \param[in] _ogreMesh Ogre mesh to get the hierarchy for
+      /// \return The hierarchy, or nullptr if there is no matching
+      /// common::Mesh
+      public: static std::shared_ptr<const Ogre2MeshBvh> Cached(
+                  const Ogre::Mesh *_ogreMesh);
+
+      /// \brief Drop the cached hierarchy of an Ogre mesh. Should be called
+      /// when the Ogre mesh is removed.
+      /// This function is thread safe.
+      /// \param[in] _ogreMeshName Name of the Ogre mesh
+      public: static void Evict(const std::string &_ogreMeshName);
+
+      /// \brief Triangle stored as one vertex and two edges, the form used
+      /// by the intersection test
+      private: struct Triangle
+      {
+        /// \brief First vertex
+        float v0[3];
+
+        /// \brief Second vertex minus first vertex
+        float e1[3];
+
+        /// \brief Third vertex minus first vertex
+        float e2[3];
+      };
+
+      /// \brief Hierarchy node. Interior nodes store the index of their
+      /// left child, the right child being the next node in the array.
+      /// Leaves store the index of their first triangle.
+      private: struct Node
+      {
+        /// \brief Minimum corner of the bounding box
+        float boundsMin[3];
+
+        /// \brief Left child index, or first triangle index for leaves
+        std::uint32_t leftFirst;
+
+        /// \brief Maximum corner of the bounding box
+        float boundsMax[3];
+
+        /// \brief Number of triangles. 0 for interior nodes
+        std::uint32_t count;
+      };
+
+      /// \brief Triangles, ordered so that each leaf references a
+      /// contiguous range
+      private: std::vector<Triangle> triangles;
+
+      /// \brief Flattened nodes, the root being the first one
+      private: std::vector<Node> nodes;
+    };
+    }
+  }
+}
+
+#endif
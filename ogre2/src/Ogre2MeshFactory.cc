@@ -16,15 +16,32 @@
  */
 
 
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <regex>
 #include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <gz/common/Console.hh>
+#include <gz/common/Filesystem.hh>
 #include <gz/common/Material.hh>
+#include <gz/common/Mesh.hh>
 #include <gz/common/Skeleton.hh>
 #include <gz/common/SkeletonAnimation.hh>
 #include <gz/common/SubMesh.hh>
 
 #include <gz/math/Matrix4.hh>
+#include <gz/math/Vector2.hh>
+#include <gz/math/Vector4.hh>
 
 #include "gz/rendering/ogre2/Ogre2Conversions.hh"
 #include "gz/rendering/ogre2/Ogre2Mesh.hh"
@@ -34,9 +51,13 @@
 #include "gz/rendering/ogre2/Ogre2Scene.hh"
 #include "gz/rendering/ogre2/Ogre2Storage.hh"
 
+#include "Ogre2CacheFile.hh"
+#include "Ogre2MeshBvh.hh"
+
 #ifdef _MSC_VER
   #pragma warning(push, 0)
 #endif
+#include <OgreBitwise.h>
 #include <OgreHardwareBufferManager.h>
 #include <OgreItem.h>
 #include <OgreKeyFrame.h>
@@ -45,21 +66,77 @@
 #include <OgreMeshManager2.h>
 #include <OgreOldBone.h>
 #include <OgreOldSkeletonManager.h>
+#include <OgreRenderSystem.h>
+#include <OgreRoot.h>
 #include <OgreSceneManager.h>
 #include <OgreSkeleton.h>
 #include <OgreSubItem.h>
 #include <OgreSubMesh.h>
 #include <OgreSubMesh2.h>
+#include <Vao/OgreIndexBufferPacked.h>
+#include <Vao/OgreVaoManager.h>
 #ifdef _MSC_VER
   #pragma warning(pop)
 #endif
 
+namespace
+{
+/// \brief Vertex and index data of one submesh, packed on the CPU in the
+/// layout expected by its ogre v2 vertex and index buffers
+struct PackedSubMesh
+{
+  /// \brief Index of the common::SubMesh this was packed from
+  unsigned int sourceIndex = 0u;
+
+  /// \brief Name of the submesh
+  std::string name;
+
+  /// \brief Primitive type of the submesh
+  Ogre::OperationType operationType = Ogre::OT_TRIANGLE_LIST;
+
+  /// \brief Layout of a single vertex in the vertex buffer
+  Ogre::VertexElement2Vec vertexElements;
+
+  /// \brief Interleaved vertex data
+  std::vector<unsigned char> vertices;
+
+  /// \brief Number of vertices
+  size_t vertexCount = 0u;
+
+  /// \brief Type of the indices
+  Ogre::IndexBufferPacked::IndexType indexType =
+      Ogre::IndexBufferPacked::IT_32BIT;
+
+  /// \brief Index data, empty if the submesh is not indexed
+  std::vector<unsigned char> indices;
+
+  /// \brief Number of indices
+  size_t indexCount = 0u;
+};
+}
+
 /// \brief Private data for the Ogre2MeshFactory class
 class gz::rendering::Ogre2MeshFactoryPrivate
 {
   /// \brief Vector with the template materials, we keep the pointer to be
   /// able to remove it when nobody is using it.
   public: std::vector<MaterialPtr> materialCache;
+
+  /// \brief Create the material used to render a submesh
+  /// \param[in] _scene Scene to create the material in
+  /// \param[in] _mesh Mesh the submesh belongs to
+  /// \param[in] _subMesh Submesh to create the material for
+  /// \return Name of the created material
+  public: std::string SubMeshMaterial(Ogre2ScenePtr _scene,
+              const common::Mesh &_mesh, const common::SubMesh &_subMesh);
+
+  /// \brief Submeshes packed ahead of time by Prepare, indexed by mesh
+  /// name. Consumed when the mesh is loaded.
+  public: std::unordered_map<std::string, std::vector<PackedSubMesh>>
+      prepared;
+
+  /// \brief Protects prepared, which Prepare fills from worker threads
+  public: std::mutex preparedMutex;
 };
 
 /// \brief Private data for the Ogre2SubMeshStoreFactory class
@@ -70,6 +147,793 @@ class gz::rendering::Ogre2SubMeshStoreFactoryPrivate
 using namespace gz;
 using namespace rendering;
 
+namespace
+{
+/// \brief Identifies mesh cache files
+const char kMeshCacheMagic[4] = {'G', 'Z', 'M', 'C'};
+
+/// \brief Version of the mesh cache file format. Increase it whenever the
+/// file layout or the way submeshes are packed changes.
+const uint32_t kMeshCacheVersion = 1u;
+
+//////////////////////////////////////////////////
+/// \brief Convert a common::SubMesh primitive type to an ogre operation type
+/// \param[in] _type Primitive type to convert
+/// \param[out] _operationType Resulting ogre operation type
+/// \return False if the primitive type is unknown
+bool ConvertPrimitiveType(common::SubMesh::PrimitiveType _type,
+    Ogre::OperationType &_operationType)
+{
+  switch (_type)
+  {
+    case common::SubMesh::TRIANGLES:
+      _operationType = Ogre::OT_TRIANGLE_LIST;
+      return true;
+    case common::SubMesh::LINES:
+      _operationType = Ogre::OT_LINE_LIST;
+      return true;
+    case common::SubMesh::LINESTRIPS:
+      _operationType = Ogre::OT_LINE_STRIP;
+      return true;
+    case common::SubMesh::TRIFANS:
+      _operationType = Ogre::OT_TRIANGLE_FAN;
+      return true;
+    case common::SubMesh::TRISTRIPS:
+      _operationType = Ogre::OT_TRIANGLE_STRIP;
+      return true;
+    case common::SubMesh::POINTS:
+      _operationType = Ogre::OT_POINT_LIST;
+      return true;
+    default:
+      return false;
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Compute per-vertex tangents from the normals of a submesh and,
+/// for triangle lists, its first texture coordinate set. The w component
+/// holds the handedness of the bitangent, as expected by Hlms when the
+/// tangent has 4 components.
+/// \param[in] _subMesh Submesh to compute tangents for
+/// \param[in] _fromTexCoords True to align the tangents with the uv
+/// gradients of the triangles. Otherwise any direction perpendicular to the
+/// normal is used.
+/// \param[out] _tangents One tangent per vertex
+void ComputeTangents(const common::SubMesh &_subMesh,
+    bool _fromTexCoords, std::vector<math::Vector4d> &_tangents)
+{
+  const unsigned int vertexCount = _subMesh.VertexCount();
+  std::vector<math::Vector3d> tan(vertexCount, math::Vector3d::Zero);
+  std::vector<math::Vector3d> bitan(vertexCount, math::Vector3d::Zero);
+
+  const bool indexed = _subMesh.IndexCount() > 0u;
+  unsigned int count = indexed ? _subMesh.IndexCount() : vertexCount;
+  if (!_fromTexCoords)
+    count = 0u;
+  for (unsigned int j = 0u; j + 2u < count; j += 3u)
+  {
+    unsigned int i[3];
+    for (unsigned int k = 0u; k < 3u; ++k)
+    {
+      i[k] = indexed ? static_cast<unsigned int>(_subMesh.Index(j + k)) :
+          j + k;
+    }
+    if (i[0] >= vertexCount || i[1] >= vertexCount || i[2] >= vertexCount)
+      continue;
+
+    math::Vector3d e1 = _subMesh.Vertex(i[1]) - _subMesh.Vertex(i[0]);
+    math::Vector3d e2 = _subMesh.Vertex(i[2]) - _subMesh.Vertex(i[0]);
+    math::Vector2d uv0 = _subMesh.TexCoordBySet(i[0], 0u);
+    math::Vector2d d1 = _subMesh.TexCoordBySet(i[1], 0u) - uv0;
+    math::Vector2d d2 = _subMesh.TexCoordBySet(i[2], 0u) - uv0;
+
+    double r = d1.X() * d2.Y() - d2.X() * d1.Y();
+    if (std::abs(r) < 1e-12)
+      continue;
+    r = 1.0 / r;
+
+    math::Vector3d t = (e1 * d2.Y() - e2 * d1.Y()) * r;
+    math::Vector3d b = (e2 * d1.X() - e1 * d2.X()) * r;
+    for (unsigned int k = 0u; k < 3u; ++k)
+    {
+      tan[i[k]] += t;
+      bitan[i[k]] += b;
+    }
+  }
+
+  _tangents.resize(vertexCount);
+  for (unsigned int j = 0u; j < vertexCount; ++j)
+  {
+    math::Vector3d n = _subMesh.Normal(j).Normalized();
+    // Gram-Schmidt orthogonalize against the normal
+    math::Vector3d t = tan[j] - n * n.Dot(tan[j]);
+    if (t.SquaredLength() < 1e-12)
+    {
+      // no usable uv gradient, pick any direction perpendicular to n
+      t = n.Perpendicular();
+    }
+    t.Normalize();
+    double w = n.Cross(t).Dot(bitan[j]) < 0.0 ? -1.0 : 1.0;
+    _tangents[j].Set(t.X(), t.Y(), t.Z(), w);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Check if half floats are precise enough to store the vertex
+/// positions of a submesh
+/// \param[in] _subMesh Submesh to check
+/// \param[in] _offset Offset added to every vertex position
+/// \return True if half float positions can be used
+bool HalfPositionsSufficient(const common::SubMesh &_subMesh,
+    const math::Vector3d &_offset)
+{
+  math::Vector3d min = _subMesh.Min() + _offset;
+  math::Vector3d max = _subMesh.Max() + _offset;
+  double maxAbs = std::max(min.Abs().Max(), max.Abs().Max());
+  double size = (max - min).Max();
+
+  // Half floats have an 11 bit significand, so a coordinate is rounded by at
+  // most |c| * 2^-11. Only use them if that stays under 0.1% of the submesh
+  // size, and within the half float range.
+  return maxAbs < 65504.0 && maxAbs / 2048.0 <= size * 1e-3;
+}
+
+//////////////////////////////////////////////////
+/// \brief Encode a normal and tangent into a QTangent, stored as 4 signed
+/// normalized shorts. Hlms decodes the normal from the x axis of the
+/// quaternion, the tangent from its y axis, and the bitangent reflection
+/// from the sign of w.
+/// \param[in] _normal Unit normal
+/// \param[in] _tangent Unit tangent perpendicular to the normal, with the
+/// reflection in w
+/// \param[out] _out 4 encoded shorts
+void EncodeQTangent(const math::Vector3d &_normal,
+    const math::Vector4d &_tangent, int16_t *_out)
+{
+  Ogre::Vector3 n = Ogre2Conversions::Convert(_normal);
+  Ogre::Vector3 t(_tangent.X(), _tangent.Y(), _tangent.Z());
+  Ogre::Quaternion q(n, t, n.crossProduct(t));
+  q.normalise();
+  if (q.w < 0)
+    q = -q;
+
+  // The reflection is stored in the sign of w, so w must never be 0. The
+  // sign of -0 would be lost once quantized, so bias w while keeping the
+  // quaternion normalized.
+  const Ogre::Real bias = 1.0f / 32767.0f;
+  if (q.w < bias)
+  {
+    Ogre::Real normFactor = Ogre::Math::Sqrt(1 - bias * bias);
+    q.w = bias;
+    q.x *= normFactor;
+    q.y *= normFactor;
+    q.z *= normFactor;
+  }
+
+  if (_tangent.W() < 0)
+    q = -q;
+
+  _out[0] = Ogre::Bitwise::floatToSnorm16(q.x);
+  _out[1] = Ogre::Bitwise::floatToSnorm16(q.y);
+  _out[2] = Ogre::Bitwise::floatToSnorm16(q.z);
+  _out[3] = Ogre::Bitwise::floatToSnorm16(q.w);
+}
+
+//////////////////////////////////////////////////
+/// \brief Pack a submesh into interleaved vertex and index data. This only
+/// touches CPU memory.
+/// \param[in] _subMesh Submesh to pack
+/// \param[in] _offset Offset added to every vertex position
+/// \param[in] _compact True to use compact vertex and index formats
+/// \param[out] _packed Packed submesh
+void PackSubMesh(const common::SubMesh &_subMesh,
+    const math::Vector3d &_offset, bool _compact, PackedSubMesh &_packed)
+{
+  _packed.name = _subMesh.Name();
+  if (!ConvertPrimitiveType(_subMesh.SubMeshPrimitiveType(),
+      _packed.operationType))
+  {
+    gzerr << "Unknown primitive type["
+          << _subMesh.SubMeshPrimitiveType() << "]\n";
+  }
+
+  const bool hasNormals = _subMesh.NormalCount() > 0u;
+  const bool halfPositions =
+      _compact && HalfPositionsSufficient(_subMesh, _offset);
+  const bool qTangents = _compact && hasNormals;
+
+  // Tangents are needed to apply normal maps. Generate them for triangle
+  // lists that have normals, using the first uv set. QTangents always need
+  // one, even if it is arbitrary.
+  std::vector<math::Vector4d> tangents;
+  const bool uvTangents = hasNormals && _subMesh.TexCoordSetCount() > 0u &&
+      _subMesh.TexCoordCountBySet(0u) > 0u &&
+      _packed.operationType == Ogre::OT_TRIANGLE_LIST;
+  if (uvTangents || qTangents)
+    ComputeTangents(_subMesh, uvTangents, tangents);
+
+  // texture coordinate sets that have data
+  std::vector<unsigned int> uvSets;
+  for (unsigned int k = 0u; k < _subMesh.TexCoordSetCount(); ++k)
+  {
+    if (_subMesh.TexCoordCountBySet(k) > 0u)
+      uvSets.push_back(k);
+  }
+
+  // The vertex layout is position, normal, tangent and tex coords, in that
+  // order. Tex coords are stored as half floats, matching what importV1
+  // produced before. QTangents replace both normal and tangent.
+  Ogre::VertexElement2Vec &elements = _packed.vertexElements;
+  elements.clear();
+  elements.push_back(Ogre::VertexElement2(
+      halfPositions ? Ogre::VET_HALF4 : Ogre::VET_FLOAT3,
+      Ogre::VES_POSITION));
+  if (qTangents)
+  {
+    elements.push_back(
+        Ogre::VertexElement2(Ogre::VET_SHORT4_SNORM, Ogre::VES_NORMAL));
+  }
+  else
+  {
+    if (hasNormals)
+    {
+      elements.push_back(
+          Ogre::VertexElement2(Ogre::VET_FLOAT3, Ogre::VES_NORMAL));
+    }
+    if (!tangents.empty())
+    {
+      elements.push_back(
+          Ogre::VertexElement2(Ogre::VET_FLOAT4, Ogre::VES_TANGENT));
+    }
+  }
+  // If submesh does not have texcoord sets, add one default set so that
+  // normal maps can still be applied to it.
+  const size_t uvSetCount = std::max<size_t>(uvSets.size(), 1u);
+  for (size_t k = 0u; k < uvSetCount; ++k)
+  {
+    elements.push_back(Ogre::VertexElement2(Ogre::VET_HALF2,
+        Ogre::VES_TEXTURE_COORDINATES));
+  }
+
+  const size_t vertexSize = Ogre::VaoManager::calculateVertexSize(elements);
+  _packed.vertexCount = _subMesh.VertexCount();
+  _packed.vertices.resize(vertexSize * _packed.vertexCount);
+
+  unsigned char *data = _packed.vertices.data();
+  for (unsigned int j = 0u; j < _subMesh.VertexCount(); ++j)
+  {
+    unsigned char *dst = data;
+    math::Vector3d v = _subMesh.Vertex(j) + _offset;
+    if (halfPositions)
+    {
+      uint16_t *h = reinterpret_cast<uint16_t *>(dst);
+      *h++ = Ogre::Bitwise::floatToHalf(static_cast<float>(v.X()));
+      *h++ = Ogre::Bitwise::floatToHalf(static_cast<float>(v.Y()));
+      *h++ = Ogre::Bitwise::floatToHalf(static_cast<float>(v.Z()));
+      *h++ = Ogre::Bitwise::floatToHalf(1.0f);
+      dst = reinterpret_cast<unsigned char *>(h);
+    }
+    else
+    {
+      float *f = reinterpret_cast<float *>(dst);
+      *f++ = static_cast<float>(v.X());
+      *f++ = static_cast<float>(v.Y());
+      *f++ = static_cast<float>(v.Z());
+      dst = reinterpret_cast<unsigned char *>(f);
+    }
+
+    if (qTangents)
+    {
+      int16_t *q = reinterpret_cast<int16_t *>(dst);
+      EncodeQTangent(_subMesh.Normal(j).Normalized(), tangents[j], q);
+      dst = reinterpret_cast<unsigned char *>(q + 4);
+    }
+    else
+    {
+      float *f = reinterpret_cast<float *>(dst);
+      if (hasNormals)
+      {
+        math::Vector3d n = _subMesh.Normal(j);
+        *f++ = static_cast<float>(n.X());
+        *f++ = static_cast<float>(n.Y());
+        *f++ = static_cast<float>(n.Z());
+      }
+
+      if (!tangents.empty())
+      {
+        const math::Vector4d &t = tangents[j];
+        *f++ = static_cast<float>(t.X());
+        *f++ = static_cast<float>(t.Y());
+        *f++ = static_cast<float>(t.Z());
+        *f++ = static_cast<float>(t.W());
+      }
+      dst = reinterpret_cast<unsigned char *>(f);
+    }
+
+    uint16_t *h = reinterpret_cast<uint16_t *>(dst);
+    if (uvSets.empty())
+    {
+      *h++ = Ogre::Bitwise::floatToHalf(0.0f);
+      *h++ = Ogre::Bitwise::floatToHalf(0.0f);
+    }
+    for (unsigned int k : uvSets)
+    {
+      math::Vector2d uv = _subMesh.TexCoordBySet(j, k);
+      *h++ = Ogre::Bitwise::floatToHalf(static_cast<float>(uv.X()));
+      *h++ = Ogre::Bitwise::floatToHalf(static_cast<float>(uv.Y()));
+    }
+
+    data += vertexSize;
+  }
+
+  // 16 bit indices can address all vertices of small submeshes
+  _packed.indexCount = _subMesh.IndexCount();
+  if (_compact && _packed.vertexCount < 65536u)
+  {
+    _packed.indexType = Ogre::IndexBufferPacked::IT_16BIT;
+    _packed.indices.resize(_packed.indexCount * sizeof(uint16_t));
+    uint16_t *indices = reinterpret_cast<uint16_t *>(_packed.indices.data());
+    for (unsigned int j = 0u; j < _subMesh.IndexCount(); ++j)
+      *indices++ = static_cast<uint16_t>(_subMesh.Index(j));
+  }
+  else
+  {
+    _packed.indexType = Ogre::IndexBufferPacked::IT_32BIT;
+    _packed.indices.resize(_packed.indexCount * sizeof(uint32_t));
+    uint32_t *indices = reinterpret_cast<uint32_t *>(_packed.indices.data());
+    for (unsigned int j = 0u; j < _subMesh.IndexCount(); ++j)
+      *indices++ = static_cast<uint32_t>(_subMesh.Index(j));
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Pack all submeshes selected by a mesh descriptor
+/// \param[in] _desc Mesh descriptor
+/// \param[out] _packed Packed submeshes
+void PackMesh(const MeshDescriptor &_desc,
+    std::vector<PackedSubMesh> &_packed)
+{
+  _packed.clear();
+  for (unsigned int i = 0; i < _desc.mesh->SubMeshCount(); i++)
+  {
+    // if submesh is specified then load only that particular submesh
+    auto s = _desc.mesh->SubMeshByIndex(i).lock();
+    if (!s || (!_desc.subMeshName.empty() &&
+        s->Name() != _desc.subMeshName))
+    {
+      continue;
+    }
+
+    // Recenter the vertices if requested. The offset is applied while
+    // packing so the original submesh is left untouched.
+    math::Vector3d offset = math::Vector3d::Zero;
+    if (_desc.centerSubMesh)
+      offset = -(s->Min() + (s->Max() - s->Min()) * 0.5);
+
+    _packed.emplace_back();
+    _packed.back().sourceIndex = i;
+    PackSubMesh(*s, offset, _desc.compactVertexFormat, _packed.back());
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Find the file a mesh was loaded from
+/// \param[in] _mesh Mesh to look up
+/// \return Path to the source file, empty if the mesh was not loaded from
+/// a file
+std::string MeshSourceFile(const common::Mesh &_mesh)
+{
+  if (common::isFile(_mesh.Name()))
+    return _mesh.Name();
+
+  std::string file = common::joinPaths(_mesh.Path(),
+      common::basename(_mesh.Name()));
+  if (!_mesh.Path().empty() && common::isFile(file))
+    return file;
+
+  return std::string();
+}
+
+//////////////////////////////////////////////////
+/// \brief Find the other files a mesh file reads its data from, i.e. the
+/// external buffers and images of a glTF file
+/// \param[in] _source Path to the mesh file
+/// \return Paths to the existing files referenced by the mesh file
+std::vector<std::string> MeshDependencyFiles(const std::string &_source)
+{
+  std::vector<std::string> files;
+  std::string ext = std::filesystem::path(_source).extension().string();
+  std::transform(ext.begin(), ext.end(), ext.begin(),
+      [](unsigned char _c) { return static_cast<char>(std::tolower(_c)); });
+  if (ext != ".gltf")
+    return files;
+
+  std::ifstream file(_source);
+  if (!file)
+    return files;
+  const std::string json((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+
+  // embedded data uris don't reference other files
+  static const std::regex kUri("\"uri\"\\s*:\\s*\"([^\"]*)\"");
+  const std::string dir = common::parentPath(_source);
+  for (auto it = std::sregex_iterator(json.begin(), json.end(), kUri);
+       it != std::sregex_iterator(); ++it)
+  {
+    const std::string uri = (*it)[1].str();
+    if (uri.empty() || uri.compare(0u, 5u, "data:") == 0)
+      continue;
+    const std::string path = common::joinPaths(dir, uri);
+    if (common::isFile(path))
+      files.push_back(path);
+  }
+  return files;
+}
+
+//////////////////////////////////////////////////
+/// \brief Describe the state of a file on disk by its path, size and
+/// modification time, which is much cheaper than hashing its contents
+/// \param[in] _path Path to the file
+/// \param[out] _state Description of the file
+/// \return False if the file can't be queried
+bool FileState(const std::string &_path, std::string &_state)
+{
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(_path, ec);
+  if (ec)
+    return false;
+  const auto time = std::filesystem::last_write_time(_path, ec);
+  if (ec)
+    return false;
+
+  std::ostringstream state;
+  state << _path << " " << size << " "
+        << time.time_since_epoch().count();
+  _state = state.str();
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Get the mesh cache file of a mesh descriptor. The file is named
+/// after a hash of the path, size and modification time of the source file
+/// and of the files it references, and of the descriptor options that
+/// change the packed data.
+/// \param[in] _desc Mesh descriptor
+/// \param[out] _key Full description of the cached data, stored in the
+/// cache file and checked on load in case of hash collisions
+/// \return Path to the cache file, empty if caching is disabled or the mesh
+/// was not loaded from a file
+std::string MeshCacheFile(const MeshDescriptor &_desc,
+    std::string &_key)
+{
+  const std::string cacheDir =
+      Ogre2RenderEngine::Instance()->MeshCachePath();
+  if (cacheDir.empty())
+    return std::string();
+
+  const std::string source = MeshSourceFile(*_desc.mesh);
+  if (source.empty())
+    return std::string();
+
+  std::string state;
+  if (!FileState(source, state))
+    return std::string();
+
+  std::ostringstream key;
+  key << "gz-rendering " << GZ_RENDERING_VERSION_FULL << "\n"
+      << "Format " << kMeshCacheVersion << "\n"
+      << "Source " << state << "\n";
+  for (const std::string &dependency : MeshDependencyFiles(source))
+  {
+    if (!FileState(dependency, state))
+      return std::string();
+    key << "Dependency " << state << "\n";
+  }
+  key << "SubMesh " << _desc.subMeshName << "\n"
+      << "Centered " << _desc.centerSubMesh << "\n"
+      << "Compact " << _desc.compactVertexFormat << "\n";
+  _key = key.str();
+
+  // name the file after the whole key
+  Ogre2CacheHash hash;
+  hash.Update(_key);
+  return common::joinPaths(cacheDir, hash.Hex() + ".mesh");
+}
+
+//////////////////////////////////////////////////
+/// \brief Append the raw bytes of a value to a buffer
+/// \param[in,out] _buffer Buffer to append to
+/// \param[in] _value Value to append
+template<typename T>
+void WriteValue(std::string &_buffer, const T &_value)
+{
+  _buffer.append(reinterpret_cast<const char *>(&_value), sizeof(T));
+}
+
+//////////////////////////////////////////////////
+/// \brief Append a block of bytes, prefixed by its size, to a buffer
+/// \param[in,out] _buffer Buffer to append to
+/// \param[in] _data Bytes to append
+/// \param[in] _size Number of bytes
+void WriteBytes(std::string &_buffer, const void *_data, size_t _size)
+{
+  WriteValue(_buffer, static_cast<uint64_t>(_size));
+  _buffer.append(static_cast<const char *>(_data), _size);
+}
+
+//////////////////////////////////////////////////
+/// \brief Read the raw bytes of a value from a buffer
+/// \param[in,out] _ptr Read position, advanced past the value
+/// \param[in] _end End of the buffer
+/// \param[out] _value Value read
+/// \return False if the buffer is too short
+template<typename T>
+bool ReadValue(const char *&_ptr, const char *_end, T &_value)
+{
+  if (static_cast<size_t>(_end - _ptr) < sizeof(T))
+    return false;
+  std::memcpy(&_value, _ptr, sizeof(T));
+  _ptr += sizeof(T);
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Read a block of bytes, prefixed by its size, from a buffer
+/// \param[in,out] _ptr Read position, advanced past the block
+/// \param[in] _end End of the buffer
+/// \param[out] _data Bytes read
+/// \return False if the buffer is too short
+template<typename Container>
+bool ReadBytes(const char *&_ptr, const char *_end, Container &_data)
+{
+  uint64_t size = 0u;
+  if (!ReadValue(_ptr, _end, size) ||
+      static_cast<uint64_t>(_end - _ptr) < size)
+  {
+    return false;
+  }
+  _data.assign(_ptr, _ptr + size);
+  _ptr += size;
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Save packed submeshes to the mesh cache
+/// \param[in] _path Path to the cache file
+/// \param[in] _key Description of the cached data
+/// \param[in] _packed Packed submeshes to save
+void WriteMeshCache(const std::string &_path, const std::string &_key,
+    const std::vector<PackedSubMesh> &_packed)
+{
+  std::string buffer;
+  buffer.append(kMeshCacheMagic, sizeof(kMeshCacheMagic));
+  WriteValue(buffer, kMeshCacheVersion);
+  WriteBytes(buffer, _key.data(), _key.size());
+  WriteValue(buffer, static_cast<uint64_t>(_packed.size()));
+  for (const PackedSubMesh &packed : _packed)
+  {
+    WriteValue(buffer, static_cast<uint32_t>(packed.sourceIndex));
+    WriteBytes(buffer, packed.name.data(), packed.name.size());
+    WriteValue(buffer, static_cast<uint32_t>(packed.operationType));
+    WriteValue(buffer, static_cast<uint64_t>(packed.vertexElements.size()));
+    for (const Ogre::VertexElement2 &element : packed.vertexElements)
+    {
+      WriteValue(buffer, static_cast<uint32_t>(element.mType));
+      WriteValue(buffer, static_cast<uint32_t>(element.mSemantic));
+    }
+    WriteValue(buffer, static_cast<uint64_t>(packed.vertexCount));
+    WriteBytes(buffer, packed.vertices.data(), packed.vertices.size());
+    WriteValue(buffer, static_cast<uint32_t>(packed.indexType));
+    WriteValue(buffer, static_cast<uint64_t>(packed.indexCount));
+    WriteBytes(buffer, packed.indices.data(), packed.indices.size());
+  }
+
+  if (!common::createDirectories(common::parentPath(_path)))
+  {
+    gzwarn << "Unable to create mesh cache folder for [" << _path << "]"
+           << std::endl;
+    return;
+  }
+
+  if (!Ogre2WriteCacheFile(_path, [&buffer](std::fstream &_file)
+      {
+        _file.write(buffer.data(),
+            static_cast<std::streamsize>(buffer.size()));
+        return static_cast<bool>(_file);
+      }))
+  {
+    gzwarn << "Unable to write mesh cache file [" << _path << "]"
+           << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Load packed submeshes from the mesh cache. Files that do not
+/// match the key, or that are truncated or inconsistent with the mesh, are
+/// removed.
+/// \param[in] _path Path to the cache file
+/// \param[in] _key Expected description of the cached data
+/// \param[in] _mesh Mesh the submeshes were packed from
+/// \param[out] _packed Packed submeshes
+/// \return True on a cache hit
+bool ReadMeshCache(const std::string &_path, const std::string &_key,
+    const common::Mesh &_mesh, std::vector<PackedSubMesh> &_packed)
+{
+  _packed.clear();
+
+  std::ifstream file(_path, std::ios::in | std::ios::binary);
+  if (!file)
+    return false;
+  std::vector<char> data((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+  file.close();
+
+  const char *ptr = data.data();
+  const char *end = data.data() + data.size();
+
+  auto parse = [&]() -> bool
+  {
+    char magic[sizeof(kMeshCacheMagic)];
+    uint32_t version = 0u;
+    std::string key;
+    uint64_t count = 0u;
+    if (!ReadValue(ptr, end, magic) ||
+        std::memcmp(magic, kMeshCacheMagic, sizeof(magic)) != 0 ||
+        !ReadValue(ptr, end, version) || version != kMeshCacheVersion ||
+        !ReadBytes(ptr, end, key) || key != _key ||
+        !ReadValue(ptr, end, count))
+    {
+      return false;
+    }
+
+    for (uint64_t i = 0u; i < count; ++i)
+    {
+      PackedSubMesh packed;
+      uint32_t sourceIndex = 0u;
+      uint32_t operationType = 0u;
+      uint64_t elementCount = 0u;
+      if (!ReadValue(ptr, end, sourceIndex) ||
+          sourceIndex >= _mesh.SubMeshCount() ||
+          !ReadBytes(ptr, end, packed.name) ||
+          !ReadValue(ptr, end, operationType) ||
+          !ReadValue(ptr, end, elementCount))
+      {
+        return false;
+      }
+      packed.sourceIndex = sourceIndex;
+      packed.operationType = static_cast<Ogre::OperationType>(operationType);
+
+      // the source file may have been parsed differently, e.g. by another
+      // version of the mesh loader
+      auto source = _mesh.SubMeshByIndex(sourceIndex).lock();
+      if (!source)
+        return false;
+
+      for (uint64_t k = 0u; k < elementCount; ++k)
+      {
+        uint32_t type = 0u;
+        uint32_t semantic = 0u;
+        if (!ReadValue(ptr, end, type) || type >= Ogre::VET_COUNT ||
+            !ReadValue(ptr, end, semantic) ||
+            semantic < Ogre::VES_POSITION || semantic >= Ogre::VES_COUNT)
+        {
+          return false;
+        }
+        packed.vertexElements.push_back(Ogre::VertexElement2(
+            static_cast<Ogre::VertexElementType>(type),
+            static_cast<Ogre::VertexElementSemantic>(semantic)));
+      }
+
+      uint64_t vertexCount = 0u;
+      if (!ReadValue(ptr, end, vertexCount) ||
+          !ReadBytes(ptr, end, packed.vertices) ||
+          vertexCount != source->VertexCount() ||
+          packed.vertices.size() != vertexCount *
+          Ogre::VaoManager::calculateVertexSize(packed.vertexElements))
+      {
+        return false;
+      }
+      packed.vertexCount = static_cast<size_t>(vertexCount);
+
+      uint32_t indexType = 0u;
+      uint64_t indexCount = 0u;
+      if (!ReadValue(ptr, end, indexType) ||
+          indexType > Ogre::IndexBufferPacked::IT_32BIT ||
+          !ReadValue(ptr, end, indexCount) ||
+          indexCount != source->IndexCount() ||
+          !ReadBytes(ptr, end, packed.indices) ||
+          packed.indices.size() != indexCount *
+          (indexType == Ogre::IndexBufferPacked::IT_16BIT ? 2u : 4u))
+      {
+        return false;
+      }
+      packed.indexType =
+          static_cast<Ogre::IndexBufferPacked::IndexType>(indexType);
+      packed.indexCount = static_cast<size_t>(indexCount);
+
+      _packed.push_back(std::move(packed));
+    }
+    return ptr == end;
+  };
+
+  if (!parse())
+  {
+    gzwarn << "Ignoring invalid mesh cache file [" << _path << "]"
+           << std::endl;
+    common::removeFile(_path);
+    _packed.clear();
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Pack all submeshes selected by a mesh descriptor, or read them
+/// from the mesh cache if the same source file was already packed with the
+/// same options. This only touches CPU memory and files, so it can run on
+/// any thread.
+/// \param[in] _desc Mesh descriptor
+/// \param[out] _packed Packed submeshes
+void PackMeshCached(const MeshDescriptor &_desc,
+    std::vector<PackedSubMesh> &_packed)
+{
+  std::string cacheKey;
+  const std::string cacheFile = MeshCacheFile(_desc, cacheKey);
+  if (cacheFile.empty() ||
+      !ReadMeshCache(cacheFile, cacheKey, *_desc.mesh, _packed))
+  {
+    PackMesh(_desc, _packed);
+    if (!cacheFile.empty())
+      WriteMeshCache(cacheFile, cacheKey, _packed);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Upload a packed submesh to the GPU and add it to an ogre v2 mesh.
+/// Must be called from the render thread.
+/// \param[in] _packed Packed submesh data
+/// \param[in] _mesh Mesh to add the submesh to
+/// \return The created submesh
+Ogre::SubMesh *UploadSubMesh(const PackedSubMesh &_packed,
+    Ogre::Mesh *_mesh)
+{
+  Ogre::VaoManager *vaoManager = Ogre::Root::getSingleton().
+      getRenderSystem()->getVaoManager();
+
+  Ogre::SubMesh *subMesh = _mesh->createSubMesh();
+  if (!_packed.name.empty())
+    _mesh->nameSubMesh(_packed.name, _mesh->getNumSubMeshes() - 1u);
+
+  if (_packed.vertexCount == 0u)
+    return subMesh;
+
+  // The data is copied into the immutable buffers, so we keep ownership
+  // of the packed data.
+  Ogre::VertexBufferPackedVec vertexBuffers;
+  vertexBuffers.push_back(vaoManager->createVertexBuffer(
+      _packed.vertexElements, _packed.vertexCount, Ogre::BT_IMMUTABLE,
+      const_cast<unsigned char *>(_packed.vertices.data()), false));
+
+  // it is ok to use null index buffer
+  Ogre::IndexBufferPacked *indexBuffer = nullptr;
+  if (_packed.indexCount > 0u)
+  {
+    indexBuffer = vaoManager->createIndexBuffer(
+        _packed.indexType, _packed.indexCount, Ogre::BT_IMMUTABLE,
+        const_cast<unsigned char *>(_packed.indices.data()), false);
+  }
+
+  Ogre::VertexArrayObject *vao = vaoManager->createVertexArrayObject(
+      vertexBuffers, indexBuffer, _packed.operationType);
+
+  subMesh->mVao[Ogre::VpNormal].push_back(vao);
+  // Use the same geometry for shadow casting.
+  subMesh->mVao[Ogre::VpShadow].push_back(vao);
+
+  return subMesh;
+}
+}
+
 //////////////////////////////////////////////////
 Ogre2MeshFactory::Ogre2MeshFactory(Ogre2ScenePtr _scene) :
   scene(_scene), dataPtr(std::make_unique<Ogre2MeshFactoryPrivate>())
@@ -85,9 +949,15 @@ Ogre2MeshFactory::~Ogre2MeshFactory()
 void Ogre2MeshFactory::Clear()
 {
   for (auto &m : this->ogreMeshes)
+  {
+    Ogre2MeshBvh::Evict(m);
     Ogre::MeshManager::getSingleton().remove(m);
+  }
 
   this->ogreMeshes.clear();
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->preparedMutex);
+  this->dataPtr->prepared.clear();
 }
 
 //////////////////////////////////////////////////
@@ -153,7 +1023,7 @@ Ogre::Item *Ogre2MeshFactory::OgreItem(const MeshDescriptor &_desc)
   Ogre::MeshPtr mesh =
       Ogre::MeshManager::getSingleton().getByName(name);
 
-  // if not, it probably has not been imported from v1 yet
+  // if not, it is a skinned mesh that has not been imported from v1 yet
   if (!mesh)
   {
     Ogre::v1::MeshPtr v1Mesh =
@@ -166,6 +1036,9 @@ Ogre::Item *Ogre2MeshFactory::OgreItem(const MeshDescriptor &_desc)
         name, Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
     mesh->importV1(v1Mesh.get(), false, true, true);
     this->ogreMeshes.push_back(name);
+
+    // the v1 mesh is not needed anymore once imported, free its buffers
+    Ogre::v1::MeshManager::getSingleton().remove(v1Mesh);
   }
 
   return sceneManager->createItem(mesh, Ogre::SCENE_DYNAMIC);
@@ -181,12 +1054,39 @@ bool Ogre2MeshFactory::Load(const MeshDescriptor &_desc)
 
   if (this->IsLoaded(_desc))
   {
+    // drop data packed by a Prepare call that raced with another load
+    std::lock_guard<std::mutex> lock(this->dataPtr->preparedMutex);
+    this->dataPtr->prepared.erase(this->MeshName(_desc));
     return true;
   }
 
   return this->LoadImpl(_desc);
 }
 
+//////////////////////////////////////////////////
+bool Ogre2MeshFactory::Prepare(const MeshDescriptor &_desc)
+{
+  MeshDescriptor normDesc = _desc;
+  if (!normDesc.mesh)
+    normDesc.Load();
+  if (!this->Validate(normDesc) || normDesc.mesh->HasSkeleton())
+    return false;
+
+  const std::string name = this->MeshName(normDesc);
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->preparedMutex);
+    if (this->dataPtr->prepared.count(name) > 0u)
+      return true;
+  }
+
+  std::vector<PackedSubMesh> packedSubMeshes;
+  PackMeshCached(normDesc, packedSubMeshes);
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->preparedMutex);
+  this->dataPtr->prepared.emplace(name, std::move(packedSubMeshes));
+  return true;
+}
+
 //////////////////////////////////////////////////
 bool Ogre2MeshFactory::IsLoaded(const MeshDescriptor &_desc)
 {
@@ -197,6 +1097,11 @@ bool Ogre2MeshFactory::IsLoaded(const MeshDescriptor &_desc)
 //////////////////////////////////////////////////
 bool Ogre2MeshFactory::LoadImpl(const MeshDescriptor &_desc)
 {
+  // Skinned meshes still go through a v1 mesh so that importV1 converts the
+  // skeleton and bone assignments. Everything else is built directly.
+  if (!_desc.mesh->HasSkeleton())
+    return this->LoadV2Impl(_desc);
+
   Ogre::v1::MeshPtr ogreMesh;
   std::string name;
   std::string group;
@@ -491,25 +1396,8 @@ bool Ogre2MeshFactory::LoadImpl(const MeshDescriptor &_desc)
 
       iBuf->unlock();
 
-      common::MaterialPtr material;
-      if (const auto subMeshIdx = subMesh.GetMaterialIndex())
-      {
-        material = _desc.mesh->MaterialByIndex(subMeshIdx.value());
-      }
-
-      MaterialPtr mat = this->scene->CreateMaterial();
-      if (material)
-      {
-        mat->CopyFrom(*material);
-        this->dataPtr->materialCache.push_back(mat);
-      }
-      else
-      {
-        MaterialPtr defaultMat = this->scene->Material("Default/White");
-        if (defaultMat != nullptr)
-          mat->CopyFrom(defaultMat);
-      }
-      ogreSubMesh->setMaterialName(mat->Name());
+      ogreSubMesh->setMaterialName(this->dataPtr->SubMeshMaterial(
+          this->scene, *_desc.mesh, subMesh));
     }
 
     math::Vector3d max = _desc.mesh->Max();
@@ -565,6 +1453,108 @@ bool Ogre2MeshFactory::LoadImpl(const MeshDescriptor &_desc)
   return true;
 }
 
+//////////////////////////////////////////////////
+bool Ogre2MeshFactory::LoadV2Impl(const MeshDescriptor &_desc)
+{
+  std::string name = this->MeshName(_desc);
+  std::string group = Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME;
+
+  math::Vector3d max = _desc.mesh->Max();
+  math::Vector3d min = _desc.mesh->Min();
+  if (!max.IsFinite())
+  {
+    gzerr << "Max bounding box is not finite[" << max << "]" << std::endl;
+    return false;
+  }
+
+  if (!min.IsFinite())
+  {
+    gzerr << "Min bounding box is not finite[" << min << "]" << std::endl;
+    return false;
+  }
+
+  Ogre2RenderEngine::Instance()->AddResourcePath(_desc.mesh->Path());
+
+  // Use the submeshes packed by Prepare if any, or pack them now
+  std::vector<PackedSubMesh> packedSubMeshes;
+  bool prepared = false;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->preparedMutex);
+    auto it = this->dataPtr->prepared.find(name);
+    if (it != this->dataPtr->prepared.end())
+    {
+      packedSubMeshes = std::move(it->second);
+      this->dataPtr->prepared.erase(it);
+      prepared = true;
+    }
+  }
+  if (!prepared)
+    PackMeshCached(_desc, packedSubMeshes);
+
+  Ogre::MeshPtr ogreMesh;
+  try
+  {
+    ogreMesh = Ogre::MeshManager::getSingleton().createManual(name, group);
+    this->ogreMeshes.push_back(name);
+
+    for (const PackedSubMesh &packed : packedSubMeshes)
+    {
+      auto s = _desc.mesh->SubMeshByIndex(packed.sourceIndex).lock();
+      Ogre::SubMesh *ogreSubMesh = UploadSubMesh(packed, ogreMesh.get());
+      ogreSubMesh->setMaterialName(this->dataPtr->SubMeshMaterial(
+          this->scene, *_desc.mesh, *s));
+    }
+
+    ogreMesh->_setBounds(Ogre::Aabb::newFromExtents(
+          Ogre::Vector3(min.X(), min.Y(), min.Z()),
+          Ogre::Vector3(max.X(), max.Y(), max.Z())),
+          false);
+    ogreMesh->_setBoundingSphereRadius((max - min).Length());
+  }
+  catch(Ogre::Exception &e)
+  {
+    gzerr << "Unable to insert mesh[" << e.getDescription() << "]"
+        << std::endl;
+    return false;
+  }
+
+  if (ogreMesh->getNumSubMeshes() == 0u)
+  {
+    std::string msg = "Unable to load mesh: '" + _desc.meshName + "'";
+    if (!_desc.subMeshName.empty())
+      msg += ", submesh: '" + _desc.subMeshName + "'";
+    msg += ". Mesh will be empty.";
+    gzwarn << msg << std::endl;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+std::string Ogre2MeshFactoryPrivate::SubMeshMaterial(Ogre2ScenePtr _scene,
+    const common::Mesh &_mesh, const common::SubMesh &_subMesh)
+{
+  common::MaterialPtr material;
+  if (const auto subMeshIdx = _subMesh.GetMaterialIndex())
+  {
+    material = _mesh.MaterialByIndex(subMeshIdx.value());
+  }
+
+  MaterialPtr mat = _scene->CreateMaterial();
+  if (material)
+  {
+    mat->CopyFrom(*material);
+    this->materialCache.push_back(mat);
+  }
+  else
+  {
+    MaterialPtr defaultMat = _scene->Material("Default/White");
+    if (defaultMat != nullptr)
+      mat->CopyFrom(defaultMat);
+  }
+  return mat->Name();
+}
+
 //////////////////////////////////////////////////
 std::string Ogre2MeshFactory::MeshName(const MeshDescriptor &_desc)
 {
@@ -572,6 +1562,8 @@ std::string Ogre2MeshFactory::MeshName(const MeshDescriptor &_desc)
   ss << _desc.meshName << "::";
   ss << _desc.subMeshName << "::";
   ss << ((_desc.centerSubMesh) ? "CENTERED" : "ORIGINAL");
+  if (_desc.compactVertexFormat)
+    ss << "::COMPACT";
   return ss.str();
 }
 
@@ -120,7 +120,13 @@ void Ogre2Node::SetRawLocalPosition(const math::Vector3d &_position)
           << "1e9 from origin" << std::endl;
     return;
   }
-  this->ogreNode->setPosition(Ogre2Conversions::Convert(_position));
+  const Ogre::Vector3 position = Ogre2Conversions::Convert(_position);
+  if (position == this->ogreNode->getPosition())
+    return;
+
+  this->ogreNode->setPosition(position);
+  if (this->scene)
+    this->scene->NodeMoved(this);
 }
 
 //////////////////////////////////////////////////
@@ -138,7 +144,13 @@ void Ogre2Node::SetRawLocalRotation(const math::Quaterniond &_rotation)
   if (nullptr == this->ogreNode)
     return;
 
-  this->ogreNode->setOrientation(Ogre2Conversions::Convert(_rotation));
+  const Ogre::Quaternion rotation = Ogre2Conversions::Convert(_rotation);
+  if (rotation == this->ogreNode->getOrientation())
+    return;
+
+  this->ogreNode->setOrientation(rotation);
+  if (this->scene)
+    this->scene->NodeMoved(this);
 }
 
 //////////////////////////////////////////////////
@@ -215,6 +227,8 @@ bool Ogre2Node::AttachChild(NodePtr _child)
 
   derived->SetParent(this->SharedThis());
   this->ogreNode->addChild(derived->Node());
+  if (this->scene)
+    this->scene->SetVisualsDirty();
   return true;
 }
 
@@ -234,10 +248,20 @@ bool Ogre2Node::DetachChild(NodePtr _child)
   }
 
   this->ogreNode->removeChild(derived->Node());
+  if (this->scene)
+    this->scene->SetVisualsDirty();
 
   return true;
 }
 
+//////////////////////////////////////////////////
+void Ogre2Node::SetUserData(const std::string &_key, Variant _value)
+{
+  BaseNode::SetUserData(_key, _value);
+  if (this->scene)
+    this->scene->SetVisualsDirty();
+}
+
 //////////////////////////////////////////////////
 Ogre2NodePtr Ogre2Node::SharedThis()
 {
@@ -278,5 +302,11 @@ void Ogre2Node::SetLocalScaleImpl(const math::Vector3d &_scale)
   if (nullptr == this->ogreNode)
     return;
 
-  this->ogreNode->setScale(Ogre2Conversions::Convert(_scale));
+  const Ogre::Vector3 scale = Ogre2Conversions::Convert(_scale);
+  if (scale == this->ogreNode->getScale())
+    return;
+
+  this->ogreNode->setScale(scale);
+  if (this->scene)
+    this->scene->NodeMoved(this);
 }
@@ -15,10 +15,17 @@
  *
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
 #include <gz/common/Console.hh>
-#include <gz/common/Mesh.hh>
-#include <gz/common/MeshManager.hh>
-#include <gz/common/SubMesh.hh>
 
 #include "gz/rendering/ogre2/Ogre2Camera.hh"
 #include "gz/rendering/ogre2/Ogre2Conversions.hh"
@@ -31,6 +38,8 @@
 #include "gz/rendering/ogre2/Ogre2ThermalCamera.hh"
 #include "gz/rendering/ogre2/Ogre2WideAngleCamera.hh"
 
+#include "Ogre2MeshBvh.hh"
+
 #ifdef _MSC_VER
   #pragma warning(push, 0)
 #endif
@@ -49,13 +58,93 @@
 // want to benchmark.
 // #define SINGLE_THREADED
 
-// Define this macro to use the old code. Only use this code if for some
-// odd reason you suspect there is a regression (particularly with skeletally
-// animated objects) or you want to benchmark.
-// The new version should produce identical results (without accounting random
-// floating point precision issues).
+// Define this macro to skip the BVH and test every triangle in world space.
+// Only use this code if for some odd reason you suspect there is a
+// regression (particularly with skeletally animated objects) or you want
+// to benchmark.
+// The BVH version should produce identical results (without accounting
+// random floating point precision issues).
 // #define SLOW_METHOD
 
+/// \brief An item that may be hit by a ray, with everything needed to
+/// test it against rays prepared up front
+struct Ogre2RayQueryCandidate
+{
+  /// \brief Mesh of the item
+  const Ogre::Mesh *mesh = nullptr;
+
+  /// \brief BVH of the item's mesh. Null until resolved with
+  /// ResolveCandidateBvh, which is only done once a ray reaches the item's
+  /// world bounding box, since building it requires triangulating the mesh
+  std::shared_ptr<const Ogre2MeshBvh> bvh;
+
+  /// \brief Transform from mesh local space to world space
+  Ogre::Matrix4 transform;
+
+  /// \brief Transform from world space to mesh local space. Only valid if
+  /// affine is true
+  Ogre::Matrix4 invTransform;
+
+  /// \brief True if transform is affine
+  bool affine = true;
+
+  /// \brief Minimum corner of the item's world bounding box
+  Ogre::Vector3 aabbMin;
+
+  /// \brief Maximum corner of the item's world bounding box
+  Ogre::Vector3 aabbMax;
+
+  /// \brief Id of the gz-rendering object the item belongs to
+  unsigned int objectId = 0u;
+};
+
+/// \brief Bounding volume hierarchy over the world bounding boxes of the
+/// candidates of a batched query. It is built once per batch by splitting
+/// the candidates at the median of their centers, so that each ray only
+/// visits the candidates whose boxes it may cross.
+struct Ogre2RayQueryCandidateBvh
+{
+  /// \brief Hierarchy node. Interior nodes store the index of their left
+  /// child, the right child being the next node in the array. Leaves store
+  /// the index of their first entry in indices.
+  struct Node
+  {
+    /// \brief Minimum corner of the bounding box
+    float boundsMin[3];
+
+    /// \brief Left child index, or first entry in indices for leaves
+    std::uint32_t leftFirst;
+
+    /// \brief Maximum corner of the bounding box
+    float boundsMax[3];
+
+    /// \brief Number of candidates. 0 for interior nodes
+    std::uint32_t count;
+  };
+
+  /// \brief Build the hierarchy
+  /// \param[in] _candidates Candidates to build the hierarchy for
+  void Build(const std::vector<Ogre2RayQueryCandidate> &_candidates);
+
+  /// \brief Call a function for every candidate whose bounding box is
+  /// crossed by a ray closer than _distance, visiting nearer nodes first
+  /// \param[in] _origin Ray origin
+  /// \param[in] _invDir Inverse of the ray direction
+  /// \param[in] _distance Max distance. Updated by _visit as hits are
+  /// found, which culls the nodes behind them.
+  /// \param[in] _visit Function called with the index of each candidate
+  template <class F>
+  void Traverse(const Ogre::Vector3 &_origin, const float _invDir[3],
+                const float &_distance, F _visit) const;
+
+  /// \brief Flattened nodes, the root being the first one
+  std::vector<Node> nodes;
+
+  /// \brief Candidate indices, ordered so that each leaf references a
+  /// contiguous range
+  std::vector<std::uint32_t> indices;
+};
+
 /// \brief Private data class for Ogre2RayQuery
 class gz::rendering::Ogre2RayQueryPrivate
 {
@@ -73,6 +162,14 @@ class gz::rendering::Ogre2RayQueryPrivate
 
   //// \brief See RayQuery::SetPreferGpu
   public: bool preferGpu = true;
+
+  /// \brief Candidates of batched queries. Kept to reuse its memory
+  /// across calls to ClosestPoints
+  public: std::vector<Ogre2RayQueryCandidate> candidates;
+
+  /// \brief Hierarchy over the candidates of batched queries. Kept to
+  /// reuse its memory across calls to ClosestPoints
+  public: Ogre2RayQueryCandidateBvh candidateBvh;
 };
 
 using namespace gz;
@@ -283,14 +380,118 @@ RayQueryResult Ogre2RayQuery::ClosestPointBySelectionBuffer()
   return result;
 }
 
+//////////////////////////////////////////////////
+/// \brief Prepare an object returned by Ogre to be tested against rays.
+/// The BVH of its mesh is not looked up, see ResolveCandidateBvh
+/// \param[in] _movable Ogre object
+/// \param[out] _candidate Prepared candidate
+/// \return False if the object can't be hit by ray queries, i.e. it is
+/// hidden, is not an Item created by gz-rendering or has no mesh
+static bool PrepareCandidate(Ogre::MovableObject *_movable,
+    Ogre2RayQueryCandidate &_candidate)
+{
+  if (!_movable || !_movable->getVisible() || !_movable->isAttached())
+    return false;
+
+  auto userAny = _movable->getUserObjectBindings().getUserAny();
+  if (userAny.isEmpty() || userAny.getType() != typeid(unsigned int) ||
+      _movable->getMovableType() != "Item")
+  {
+    return false;
+  }
+
+  Ogre::Item *ogreItem = static_cast<Ogre::Item *>(_movable);
+  _candidate.mesh = ogreItem->getMesh().get();
+  _candidate.bvh.reset();
+  if (!_candidate.mesh)
+    return false;
+
+  _candidate.transform = ogreItem->_getParentNodeFullTransform();
+#ifndef SLOW_METHOD
+  _candidate.affine = _candidate.transform.isAffine();
+#else
+  _candidate.affine = false;
+#endif
+  if (_candidate.affine)
+    _candidate.invTransform = _candidate.transform.inverseAffine();
+
+  const Ogre::Aabb aabb = ogreItem->getWorldAabb();
+  _candidate.aabbMin = aabb.getMinimum();
+  _candidate.aabbMax = aabb.getMaximum();
+  _candidate.objectId = Ogre::any_cast<unsigned int>(userAny);
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Look up the BVH of a candidate's mesh, building it if this is
+/// the first time the mesh is queried
+/// \param[in, out] _candidate Candidate prepared with PrepareCandidate
+/// \return False if the mesh has no known gz-common mesh to build the BVH
+/// from
+static bool ResolveCandidateBvh(Ogre2RayQueryCandidate &_candidate)
+{
+  if (!_candidate.bvh)
+    _candidate.bvh = Ogre2MeshBvh::Cached(_candidate.mesh);
+  return _candidate.bvh != nullptr;
+}
+
+//////////////////////////////////////////////////
+/// \brief Find the closest triangle of a candidate hit by a ray
+/// \param[in] _candidate Candidate to test
+/// \param[in] _rayOrigin Ray origin in world space
+/// \param[in] _rayDir Normalized ray direction in world space
+/// \param[in, out] _distance Closest distance so far, updated on hit
+/// \return True if a triangle closer than _distance was hit
+static bool IntersectCandidate(const Ogre2RayQueryCandidate &_candidate,
+    const Ogre::Vector3 &_rayOrigin, const Ogre::Vector3 &_rayDir,
+    float &_distance)
+{
+  if (_candidate.affine)
+  {
+    // Traverse the BVH in mesh local space. The local direction is not
+    // normalized so that hit distances remain in world units.
+    Ogre::Matrix3 invTransform3x3;
+    _candidate.invTransform.extract3x3Matrix(invTransform3x3);
+    const Ogre::Vector3 localOrigin =
+        _candidate.invTransform.transformAffine(_rayOrigin);
+    const Ogre::Vector3 localDir = invTransform3x3 * _rayDir;
+    const float origin[3] = {
+      static_cast<float>(localOrigin.x),
+      static_cast<float>(localOrigin.y),
+      static_cast<float>(localOrigin.z)};
+    const float dir[3] = {
+      static_cast<float>(localDir.x),
+      static_cast<float>(localDir.y),
+      static_cast<float>(localDir.z)};
+    return _candidate.bvh->Intersect(origin, dir, _distance);
+  }
+
+  float matrix[16];
+  for (int r = 0; r < 4; ++r)
+  {
+    for (int c = 0; c < 4; ++c)
+      matrix[r * 4 + c] = static_cast<float>(_candidate.transform[r][c]);
+  }
+  const float origin[3] = {
+    static_cast<float>(_rayOrigin.x),
+    static_cast<float>(_rayOrigin.y),
+    static_cast<float>(_rayOrigin.z)};
+  const float dir[3] = {
+    static_cast<float>(_rayDir.x),
+    static_cast<float>(_rayDir.y),
+    static_cast<float>(_rayDir.z)};
+  return _candidate.bvh->IntersectTransformed(matrix, origin, dir, _distance);
+}
+
 //////////////////////////////////////////////////
 
 /// \brief This class performs a Triangle-level raycast over the broadphase
 /// results returned by OgreNext spreading the work as evenly as possible
 /// across multiple threads
 ///
-/// On multicore machines this can lead to considerable speed ups, specially
-/// if the scene has a lot of triangles.
+/// Triangles are tested through a per-mesh BVH (see Ogre2MeshBvh), so the
+/// cost of a query grows with the logarithm of the triangle count rather
+/// than linearly.
 class GZ_RENDERING_OGRE2_HIDDEN ThreadedTriRay final
   : public Ogre::UniformScalableTask
 {
@@ -338,177 +539,358 @@ class GZ_RENDERING_OGRE2_HIDDEN ThreadedTriRay final
 //////////////////////////////////////////////////
 void ThreadedTriRay::execute(size_t _threadId, size_t _numThreads)
 {
-  const unsigned int numThreads = static_cast<unsigned int>(_numThreads);
-  const unsigned int threadId = static_cast<unsigned int>(_threadId);
-
-  double distance = std::numeric_limits<double>::max();
+  float distance = std::numeric_limits<float>::max();
 
   RayQueryResult result;
 
-  // Iterate over all the results.
-  for (auto iter = this->ogreResult.begin(); iter != this->ogreResult.end();
-       ++iter)
+  // Iterate over the results assigned to this thread. Every item is
+  // tested against the BVH of its mesh, which is cheap, so the work is
+  // split per item rather than per triangle. This also spreads the cost of
+  // building the BVH of meshes seen for the first time across threads.
+  Ogre2RayQueryCandidate candidate;
+  for (size_t i = _threadId; i < this->ogreResult.size(); i += _numThreads)
   {
-    if (iter->distance <= 0.0)
+    const Ogre::RaySceneQueryResultEntry &entry = this->ogreResult[i];
+    if (entry.distance <= 0.0)
       continue;
 
-    if (!iter->movable || !iter->movable->getVisible())
+    // results are sorted by distance, no item beyond this one can be closer
+    if (entry.distance > distance)
+      break;
+
+    if (!PrepareCandidate(entry.movable, candidate) ||
+        !ResolveCandidateBvh(candidate))
+    {
       continue;
+    }
 
-    auto userAny = iter->movable->getUserObjectBindings().getUserAny();
-    if (!userAny.isEmpty() && userAny.getType() == typeid(unsigned int) &&
-        iter->movable->getMovableType() == "Item")
+    if (IntersectCandidate(candidate, this->rayOrigin, this->rayDir,
+                           distance))
     {
-      Ogre::Item *ogreItem = static_cast<Ogre::Item *>(iter->movable);
+      // this is the closest so far, save it off
+      result.distance = distance;
+      result.point = Ogre2Conversions::Convert(
+          this->rayOrigin + this->rayDir * distance);
+      result.objectId = candidate.objectId;
+    }
+  }
 
-      // mesh factory creates name with ::CENTER or ::ORIGINAL depending on
-      // the params passed in the MeshDescriptor when loading the mesh
-      // so strip off the suffix
-      std::string meshName = ogreItem->getMesh()->getName();
-      size_t idx = meshName.find("::");
-      if (idx != std::string::npos)
-        meshName = meshName.substr(0, idx);
+  collectedResults[_threadId] = result;
+}
 
-      const common::Mesh *mesh =
-        common::MeshManager::Instance()->MeshByName(meshName);
+//////////////////////////////////////////////////
+RayQueryResult ThreadedTriRay::CollapseCollectedResults()
+{
+  RayQueryResult result;
+  for (const RayQueryResult &entry : this->collectedResults)
+  {
+    if (entry)
+    {
+      if (!result || entry.distance < result.distance)
+      {
+        result = entry;
+      }
+    }
+  }
+  return result;
+}
 
-      if (!mesh)
-        continue;
+/// \brief Maximum number of candidates in a leaf of the candidate BVH
+static constexpr std::uint32_t kCandidateLeafSize = 2u;
+
+/// \brief Maximum depth of the candidate BVH. Bounds the traversal stack.
+static constexpr unsigned int kCandidateBvhMaxDepth = 64u;
+
+/// \brief Slab test of a ray against an axis aligned box
+/// \param[in] _min Minimum corner of the box
+/// \param[in] _max Maximum corner of the box
+/// \param[in] _origin Ray origin
+/// \param[in] _invDir Inverse of the ray direction
+/// \param[in] _tMax Max distance along the ray
+/// \return Distance at which the ray enters the box, or max float if it
+/// misses the box or enters it beyond _tMax
+static float IntersectBox(const float _min[3], const float _max[3],
+    const Ogre::Vector3 &_origin, const float _invDir[3], float _tMax)
+{
+  float tNear = 0.0f;
+  float tFar = _tMax;
+  for (int a = 0; a < 3; ++a)
+  {
+    const float t0 = static_cast<float>(_min[a] - _origin[a]) * _invDir[a];
+    const float t1 = static_cast<float>(_max[a] - _origin[a]) * _invDir[a];
+    tNear = std::max(tNear, std::min(t0, t1));
+    tFar = std::min(tFar, std::max(t0, t1));
+  }
+  return tNear > tFar ? std::numeric_limits<float>::max() : tNear;
+}
 
-      Ogre::Matrix4 transform = ogreItem->_getParentNodeFullTransform();
+//////////////////////////////////////////////////
+void Ogre2RayQueryCandidateBvh::Build(
+    const std::vector<Ogre2RayQueryCandidate> &_candidates)
+{
+  this->nodes.clear();
+  this->indices.resize(_candidates.size());
+  for (std::size_t i = 0u; i < _candidates.size(); ++i)
+    this->indices[i] = static_cast<std::uint32_t>(i);
 
-      const bool bIsAffine = transform.isAffine();
+  if (_candidates.empty())
+    return;
 
-      Ogre::Ray mouseRay;
-#ifndef SLOW_METHOD
-      if (bIsAffine)
-      {
-        Ogre::Matrix4 invTransform = transform.inverse();
-        Ogre::Matrix3 invTransform3x3;
-        invTransform.extract3x3Matrix(invTransform3x3);
-        mouseRay = Ogre::Ray(invTransform * this->rayOrigin,
-                             (invTransform3x3 * this->rayDir).normalisedCopy());
-      }
-      else
-#endif
-      {
-        mouseRay = Ogre::Ray(this->rayOrigin, this->rayDir);
-      }
+  auto center = [&_candidates](std::uint32_t _idx, int _axis)
+  {
+    return _candidates[_idx].aabbMin[_axis] + _candidates[_idx].aabbMax[_axis];
+  };
+
+  // Build top-down, as in Ogre2MeshBvh. Every node owns a contiguous range
+  // of indices, which is partitioned in place when the node is split.
+  this->nodes.push_back(Node());
+  this->nodes[0].leftFirst = 0u;
+  this->nodes[0].count = static_cast<std::uint32_t>(_candidates.size());
+
+  std::vector<std::pair<std::uint32_t, unsigned int>> buildStack;
+  buildStack.emplace_back(0u, 1u);
+  while (!buildStack.empty())
+  {
+    const std::uint32_t nodeIdx = buildStack.back().first;
+    const unsigned int depth = buildStack.back().second;
+    buildStack.pop_back();
+
+    const std::uint32_t first = this->nodes[nodeIdx].leftFirst;
+    const std::uint32_t count = this->nodes[nodeIdx].count;
+
+    Ogre::Vector3 boundsMin(std::numeric_limits<float>::max());
+    Ogre::Vector3 boundsMax(std::numeric_limits<float>::lowest());
+    Ogre::Vector3 centerMin(std::numeric_limits<float>::max());
+    Ogre::Vector3 centerMax(std::numeric_limits<float>::lowest());
+    for (std::uint32_t i = first; i < first + count; ++i)
+    {
+      const Ogre2RayQueryCandidate &candidate =
+          _candidates[this->indices[i]];
+      boundsMin.makeFloor(candidate.aabbMin);
+      boundsMax.makeCeil(candidate.aabbMax);
+      const Ogre::Vector3 c = candidate.aabbMin + candidate.aabbMax;
+      centerMin.makeFloor(c);
+      centerMax.makeCeil(c);
+    }
+    for (int a = 0; a < 3; ++a)
+    {
+      this->nodes[nodeIdx].boundsMin[a] = boundsMin[a];
+      this->nodes[nodeIdx].boundsMax[a] = boundsMax[a];
+    }
 
-      // test for hitting individual triangles on the mesh
-      for (unsigned int j = 0; j < mesh->SubMeshCount(); ++j)
-      {
-        auto s = mesh->SubMeshByIndex(j);
-        auto submesh = s.lock();
-        if (!submesh || submesh->VertexCount() < 3u)
-          continue;
-        const unsigned int indexCount = submesh->IndexCount();
-
-        const math::Vector3d *RESTRICT_ALIAS vertices =
-          submesh->VertexPtr();
-        const unsigned int *RESTRICT_ALIAS indices = submesh->IndexPtr();
-
-        std::pair<bool, Ogre::Real> bestHit = {
-          false, std::numeric_limits<Ogre::Real>::max()
-        };
-
-        // Round up to next multiple of numThreads and divide by it
-        unsigned int indexCountPerThread =
-          (indexCount + (numThreads - 1u)) / numThreads;
-        // indexCountPerThread must be multiple of 3
-        indexCountPerThread = ((indexCountPerThread + 2u) / 3u) * 3u;
-
-        unsigned int indexStart =
-          std::min(indexCountPerThread * threadId, indexCount);
-        unsigned int indexEnd =
-          std::min(indexCountPerThread * (threadId + 1u), indexCount);
-
-        for (unsigned int k = indexStart; k < indexEnd; k += 3)
-        {
-          if (indexCount <= k + 2)
-            continue;
-
-#ifdef SLOW_METHOD
-          math::Vector3d vertexA = submesh->Vertex(submesh->Index(k));
-          math::Vector3d vertexB = submesh->Vertex(submesh->Index(k + 1));
-          math::Vector3d vertexC = submesh->Vertex(submesh->Index(k + 2));
-
-          Ogre::Vector3 worldVertexA =
-            transform * Ogre2Conversions::Convert(vertexA);
-          Ogre::Vector3 worldVertexB =
-            transform * Ogre2Conversions::Convert(vertexB);
-          Ogre::Vector3 worldVertexC =
-            transform * Ogre2Conversions::Convert(vertexC);
-#else
-          Ogre::Vector3 worldVertexA, worldVertexB, worldVertexC;
+    if (count <= kCandidateLeafSize || depth >= kCandidateBvhMaxDepth)
+      continue;
 
-          if (bIsAffine)
-          {
-            worldVertexA = Ogre2Conversions::Convert(vertices[indices[k]]);
-            worldVertexB = Ogre2Conversions::Convert(vertices[indices[k + 1]]);
-            worldVertexC = Ogre2Conversions::Convert(vertices[indices[k + 2]]);
-          }
-          else
-          {
-            worldVertexA =
-              transform * Ogre2Conversions::Convert(vertices[indices[k]]);
-            worldVertexB =
-              transform * Ogre2Conversions::Convert(vertices[indices[k + 1]]);
-            worldVertexC =
-              transform * Ogre2Conversions::Convert(vertices[indices[k + 2]]);
-          }
-#endif
+    // split along the axis where the centers are the most spread out
+    const Ogre::Vector3 extent = centerMax - centerMin;
+    int axis = 0;
+    if (extent.y > extent[axis])
+      axis = 1;
+    if (extent.z > extent[axis])
+      axis = 2;
+    if (extent[axis] <= 0.0f)
+      continue;
 
-          // check for a hit against this triangle
-          std::pair<bool, Ogre::Real> hit = Ogre::Math::intersects(
-            mouseRay, worldVertexA, worldVertexB, worldVertexC, true, false);
+    const std::uint32_t leftCount = count / 2u;
+    std::nth_element(this->indices.begin() + first,
+        this->indices.begin() + first + leftCount,
+        this->indices.begin() + first + count,
+        [&](std::uint32_t _a, std::uint32_t _b)
+        {
+          return center(_a, axis) < center(_b, axis);
+        });
+
+    const std::uint32_t leftIdx = static_cast<std::uint32_t>(
+        this->nodes.size());
+    this->nodes.push_back(Node());
+    this->nodes.push_back(Node());
+    this->nodes[leftIdx].leftFirst = first;
+    this->nodes[leftIdx].count = leftCount;
+    this->nodes[leftIdx + 1u].leftFirst = first + leftCount;
+    this->nodes[leftIdx + 1u].count = count - leftCount;
+    this->nodes[nodeIdx].leftFirst = leftIdx;
+    this->nodes[nodeIdx].count = 0u;
+
+    buildStack.emplace_back(leftIdx + 1u, depth + 1u);
+    buildStack.emplace_back(leftIdx, depth + 1u);
+  }
+}
 
-          // if it was a hit check if its the closest
-          if (hit.first && hit.second < bestHit.second)
-          {
-            bestHit = hit;
-          }
-        }
+//////////////////////////////////////////////////
+template <class F>
+void Ogre2RayQueryCandidateBvh::Traverse(const Ogre::Vector3 &_origin,
+    const float _invDir[3], const float &_distance, F _visit) const
+{
+  if (this->nodes.empty())
+    return;
 
-        if (bestHit.first && distance > bestHit.second)
-        {
-          // this is the closest so far, save it off
-          distance = bestHit.second;
-          result.distance = distance;
-          if (bIsAffine)
-          {
-            result.point = Ogre2Conversions::Convert(
-              transform * mouseRay.getPoint(distance));
-          }
-          else
-          {
-            result.point =
-              Ogre2Conversions::Convert(mouseRay.getPoint(distance));
-          }
-          result.objectId = Ogre::any_cast<unsigned int>(userAny);
-        }
+  const float kMiss = std::numeric_limits<float>::max();
+  if (IntersectBox(this->nodes[0].boundsMin, this->nodes[0].boundsMax,
+                   _origin, _invDir, _distance) == kMiss)
+  {
+    return;
+  }
+
+  std::uint32_t stack[kCandidateBvhMaxDepth * 2u];
+  unsigned int stackSize = 0u;
+  stack[stackSize++] = 0u;
+  while (stackSize > 0u)
+  {
+    const Node &node = this->nodes[stack[--stackSize]];
+    if (node.count > 0u)
+    {
+      for (std::uint32_t i = node.leftFirst; i < node.leftFirst + node.count;
+           ++i)
+      {
+        _visit(this->indices[i]);
       }
+      continue;
     }
-  }
 
-  collectedResults[_threadId] = result;
+    // visit the nearest child first so that hits in it cull the other one
+    std::uint32_t nearIdx = node.leftFirst;
+    std::uint32_t farIdx = node.leftFirst + 1u;
+    float nearT = IntersectBox(this->nodes[nearIdx].boundsMin,
+        this->nodes[nearIdx].boundsMax, _origin, _invDir, _distance);
+    float farT = IntersectBox(this->nodes[farIdx].boundsMin,
+        this->nodes[farIdx].boundsMax, _origin, _invDir, _distance);
+    if (farT < nearT)
+    {
+      std::swap(nearIdx, farIdx);
+      std::swap(nearT, farT);
+    }
+    if (farT != kMiss)
+      stack[stackSize++] = farIdx;
+    if (nearT != kMiss)
+      stack[stackSize++] = nearIdx;
+  }
 }
 
+/// \brief Number of rays a worker thread claims at a time in batched
+/// queries
+static constexpr size_t kRayPacketSize = 64u;
+
+/// \brief This class performs a Triangle-level raycast of a batch of rays
+/// against a list of candidates prepared once for the whole batch.
+/// Threads claim packets of rays until all rays are done, which balances
+/// the load when some rays are much more expensive than others.
+/// The BVH of a candidate is only resolved the first time a ray reaches its
+/// world bounding box, so a small batch doesn't pay for triangulating every
+/// mesh in the scene.
+class GZ_RENDERING_OGRE2_HIDDEN ThreadedBatchRay final
+  : public Ogre::UniformScalableTask
+{
+  /// \brief Items that may be hit
+  private: std::vector<Ogre2RayQueryCandidate> &candidates;
+
+  /// \brief One flag per candidate, so that its BVH is resolved by a
+  /// single thread while the others wait for it
+  private: std::unique_ptr<std::once_flag[]> bvhResolved;
+
+  /// \brief Hierarchy over the bounding boxes of the candidates
+  private: const Ogre2RayQueryCandidateBvh &candidateBvh;
+
+  /// \brief Ray origins
+  private: const std::vector<math::Vector3d> &origins;
+
+  /// \brief Ray directions
+  private: const std::vector<math::Vector3d> &directions;
+
+  /// \brief Closest intersection of each ray
+  private: std::vector<RayQueryResult> &results;
+
+  /// \brief Index of the next packet of rays to claim
+  private: std::atomic<size_t> nextPacket{0u};
+
+  /// \brief Constructor
+  /// \param[in, out] _candidates Items that may be hit. Their BVHs are
+  /// resolved as rays reach them
+  /// \param[in] _candidateBvh Hierarchy built over _candidates
+  /// \param[in] _origins Ray origins
+  /// \param[in] _directions Ray directions
+  /// \param[out] _results Closest intersection of each ray, must have the
+  /// same size as _origins
+  public: ThreadedBatchRay(
+              std::vector<Ogre2RayQueryCandidate> &_candidates,
+              const Ogre2RayQueryCandidateBvh &_candidateBvh,
+              const std::vector<math::Vector3d> &_origins,
+              const std::vector<math::Vector3d> &_directions,
+              std::vector<RayQueryResult> &_results) :
+      candidates(_candidates),
+      bvhResolved(new std::once_flag[_candidates.size()]),
+      candidateBvh(_candidateBvh),
+      origins(_origins),
+      directions(_directions),
+      results(_results)
+  {
+  }
+
+  // Documentation inherited
+  public: void execute(size_t _threadId, size_t _numThreads) override;
+};
+
 //////////////////////////////////////////////////
-RayQueryResult ThreadedTriRay::CollapseCollectedResults()
+void ThreadedBatchRay::execute(size_t /*_threadId*/, size_t /*_numThreads*/)
 {
-  RayQueryResult result;
-  for (const RayQueryResult &entry : this->collectedResults)
+  const size_t rayCount = this->origins.size();
+  while (true)
   {
-    if (entry)
+    const size_t first = this->nextPacket.fetch_add(1u) * kRayPacketSize;
+    if (first >= rayCount)
+      break;
+    const size_t last = std::min(first + kRayPacketSize, rayCount);
+
+    for (size_t i = first; i < last; ++i)
     {
-      if (!result || entry.distance < result.distance)
+      const Ogre::Vector3 rayOrigin =
+          Ogre2Conversions::Convert(this->origins[i]);
+      Ogre::Vector3 rayDir = Ogre2Conversions::Convert(this->directions[i]);
+      if (rayDir.normalise() <= Ogre::Real(0))
+        continue;
+
+      float invDir[3];
+      for (int a = 0; a < 3; ++a)
       {
-        result = entry;
+        invDir[a] = std::fabs(rayDir[a]) > Ogre::Real(1e-20) ?
+            static_cast<float>(1.0 / rayDir[a]) :
+            std::numeric_limits<float>::max();
+      }
+
+      // broadphase: walk the hierarchy over the items' world bounding boxes
+      // and slab test each item reached against its own box. As in
+      // ThreadedTriRay, items whose box contains the ray origin are skipped.
+      float distance = std::numeric_limits<float>::max();
+      const Ogre2RayQueryCandidate *hitCandidate = nullptr;
+      this->candidateBvh.Traverse(rayOrigin, invDir, distance,
+          [&](std::uint32_t _idx)
+          {
+            Ogre2RayQueryCandidate &candidate = this->candidates[_idx];
+            const float boxDistance = IntersectBox(candidate.aabbMin.ptr(),
+                candidate.aabbMax.ptr(), rayOrigin, invDir, distance);
+            if (boxDistance <= 0.0f ||
+                boxDistance == std::numeric_limits<float>::max())
+            {
+              return;
+            }
+
+            std::call_once(this->bvhResolved[_idx],
+                [&candidate]() { ResolveCandidateBvh(candidate); });
+            if (!candidate.bvh)
+              return;
+
+            if (IntersectCandidate(candidate, rayOrigin, rayDir, distance))
+              hitCandidate = &candidate;
+          });
+
+      RayQueryResult &result = this->results[i];
+      if (hitCandidate)
+      {
+        result.distance = distance;
+        result.point = Ogre2Conversions::Convert(rayOrigin + rayDir * distance);
+        result.objectId = hitCandidate->objectId;
       }
     }
   }
-  return result;
 }
 
 //////////////////////////////////////////////////
@@ -528,7 +910,8 @@ RayQueryResult Ogre2RayQuery::ClosestPointByIntersection(bool _forceSceneUpdate)
   }
 
   const Ogre::Vector3 rayOrigin = Ogre2Conversions::Convert(this->origin);
-  const Ogre::Vector3 rayDir = Ogre2Conversions::Convert(this->direction);
+  const Ogre::Vector3 rayDir =
+      Ogre2Conversions::Convert(this->direction).normalisedCopy();
 
   Ogre::Ray mouseRay(rayOrigin, rayDir);
 
@@ -555,3 +938,64 @@ RayQueryResult Ogre2RayQuery::ClosestPointByIntersection(bool _forceSceneUpdate)
 
   return result;
 }
+
+//////////////////////////////////////////////////
+void Ogre2RayQuery::ClosestPoints(
+    const std::vector<math::Vector3d> &_origins,
+    const std::vector<math::Vector3d> &_directions,
+    std::vector<RayQueryResult> &_results,
+    bool _forceSceneUpdate)
+{
+  _results.clear();
+  if (_origins.size() != _directions.size())
+  {
+    gzerr << "Number of ray origins [" << _origins.size()
+          << "] does not match number of directions ["
+          << _directions.size() << "]" << std::endl;
+    return;
+  }
+  _results.resize(_origins.size());
+
+  Ogre2ScenePtr ogreScene =
+      std::dynamic_pointer_cast<Ogre2Scene>(this->Scene());
+  if (!ogreScene || _origins.empty())
+    return;
+
+  Ogre::SceneManager *ogreSceneManager = ogreScene->OgreSceneManager();
+
+  if (_forceSceneUpdate)
+  {
+    ogreSceneManager->updateSceneGraph();
+  }
+
+  // Gather the items that can be hit once for the whole batch instead of
+  // running Ogre's broadphase once per ray. This only reads their bounds
+  // and transforms, their BVHs are resolved as rays reach them.
+  std::vector<Ogre2RayQueryCandidate> &candidates = this->dataPtr->candidates;
+  candidates.clear();
+  Ogre::SceneManager::MovableObjectIterator itemIt =
+      ogreSceneManager->getMovableObjectIterator(
+      Ogre::ItemFactory::FACTORY_TYPE_NAME);
+  Ogre2RayQueryCandidate candidate;
+  while (itemIt.hasMoreElements())
+  {
+    if (PrepareCandidate(itemIt.getNext(), candidate))
+      candidates.push_back(candidate);
+  }
+
+  if (candidates.empty())
+    return;
+
+  this->dataPtr->candidateBvh.Build(candidates);
+
+  ThreadedBatchRay rayTask(candidates, this->dataPtr->candidateBvh,
+                           _origins, _directions, _results);
+#ifndef SINGLE_THREADED
+  ogreSceneManager->executeUserScalableTask(&rayTask, true);
+#else
+  rayTask.execute(0u, 1u);
+#endif
+
+  // don't keep meshes alive past this call
+  candidates.clear();
+}
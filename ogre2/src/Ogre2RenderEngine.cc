@@ -20,6 +20,12 @@
   // pulled in by anybody (e.g., Boost).
   #include <Winsock2.h>
 #endif
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
 #include <gz/common/Console.hh>
 #include <gz/common/Filesystem.hh>
 #include <gz/common/Util.hh>
@@ -36,6 +42,7 @@
 #include "gz/rendering/ogre2/Ogre2Scene.hh"
 #include "gz/rendering/ogre2/Ogre2Storage.hh"
 
+#include "Ogre2CacheFile.hh"
 #include "Ogre2GzHlmsPbsPrivate.hh"
 #include "Ogre2GzHlmsTerraPrivate.hh"
 #include "Ogre2GzHlmsUnlitPrivate.hh"
@@ -57,6 +64,8 @@
 #include "Terra/Hlms/PbsListener/OgreHlmsPbsTerraShadows.h"
 #include "Terra/TerraWorkspaceListener.h"
 
+#include <OgreHlmsDiskCache.h>
+
 #if HAVE_GLX
 # include <X11/Xlib.h>
 # include <X11/Xutil.h>
@@ -105,6 +114,20 @@ class GZ_RENDERING_OGRE2_HIDDEN
   /// \brief Custom Terra modifications
   public: Ogre::Ogre2GzHlmsTerra *gzHlmsTerra{nullptr};
 
+  /// \brief Folder the HLMS and shader microcode caches are loaded from
+  /// and saved to. It is a subfolder of the "shaderCachePath" engine
+  /// parameter named after the GPU, driver and library versions, so that
+  /// caches are never shared by incompatible setups. Empty if disabled.
+  public: std::string shaderCacheDir;
+
+  /// \brief Contents of the key file stored with the shader caches. It
+  /// describes the setup the caches were built for.
+  public: std::string shaderCacheKey;
+
+  /// \brief Folder packed meshes are cached in. Given by the
+  /// "meshCachePath" engine parameter. Empty if disabled.
+  public: std::string meshCacheDir;
+
 #ifdef OGRE_BUILD_RENDERSYSTEM_VULKAN
   /// \brief Needed to receive an external Vulkan device from Qt
   /// and inject it into OgreNext.
@@ -127,6 +150,65 @@ class GZ_RENDERING_OGRE2_HIDDEN
 using namespace gz;
 using namespace rendering;
 
+/// \brief Name of the file holding the key of the shader caches
+static const char kShaderCacheKeyFile[] = "key.txt";
+
+/// \brief Name of the file holding the shader microcode cache
+static const char kShaderMicrocodeFile[] = "microcode.cache";
+
+//////////////////////////////////////////////////
+/// \brief Name of the file holding the HLMS disk cache of an HLMS type
+/// \param[in] _type HLMS type
+/// \return File name
+static std::string HlmsDiskCacheFile(size_t _type)
+{
+  return "hlms" + std::to_string(_type) + ".cache";
+}
+
+//////////////////////////////////////////////////
+/// \brief Open a file for reading as an Ogre data stream
+/// \param[in] _path Path to the file
+/// \return The stream, or null if the file can't be opened
+static Ogre::DataStreamPtr OpenCacheFile(const std::string &_path)
+{
+  auto file = OGRE_NEW_T(std::ifstream, Ogre::MEMCATEGORY_GENERAL)(
+      _path.c_str(), std::ios::in | std::ios::binary);
+  if (!file->is_open())
+  {
+    OGRE_DELETE_T(file, basic_ifstream, Ogre::MEMCATEGORY_GENERAL);
+    return Ogre::DataStreamPtr();
+  }
+  return Ogre::DataStreamPtr(
+      OGRE_NEW Ogre::FileStreamDataStream(_path, file, true));
+}
+
+//////////////////////////////////////////////////
+/// \brief Write a shader cache file with an Ogre data stream
+/// \param[in] _path Path to the file
+/// \param[in] _write Function writing the data to the given stream
+/// \return True on success
+template <typename WriteFunc>
+static bool SaveCacheFile(const std::string &_path, WriteFunc _write)
+{
+  return Ogre2WriteCacheFile(_path, [&](std::fstream &_file)
+  {
+    // the file is owned by Ogre2WriteCacheFile, the stream only closes it
+    Ogre::DataStreamPtr stream(
+        OGRE_NEW Ogre::FileStreamDataStream(_path, &_file, 0u, false));
+    try
+    {
+      _write(stream);
+    }
+    catch (Ogre::Exception &_e)
+    {
+      gzwarn << "Unable to write shader cache file [" << _path << "]: "
+             << _e.what() << std::endl;
+      return false;
+    }
+    return true;
+  });
+}
+
 //////////////////////////////////////////////////
 Ogre2RenderEnginePlugin::Ogre2RenderEnginePlugin()
 {
@@ -192,6 +274,8 @@ void Ogre2RenderEngine::Destroy()
 
   this->dataPtr->hlmsPbsTerraShadows.reset();
 
+  this->SaveShaderCache();
+
   if (this->ogreRoot)
   {
     // Clean up any textures that may still be in flight.
@@ -391,6 +475,14 @@ bool Ogre2RenderEngine::LoadImpl(
         this->dataPtr->graphicsAPI = GraphicsAPI::METAL;
   }
 
+  it = _params.find("shaderCachePath");
+  if (it != _params.end())
+    this->dataPtr->shaderCacheDir = it->second;
+
+  it = _params.find("meshCachePath");
+  if (it != _params.end())
+    this->dataPtr->meshCacheDir = it->second;
+
 #ifdef OGRE_BUILD_RENDERSYSTEM_VULKAN
   this->dataPtr->vkExternalInstance.instance = nullptr;
   this->dataPtr->vkExternalDevice.physicalDevice = nullptr;
@@ -504,6 +596,159 @@ void Ogre2RenderEngine::LoadAttempt()
   this->ogreRoot->initialise(false);
   this->CreateRenderWindow();
   this->CreateResources();
+  this->LoadShaderCache();
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderEngine::LoadShaderCache()
+{
+  if (this->dataPtr->shaderCacheDir.empty() || !this->ogreRoot)
+    return;
+
+  Ogre::RenderSystem *renderSys = this->ogreRoot->getRenderSystem();
+  const Ogre::RenderSystemCapabilities *caps = renderSys->getCapabilities();
+
+  // Shaders built for a GPU, driver or library version can't be reused
+  // with another one. Keep one folder per setup.
+  std::ostringstream key;
+  key << "gz-rendering " << GZ_RENDERING_VERSION_FULL << "\n"
+      << "OgreNext " << OGRE_VERSION_MAJOR << "." << OGRE_VERSION_MINOR << "."
+      << OGRE_VERSION_PATCH << "\n"
+      << "Render system " << renderSys->getName() << "\n"
+      << "Vendor " << Ogre::RenderSystemCapabilities::vendorToString(
+           caps->getVendor()) << "\n"
+      << "Device " << caps->getDeviceName() << "\n"
+      << "Driver " << caps->getDriverVersion().toString() << "\n";
+  this->dataPtr->shaderCacheKey = key.str();
+
+  // The hash is only used to name the folder. The key file is checked on
+  // load in case of collisions.
+  Ogre2CacheHash hash;
+  hash.Update(this->dataPtr->shaderCacheKey);
+  this->dataPtr->shaderCacheDir =
+      common::joinPaths(this->dataPtr->shaderCacheDir, hash.Hex());
+
+  if (!common::createDirectories(this->dataPtr->shaderCacheDir))
+  {
+    gzwarn << "Unable to create shader cache folder ["
+           << this->dataPtr->shaderCacheDir << "]. Shaders won't be cached."
+           << std::endl;
+    this->dataPtr->shaderCacheDir.clear();
+    return;
+  }
+
+  Ogre::GpuProgramManager &gpuProgramMgr =
+      Ogre::GpuProgramManager::getSingleton();
+  if (gpuProgramMgr.canGetCompiledShaderBuffer())
+    gpuProgramMgr.setSaveMicrocodesToCache(true);
+
+  // Only load caches written for this exact setup
+  const std::string keyPath = common::joinPaths(
+      this->dataPtr->shaderCacheDir, kShaderCacheKeyFile);
+  std::ifstream keyFile(keyPath, std::ios::binary);
+  std::string savedKey((std::istreambuf_iterator<char>(keyFile)),
+      std::istreambuf_iterator<char>());
+  if (savedKey != this->dataPtr->shaderCacheKey)
+    return;
+
+  const std::string microcodePath = common::joinPaths(
+      this->dataPtr->shaderCacheDir, kShaderMicrocodeFile);
+  if (gpuProgramMgr.canGetCompiledShaderBuffer() &&
+      common::exists(microcodePath))
+  {
+    try
+    {
+      Ogre::DataStreamPtr stream = OpenCacheFile(microcodePath);
+      if (stream)
+        gpuProgramMgr.loadMicrocodeCache(stream);
+    }
+    catch (Ogre::Exception &_e)
+    {
+      gzwarn << "Discarding invalid shader microcode cache ["
+             << microcodePath << "]: " << _e.what() << std::endl;
+      common::removeFile(microcodePath);
+    }
+  }
+
+  Ogre::HlmsManager *hlmsManager = this->ogreRoot->getHlmsManager();
+  Ogre::HlmsDiskCache diskCache(hlmsManager);
+  for (size_t i = Ogre::HLMS_LOW_LEVEL + 1u; i < Ogre::HLMS_MAX; ++i)
+  {
+    Ogre::Hlms *hlms = hlmsManager->getHlms(static_cast<Ogre::HlmsTypes>(i));
+    const std::string path = common::joinPaths(
+        this->dataPtr->shaderCacheDir, HlmsDiskCacheFile(i));
+    if (!hlms || !common::exists(path))
+      continue;
+
+    // The disk cache stores the hash of the HLMS templates. Shaders are
+    // regenerated from the cached properties if the templates changed.
+    try
+    {
+      Ogre::DataStreamPtr stream = OpenCacheFile(path);
+      if (stream)
+      {
+        diskCache.loadFrom(stream);
+        diskCache.applyTo(hlms);
+      }
+    }
+    catch (Ogre::Exception &_e)
+    {
+      gzwarn << "Discarding invalid HLMS cache [" << path << "]: "
+             << _e.what() << std::endl;
+      common::removeFile(path);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderEngine::SaveShaderCache()
+{
+  if (this->dataPtr->shaderCacheDir.empty() || !this->ogreRoot ||
+      !this->ogreRoot->getRenderSystem() ||
+      !Ogre::GpuProgramManager::getSingletonPtr())
+  {
+    return;
+  }
+
+  Ogre::HlmsManager *hlmsManager = this->ogreRoot->getHlmsManager();
+  Ogre::HlmsDiskCache diskCache(hlmsManager);
+  for (size_t i = Ogre::HLMS_LOW_LEVEL + 1u; i < Ogre::HLMS_MAX; ++i)
+  {
+    Ogre::Hlms *hlms = hlmsManager->getHlms(static_cast<Ogre::HlmsTypes>(i));
+    if (!hlms)
+      continue;
+
+    diskCache.copyFrom(hlms);
+    SaveCacheFile(common::joinPaths(
+        this->dataPtr->shaderCacheDir, HlmsDiskCacheFile(i)),
+        [&diskCache](Ogre::DataStreamPtr &_stream)
+        {
+          diskCache.saveTo(_stream);
+        });
+  }
+
+  Ogre::GpuProgramManager &gpuProgramMgr =
+      Ogre::GpuProgramManager::getSingleton();
+  if (gpuProgramMgr.getSaveMicrocodesToCache() && gpuProgramMgr.isCacheDirty())
+  {
+    SaveCacheFile(common::joinPaths(
+        this->dataPtr->shaderCacheDir, kShaderMicrocodeFile),
+        [&gpuProgramMgr](Ogre::DataStreamPtr &_stream)
+        {
+          gpuProgramMgr.saveMicrocodeCache(_stream);
+        });
+  }
+
+  // Written last so that the caches are only used once complete
+  const std::string key = this->dataPtr->shaderCacheKey;
+  SaveCacheFile(common::joinPaths(
+      this->dataPtr->shaderCacheDir, kShaderCacheKeyFile),
+      [&key](Ogre::DataStreamPtr &_stream)
+      {
+        _stream->write(key.data(), key.size());
+      });
+
+  this->dataPtr->shaderCacheDir.clear();
 }
 
 //////////////////////////////////////////////////
@@ -1449,6 +1694,12 @@ Ogre::HlmsPbsTerraShadows *Ogre2RenderEngine::HlmsPbsTerraShadows() const
   return this->dataPtr->hlmsPbsTerraShadows.get();
 }
 
+/////////////////////////////////////////////////
+std::string Ogre2RenderEngine::MeshCachePath() const
+{
+  return this->dataPtr->meshCacheDir;
+}
+
 /////////////////////////////////////////////////
 Ogre::CompositorWorkspaceListener *Ogre2RenderEngine::TerraWorkspaceListener()
   const
@@ -30,6 +30,8 @@
 
 #include <string.h>
 
+#include "Ogre2AsyncReadback.hh"
+
 namespace gz
 {
 namespace rendering
@@ -102,6 +104,10 @@ class gz::rendering::Ogre2RenderTargetPrivate
   /// actual window
   ///
   public: Ogre::TextureGpu *ogreTexture[2] = {nullptr, nullptr};
+
+  /// \brief Asynchronous readback of the final texture, used when the
+  /// readback latency is greater than 0
+  public: Ogre2AsyncReadback readback;
 };
 
 using namespace gz;
@@ -415,6 +421,28 @@ void Ogre2RenderTarget::Copy(Image &_image) const
       texture->getInternalWidth(), texture->getInternalHeight(), 1u, 1u,
       dstOgrePf, 1u)));
 
+  // copy either the frame downloaded asynchronously _latency frames ago or
+  // the current content of the texture
+  Ogre2AsyncReadback &readback = this->dataPtr->readback;
+  auto copyToMemory = [&](Ogre::TextureBox &_dstBox)
+  {
+    if (readback.Latency() > 0u)
+    {
+      Ogre::TextureBox srcBox = readback.MapFrame();
+      Ogre::PixelFormatGpuUtils::bulkPixelConversion(
+          srcBox, texture->getPixelFormat(), _dstBox, dstOgrePf);
+      readback.UnmapFrame();
+    }
+    else
+    {
+      Ogre::Image2::copyContentsToMemory(
+          texture, texture->getEmptyBox(0u), _dstBox, dstOgrePf);
+    }
+  };
+
+  if (readback.Latency() > 0u && !readback.FrameReady())
+    return;
+
   if ((_image.Format() == PF_BAYER_RGGB8) ||
       (_image.Format() == PF_BAYER_BGGR8) ||
       (_image.Format() == PF_BAYER_GBRG8) ||
@@ -423,16 +451,14 @@ void Ogre2RenderTarget::Copy(Image &_image) const
     // create tmp color image to get data from gpu
     Image colorImage(this->width, this->height, PF_R8G8B8);
     dstBox.data = colorImage.Data();
-    Ogre::Image2::copyContentsToMemory(
-        texture, texture->getEmptyBox(0u), dstBox, dstOgrePf);
+    copyToMemory(dstBox);
     // convert color image to bayer image
     _image = gz::rendering::convertRGBToBayer(colorImage, _image.Format());
   }
   else
   {
     dstBox.data = _image.Data();
-    Ogre::Image2::copyContentsToMemory(
-        texture, texture->getEmptyBox(0u), dstBox, dstOgrePf);
+    copyToMemory(dstBox);
   }
 }
 
@@ -505,7 +531,21 @@ void Ogre2RenderTarget::PreRender()
 //////////////////////////////////////////////////
 void Ogre2RenderTarget::PostRender()
 {
-  // do nothing by default
+  // start downloading the frame if the readback is asynchronous
+  if (this->dataPtr->readback.Latency() > 0u)
+    this->dataPtr->readback.Download(this->RenderTarget());
+}
+
+//////////////////////////////////////////////////
+void Ogre2RenderTarget::SetReadbackLatency(unsigned int _latency)
+{
+  this->dataPtr->readback.SetLatency(_latency);
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2RenderTarget::ReadbackLatency() const
+{
+  return this->dataPtr->readback.Latency();
 }
 
 //////////////////////////////////////////////////
@@ -537,6 +577,7 @@ void Ogre2RenderTarget::DestroyTargetImpl()
   if (nullptr == this->dataPtr->ogreTexture[0])
     return;
 
+  this->dataPtr->readback.Reset();
   this->DestroyCompositor();
 
   Ogre::Root *root = Ogre2RenderEngine::Instance()->OgreRoot();
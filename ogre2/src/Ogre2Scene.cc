@@ -15,7 +15,31 @@
  *
  */
 
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <limits>
+#include <list>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <gz/common/AssimpLoader.hh>
+#include <gz/common/ColladaLoader.hh>
 #include <gz/common/Console.hh>
+#include <gz/common/Filesystem.hh>
+#include <gz/common/Mesh.hh>
+#include <gz/common/MeshManager.hh>
+#include <gz/common/ObjLoader.hh>
+#include <gz/common/STLLoader.hh>
+#include <gz/common/StringUtils.hh>
+#include <gz/common/Util.hh>
+#include <gz/common/WorkerPool.hh>
 
 #include "gz/rendering/base/SceneExt.hh"
 #include "gz/rendering/GraphicsAPI.hh"
@@ -35,12 +59,14 @@
 #include "gz/rendering/ogre2/Ogre2Grid.hh"
 #include "gz/rendering/ogre2/Ogre2Heightmap.hh"
 #include "gz/rendering/ogre2/Ogre2InertiaVisual.hh"
+#include "gz/rendering/ogre2/Ogre2InstancedVisual.hh"
 #include "gz/rendering/ogre2/Ogre2JointVisual.hh"
 #include "gz/rendering/ogre2/Ogre2Light.hh"
 #include "gz/rendering/ogre2/Ogre2LightVisual.hh"
 #include "gz/rendering/ogre2/Ogre2LidarVisual.hh"
 #include "gz/rendering/ogre2/Ogre2Marker.hh"
 #include "gz/rendering/ogre2/Ogre2Material.hh"
+#include "gz/rendering/ogre2/Ogre2Mesh.hh"
 #include "gz/rendering/ogre2/Ogre2MeshFactory.hh"
 #include "gz/rendering/ogre2/Ogre2Node.hh"
 #include "gz/rendering/ogre2/Ogre2ParticleEmitter.hh"
@@ -63,6 +89,7 @@
 #include <Compositor/Pass/PassClear/OgreCompositorPassClearDef.h>
 #include <Compositor/Pass/PassQuad/OgreCompositorPassQuadDef.h>
 #include <Compositor/Pass/PassScene/OgreCompositorPassSceneDef.h>
+#include <Hlms/Pbs/OgreHlmsPbsDatablock.h>
 #include <OgreDepthBuffer.h>
 #include <OgreMatrix4.h>
 #include <OgrePlatformInformation.h>
@@ -73,6 +100,14 @@
 #if OGRE_VERSION_MAJOR == 2 && OGRE_VERSION_MINOR == 1
 #include <OgreHlms.h>
 #include <OgreHlmsManager.h>
+#else
+#include <Hlms/Unlit/OgreHlmsUnlitDatablock.h>
+#include <OgreCamera.h>
+#include <OgreHlms.h>
+#include <OgreHlmsManager.h>
+#include <OgreItem.h>
+#include <OgreTextureGpu.h>
+#include <OgreTextureGpuManager.h>
 #endif
 
 #include "Terra/Terra.h"
@@ -112,11 +147,458 @@ class gz::rendering::Ogre2ScenePrivate
 
   /// \brief See Ogre2Scene::SetLightsGiDirty
   public: bool lightsGiDirty = false;
+
+  /// \brief See Ogre2Scene::VisualsRevision
+  public: uint64_t visualsRevision = 0u;
+
+  /// \brief See Scene::SetTextureResidencyPolicy
+  public: TextureResidencyPolicy textureResidencyPolicy = TRP_BLOCK_ALWAYS;
+
+  /// \brief See Scene::SetTextureWarmUpFrameCount
+  public: unsigned int textureWarmUpFrameCount = 60u;
+
+  /// \brief Number of PreRender calls left before the texture warm-up
+  /// phase ends
+  public: unsigned int textureWarmUpFramesLeft = 60u;
+
+  /// \brief True if the current frame is part of the texture warm-up phase
+  public: bool textureWarmUp = true;
+
+  /// \brief A visual the scene may make static, see
+  /// Scene::SetAutoStaticFrameCount
+  public: struct AutoStaticCandidate
+  {
+    /// \brief The visual
+    std::weak_ptr<Ogre2Visual> visual;
+
+    /// \brief Value of frameCount when the visual last moved
+    uint64_t lastMoved = 0u;
+  };
+
+  /// \brief See Scene::SetAutoStaticFrameCount
+  public: unsigned int autoStaticFrameCount = 0u;
+
+  /// \brief Number of PreRender calls so far
+  public: uint64_t frameCount = 0u;
+
+  /// \brief Dynamic visuals that may be made static, indexed by id
+  public: std::unordered_map<unsigned int, AutoStaticCandidate>
+      autoStaticCandidates;
+
+  /// \brief Ids of the visuals made static by the scene
+  public: std::unordered_set<unsigned int> autoStaticVisuals;
+
+  /// \brief Visuals revision the candidates were gathered at
+  public: uint64_t autoStaticRevision = std::numeric_limits<uint64_t>::max();
+
+  /// \brief A mesh requested with Scene::CreateMeshAsync
+  public: struct PendingMesh
+  {
+    /// \brief Id of the mesh object
+    unsigned int id = 0u;
+
+    /// \brief Name of the mesh object
+    std::string name;
+
+    /// \brief Descriptor of the mesh to create
+    MeshDescriptor desc;
+
+    /// \brief Mesh file to parse on a worker thread. Empty if the
+    /// common::MeshManager already has the mesh.
+    std::string path;
+
+    /// \brief Mesh parsed on a worker thread. It is added to the
+    /// common::MeshManager on the render thread, since the mesh manager is
+    /// not thread safe.
+    std::unique_ptr<common::Mesh> parsedMesh;
+
+    /// \brief Set to true by a worker thread once the CPU side work is
+    /// done
+    std::atomic<bool> prepared{false};
+
+    /// \brief Promise fulfilled once the mesh is created
+    std::promise<MeshPtr> promise;
+  };
+
+  /// \brief Meshes requested with Scene::CreateMeshAsync and not created
+  /// yet. Only accessed from the render thread.
+  public: std::list<std::shared_ptr<PendingMesh>> pendingMeshes;
+
+  /// \brief Worker threads doing the CPU side work of CreateMeshAsync.
+  /// Created on first use.
+  public: std::unique_ptr<common::WorkerPool> meshWorkers;
+
+#if OGRE_VERSION_MAJOR != 2 || OGRE_VERSION_MINOR != 1
+  /// \brief An item using textures that are still being loaded
+  public: struct PendingTextureItem
+  {
+    /// \brief The item
+    Ogre::Item *item;
+
+    /// \brief Textures of the item that are not loaded yet
+    std::vector<Ogre::TextureGpu *> textures;
+  };
+
+  /// \brief Items with textures that are still being loaded. Used by
+  /// TRP_BLOCK_VISIBLE to only look at these items on every camera
+  /// render. Entries are dropped once their textures are loaded.
+  public: std::vector<PendingTextureItem> pendingTextureItems;
+
+  /// \brief Value of visualsRevision when pendingTextureItems was built
+  public: uint64_t pendingTexturesVisualsRevision =
+      std::numeric_limits<uint64_t>::max();
+
+  /// \brief Value of texturesRevision when pendingTextureItems was built
+  public: uint64_t pendingTexturesTexturesRevision =
+      std::numeric_limits<uint64_t>::max();
+#endif
+
+  /// \brief See Ogre2Scene::SetTexturesDirty
+  public: uint64_t texturesRevision = 0u;
+
+  /// \brief A datablock shared by the submeshes of identical materials
+  public: struct SharedDatablock
+  {
+    /// \brief Clone of the datablock of the first material with this state
+    Ogre::HlmsPbsDatablock *datablock = nullptr;
+
+    /// \brief Number of submeshes using the datablock
+    unsigned int refCount = 0u;
+  };
+
+  /// \brief Shared datablocks indexed by the state of their material
+  public: std::unordered_map<std::string, SharedDatablock> sharedDatablocks;
+
+  /// \brief Key of every shared datablock in sharedDatablocks
+  public: std::unordered_map<const Ogre::HlmsPbsDatablock *, std::string>
+      sharedDatablockKeys;
+
+  /// \brief Counter used to give shared datablocks unique names
+  public: uint64_t sharedDatablockCount = 0u;
 };
 
 using namespace gz;
 using namespace rendering;
 
+//////////////////////////////////////////////////
+/// \brief Check if the scene may make a visual static. Derived visual
+/// types and geometries other than meshes may update their Ogre objects
+/// every frame, so only plain visuals holding meshes qualify.
+/// \param[in] _visual Visual to check
+/// \return True if the visual may be made static
+static bool IsAutoStaticEligible(const Ogre2Visual &_visual)
+{
+  if (typeid(_visual) != typeid(Ogre2Visual))
+    return false;
+
+  for (unsigned int i = 0; i < _visual.GeometryCount(); ++i)
+  {
+    GeometryPtr geometry = _visual.GeometryByIndex(i);
+    if (!geometry || typeid(*geometry) != typeid(Ogre2Mesh))
+      return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Parse a mesh file with the loader common::MeshManager::Load would
+/// use, without adding the mesh to the mesh manager. Safe to call from any
+/// thread.
+/// \param[in] _path Path to the mesh file
+/// \return The parsed mesh, null on failure
+static common::Mesh *ParseMeshFile(const std::string &_path)
+{
+  const std::size_t dot = _path.rfind('.');
+  const std::string extension = common::lowercase(
+      dot == std::string::npos ? std::string() : _path.substr(dot + 1u));
+
+  std::string forceAssimp;
+  std::unique_ptr<common::MeshLoader> loader;
+  if (common::env("GZ_MESH_FORCE_ASSIMP", forceAssimp) &&
+      forceAssimp == "true")
+  {
+    loader = std::make_unique<common::AssimpLoader>();
+  }
+  else if (extension == "stl" || extension == "stlb" || extension == "stla")
+  {
+    loader = std::make_unique<common::STLLoader>();
+  }
+  else if (extension == "dae")
+  {
+    loader = std::make_unique<common::ColladaLoader>();
+  }
+  else if (extension == "obj")
+  {
+    loader = std::make_unique<common::ObjLoader>();
+  }
+  else if (extension == "gltf" || extension == "glb" || extension == "fbx")
+  {
+    loader = std::make_unique<common::AssimpLoader>();
+  }
+  else
+  {
+    gzerr << "Unsupported mesh format for file[" << _path << "]"
+          << std::endl;
+    return nullptr;
+  }
+
+  return loader->Load(_path);
+}
+
+//////////////////////////////////////////////////
+/// \brief Walk the scene graph to refresh the visuals the scene may make
+/// static. Visuals previously made static by the scene are made dynamic
+/// again if they no longer qualify or their parent is not static anymore.
+/// \param[in] _node Node whose children are visited
+/// \param[in] _parentStatic True if _node never moves, i.e. it is static
+/// or it is the root visual
+/// \param[in, out] _data Scene private data
+/// \param[in] _candidates Candidates gathered by the previous walk
+/// \param[out] _autoStatic Ids of the visuals kept static
+static void GatherAutoStatic(const NodePtr &_node, bool _parentStatic,
+    Ogre2ScenePrivate &_data,
+    const std::unordered_map<unsigned int,
+        Ogre2ScenePrivate::AutoStaticCandidate> &_candidates,
+    std::unordered_set<unsigned int> &_autoStatic)
+{
+  for (unsigned int i = 0; i < _node->ChildCount(); ++i)
+  {
+    NodePtr child = _node->ChildByIndex(i);
+    Ogre2NodePtr ogreChild = std::dynamic_pointer_cast<Ogre2Node>(child);
+    if (!ogreChild || !ogreChild->Node())
+      continue;
+
+    bool isStatic = ogreChild->Node()->isStatic();
+    Ogre2VisualPtr visual = std::dynamic_pointer_cast<Ogre2Visual>(child);
+    if (visual)
+    {
+      const bool eligible = IsAutoStaticEligible(*visual);
+      if (isStatic && _data.autoStaticVisuals.count(visual->Id()))
+      {
+        if (_parentStatic && eligible)
+        {
+          _autoStatic.insert(visual->Id());
+        }
+        else
+        {
+          visual->SetStatic(false);
+          isStatic = false;
+        }
+      }
+
+      if (!isStatic && eligible)
+      {
+        auto &candidate = _data.autoStaticCandidates[visual->Id()];
+        candidate.visual = visual;
+        auto it = _candidates.find(visual->Id());
+        candidate.lastMoved = it != _candidates.end() ?
+            it->second.lastMoved : _data.frameCount;
+      }
+    }
+
+    GatherAutoStatic(child, isStatic, _data, _candidates, _autoStatic);
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Make a visual the scene made static dynamic again, along with
+/// its descendants that the scene made static
+/// \param[in] _visual Visual to make dynamic
+/// \param[in, out] _data Scene private data
+static void DemoteAutoStatic(const Ogre2VisualPtr &_visual,
+    Ogre2ScenePrivate &_data)
+{
+  _visual->SetStatic(false);
+  _data.autoStaticVisuals.erase(_visual->Id());
+  auto &candidate = _data.autoStaticCandidates[_visual->Id()];
+  candidate.visual = _visual;
+  candidate.lastMoved = _data.frameCount;
+
+  for (unsigned int i = 0; i < _visual->ChildCount(); ++i)
+  {
+    Ogre2VisualPtr child =
+        std::dynamic_pointer_cast<Ogre2Visual>(_visual->ChildByIndex(i));
+    if (child && _data.autoStaticVisuals.count(child->Id()))
+      DemoteAutoStatic(child, _data);
+  }
+}
+
+#if OGRE_VERSION_MAJOR != 2 || OGRE_VERSION_MINOR != 1
+//////////////////////////////////////////////////
+/// \brief Add the textures used by a datablock to a set
+/// \param[in] _datablock Datablock to get the textures from
+/// \param[in, out] _textures Set the textures are added to
+static void CollectTextures(const Ogre::HlmsDatablock *_datablock,
+    std::unordered_set<Ogre::TextureGpu *> &_textures)
+{
+  if (!_datablock)
+    return;
+
+  const Ogre::HlmsTypes type = _datablock->getCreator()->getType();
+  if (type == Ogre::HLMS_PBS)
+  {
+    auto pbsDatablock =
+        static_cast<const Ogre::HlmsPbsDatablock *>(_datablock);
+    for (uint8_t i = 0u; i < Ogre::NUM_PBSM_TEXTURE_TYPES; ++i)
+    {
+      Ogre::TextureGpu *texture = pbsDatablock->getTexture(i);
+      if (texture)
+        _textures.insert(texture);
+    }
+  }
+  else if (type == Ogre::HLMS_UNLIT)
+  {
+    auto unlitDatablock =
+        static_cast<const Ogre::HlmsUnlitDatablock *>(_datablock);
+    for (uint8_t i = 0u; i < Ogre::NUM_UNLIT_TEXTURE_TYPES; ++i)
+    {
+      Ogre::TextureGpu *texture = unlitDatablock->getTexture(i);
+      if (texture)
+        _textures.insert(texture);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Append the bytes of a value to a datablock key
+/// \param[in, out] _key Key to append to
+/// \param[in] _value Value to append
+template<typename T>
+static void AppendKey(std::string &_key, const T &_value)
+{
+  static_assert(std::is_trivially_copyable<T>::value,
+      "Only plain values can be part of a datablock key");
+  _key.append(reinterpret_cast<const char *>(&_value), sizeof(T));
+}
+
+//////////////////////////////////////////////////
+/// \brief Get a key describing everything a gz material can change in a
+/// pbs datablock. Two datablocks with the same key render identically.
+/// Macro, blend and sampler blocks and textures are shared by OgreNext, so
+/// their addresses identify their state.
+/// \param[in] _datablock Datablock to describe
+/// \return Datablock key
+static std::string DatablockKey(const Ogre::HlmsPbsDatablock *_datablock)
+{
+  std::string key;
+  key.reserve(512u);
+  AppendKey(key, _datablock->getWorkflow());
+  AppendKey(key, _datablock->getDiffuse());
+  AppendKey(key, _datablock->getSpecular());
+  AppendKey(key, _datablock->getEmissive());
+  AppendKey(key, _datablock->getFresnel());
+  AppendKey(key, _datablock->getRoughness());
+  AppendKey(key, _datablock->getMetalness());
+  AppendKey(key, _datablock->getTransparency());
+  AppendKey(key, _datablock->getTransparencyMode());
+  AppendKey(key, _datablock->getUseAlphaFromTextures());
+  AppendKey(key, _datablock->getAlphaTest());
+  AppendKey(key, _datablock->getAlphaTestThreshold());
+  AppendKey(key, _datablock->getTwoSidedLighting());
+  AppendKey(key, _datablock->getReceiveShadows());
+  AppendKey(key, _datablock->getUseEmissiveAsLightmap());
+  AppendKey(key, _datablock->getUseDiffuseMapAsGrayscale());
+  AppendKey(key, _datablock->getBrdf());
+  AppendKey(key, _datablock->getMacroblock(false));
+  AppendKey(key, _datablock->getMacroblock(true));
+  AppendKey(key, _datablock->getBlendblock(false));
+  AppendKey(key, _datablock->getBlendblock(true));
+  for (uint8_t i = 0u; i < Ogre::NUM_PBSM_TEXTURE_TYPES; ++i)
+  {
+    AppendKey(key, _datablock->getTexture(i));
+    AppendKey(key, _datablock->getSamplerblock(i));
+    AppendKey(key, _datablock->getTextureUvSource(
+        static_cast<Ogre::PbsTextureTypes>(i)));
+  }
+  return key;
+}
+
+//////////////////////////////////////////////////
+/// \brief Find the items whose textures are scheduled to become resident
+/// but are not loaded yet
+/// \param[in] _sceneManager Scene manager holding the items
+/// \param[out] _items Items with pending textures, cleared before use
+static void CollectPendingTextureItems(Ogre::SceneManager *_sceneManager,
+    std::vector<Ogre2ScenePrivate::PendingTextureItem> &_items)
+{
+  _items.clear();
+
+  std::unordered_set<Ogre::TextureGpu *> textures;
+  auto itor = _sceneManager->getMovableObjectIterator(
+      Ogre::ItemFactory::FACTORY_TYPE_NAME);
+  while (itor.hasMoreElements())
+  {
+    Ogre::Item *item = static_cast<Ogre::Item *>(itor.getNext());
+    // attaching an item marks the visuals dirty, which rebuilds the list
+    if (!item->isAttached())
+      continue;
+
+    textures.clear();
+    for (size_t i = 0; i < item->getNumSubItems(); ++i)
+      CollectTextures(item->getSubItem(i)->getDatablock(), textures);
+
+    Ogre2ScenePrivate::PendingTextureItem pending;
+    for (Ogre::TextureGpu *texture : textures)
+    {
+      if (texture->getNextResidencyStatus() == Ogre::GpuResidency::Resident &&
+          !texture->isDataReady())
+      {
+        pending.textures.push_back(texture);
+      }
+    }
+    if (!pending.textures.empty())
+    {
+      pending.item = item;
+      _items.push_back(std::move(pending));
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+/// \brief Block until the pending textures of the items in view of a
+/// camera are loaded. Textures that got loaded are dropped from _items,
+/// and so are items left without pending textures.
+/// \param[in] _camera Camera about to render
+/// \param[in, out] _items Items with pending textures, see
+/// CollectPendingTextureItems
+static void WaitForVisibleTextures(const Ogre::Camera *_camera,
+    std::vector<Ogre2ScenePrivate::PendingTextureItem> &_items)
+{
+  for (size_t i = 0; i < _items.size();)
+  {
+    Ogre2ScenePrivate::PendingTextureItem &pending = _items[i];
+    Ogre::Item *item = pending.item;
+    if (item->isVisible() && item->isAttached())
+    {
+      const Ogre::Aabb aabb = item->getWorldAabb();
+      if (_camera->isVisible(Ogre::AxisAlignedBox(
+          aabb.getMinimum(), aabb.getMaximum())))
+      {
+        for (Ogre::TextureGpu *texture : pending.textures)
+        {
+          if (!texture->isDataReady())
+            texture->waitForData();
+        }
+      }
+    }
+
+    auto &textures = pending.textures;
+    textures.erase(std::remove_if(textures.begin(), textures.end(),
+        [](Ogre::TextureGpu *_texture) { return _texture->isDataReady(); }),
+        textures.end());
+    if (textures.empty())
+    {
+      std::swap(pending, _items.back());
+      _items.pop_back();
+    }
+    else
+    {
+      ++i;
+    }
+  }
+}
+#endif
+
 //////////////////////////////////////////////////
 Ogre2Scene::Ogre2Scene(unsigned int _id, const std::string &_name) :
   BaseScene(_id, _name), dataPtr(std::make_unique<Ogre2ScenePrivate>())
@@ -213,6 +695,14 @@ void Ogre2Scene::PreRender()
              "See Scene::SetCameraPassCountPerGpuFlush for details");
   this->dataPtr->frameUpdateStarted = true;
 
+  this->dataPtr->textureWarmUp = this->dataPtr->textureWarmUpFramesLeft > 0u;
+  if (this->dataPtr->textureWarmUp)
+    --this->dataPtr->textureWarmUpFramesLeft;
+
+  ++this->dataPtr->frameCount;
+  this->CreatePendingMeshes();
+  this->UpdateAutoStatic();
+
   if (this->ShadowsDirty())
   {
     // notify all render targets
@@ -358,11 +848,49 @@ void Ogre2Scene::StartRendering(Ogre::Camera *_camera)
   // if we want all our simulated frames to be perfect & deterministic
   // results
   //
-  // We don't want placeholder textures to be used; thus wait until all
-  // textures being loaded are done.
+  // We don't want placeholder textures to be used; thus by default wait
+  // until all textures being loaded are done. The texture residency policy
+  // can relax this. See Scene::SetTextureResidencyPolicy
   Ogre::RenderSystem *renderSys =
     this->ogreSceneManager->getDestinationRenderSystem();
-  renderSys->getTextureGpuManager()->waitForStreamingCompletion();
+  Ogre::TextureGpuManager *textureMgr = renderSys->getTextureGpuManager();
+  switch (this->dataPtr->textureResidencyPolicy)
+  {
+    case TRP_BLOCK_WARM_UP:
+      if (this->dataPtr->textureWarmUp)
+        textureMgr->waitForStreamingCompletion();
+      break;
+    case TRP_BLOCK_VISIBLE:
+      if (textureMgr->isDoneStreaming())
+        break;
+      if (_camera)
+      {
+        // Looking for pending textures means going through every item, so
+        // only do it when the items or their materials changed
+        if (this->dataPtr->pendingTexturesVisualsRevision !=
+                this->dataPtr->visualsRevision ||
+            this->dataPtr->pendingTexturesTexturesRevision !=
+                this->dataPtr->texturesRevision)
+        {
+          CollectPendingTextureItems(this->ogreSceneManager,
+                                     this->dataPtr->pendingTextureItems);
+          this->dataPtr->pendingTexturesVisualsRevision =
+              this->dataPtr->visualsRevision;
+          this->dataPtr->pendingTexturesTexturesRevision =
+              this->dataPtr->texturesRevision;
+        }
+        WaitForVisibleTextures(_camera, this->dataPtr->pendingTextureItems);
+      }
+      else
+      {
+        textureMgr->waitForStreamingCompletion();
+      }
+      break;
+    case TRP_BLOCK_ALWAYS:
+    default:
+      textureMgr->waitForStreamingCompletion();
+      break;
+  }
 #endif
 }
 
@@ -456,6 +984,230 @@ bool Ogre2Scene::LegacyAutoGpuFlush() const
   return this->dataPtr->cameraPassCountPerGpuFlush == 0u;
 }
 
+//////////////////////////////////////////////////
+void Ogre2Scene::SetTextureResidencyPolicy(
+    enum TextureResidencyPolicy _policy)
+{
+  this->dataPtr->textureResidencyPolicy = _policy;
+}
+
+//////////////////////////////////////////////////
+enum TextureResidencyPolicy Ogre2Scene::TextureResidencyPolicy() const
+{
+  return this->dataPtr->textureResidencyPolicy;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetTextureWarmUpFrameCount(unsigned int _frames)
+{
+  this->dataPtr->textureWarmUpFrameCount = _frames;
+  this->dataPtr->textureWarmUpFramesLeft = _frames;
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2Scene::TextureWarmUpFrameCount() const
+{
+  return this->dataPtr->textureWarmUpFrameCount;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::PreloadTextures()
+{
+#if OGRE_VERSION_MAJOR != 2 || OGRE_VERSION_MINOR != 1
+  Ogre::Root *root = Ogre2RenderEngine::Instance()->OgreRoot();
+
+  // Gather the textures of the materials used by the items of this scene.
+  // The HlmsManager is shared by all scenes, so its datablocks can't be
+  // used here.
+  std::unordered_set<Ogre::TextureGpu *> textures;
+  auto itor = this->ogreSceneManager->getMovableObjectIterator(
+      Ogre::ItemFactory::FACTORY_TYPE_NAME);
+  while (itor.hasMoreElements())
+  {
+    Ogre::Item *item = static_cast<Ogre::Item *>(itor.getNext());
+    for (size_t i = 0; i < item->getNumSubItems(); ++i)
+      CollectTextures(item->getSubItem(i)->getDatablock(), textures);
+  }
+
+  // Schedule all the loads first so the streaming worker threads can batch
+  // them, then wait once for all of them
+  for (Ogre::TextureGpu *texture : textures)
+  {
+    if (texture->getNextResidencyStatus() != Ogre::GpuResidency::Resident &&
+        !texture->isManualTexture() && !texture->isRenderToTexture())
+    {
+      texture->scheduleTransitionTo(Ogre::GpuResidency::Resident);
+    }
+  }
+
+  root->getRenderSystem()->getTextureGpuManager()->
+      waitForStreamingCompletion();
+#endif
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetAutoStaticFrameCount(unsigned int _frames)
+{
+  this->dataPtr->autoStaticFrameCount = _frames;
+  if (_frames > 0u)
+    return;
+
+  // Disabled, give back the visuals made static by the scene
+  for (unsigned int id : this->dataPtr->autoStaticVisuals)
+  {
+    Ogre2VisualPtr visual =
+        std::dynamic_pointer_cast<Ogre2Visual>(this->VisualById(id));
+    if (visual && visual->Node())
+      visual->SetStatic(false);
+  }
+  this->dataPtr->autoStaticVisuals.clear();
+  this->dataPtr->autoStaticCandidates.clear();
+  this->dataPtr->autoStaticRevision = std::numeric_limits<uint64_t>::max();
+}
+
+//////////////////////////////////////////////////
+unsigned int Ogre2Scene::AutoStaticFrameCount() const
+{
+  return this->dataPtr->autoStaticFrameCount;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::UpdateAutoStatic()
+{
+  if (this->dataPtr->autoStaticFrameCount == 0u || !this->rootVisual)
+    return;
+
+  // Scene graph changed, gather the candidates again
+  if (this->dataPtr->autoStaticRevision != this->VisualsRevision())
+  {
+    auto candidates = std::move(this->dataPtr->autoStaticCandidates);
+    this->dataPtr->autoStaticCandidates.clear();
+    std::unordered_set<unsigned int> autoStatic;
+    GatherAutoStatic(this->rootVisual, true, *this->dataPtr, candidates,
+        autoStatic);
+    this->dataPtr->autoStaticVisuals = std::move(autoStatic);
+    this->dataPtr->autoStaticRevision = this->VisualsRevision();
+  }
+
+  auto &candidates = this->dataPtr->autoStaticCandidates;
+  for (auto it = candidates.begin(); it != candidates.end();)
+  {
+    if (this->dataPtr->frameCount - it->second.lastMoved <
+        this->dataPtr->autoStaticFrameCount)
+    {
+      ++it;
+      continue;
+    }
+
+    Ogre2VisualPtr visual = it->second.visual.lock();
+    if (!visual || !visual->Node() || visual->Node()->isStatic())
+    {
+      it = candidates.erase(it);
+      continue;
+    }
+
+    // A static node does not follow its parent, so wait for the parent to
+    // be static first
+    NodePtr parent = visual->Parent();
+    Ogre2NodePtr ogreParent = std::dynamic_pointer_cast<Ogre2Node>(parent);
+    if (!ogreParent || !ogreParent->Node() ||
+        (parent != this->rootVisual && !ogreParent->Node()->isStatic()))
+    {
+      ++it;
+      continue;
+    }
+
+    visual->SetStatic(true);
+    this->dataPtr->autoStaticVisuals.insert(visual->Id());
+    it = candidates.erase(it);
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::NodeMoved(Ogre2Node *_node)
+{
+  Ogre::SceneNode *ogreNode = _node->Node();
+  if (!ogreNode)
+    return;
+
+  if (ogreNode->isStatic())
+  {
+    if (!this->dataPtr->autoStaticVisuals.count(_node->Id()))
+    {
+      // Static nodes are only updated when flagged dirty. OgreNext keeps
+      // the lowest dirty depth and updates the static lists once in the
+      // next updateSceneGraph, so this call is cheap.
+      this->ogreSceneManager->notifyStaticDirty(ogreNode);
+      return;
+    }
+
+    Ogre2VisualPtr visual =
+        std::dynamic_pointer_cast<Ogre2Visual>(this->VisualById(_node->Id()));
+    if (visual)
+      DemoteAutoStatic(visual, *this->dataPtr);
+    return;
+  }
+
+  if (this->dataPtr->autoStaticFrameCount == 0u)
+    return;
+
+  auto it = this->dataPtr->autoStaticCandidates.find(_node->Id());
+  if (it != this->dataPtr->autoStaticCandidates.end())
+    it->second.lastMoved = this->dataPtr->frameCount;
+}
+
+//////////////////////////////////////////////////
+Ogre::HlmsPbsDatablock *Ogre2Scene::AcquireSharedDatablock(
+    Ogre2Material &_material)
+{
+#if OGRE_VERSION_MAJOR == 2 && OGRE_VERSION_MINOR == 1
+  (void)_material;
+  return nullptr;
+#else
+  // shader parameters are per material, so they can not be shared
+  Ogre::HlmsPbsDatablock *datablock = _material.Datablock();
+  if (!datablock || !_material.VertexShader().empty() ||
+      !_material.FragmentShader().empty())
+  {
+    return nullptr;
+  }
+
+  const std::string key = DatablockKey(datablock);
+  auto &shared = this->dataPtr->sharedDatablocks[key];
+  if (!shared.datablock)
+  {
+    const std::string name = this->Name() + "::SharedDatablock" +
+        std::to_string(this->dataPtr->sharedDatablockCount++);
+    shared.datablock =
+        static_cast<Ogre::HlmsPbsDatablock *>(datablock->clone(name));
+    this->dataPtr->sharedDatablockKeys[shared.datablock] = key;
+  }
+  ++shared.refCount;
+
+  _material.SetDatablockShared();
+  return shared.datablock;
+#endif
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::ReleaseSharedDatablock(Ogre::HlmsPbsDatablock *_datablock)
+{
+  auto keyIt = this->dataPtr->sharedDatablockKeys.find(_datablock);
+  if (keyIt == this->dataPtr->sharedDatablockKeys.end())
+    return;
+
+  auto it = this->dataPtr->sharedDatablocks.find(keyIt->second);
+  if (--it->second.refCount > 0u)
+    return;
+
+  // no renderable is linked to it anymore, but the segmentation and
+  // thermal cameras may still cache it
+  _datablock->getCreator()->destroyDatablock(_datablock->getName());
+  this->dataPtr->sharedDatablocks.erase(it);
+  this->dataPtr->sharedDatablockKeys.erase(keyIt);
+  this->SetVisualsDirty();
+}
+
 //////////////////////////////////////////////////
 void Ogre2Scene::Clear()
 {
@@ -467,6 +1219,17 @@ void Ogre2Scene::Clear()
 //////////////////////////////////////////////////
 void Ogre2Scene::Destroy()
 {
+  // let workers finish before the mesh factory they use goes away. Meshes
+  // that were not created yet resolve to null.
+  if (this->dataPtr->meshWorkers)
+  {
+    this->dataPtr->meshWorkers->WaitForResults();
+    this->dataPtr->meshWorkers.reset();
+  }
+  for (auto &pending : this->dataPtr->pendingMeshes)
+    pending->promise.set_value(nullptr);
+  this->dataPtr->pendingMeshes.clear();
+
   this->DestroyNodes();
 
   // cleanup any items that were not attached to nodes
@@ -477,6 +1240,16 @@ void Ogre2Scene::Destroy()
 
   BaseScene::Destroy();
 
+  // submeshes of meshes that were never destroyed may still hold shared
+  // datablocks. All items are gone so nothing links to them anymore.
+  for (auto &shared : this->dataPtr->sharedDatablocks)
+  {
+    shared.second.datablock->getCreator()->destroyDatablock(
+        shared.second.datablock->getName());
+  }
+  this->dataPtr->sharedDatablocks.clear();
+  this->dataPtr->sharedDatablockKeys.clear();
+
   if (this->ogreSceneManager)
   {
     this->ogreSceneManager->removeRenderQueueListener(
@@ -1255,6 +2028,98 @@ MeshPtr Ogre2Scene::CreateMeshImpl(unsigned int _id,
   return (result) ? mesh : nullptr;
 }
 
+//////////////////////////////////////////////////
+std::future<MeshPtr> Ogre2Scene::CreateMeshAsync(const MeshDescriptor &_desc)
+{
+  auto pending = std::make_shared<Ogre2ScenePrivate::PendingMesh>();
+  pending->desc = _desc;
+  std::future<MeshPtr> future = pending->promise.get_future();
+
+  std::string meshName = (_desc.mesh) ? _desc.mesh->Name() : _desc.meshName;
+  pending->id = this->CreateObjectId();
+  pending->name = this->CreateObjectName(pending->id, "Mesh-" + meshName);
+
+  // The mesh manager is only accessed from this thread. Workers get either
+  // the mesh it already has or a file to parse on their own.
+  MeshDescriptor &desc = pending->desc;
+  if (!desc.mesh && !desc.meshName.empty())
+  {
+    common::MeshManager *meshManager = common::MeshManager::Instance();
+    if (meshManager->HasMesh(desc.meshName))
+      desc.mesh = meshManager->MeshByName(desc.meshName);
+    else
+      pending->path = common::findFile(desc.meshName);
+  }
+
+  if (!this->dataPtr->meshWorkers)
+    this->dataPtr->meshWorkers = std::make_unique<common::WorkerPool>();
+
+  Ogre2MeshFactoryPtr factory = this->meshFactory;
+  this->dataPtr->meshWorkers->AddWork(
+      [factory, pending]()
+      {
+        // Parse the mesh file here if the mesh manager doesn't have it
+        // yet. Meshes with a skeleton are not prepared, they are loaded
+        // through a v1 mesh that can only be built on the render thread.
+        MeshDescriptor &desc = pending->desc;
+        if (!pending->path.empty())
+        {
+          pending->parsedMesh.reset(ParseMeshFile(pending->path));
+          if (pending->parsedMesh)
+          {
+            // named as common::MeshManager::Load would
+            pending->parsedMesh->SetName(desc.meshName);
+            desc.mesh = pending->parsedMesh.get();
+          }
+        }
+        if (desc.mesh)
+          factory->Prepare(desc);
+      },
+      [pending]()
+      {
+        pending->prepared = true;
+      });
+  this->dataPtr->pendingMeshes.push_back(pending);
+
+  return future;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::CreatePendingMeshes()
+{
+  auto it = this->dataPtr->pendingMeshes.begin();
+  while (it != this->dataPtr->pendingMeshes.end())
+  {
+    auto &pending = *it;
+    if (!pending->prepared)
+    {
+      ++it;
+      continue;
+    }
+
+    // Add the mesh parsed by the worker to the mesh manager, unless the
+    // same file was loaded in the meantime
+    if (pending->parsedMesh)
+    {
+      common::MeshManager *meshManager = common::MeshManager::Instance();
+      if (meshManager->HasMesh(pending->desc.meshName))
+      {
+        pending->desc.mesh =
+            meshManager->MeshByName(pending->desc.meshName);
+        pending->parsedMesh.reset();
+      }
+      else
+      {
+        meshManager->AddMesh(pending->parsedMesh.release());
+      }
+    }
+
+    pending->promise.set_value(
+        this->CreateMeshImpl(pending->id, pending->name, pending->desc));
+    it = this->dataPtr->pendingMeshes.erase(it);
+  }
+}
+
 //////////////////////////////////////////////////
 CapsulePtr Ogre2Scene::CreateCapsuleImpl(unsigned int _id,
     const std::string &_name)
@@ -1310,6 +2175,15 @@ LidarVisualPtr Ogre2Scene::CreateLidarVisualImpl(unsigned int _id,
   return (result) ? lidar: nullptr;
 }
 
+//////////////////////////////////////////////////
+InstancedVisualPtr Ogre2Scene::CreateInstancedVisualImpl(unsigned int _id,
+    const std::string &_name)
+{
+  Ogre2InstancedVisualPtr visual(new Ogre2InstancedVisual);
+  bool result = this->InitObject(visual, _id, _name);
+  return (result) ? visual : nullptr;
+}
+
 //////////////////////////////////////////////////
 TextPtr Ogre2Scene::CreateTextImpl(unsigned int /*_id*/,
     const std::string &/*_name*/)
@@ -1510,6 +2384,36 @@ bool Ogre2Scene::ShadowsDirty() const
   return this->dataPtr->shadowsDirty;
 }
 
+//////////////////////////////////////////////////
+void Ogre2Scene::SetVisualsDirty()
+{
+  ++this->dataPtr->visualsRevision;
+}
+
+//////////////////////////////////////////////////
+void Ogre2Scene::SetTexturesDirty()
+{
+  ++this->dataPtr->texturesRevision;
+}
+
+//////////////////////////////////////////////////
+uint64_t Ogre2Scene::VisualsRevision() const
+{
+  return this->dataPtr->visualsRevision;
+}
+
+//////////////////////////////////////////////////
+uint64_t Ogre2Scene::TexturesRevision() const
+{
+  return this->dataPtr->texturesRevision;
+}
+
+//////////////////////////////////////////////////
+uint64_t Ogre2Scene::FrameCount() const
+{
+  return this->dataPtr->frameCount;
+}
+
 //////////////////////////////////////////////////
 void Ogre2Scene::SetSkyEnabled(bool _enabled)
 {
@@ -32,6 +32,7 @@
 #include "gz/rendering/RenderTypes.hh"
 #include "gz/rendering/Utils.hh"
 
+#include "Ogre2AsyncReadback.hh"
 #include "Ogre2SegmentationMaterialSwitcher.hh"
 
 /// \brief Private data for the Ogre2SegmentationCamera class
@@ -52,6 +53,10 @@ class gz::rendering::Ogre2SegmentationCameraPrivate
   /// \brief Output texture
   public: Ogre::TextureGpu *ogreSegmentationTexture {nullptr};
 
+  /// \brief Asynchronous readback of the output texture, used when the
+  /// sensor readback latency is greater than 0
+  public: Ogre2AsyncReadback readback;
+
   /// \brief Dummy render texture for the depth data
   public: RenderTexturePtr segmentationTexture {nullptr};
 
@@ -113,6 +118,8 @@ void Ogre2SegmentationCamera::Destroy()
   if (!this->ogreCamera)
     return;
 
+  this->dataPtr->readback.Reset();
+
   auto engine = Ogre2RenderEngine::Instance();
   auto ogreRoot = engine->OgreRoot();
   auto ogreCompMgr = ogreRoot->getCompositorManager2();
@@ -267,8 +274,21 @@ void Ogre2SegmentationCamera::PostRender()
   const auto bufferSize = len * channelCount * bytesPerChannel;
 
   Ogre::Image2 image;
-  image.convertFromTexture(this->dataPtr->ogreSegmentationTexture, 0u, 0u);
-  Ogre::TextureBox box = image.getData(0);
+  Ogre::TextureBox box;
+  Ogre2AsyncReadback &readback = this->dataPtr->readback;
+  readback.SetLatency(this->ReadbackLatency());
+  if (readback.Latency() > 0u)
+  {
+    readback.Download(this->dataPtr->ogreSegmentationTexture);
+    if (!readback.FrameReady())
+      return;
+    box = readback.MapFrame();
+  }
+  else
+  {
+    image.convertFromTexture(this->dataPtr->ogreSegmentationTexture, 0u, 0u);
+    box = image.getData(0);
+  }
 
   if (!this->dataPtr->buffer)
   {
@@ -295,6 +315,9 @@ void Ogre2SegmentationCamera::PostRender()
     }
   }
 
+  if (readback.Latency() > 0u)
+    readback.UnmapFrame();
+
   this->dataPtr->newSegmentationFrame(
     this->dataPtr->buffer,
     width, height, channelCount,
@@ -362,7 +385,7 @@ void Ogre2SegmentationCamera::LabelMapFromColoredBuffer(
   if (!this->dataPtr->buffer)
     return;
 
-  auto colorToLabel = this->dataPtr->materialSwitcher->ColorToLabel();
+  const auto &colorToLabel = this->dataPtr->materialSwitcher->ColorToLabel();
 
   auto width = this->ImageWidth();
   auto height = this->ImageHeight();
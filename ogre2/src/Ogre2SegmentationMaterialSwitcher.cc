@@ -18,6 +18,8 @@
 #include "Ogre2SegmentationMaterialSwitcher.hh"
 
 #include <algorithm>
+#include <map>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -46,6 +48,37 @@
 using namespace gz;
 using namespace rendering;
 
+/// \brief Get the cache shared by the segmentation cameras with the given
+/// settings, creating it if no camera uses it yet
+/// \param[in] _key Scene and segmentation settings
+/// \return The shared cache
+static std::shared_ptr<Ogre2SegmentationCache> SharedSegmentationCache(
+    const std::string &_key)
+{
+  static std::map<std::string, std::weak_ptr<Ogre2SegmentationCache>> caches;
+
+  auto it = caches.find(_key);
+  if (it != caches.end())
+  {
+    std::shared_ptr<Ogre2SegmentationCache> cache = it->second.lock();
+    if (cache)
+      return cache;
+  }
+
+  // drop caches of cameras that no longer exist
+  for (auto c = caches.begin(); c != caches.end();)
+  {
+    if (c->second.expired())
+      c = caches.erase(c);
+    else
+      ++c;
+  }
+
+  auto cache = std::make_shared<Ogre2SegmentationCache>();
+  caches[_key] = cache;
+  return cache;
+}
+
 /////////////////////////////////////////////////
 Ogre2SegmentationMaterialSwitcher::Ogre2SegmentationMaterialSwitcher(
   Ogre2ScenePtr _scene, SegmentationCamera *_camera)
@@ -81,19 +114,31 @@ bool Ogre2SegmentationMaterialSwitcher::IsTakenColor(const math::Color &_color)
 
 /////////////////////////////////////////////////
 Ogre::Vector4 Ogre2SegmentationMaterialSwitcher::ColorForVisual(
-  const VisualPtr &_visual, std::string &_prevParentName)
+  const VisualPtr &_visual, std::string &_prevParentName,
+  const Ogre::Item *_item)
 {
+  // items labelled individually are instances of their own
+  const Ogre::Any &itemLabelAny = _item ?
+      _item->getUserObjectBindings().getUserAny("label") : Ogre::Any();
+
   // get class user data
   Variant labelAny = _visual->UserData("label");
   int label;
-  try
+  if (!itemLabelAny.isEmpty() && itemLabelAny.getType() == typeid(int))
   {
-    label = std::get<int>(labelAny);
+    label = Ogre::any_cast<int>(itemLabelAny);
   }
-  catch (std::bad_variant_access &)
+  else
   {
-    // items with no class are considered background
-    label = this->segmentationCamera->BackgroundLabel();
+    try
+    {
+      label = std::get<int>(labelAny);
+    }
+    catch (std::bad_variant_access &)
+    {
+      // items with no class are considered background
+      label = this->segmentationCamera->BackgroundLabel();
+    }
   }
 
   // sub item custom parameter to set the pixel color material
@@ -118,7 +163,8 @@ Ogre::Vector4 Ogre2SegmentationMaterialSwitcher::ColorForVisual(
   else if (this->segmentationCamera->Type() == SegmentationType::ST_PANOPTIC)
   {
     auto itemName = _visual->Name();
-    std::string parentName = this->TopLevelModelVisual(_visual)->Name();
+    std::string parentName = itemLabelAny.isEmpty() ?
+        this->TopLevelModelVisual(_visual)->Name() : _item->getName();
 
     auto it = this->instancesCount.find(label);
     if (it == this->instancesCount.end())
@@ -209,7 +255,7 @@ math::Color Ogre2SegmentationMaterialSwitcher::LabelToColor(int64_t _label,
 
   // We don't multiply by 255 here as (r,g,b) are in [0-255] range
   int64_t colorId = r * 256 * 256 + g * 256 + b;
-  this->colorToLabel[colorId] = _label;
+  this->cache->colorToLabel[colorId] = _label;
 
   return color;
 }
@@ -227,16 +273,41 @@ VisualPtr Ogre2SegmentationMaterialSwitcher::TopLevelModelVisual(
 }
 
 ////////////////////////////////////////////////
-void Ogre2SegmentationMaterialSwitcher::cameraPreRenderScene(
-    Ogre::Camera * /*_cam*/)
+void Ogre2SegmentationMaterialSwitcher::UpdateCache()
+{
+  const math::Color &background =
+      this->segmentationCamera->BackgroundColor();
+  std::string key = std::to_string(
+      reinterpret_cast<std::uintptr_t>(this->scene.get())) + ":" +
+      std::to_string(static_cast<int>(this->segmentationCamera->Type())) +
+      ":" + std::to_string(this->segmentationCamera->IsColoredMap()) + ":" +
+      std::to_string(this->segmentationCamera->BackgroundLabel()) + ":" +
+      std::to_string(background.AsRGBA());
+
+  if (!this->cache || key != this->cacheKey)
+  {
+    this->cache = SharedSegmentationCache(key);
+    this->cacheKey = std::move(key);
+  }
+
+  if (this->cache->revision != this->scene->VisualsRevision())
+  {
+    this->RebuildCache();
+    this->cache->revision = this->scene->VisualsRevision();
+  }
+}
+
+////////////////////////////////////////////////
+void Ogre2SegmentationMaterialSwitcher::RebuildCache()
 {
-  this->colorToLabel.clear();
+  this->cache->subItems.clear();
+  this->cache->datablocks.clear();
+  this->cache->heightmaps.clear();
+  this->cache->colorToLabel.clear();
+
   auto itor = this->scene->OgreSceneManager()->getMovableObjectIterator(
       Ogre::ItemFactory::FACTORY_TYPE_NAME);
 
-  auto engine = Ogre2RenderEngine::Instance();
-  engine->SetGzOgreRenderingMode(GORM_SOLID_COLOR);
-
   // Used for multi-link models, where each model has many ogre items but
   // belongs to the same object, and all of them has the same parent name
   std::string prevParentName = "";
@@ -246,8 +317,12 @@ void Ogre2SegmentationMaterialSwitcher::cameraPreRenderScene(
   while (itor.hasMoreElements())
   {
     Ogre::MovableObject *object = itor.peekNext();
-    ogreObjects.push_back(object);
     itor.moveNext();
+
+    // Detached items are not rendered, so there is nothing to cache
+    if (!object->isAttached())
+      continue;
+    ogreObjects.push_back(object);
   }
 
   // Sort the ogre objects by name
@@ -258,17 +333,7 @@ void Ogre2SegmentationMaterialSwitcher::cameraPreRenderScene(
       return object1->getName() > object2->getName();
   });
 
-  this->materialMap.clear();
-  this->datablockMap.clear();
-  Ogre::HlmsManager *hlmsManager = engine->OgreRoot()->getHlmsManager();
-
-  Ogre::HlmsDatablock *defaultPbs =
-    hlmsManager->getHlms(Ogre::HLMS_PBS)->getDefaultDatablock();
-
-  // Construct one now so that datablock->setBlendblock
-  // each is as fast as possible
-  const Ogre::HlmsBlendblock *noBlend =
-    hlmsManager->getBlendblock(Ogre::HlmsBlendblock());
+  std::unordered_set<Ogre::HlmsDatablock *> datablocks;
 
   for (auto object : ogreObjects)
   {
@@ -293,18 +358,18 @@ void Ogre2SegmentationMaterialSwitcher::cameraPreRenderScene(
       }
 
       const Ogre::Vector4 customParameter =
-        ColorForVisual(visual, prevParentName);
+        ColorForVisual(visual, prevParentName, item);
 
       const size_t numSubItems = item->getNumSubItems();
       for (size_t i = 0; i < numSubItems; ++i)
       {
-        // Set the custom value to the sub item to render
-        Ogre::SubItem *subItem = item->getSubItem(i);
-        subItem->setCustomParameter(1, customParameter);
+        Ogre2SegmentationCache::SubItemBinding binding;
+        binding.subItem = item->getSubItem(i);
+        binding.color = customParameter;
 
-        if (!subItem->getMaterial().isNull())
+        if (!binding.subItem->getMaterial().isNull())
         {
-          this->materialMap.push_back({ subItem, subItem->getMaterial() });
+          binding.material = binding.subItem->getMaterial();
 
           // We need to keep the material's vertex shader
           // to keep vertex deformation consistent; so we use
@@ -315,7 +380,7 @@ void Ogre2SegmentationMaterialSwitcher::cameraPreRenderScene(
           // (i.e. it's not using Ogre2Material interface).
           // In those cases we fallback to PBS in the current IORM mode.
           auto material = Ogre::MaterialManager::getSingleton().getByName(
-            subItem->getMaterial()->getName() + "_solid",
+            binding.material->getName() + "_solid",
             Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
           if (material)
           {
@@ -328,38 +393,23 @@ void Ogre2SegmentationMaterialSwitcher::cameraPreRenderScene(
 
             if (material->getNumSupportedTechniques() > 0u)
             {
-              subItem->setMaterial(material);
+              binding.solidMaterial = material;
+            }
+            else
+            {
+              // keep the original material
+              binding.solidMaterial = binding.material;
             }
           }
-          else
-          {
-            // The supplied vertex shader could not pair with the
-            // pixel shader we provide. Try to salvage the situation
-            // using PBS shader. Custom deformation won't work but
-            // if we're lucky that won't matter
-            subItem->setDatablock(defaultPbs);
-          }
+          // else: the supplied vertex shader could not pair with the
+          // pixel shader we provide. The PBS shader is used instead.
         }
-        else
+        else if (datablocks.insert(binding.subItem->getDatablock()).second)
         {
-          Ogre::HlmsDatablock *datablock = subItem->getDatablock();
-          const Ogre::HlmsBlendblock *blendblock = datablock->getBlendblock();
-
-          // We can't do any sort of blending. This isn't colour what we're
-          // storing, but rather an ID.
-          if (blendblock->mSourceBlendFactor != Ogre::SBF_ONE ||
-              blendblock->mDestBlendFactor != Ogre::SBF_ZERO ||
-              blendblock->mBlendOperation != Ogre::SBO_ADD ||
-              (blendblock->mSeparateBlend &&
-               (blendblock->mSourceBlendFactorAlpha != Ogre::SBF_ONE ||
-                blendblock->mDestBlendFactorAlpha != Ogre::SBF_ZERO ||
-                blendblock->mBlendOperationAlpha != Ogre::SBO_ADD)))
-          {
-            hlmsManager->addReference(blendblock);
-            this->datablockMap[datablock] = blendblock;
-            datablock->setBlendblock(noBlend);
-          }
+          this->cache->datablocks.push_back(binding.subItem->getDatablock());
         }
+
+        this->cache->subItems.push_back(std::move(binding));
       }
     }
   }
@@ -376,19 +426,81 @@ void Ogre2SegmentationMaterialSwitcher::cameraPreRenderScene(
       VisualPtr visual = heightmap->Parent();
       const Ogre::Vector4 customParameter =
         ColorForVisual(visual, prevParentName);
-      heightmap->Terra()->SetSolidColor(1u, customParameter);
+      this->cache->heightmaps.emplace_back(h, customParameter);
     }
   }
 
-  // Remove the reference count on noBlend we created
-  hlmsManager->destroyBlendblock(noBlend);
-
   // reset the count & colors tracking
   this->instancesCount.clear();
   this->takenColors.clear();
   this->coloredLabel.clear();
 }
 
+////////////////////////////////////////////////
+void Ogre2SegmentationMaterialSwitcher::cameraPreRenderScene(
+    Ogre::Camera * /*_cam*/)
+{
+  auto engine = Ogre2RenderEngine::Instance();
+  engine->SetGzOgreRenderingMode(GORM_SOLID_COLOR);
+
+  this->UpdateCache();
+
+  this->datablockMap.clear();
+  Ogre::HlmsManager *hlmsManager = engine->OgreRoot()->getHlmsManager();
+
+  Ogre::HlmsDatablock *defaultPbs =
+    hlmsManager->getHlms(Ogre::HLMS_PBS)->getDefaultDatablock();
+
+  for (const auto &binding : this->cache->subItems)
+  {
+    // Set the custom value to the sub item to render
+    binding.subItem->setCustomParameter(1, binding.color);
+
+    if (binding.material)
+    {
+      if (binding.solidMaterial)
+        binding.subItem->setMaterial(binding.solidMaterial);
+      else
+        binding.subItem->setDatablock(defaultPbs);
+    }
+  }
+
+  // Construct one now so that datablock->setBlendblock
+  // each is as fast as possible
+  const Ogre::HlmsBlendblock *noBlend =
+    hlmsManager->getBlendblock(Ogre::HlmsBlendblock());
+
+  for (Ogre::HlmsDatablock *datablock : this->cache->datablocks)
+  {
+    const Ogre::HlmsBlendblock *blendblock = datablock->getBlendblock();
+
+    // We can't do any sort of blending. This isn't colour what we're
+    // storing, but rather an ID.
+    if (blendblock->mSourceBlendFactor != Ogre::SBF_ONE ||
+        blendblock->mDestBlendFactor != Ogre::SBF_ZERO ||
+        blendblock->mBlendOperation != Ogre::SBO_ADD ||
+        (blendblock->mSeparateBlend &&
+         (blendblock->mSourceBlendFactorAlpha != Ogre::SBF_ONE ||
+          blendblock->mDestBlendFactorAlpha != Ogre::SBF_ZERO ||
+          blendblock->mBlendOperationAlpha != Ogre::SBO_ADD)))
+    {
+      hlmsManager->addReference(blendblock);
+      this->datablockMap[datablock] = blendblock;
+      datablock->setBlendblock(noBlend);
+    }
+  }
+
+  // Remove the reference count on noBlend we created
+  hlmsManager->destroyBlendblock(noBlend);
+
+  for (const auto &[h, customParameter] : this->cache->heightmaps)
+  {
+    auto heightmap = h.lock();
+    if (heightmap)
+      heightmap->Terra()->SetSolidColor(1u, customParameter);
+  }
+}
+
 ////////////////////////////////////////////////
 void Ogre2SegmentationMaterialSwitcher::cameraPostRenderScene(
     Ogre::Camera * /*_cam*/)
@@ -411,35 +523,21 @@ void Ogre2SegmentationMaterialSwitcher::cameraPostRenderScene(
   // if that code forgets to call but it was already carrying the value
   // we set here.
   //
-  // This consumes more performance but it's the price to pay for
-  // safety.
-  auto itor = this->scene->OgreSceneManager()->getMovableObjectIterator(
-      Ogre::ItemFactory::FACTORY_TYPE_NAME);
-  while (itor.hasMoreElements())
-  {
-    Ogre::MovableObject *object = itor.peekNext();
-    Ogre::Item *item = static_cast<Ogre::Item *>(object);
-    const size_t numSubItems = item->getNumSubItems();
-    for (size_t i = 0; i < numSubItems; ++i)
-    {
-      Ogre::SubItem *subItem = item->getSubItem(i);
-      subItem->removeCustomParameter(1u);
-    }
-    itor.moveNext();
-  }
-
-  // Restore Items with low level materials
-  for (auto subItemMat : this->materialMap)
+  // The cache only holds the sub items we modified so this is cheaper
+  // than iterating every item in the scene.
+  //
+  // Also restore Items with low level materials
+  for (const auto &binding : this->cache->subItems)
   {
-    subItemMat.first->setMaterial(subItemMat.second);
+    binding.subItem->removeCustomParameter(1u);
+    if (binding.material)
+      binding.subItem->setMaterial(binding.material);
   }
-  this->materialMap.clear();
 
   // Remove the custom parameter (same reason as with Items)
-  auto heightmaps = this->scene->Heightmaps();
-  for (auto h : heightmaps)
+  for (const auto &entry : this->cache->heightmaps)
   {
-    auto heightmap = h.lock();
+    auto heightmap = entry.first.lock();
     if (heightmap)
       heightmap->Terra()->UnsetSolidColors();
   }
@@ -451,5 +549,8 @@ void Ogre2SegmentationMaterialSwitcher::cameraPostRenderScene(
 const std::unordered_map<int64_t, int64_t> &
 Ogre2SegmentationMaterialSwitcher::ColorToLabel() const
 {
-  return this->colorToLabel;
+  static const std::unordered_map<int64_t, int64_t> kEmpty;
+  if (!this->cache)
+    return kEmpty;
+  return this->cache->colorToLabel;
 }
@@ -18,6 +18,8 @@
 #ifndef GZ_RENDERING_OGRE2_OGRE2SEGMENTATIONMATERIALSWITCHER_HH_
 #define GZ_RENDERING_OGRE2_OGRE2SEGMENTATIONMATERIALSWITCHER_HH_
 
+#include <cstdint>
+#include <memory>
 #include <random>
 #include <string>
 #include <unordered_map>
@@ -39,6 +41,49 @@ namespace rendering
 {
 inline namespace GZ_RENDERING_VERSION_NAMESPACE {
 
+/// \brief Segmentation colors of every item in a scene and the material
+/// changes needed to render them, computed for a given set of segmentation
+/// settings. It is rebuilt only when Ogre2Scene::VisualsRevision changes
+/// and is shared by all the segmentation cameras of a scene that use the
+/// same settings.
+class Ogre2SegmentationCache
+{
+  /// \brief A sub item to render with a solid color
+  public: struct SubItemBinding
+  {
+    /// \brief The sub item
+    Ogre::SubItem *subItem = nullptr;
+
+    /// \brief Color to pass as custom parameter
+    Ogre::Vector4 color;
+
+    /// \brief Original low level material of the sub item, if any
+    Ogre::MaterialPtr material;
+
+    /// \brief Material to render the sub item with when it has a low level
+    /// material. If null the default PBS datablock is used instead.
+    Ogre::MaterialPtr solidMaterial;
+  };
+
+  /// \brief Value of Ogre2Scene::VisualsRevision the cache was built with
+  public: uint64_t revision = UINT64_MAX;
+
+  /// \brief Sub items of all the items that belong to visuals
+  public: std::vector<SubItemBinding> subItems;
+
+  /// \brief Datablocks of the sub items that don't have a low level
+  /// material. Their blending must be disabled while rendering.
+  public: std::vector<Ogre::HlmsDatablock *> datablocks;
+
+  /// \brief Heightmaps and their color
+  public: std::vector<std::pair<std::weak_ptr<Ogre2Heightmap>,
+                                Ogre::Vector4>> heightmaps;
+
+  /// \brief Mapping from the colorId to the label id.
+  /// See Ogre2SegmentationMaterialSwitcher::ColorToLabel
+  public: std::unordered_map<int64_t, int64_t> colorToLabel;
+};
+
 /// \brief Helper class to assign unique colors to renderables
 /// Due to historic reasons it's called "MaterialSwitcher" although
 /// there is no longer any material switching going on.
@@ -73,9 +118,13 @@ class GZ_RENDERING_OGRE2_VISIBLE Ogre2SegmentationMaterialSwitcher :
   /// \param[in] _visual Visual will be applying the color to
   /// \param[in,out] _prevParentName A persistent string between call
   /// to ensure multilink visuals receive the same color
+  /// \param[in] _item Item of the visual the color is for. If it has a
+  /// "label" of its own (e.g. an instance of an InstancedVisual), it is
+  /// used instead of the visual label and the item is a separate instance.
   /// \return The color to apply to the visual
   private: Ogre::Vector4 ColorForVisual(const VisualPtr &_visual,
-                                        std::string &_prevParentName);
+                                        std::string &_prevParentName,
+                                        const Ogre::Item *_item = nullptr);
 
   /// \brief Convert label of semantic map to a unique color for colored map and
   /// add the color of the label to the taken colors if it doesn't exist
@@ -99,6 +148,15 @@ class GZ_RENDERING_OGRE2_VISIBLE Ogre2SegmentationMaterialSwitcher :
   /// \return True if taken, False otherwise
   private: bool IsTakenColor(const math::Color &_color);
 
+  /// \brief Switch to the cache shared by cameras with the current
+  /// settings of the segmentation camera and rebuild it if the visuals
+  /// changed since it was last built
+  private: void UpdateCache();
+
+  /// \brief Recompute the colors and material bindings of all the items
+  /// into the current cache
+  private: void RebuildCache();
+
   /// \brief A map of ogre sub item pointer to its original hlms maults to 10mK
   private: double resolution = 0.01;
 
@@ -113,22 +171,17 @@ class GZ_RENDERING_OGRE2_VISIBLE Ogre2SegmentationMaterialSwitcher :
   /// Useful for coloring items in semantic mode in LabelToColor()
   private: std::unordered_set<int64_t> coloredLabel;
 
-  /// \brief Mapping from the colorId to the label id, used in converting
-  /// the colored map to label ids map
-  /// Key: colorId, value: label in case of semantic segmentation
-  /// or composite id (8 bit label + 16 bit instances) in instance type
-  private: std::unordered_map<int64_t, int64_t> colorToLabel;
+  /// \brief Colors and material bindings of the items, possibly shared
+  /// with other cameras
+  private: std::shared_ptr<Ogre2SegmentationCache> cache;
+
+  /// \brief Segmentation settings the current cache was acquired for
+  private: std::string cacheKey;
 
   /// \brief A map of ogre datablock pointer to their original blendblocks
   private: std::unordered_map<Ogre::HlmsDatablock *,
       const Ogre::HlmsBlendblock *> datablockMap;
 
-  /// \brief A map of ogre sub item pointer to their original low level
-  /// material.
-  /// Most objects don't use one so it should be almost always empty.
-  private:
-    std::vector<std::pair<Ogre::SubItem *, Ogre::MaterialPtr>> materialMap;
-
   /// \brief Pseudo num generator to generate colors from label id
   private: std::default_random_engine generator;
 
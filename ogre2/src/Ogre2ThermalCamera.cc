@@ -27,9 +27,13 @@
 
 #include <algorithm>
 #include <limits>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <variant>
+#include <vector>
 
 #ifdef _MSC_VER
 #pragma warning(push, 0)
@@ -60,6 +64,7 @@
 
 #include <gz/common/Image.hh>
 
+#include "Ogre2AsyncReadback.hh"
 #include "Terra/Terra.h"
 
 namespace gz
@@ -99,6 +104,50 @@ class Ogre2ThermalCameraMaterialSwitcher : public Ogre::Camera::Listener
   private: virtual void cameraPostRenderScene(
     Ogre::Camera * _cam) override;
 
+  /// \brief Recompute the thermal state of every item and heightmap from
+  /// the user data of their visuals and the state of their materials
+  private: void Rebuild();
+
+  /// \brief How a sub item is rendered by the thermal camera
+  private: enum class SubItemType
+  {
+    /// \brief Uniform temperature given by the "temperature" user data
+    HEAT_SOURCE,
+
+    /// \brief Temperature read from the heat signature texture given by
+    /// the "temperature" user data
+    HEAT_SIGNATURE,
+
+    /// \brief No temperature set. Its color is converted to temperature
+    BACKGROUND
+  };
+
+  /// \brief Thermal state of a sub item, computed once and applied on
+  /// every render until the visuals change
+  private: struct ThermalSubItem
+  {
+    /// \brief The sub item
+    Ogre::SubItem *subItem = nullptr;
+
+    /// \brief How the sub item is rendered
+    SubItemType type = SubItemType::BACKGROUND;
+
+    /// \brief Normalized temperature of heat sources, or diffuse color of
+    /// background objects
+    Ogre::Vector4 color = Ogre::Vector4::ZERO;
+
+    /// \brief Original low level material of the sub item, if any
+    Ogre::MaterialPtr material;
+
+    /// \brief Material to render the sub item with. If null while
+    /// material is set, the default PBS datablock is used instead
+    Ogre::MaterialPtr thermalMaterial;
+
+    /// \brief Original datablock, restored after rendering heat
+    /// signatures
+    Ogre::HlmsDatablock *datablock = nullptr;
+  };
+
   /// \brief Scene manager
   private: Ogre2ScenePtr scene = nullptr;
 
@@ -120,19 +169,26 @@ class Ogre2ThermalCameraMaterialSwitcher : public Ogre::Camera::Listener
   /// \brief The thermal camera
   private: const Ogre::Camera* ogreCamera{nullptr};
 
-  /// \brief A map of ogre sub item pointer to their original hlms material
-  private: std::vector<std::pair<Ogre::SubItem *, Ogre::HlmsDatablock *>>
-      itemDatablockMap;
+  /// \brief Thermal state of the sub items of all the items that belong
+  /// to visuals
+  private: std::vector<ThermalSubItem> subItems;
+
+  /// \brief Heightmaps and their solid color
+  private: std::vector<std::pair<std::weak_ptr<Ogre2Heightmap>,
+                                 Ogre::Vector4>> heightmaps;
 
-  /// \brief A map of ogre sub item pointer to their original low level
-  /// material.
-  /// Most objects don't use one so it should be almost always empty.
-  private:
-    std::vector<std::pair<Ogre::SubItem *, Ogre::MaterialPtr>> materialMap;
+  /// \brief Value of Ogre2Scene::VisualsRevision subItems and heightmaps
+  /// were built with
+  private: uint64_t revision = std::numeric_limits<uint64_t>::max();
 
-  /// \brief A map of ogre datablock pointer to their original blendblocks
-  private: std::unordered_map<Ogre::HlmsDatablock *,
-      const Ogre::HlmsBlendblock *> datablockMap;
+  /// \brief Value of Ogre2Scene::TexturesRevision the colors and blending
+  /// state of subItems were read with
+  private: uint64_t texturesRevision = std::numeric_limits<uint64_t>::max();
+
+  /// \brief Datablocks of heat sources that blend, with their original
+  /// blendblocks. Blending is disabled while rendering and restored after.
+  private: std::vector<std::pair<Ogre::HlmsDatablock *,
+      const Ogre::HlmsBlendblock *>> blendOverrides;
 
   /// \brief linear temperature resolution. Defaults to 10mK
   private: double resolution = 0.01;
@@ -154,6 +210,10 @@ class gz::rendering::Ogre2ThermalCameraPrivate
   /// \brief Outgoing thermal data, used by newThermalFrame event.
   public: uint16_t *thermalImage = nullptr;
 
+  /// \brief Asynchronous readback of the thermal texture, used when the
+  /// sensor readback latency is greater than 0
+  public: Ogre2AsyncReadback readback;
+
   /// \brief maximum value used for data outside sensor range
   public: uint16_t dataMaxVal = std::numeric_limits<uint16_t>::max();
 
@@ -220,36 +280,99 @@ void Ogre2ThermalCameraMaterialSwitcher::SetFormat(PixelFormat _format)
 {
   this->format = _format;
   this->bitDepth = 8u * PixelUtil::BytesPerChannel(format);
+  this->revision = std::numeric_limits<uint64_t>::max();
 }
 
 //////////////////////////////////////////////////
 void Ogre2ThermalCameraMaterialSwitcher::SetLinearResolution(double _resolution)
 {
   this->resolution = _resolution;
+  this->revision = std::numeric_limits<uint64_t>::max();
 }
+
 //////////////////////////////////////////////////
-void Ogre2ThermalCameraMaterialSwitcher::cameraPreRenderScene(
-    Ogre::Camera * /*_cam*/)
+/// \brief Get the temperature of a heat source from the "temperature" user
+/// data of its visual
+/// \param[in] _tempAny Value of the user data. Must not be a string
+/// \param[in] _name Name of the visual, for error messages
+/// \return Temperature in kelvin, clamped to 0, or -1 if the value has
+/// an unsupported type
+static float HeatSourceTemperature(const Variant &_tempAny,
+    const std::string &_name)
 {
-  auto engine = Ogre2RenderEngine::Instance();
-  engine->SetGzOgreRenderingMode(GORM_SOLID_THERMAL_COLOR_TEXTURED);
+  float temp = -1.0;
+  if (auto value = std::get_if<float>(&_tempAny))
+  {
+    temp = *value;
+  }
+  else if (auto valueDouble = std::get_if<double>(&_tempAny))
+  {
+    temp = static_cast<float>(*valueDouble);
+  }
+  else if (auto valueInt = std::get_if<int>(&_tempAny))
+  {
+    temp = static_cast<float>(*valueInt);
+  }
+  else
+  {
+    gzerr << "Error casting user data: temperature of [" << _name
+          << "] must be a float, double or int\n";
+    return -1.0;
+  }
 
-  // swap item to use v1 shader material
-  // Note: keep an eye out for performance impact on switching materials
-  // on the fly. We are not doing this often so should be ok.
-  this->itemDatablockMap.clear();
-  this->materialMap.clear();
-  Ogre::HlmsManager *hlmsManager = engine->OgreRoot()->getHlmsManager();
+  // if a non-positive temperature was given, clamp it to 0
+  if (temp < 0.0)
+  {
+    temp = 0.0;
+    gzwarn << "Unable to set negatve temperature for: "
+        << _name << ". Value cannot be lower than absolute "
+        << "zero. Clamping temperature to 0 degrees Kelvin."
+        << std::endl;
+  }
+  return temp;
+}
+//////////////////////////////////////////////////
+void Ogre2ThermalCameraMaterialSwitcher::Rebuild()
+{
+  this->subItems.clear();
+  this->heightmaps.clear();
+  this->blendOverrides.clear();
+  std::unordered_set<Ogre::HlmsDatablock *> blendingDatablocks;
 
-  Ogre::HlmsDatablock *defaultPbs =
-    hlmsManager->getHlms(Ogre::HLMS_PBS)->getDefaultDatablock();
+  auto engine = Ogre2RenderEngine::Instance();
+  const std::string tempKey = "temperature";
 
-  // Construct one now so that datablock->setBlendblock
-  // each is as fast as possible
-  const Ogre::HlmsBlendblock *noBlend =
-    hlmsManager->getBlendblock(Ogre::HlmsBlendblock());
+  // Find the material replacing a low level material. We need to keep the
+  // material's vertex shader to keep vertex deformation consistent; so we
+  // use a cloned material with a different pixel shader
+  // https://github.com/gazebosim/gz-rendering/issues/544
+  //
+  // material may be a nullptr if we called setMaterial directly
+  // (i.e. it's not using Ogre2Material interface).
+  // In those cases we fallback to PBS in the current IORM mode.
+  auto solidMaterial = [](const Ogre::MaterialPtr &_material)
+  {
+    auto material = Ogre::MaterialManager::getSingleton().getByName(
+      _material->getName() + "_solid",
+      Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+    if (!material)
+    {
+      // The supplied vertex shader could not pair with the
+      // pixel shader we provide. Try to salvage the situation
+      // using PBS shader. Custom deformation won't work but
+      // if we're lucky that won't matter
+      return Ogre::MaterialPtr();
+    }
 
-  const std::string tempKey = "temperature";
+    if (material->getLoadingState() == Ogre::Resource::LOADSTATE_UNLOADED)
+    {
+      // Manually defined materials like PointCloudPoint_solid
+      // need this
+      material->load();
+    }
+
+    return material->getNumSupportedTechniques() > 0u ? material : _material;
+  };
 
   auto itor = this->scene->OgreSceneManager()->getMovableObjectIterator(
       Ogre::ItemFactory::FACTORY_TYPE_NAME);
@@ -257,372 +380,311 @@ void Ogre2ThermalCameraMaterialSwitcher::cameraPreRenderScene(
   {
     Ogre::MovableObject *object = itor.peekNext();
     Ogre::Item *item = static_cast<Ogre::Item *>(object);
+    itor.moveNext();
+
+    // detached items are not rendered
+    if (!item->isAttached())
+      continue;
 
     // get visual
     Ogre::Any userAny = item->getUserObjectBindings().getUserAny();
-    if (!userAny.isEmpty() && userAny.getType() == typeid(unsigned int))
+    if (userAny.isEmpty() || userAny.getType() != typeid(unsigned int))
+      continue;
+
+    VisualPtr result;
+    try
     {
-      VisualPtr result;
-      try
-      {
-        result = this->scene->VisualById(Ogre::any_cast<unsigned int>(userAny));
-      }
-      catch(Ogre::Exception &e)
-      {
-        gzerr << "Ogre Error:" << e.getFullDescription() << "\n";
-      }
-      Ogre2VisualPtr ogreVisual =
-          std::dynamic_pointer_cast<Ogre2Visual>(result);
+      result = this->scene->VisualById(Ogre::any_cast<unsigned int>(userAny));
+    }
+    catch(Ogre::Exception &e)
+    {
+      gzerr << "Ogre Error:" << e.getFullDescription() << "\n";
+    }
+    Ogre2VisualPtr ogreVisual =
+        std::dynamic_pointer_cast<Ogre2Visual>(result);
+    if (!ogreVisual)
+      continue;
+
+    // get temperature
+    Variant tempAny = ogreVisual->UserData(tempKey);
+    if (tempAny.index() != 0 && !std::holds_alternative<std::string>(tempAny))
+    {
+      const float temp = HeatSourceTemperature(tempAny, ogreVisual->Name());
+
+      // normalize temperature value
+      const float color = static_cast<float>((temp / this->resolution) /
+                                             ((1 << bitDepth) - 1.0));
 
-      // get temperature
-      Variant tempAny = ogreVisual->UserData(tempKey);
-      if (tempAny.index() != 0 && !std::holds_alternative<std::string>(tempAny))
+      const size_t numSubItems = item->getNumSubItems();
+      for (size_t i = 0; i < numSubItems; ++i)
       {
-        float temp = -1.0;
-        bool foundTemp = true;
-        try
-        {
-          temp = std::get<float>(tempAny);
-        }
-        catch(...)
-        {
-          try
-          {
-            temp = static_cast<float>(std::get<double>(tempAny));
-          }
-          catch(...)
-          {
-            try
-            {
-              temp = static_cast<float>(std::get<int>(tempAny));
-            }
-            catch(std::bad_variant_access &e)
-            {
-              gzerr << "Error casting user data: " << e.what() << "\n";
-              temp = -1.0;
-              foundTemp = false;
-            }
-          }
-        }
+        ThermalSubItem subItem;
+        subItem.subItem = item->getSubItem(i);
+        subItem.type = SubItemType::HEAT_SOURCE;
+
+        // set g, b, a to 0. This will be used by shaders to determine
+        // if particular fragment is a heat source or not
+        // see media/materials/programs/GLSL/thermal_camera_fs.glsl
+        subItem.color = Ogre::Vector4(color, 0, 0, 0.0);
 
-        // if a non-positive temperature was given, clamp it to 0
-        if (foundTemp && temp < 0.0)
+        if (!subItem.subItem->getMaterial().isNull())
         {
-          temp = 0.0;
-          gzwarn << "Unable to set negatve temperature for: "
-              << ogreVisual->Name() << ". Value cannot be lower than absolute "
-              << "zero. Clamping temperature to 0 degrees Kelvin."
-              << std::endl;
+          subItem.material = subItem.subItem->getMaterial();
+          subItem.thermalMaterial = solidMaterial(subItem.material);
         }
-
-        const size_t numSubItems = item->getNumSubItems();
-        for (size_t i = 0; i < numSubItems; ++i)
+        else
         {
-          Ogre::SubItem *subItem = item->getSubItem(i);
-
-          // normalize temperature value
-          const float color = static_cast<float>((temp / this->resolution) /
-                                                 ((1 << bitDepth) - 1.0));
-
-          // set g, b, a to 0. This will be used by shaders to determine
-          // if particular fragment is a heat source or not
-          // see media/materials/programs/GLSL/thermal_camera_fs.glsl
-          subItem->setCustomParameter(1, Ogre::Vector4(color, 0, 0, 0.0));
-
-          if (!subItem->getMaterial().isNull())
+          // We can't do any sort of blending. This isn't colour what we're
+          // storing, but rather an ID.
+          Ogre::HlmsDatablock *datablock = subItem.subItem->getDatablock();
+          const Ogre::HlmsBlendblock *blendblock =
+              datablock->getBlendblock();
+          if ((blendblock->mSourceBlendFactor != Ogre::SBF_ONE ||
+               blendblock->mDestBlendFactor != Ogre::SBF_ZERO ||
+               blendblock->mBlendOperation != Ogre::SBO_ADD ||
+               (blendblock->mSeparateBlend &&
+                (blendblock->mSourceBlendFactorAlpha != Ogre::SBF_ONE ||
+                 blendblock->mDestBlendFactorAlpha != Ogre::SBF_ZERO ||
+                 blendblock->mBlendOperationAlpha != Ogre::SBO_ADD))) &&
+              blendingDatablocks.insert(datablock).second)
           {
-            this->materialMap.push_back({ subItem, subItem->getMaterial() });
-
-            // We need to keep the material's vertex shader
-            // to keep vertex deformation consistent; so we use
-            // a cloned material with a different pixel shader
-            // https://github.com/gazebosim/gz-rendering/issues/544
-            //
-            // material may be a nullptr if we called setMaterial directly
-            // (i.e. it's not using Ogre2Material interface).
-            // In those cases we fallback to PBS in the current IORM mode.
-            auto material = Ogre::MaterialManager::getSingleton().getByName(
-              subItem->getMaterial()->getName() + "_solid",
-              Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
-            if (material)
-            {
-              if (material->getLoadingState() ==
-                  Ogre::Resource::LOADSTATE_UNLOADED)
-              {
-                // Manually defined materials like PointCloudPoint_solid
-                // need this
-                material->load();
-              }
-
-              if (material->getNumSupportedTechniques() > 0u)
-              {
-                subItem->setMaterial(material);
-              }
-            }
-            else
-            {
-              // The supplied vertex shader could not pair with the
-              // pixel shader we provide. Try to salvage the situation
-              // using PBS shader. Custom deformation won't work but
-              // if we're lucky that won't matter
-              subItem->setDatablock(defaultPbs);
-            }
-          }
-          else
-          {
-            Ogre::HlmsDatablock *datablock = subItem->getDatablock();
-            const Ogre::HlmsBlendblock *blendblock = datablock->getBlendblock();
-
-            // We can't do any sort of blending. This isn't colour what we're
-            // storing, but rather an ID.
-            if (blendblock->mSourceBlendFactor != Ogre::SBF_ONE ||
-                blendblock->mDestBlendFactor != Ogre::SBF_ZERO ||
-                blendblock->mBlendOperation != Ogre::SBO_ADD ||
-                (blendblock->mSeparateBlend &&
-                 (blendblock->mSourceBlendFactorAlpha != Ogre::SBF_ONE ||
-                  blendblock->mDestBlendFactorAlpha != Ogre::SBF_ZERO ||
-                  blendblock->mBlendOperationAlpha != Ogre::SBO_ADD)))
-            {
-              hlmsManager->addReference(blendblock);
-              this->datablockMap[datablock] = blendblock;
-              datablock->setBlendblock(noBlend);
-            }
+            this->blendOverrides.emplace_back(datablock, blendblock);
           }
         }
+        this->subItems.push_back(std::move(subItem));
       }
-      // get heat signature and the corresponding min/max temperature values
-      else if (auto heatSignature = std::get_if<std::string>(&tempAny))
+    }
+    // get heat signature and the corresponding min/max temperature values
+    else if (auto heatSignature = std::get_if<std::string>(&tempAny))
+    {
+      // if this is the first time rendering the heat signature,
+      // we need to make sure that the texture is loaded and applied to
+      // the heat signature material before loading the material
+      if (this->heatSignatureMaterials.find(item->getId()) ==
+          this->heatSignatureMaterials.end())
       {
-        // if this is the first time rendering the heat signature,
-        // we need to make sure that the texture is loaded and applied to
-        // the heat signature material before loading the material
-        if (this->heatSignatureMaterials.find(item->getId()) ==
-            this->heatSignatureMaterials.end())
+        // make sure the texture is in ogre's resource path
+        const auto &texture = *heatSignature;
+        engine->AddResourcePath(texture);
+
+        // create a material for this item, now that the texture has been
+        // searched for. We must clone the base heat signature material since
+        // different items may use different textures. We also append the
+        // item's ID to the end of the new material name to ensure new
+        // material uniqueness in case two items use the same heat signature
+        // texture, but have different temperature ranges
+        std::string baseName = common::basename(texture);
+        auto heatSignatureMaterial = this->baseHeatSigMaterial->clone(
+            this->name + "_" + baseName + "_" +
+            Ogre::StringConverter::toString(item->getId()));
+        auto textureUnitStatePtr = heatSignatureMaterial->
+          getTechnique(0)->getPass(0)->getTextureUnitState(0);
+        Ogre::String textureName = baseName;
+        textureUnitStatePtr->setTextureName(textureName);
+
+        // set temperature range for the heat signature
+        auto minTempVariant = ogreVisual->UserData("minTemp");
+        auto maxTempVariant = ogreVisual->UserData("maxTemp");
+        auto minTemperature = std::get_if<float>(&minTempVariant);
+        auto maxTemperature = std::get_if<float>(&maxTempVariant);
+        if (minTemperature && maxTemperature)
         {
-          // make sure the texture is in ogre's resource path
-          const auto &texture = *heatSignature;
-          engine->AddResourcePath(texture);
-
-          // create a material for this item, now that the texture has been
-          // searched for. We must clone the base heat signature material since
-          // different items may use different textures. We also append the
-          // item's ID to the end of the new material name to ensure new
-          // material uniqueness in case two items use the same heat signature
-          // texture, but have different temperature ranges
-          std::string baseName = common::basename(texture);
-          auto heatSignatureMaterial = this->baseHeatSigMaterial->clone(
-              this->name + "_" + baseName + "_" +
-              Ogre::StringConverter::toString(item->getId()));
-          auto textureUnitStatePtr = heatSignatureMaterial->
-            getTechnique(0)->getPass(0)->getTextureUnitState(0);
-          Ogre::String textureName = baseName;
-          textureUnitStatePtr->setTextureName(textureName);
-
-          // set temperature range for the heat signature
-          auto minTempVariant = ogreVisual->UserData("minTemp");
-          auto maxTempVariant = ogreVisual->UserData("maxTemp");
-          auto minTemperature = std::get_if<float>(&minTempVariant);
-          auto maxTemperature = std::get_if<float>(&maxTempVariant);
-          if (minTemperature && maxTemperature)
-          {
-            // make sure the temperature range is between [min, max] kelvin
-            // for the given pixel format and camera resolution
-            float maxTemp = ((1 << bitDepth) - 1.0) * this->resolution;
-            Ogre::GpuProgramParametersSharedPtr params =
-              heatSignatureMaterial->getTechnique(0)->getPass(0)->
-              getFragmentProgramParameters();
-            params->setNamedConstant("minTemp",
-                std::max(static_cast<float>(*minTemperature), 0.0f));
-            params->setNamedConstant("maxTemp",
-                std::min(static_cast<float>(*maxTemperature), maxTemp));
-            params->setNamedConstant("bitDepth",
-                static_cast<int>(this->bitDepth));
-            params->setNamedConstant("resolution",
-                static_cast<float>(this->resolution));
-          }
-          heatSignatureMaterial->load();
-          this->heatSignatureMaterials[item->getId()] = heatSignatureMaterial;
+          // make sure the temperature range is between [min, max] kelvin
+          // for the given pixel format and camera resolution
+          float maxTemp = ((1 << bitDepth) - 1.0) * this->resolution;
+          Ogre::GpuProgramParametersSharedPtr params =
+            heatSignatureMaterial->getTechnique(0)->getPass(0)->
+            getFragmentProgramParameters();
+          params->setNamedConstant("minTemp",
+              std::max(static_cast<float>(*minTemperature), 0.0f));
+          params->setNamedConstant("maxTemp",
+              std::min(static_cast<float>(*maxTemperature), maxTemp));
+          params->setNamedConstant("bitDepth",
+              static_cast<int>(this->bitDepth));
+          params->setNamedConstant("resolution",
+              static_cast<float>(this->resolution));
         }
+        heatSignatureMaterial->load();
+        this->heatSignatureMaterials[item->getId()] = heatSignatureMaterial;
+      }
 
-        const size_t numSubItems = item->getNumSubItems();
-        for (size_t i = 0; i < numSubItems; ++i)
-        {
-          Ogre::SubItem *subItem = item->getSubItem(i);
-
-          if (!subItem->getMaterial().isNull())
-          {
-            // TODO(anyone): We need to keep the material's vertex shader
-            // to keep vertex deformation consistent. See
-            // https://github.com/gazebosim/gz-rendering/issues/544
-            this->materialMap.push_back({ subItem, subItem->getMaterial() });
-          }
-          else
-          {
-            // TODO(anyone): We're not using Hlms pieces, therefore HW
-            // vertex deformation (e.g. skinning / skeletal animation) won't
-            // show up correctly
-            Ogre::HlmsDatablock *datablock = subItem->getDatablock();
-            this->itemDatablockMap.push_back({ subItem, datablock });
-          }
+      const size_t numSubItems = item->getNumSubItems();
+      for (size_t i = 0; i < numSubItems; ++i)
+      {
+        ThermalSubItem subItem;
+        subItem.subItem = item->getSubItem(i);
+        subItem.type = SubItemType::HEAT_SIGNATURE;
+        subItem.thermalMaterial = this->heatSignatureMaterials[item->getId()];
 
-          subItem->setMaterial(this->heatSignatureMaterials[item->getId()]);
+        if (!subItem.subItem->getMaterial().isNull())
+        {
+          // TODO(anyone): We need to keep the material's vertex shader
+          // to keep vertex deformation consistent. See
+          // https://github.com/gazebosim/gz-rendering/issues/544
+          subItem.material = subItem.subItem->getMaterial();
         }
+        else
+        {
+          // TODO(anyone): We're not using Hlms pieces, therefore HW
+          // vertex deformation (e.g. skinning / skeletal animation) won't
+          // show up correctly
+          subItem.datablock = subItem.subItem->getDatablock();
+        }
+        this->subItems.push_back(std::move(subItem));
       }
-      else
+    }
+    else
+    {
+      // Temperature object not set
+      // We consider this a "background object".
+      //
+      // It will be set to ambient temperature in thermal_camera_fs.glsl
+      // but its unlit, textured RGB color actually matters.
+      //
+      // We will be converting rgb values to temperature values in shaders
+      // thus we want them textured but without lighting
+      const size_t numSubItems = item->getNumSubItems();
+      for (size_t i = 0; i < numSubItems; ++i)
       {
-        // Temperature object not set
-        // We consider this a "background object".
-        //
-        // It will be set to ambient temperature in thermal_camera_fs.glsl
-        // but its unlit, textured RGB color actually matters.
-        //
-        // We will be converting rgb values to temperature values in shaders
-        // thus we want them textured but without lighting
-        const size_t numSubItems = item->getNumSubItems();
-        for (size_t i = 0; i < numSubItems; ++i)
+        ThermalSubItem subItem;
+        subItem.subItem = item->getSubItem(i);
+        subItem.type = SubItemType::BACKGROUND;
+        const Ogre::ColourValue diffuse =
+            subItem.subItem->getDatablock()->getDiffuseColour();
+        subItem.color = Ogre::Vector4(diffuse.r, diffuse.g, diffuse.b, 1.0);
+        if (!subItem.subItem->getMaterial().isNull())
         {
-          Ogre::SubItem *subItem = item->getSubItem(i);
-
-          const Ogre::HlmsDatablock *datablock = subItem->getDatablock();
-          const Ogre::ColourValue color = datablock->getDiffuseColour();
-          subItem->setCustomParameter(
-            1u, Ogre::Vector4(color.r, color.g, color.b, 1.0));
-
-          // Set 2 to signal we want it to multiply against
-          // the diffuse texture (if any). The actual value doesn't matter.
-          subItem->setCustomParameter(2u, Ogre::Vector4::ZERO);
-
-          if (!subItem->getMaterial().isNull())
-          {
-            this->materialMap.push_back({ subItem, subItem->getMaterial() });
-
-            // We need to keep the material's vertex shader
-            // to keep vertex deformation consistent; so we use
-            // a cloned material with a different pixel shader
-            // https://github.com/gazebosim/gz-rendering/issues/544
-            //
-            // material may be a nullptr if we called setMaterial directly
-            // (i.e. it's not using Ogre2Material interface).
-            // In those cases we fallback to PBS in the current IORM mode.
-            auto material = Ogre::MaterialManager::getSingleton().getByName(
-              subItem->getMaterial()->getName() + "_solid",
-              Ogre::ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
-            if (material)
-            {
-              if (material->getLoadingState() ==
-                  Ogre::Resource::LOADSTATE_UNLOADED)
-              {
-                // Manually defined materials like PointCloudPoint_solid
-                // need this
-                material->load();
-              }
-
-              if (material->getNumSupportedTechniques() > 0u)
-              {
-                subItem->setMaterial(material);
-              }
-            }
-            else
-            {
-              // The supplied vertex shader could not pair with the
-              // pixel shader we provide. Try to salvage the situation
-              // using PBS shader. Custom deformation won't work but
-              // if we're lucky that won't matter
-              subItem->setDatablock(defaultPbs);
-            }
-          }
-          else
-          {
-            // We don't save to this->datablockMap because we're already
-            // honouring the original HlmsBlendblock. There's nothing
-            // to override.
-          }
+          subItem.material = subItem.subItem->getMaterial();
+          subItem.thermalMaterial = solidMaterial(subItem.material);
         }
+        this->subItems.push_back(std::move(subItem));
       }
     }
-
-    itor.moveNext();
   }
 
   // Do the same with heightmaps / terrain
-  auto heightmaps = this->scene->Heightmaps();
-  for (auto h : heightmaps)
+  auto sceneHeightmaps = this->scene->Heightmaps();
+  for (auto h : sceneHeightmaps)
   {
     auto heightmap = h.lock();
-    if (heightmap)
+    if (!heightmap)
+      continue;
+
+    VisualPtr visual = heightmap->Parent();
+
+    // get temperature
+    Variant tempAny = visual->UserData(tempKey);
+    if (tempAny.index() != 0 && !std::holds_alternative<std::string>(tempAny))
     {
-      VisualPtr visual = heightmap->Parent();
+      const float temp = HeatSourceTemperature(tempAny, visual->Name());
 
-      // get temperature
-      Variant tempAny = visual->UserData(tempKey);
-      if (tempAny.index() != 0 && !std::holds_alternative<std::string>(tempAny))
-      {
-        float temp = -1.0;
-        bool foundTemp = true;
-        try
-        {
-          temp = std::get<float>(tempAny);
-        }
-        catch (...)
-        {
-          try
-          {
-            temp = static_cast<float>(std::get<double>(tempAny));
-          }
-          catch (...)
-          {
-            try
-            {
-              temp = static_cast<float>(std::get<int>(tempAny));
-            }
-            catch (std::bad_variant_access &e)
-            {
-              gzerr << "Error casting user data: " << e.what() << "\n";
-              temp = -1.0;
-              foundTemp = false;
-            }
-          }
-        }
+      // normalize temperature value
+      const float color = static_cast<float>((temp / this->resolution) /
+                                             ((1 << bitDepth) - 1.0));
 
-        // if a non-positive temperature was given, clamp it to 0
-        if (foundTemp && temp < 0.0)
-        {
-          temp = 0.0;
-          gzwarn << "Unable to set negatve temperature for: " << visual->Name()
-                  << ". Value cannot be lower than absolute "
-                  << "zero. Clamping temperature to 0 degrees Kelvin."
-                  << std::endl;
-        }
+      this->heightmaps.emplace_back(h, Ogre::Vector4(color, 0, 0, 0.0));
+      // TODO(anyone): Retrieve datablock and make sure it's not blending
+      // like we do with Items (it should be impossible?)
+    }
+    // get heat signature and the corresponding min/max temperature values
+    else if (std::get_if<std::string>(&tempAny))
+    {
+      gzerr << "Heat Signature not yet supported by Heightmaps. Simulation "
+                "may crash!\n";
+    }
+    else
+    {
+      // Temperature object not set
+      // We consider this a "background object".
+
+      // TODO(anyone): Retrieve datablock and get diffuse color
+      // (it's likely gonna be 1 1 1 1 anyway... Does it matter?).
+      this->heightmaps.emplace_back(h, Ogre::Vector4(1.0, 1.0, 1.0, 1.0));
+      // TODO(anyone): Retrieve datablock and make sure it's not blending
+      // like we do with Items (it should be impossible?)
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2ThermalCameraMaterialSwitcher::cameraPreRenderScene(
+    Ogre::Camera * /*_cam*/)
+{
+  auto engine = Ogre2RenderEngine::Instance();
+  engine->SetGzOgreRenderingMode(GORM_SOLID_THERMAL_COLOR_TEXTURED);
 
-        // normalize temperature value
-        const float color = static_cast<float>((temp / this->resolution) /
-                                               ((1 << bitDepth) - 1.0));
+  // The thermal state of items only depends on the user data of their
+  // visuals and on their materials, so it is only recomputed when they
+  // change
+  if (this->revision != this->scene->VisualsRevision() ||
+      this->texturesRevision != this->scene->TexturesRevision())
+  {
+    this->Rebuild();
+    this->revision = this->scene->VisualsRevision();
+    this->texturesRevision = this->scene->TexturesRevision();
+  }
 
-        heightmap->Terra()->SetSolidColor(1u, Ogre::Vector4(color, 0, 0, 0.0));
-        // TODO(anyone): Retrieve datablock and make sure it's not blending
-        // like we do with Items (it should be impossible?)
-      }
-      // get heat signature and the corresponding min/max temperature values
-      else if (std::get_if<std::string>(&tempAny))
-      {
-        gzerr << "Heat Signature not yet supported by Heightmaps. Simulation "
-                  "may crash!\n";
-      }
+  // swap item to use v1 shader material
+  // Note: keep an eye out for performance impact on switching materials
+  // on the fly. We are not doing this often so should be ok.
+  Ogre::HlmsManager *hlmsManager = engine->OgreRoot()->getHlmsManager();
+
+  Ogre::HlmsDatablock *defaultPbs =
+    hlmsManager->getHlms(Ogre::HLMS_PBS)->getDefaultDatablock();
+
+  // Construct one now so that datablock->setBlendblock
+  // each is as fast as possible
+  const Ogre::HlmsBlendblock *noBlend =
+    hlmsManager->getBlendblock(Ogre::HlmsBlendblock());
+
+  // Keep the original blendblocks alive while the datablocks don't
+  // reference them
+  for (const auto &[datablock, blendblock] : this->blendOverrides)
+  {
+    hlmsManager->addReference(blendblock);
+    datablock->setBlendblock(noBlend);
+  }
+
+  for (const ThermalSubItem &thermalSubItem : this->subItems)
+  {
+    Ogre::SubItem *subItem = thermalSubItem.subItem;
+    switch (thermalSubItem.type)
+    {
+      case SubItemType::HEAT_SOURCE:
+        subItem->setCustomParameter(1, thermalSubItem.color);
+        break;
+      case SubItemType::HEAT_SIGNATURE:
+        subItem->setMaterial(thermalSubItem.thermalMaterial);
+        break;
+      case SubItemType::BACKGROUND:
+        subItem->setCustomParameter(1u, thermalSubItem.color);
+
+        // Set 2 to signal we want it to multiply against
+        // the diffuse texture (if any). The actual value doesn't matter.
+        subItem->setCustomParameter(2u, Ogre::Vector4::ZERO);
+
+        // Blending is not overridden because we're already honouring the
+        // original HlmsBlendblock. There's nothing to override.
+        break;
+    }
+
+    if (thermalSubItem.material &&
+        thermalSubItem.type != SubItemType::HEAT_SIGNATURE)
+    {
+      if (thermalSubItem.thermalMaterial)
+        subItem->setMaterial(thermalSubItem.thermalMaterial);
       else
-      {
-        // Temperature object not set
-        // We consider this a "background object".
-
-        // TODO(anyone): Retrieve datablock and get diffuse color
-        // (it's likely gonna be 1 1 1 1 anyway... Does it matter?).
-        heightmap->Terra()->SetSolidColor(1u,
-                                          Ogre::Vector4(1.0, 1.0, 1.0, 1.0));
-        // TODO(anyone): Retrieve datablock and make sure it's not blending
-        // like we do with Items (it should be impossible?)
-      }
+        subItem->setDatablock(defaultPbs);
     }
   }
 
+  for (const auto &[h, color] : this->heightmaps)
+  {
+    auto heightmap = h.lock();
+    if (heightmap)
+      heightmap->Terra()->SetSolidColor(1u, color);
+  }
+
   // Remove the reference count on noBlend we created
   hlmsManager->destroyBlendblock(noBlend);
 }
@@ -635,13 +697,12 @@ void Ogre2ThermalCameraMaterialSwitcher::cameraPostRenderScene(
   Ogre::HlmsManager *hlmsManager = engine->OgreRoot()->getHlmsManager();
 
   // Restore original blending to modified materials
-  for (const auto &[datablock, blendblock] : this->datablockMap)
+  for (const auto &[datablock, blendblock] : this->blendOverrides)
   {
     datablock->setBlendblock(blendblock);
     // Remove the reference we added (this won't actually destroy it)
     hlmsManager->destroyBlendblock(blendblock);
   }
-  this->datablockMap.clear();
 
   // Remove the custom parameter. Why? If there are multiple cameras that
   // use GORM_SOLID_COLOR (or any other mode), we want them to throw if
@@ -649,47 +710,27 @@ void Ogre2ThermalCameraMaterialSwitcher::cameraPostRenderScene(
   // if that code forgets to call but it was already carrying the value
   // we set here.
   //
-  // This consumes more performance but it's the price to pay for
-  // safety.
-  auto itor = this->scene->OgreSceneManager()->getMovableObjectIterator(
-      Ogre::ItemFactory::FACTORY_TYPE_NAME);
-  while (itor.hasMoreElements())
-  {
-    Ogre::MovableObject *object = itor.peekNext();
-    Ogre::Item *item = static_cast<Ogre::Item *>(object);
-    const size_t numSubItems = item->getNumSubItems();
-    for (size_t i = 0; i < numSubItems; ++i)
-    {
-      Ogre::SubItem *subItem = item->getSubItem(i);
-      subItem->removeCustomParameter(1u);
-      subItem->removeCustomParameter(2u);
-    }
-    itor.moveNext();
-  }
-
-  // Restore Items with low level materials
-  for (auto subItemMat : this->materialMap)
+  // Also restore Items with low level materials and
+  // restore item to use pbs hlms material
+  for (const ThermalSubItem &thermalSubItem : this->subItems)
   {
-    subItemMat.first->setMaterial(subItemMat.second);
+    Ogre::SubItem *subItem = thermalSubItem.subItem;
+    subItem->removeCustomParameter(1u);
+    subItem->removeCustomParameter(2u);
+    if (thermalSubItem.material)
+      subItem->setMaterial(thermalSubItem.material);
+    else if (thermalSubItem.datablock)
+      subItem->setDatablock(thermalSubItem.datablock);
   }
-  this->materialMap.clear();
 
   // Remove the custom parameter (same reason as with Items)
-  auto heightmaps = this->scene->Heightmaps();
-  for (auto h : heightmaps)
+  for (const auto &entry : this->heightmaps)
   {
-    auto heightmap = h.lock();
+    auto heightmap = entry.first.lock();
     if (heightmap)
       heightmap->Terra()->UnsetSolidColors();
   }
 
-  // restore item to use pbs hlms material
-  for (auto it : this->itemDatablockMap)
-  {
-    Ogre::SubItem *subItem = it.first;
-    subItem->setDatablock(it.second);
-  }
-
   engine->SetGzOgreRenderingMode(GORM_NORMAL);
 }
 
@@ -734,6 +775,8 @@ void Ogre2ThermalCamera::Destroy()
   if (!this->ogreCamera)
     return;
 
+  this->dataPtr->readback.Reset();
+
   auto engine = Ogre2RenderEngine::Instance();
   auto ogreRoot = engine->OgreRoot();
   auto ogreCompMgr = ogreRoot->getCompositorManager2();
@@ -1147,14 +1190,27 @@ void Ogre2ThermalCamera::PostRender()
   unsigned int bytesPerChannel = PixelUtil::BytesPerChannel(format);
 
   Ogre::Image2 image;
-  image.convertFromTexture(this->dataPtr->ogreThermalTexture, 0u, 0u);
+  Ogre::TextureBox box;
+  Ogre2AsyncReadback &readback = this->dataPtr->readback;
+  readback.SetLatency(this->ReadbackLatency());
+  if (readback.Latency() > 0u)
+  {
+    readback.Download(this->dataPtr->ogreThermalTexture);
+    if (!readback.FrameReady())
+      return;
+    box = readback.MapFrame();
+  }
+  else
+  {
+    image.convertFromTexture(this->dataPtr->ogreThermalTexture, 0u, 0u);
+    box = image.getData(0u);
+  }
 
   if (!this->dataPtr->thermalImage)
   {
     this->dataPtr->thermalImage = new uint16_t[len];
   }
 
-  Ogre::TextureBox box = image.getData(0u);
   if (format == PF_L8)
   {
     uint8_t *thermalBuffer = static_cast<uint8_t*>(box.data);
@@ -1186,6 +1242,9 @@ void Ogre2ThermalCamera::PostRender()
     }
   }
 
+  if (readback.Latency() > 0u)
+    readback.UnmapFrame();
+
   this->dataPtr->newThermalFrame(
       this->dataPtr->thermalImage, width, height, 1,
       PixelUtil::Name(format));
@@ -15,12 +15,18 @@
  *
  */
 
+#include <limits>
+#include <typeinfo>
+#include <vector>
+
 #include <gz/common/Console.hh>
 
 #include "gz/rendering/ogre2/Ogre2Conversions.hh"
 #include "gz/rendering/ogre2/Ogre2Geometry.hh"
+#include "gz/rendering/ogre2/Ogre2Mesh.hh"
 #include "gz/rendering/ogre2/Ogre2ParticleEmitter.hh"
 #include "gz/rendering/ogre2/Ogre2RenderTypes.hh"
+#include "gz/rendering/ogre2/Ogre2Scene.hh"
 #include "gz/rendering/ogre2/Ogre2Storage.hh"
 #include "gz/rendering/ogre2/Ogre2Visual.hh"
 #include "gz/rendering/Utils.hh"
@@ -29,6 +35,7 @@
   #pragma warning(push, 0)
 #endif
 #include <OgreItem.h>
+#include <OgreSceneManager.h>
 #ifdef _MSC_VER
   #pragma warning(pop)
 #endif
@@ -41,8 +48,51 @@ class gz::rendering::Ogre2VisualPrivate
 {
   /// \brief True if wireframe mode is enabled
   public: bool wireframe;
+
+  /// \brief Value of Ogre2Scene::VisualsRevision the pre-render lists
+  /// below were built for
+  public: uint64_t preRenderRevision = std::numeric_limits<uint64_t>::max();
+
+  /// \brief Value of Ogre2Scene::VisualsRevision when the current full
+  /// pre-render started
+  public: uint64_t preRenderStartRevision = 0u;
+
+  /// \brief Children that need to be pre-rendered every frame. Only valid
+  /// while preRenderRevision is current; children can only be removed by
+  /// bumping the revision.
+  public: std::vector<Node *> preRenderChildren;
+
+  /// \brief Geometries that need to be pre-rendered every frame. Same
+  /// validity rules as preRenderChildren.
+  public: std::vector<Geometry *> preRenderGeometries;
+
+  /// \brief True if nothing in this visual's subtree needs to be
+  /// pre-rendered, so its parent can skip it
+  public: bool preRenderStatic = false;
 };
 
+/// \brief Check if a geometry has nothing to do in PreRender. This is the
+/// case of plain meshes whose materials have no custom shader parameters.
+/// \param[in] _geometry Geometry to check
+/// \return True if the geometry can be skipped
+static bool IsPreRenderStatic(Geometry *_geometry)
+{
+  if (typeid(*_geometry) != typeid(Ogre2Mesh))
+    return false;
+
+  Ogre2Mesh *mesh = static_cast<Ogre2Mesh *>(_geometry);
+  for (unsigned int i = 0; i < mesh->SubMeshCount(); ++i)
+  {
+    MaterialPtr material = mesh->SubMeshByIndex(i)->Material();
+    if (material &&
+        (material->VertexShaderParams() || material->FragmentShaderParams()))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
 //////////////////////////////////////////////////
 Ogre2Visual::Ogre2Visual()
   : dataPtr(new Ogre2VisualPrivate)
@@ -65,6 +115,25 @@ void Ogre2Visual::SetWireframe(bool _show)
     return;
 
   this->dataPtr->wireframe = _show;
+
+  // the datablocks are modified below, so they must not be shared with
+  // other visuals
+  for (unsigned int i = 0; i < this->GeometryCount(); ++i)
+  {
+    Ogre2MeshPtr mesh =
+        std::dynamic_pointer_cast<Ogre2Mesh>(this->GeometryByIndex(i));
+    if (!mesh)
+      continue;
+
+    for (unsigned int j = 0; j < mesh->SubMeshCount(); ++j)
+    {
+      Ogre2SubMeshPtr subMesh =
+          std::dynamic_pointer_cast<Ogre2SubMesh>(mesh->SubMeshByIndex(j));
+      if (subMesh)
+        subMesh->DetachSharedDatablock();
+    }
+  }
+
   for (unsigned int i = 0; i < this->ogreNode->numAttachedObjects();
       i++)
   {
@@ -105,10 +174,73 @@ void Ogre2Visual::SetVisible(bool _visible)
   this->ogreNode->setVisible(_visible);
 }
 
+//////////////////////////////////////////////////
+void Ogre2Visual::PreRenderChildren()
+{
+  const uint64_t revision = this->scene->VisualsRevision();
+  if (this->dataPtr->preRenderRevision == revision)
+  {
+    for (Node *child : this->dataPtr->preRenderChildren)
+      child->PreRender();
+    return;
+  }
+
+  // Visuals changed since the lists were built. Visit everything and
+  // record what needs to be visited in the next frames.
+  // Children may change the visuals while being pre-rendered, so the
+  // revision is sampled before visiting them.
+  this->dataPtr->preRenderStartRevision = revision;
+  this->dataPtr->preRenderChildren.clear();
+  for (unsigned int i = 0; i < this->ChildCount(); ++i)
+  {
+    NodePtr child = this->ChildByIndex(i);
+    child->PreRender();
+
+    Node *node = child.get();
+    if (typeid(*node) != typeid(Ogre2Visual) ||
+        !static_cast<Ogre2Visual *>(node)->dataPtr->preRenderStatic)
+    {
+      this->dataPtr->preRenderChildren.push_back(node);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Ogre2Visual::PreRenderGeometries()
+{
+  if (this->dataPtr->preRenderRevision == this->scene->VisualsRevision())
+  {
+    for (Geometry *geometry : this->dataPtr->preRenderGeometries)
+      geometry->PreRender();
+    return;
+  }
+
+  this->dataPtr->preRenderGeometries.clear();
+  for (unsigned int i = 0; i < this->GeometryCount(); ++i)
+  {
+    GeometryPtr geometry = this->GeometryByIndex(i);
+    geometry->PreRender();
+
+    if (!IsPreRenderStatic(geometry.get()))
+      this->dataPtr->preRenderGeometries.push_back(geometry.get());
+  }
+
+  // BaseVisual::PreRender visits children first, so both lists are now
+  // complete. Derived visual types may update themselves every frame and
+  // are never skipped.
+  this->dataPtr->preRenderStatic = typeid(*this) == typeid(Ogre2Visual) &&
+      this->dataPtr->preRenderChildren.empty() &&
+      this->dataPtr->preRenderGeometries.empty();
+  this->dataPtr->preRenderRevision = this->dataPtr->preRenderStartRevision;
+}
+
 //////////////////////////////////////////////////
 void Ogre2Visual::SetStatic(bool _static)
 {
+  // Also moves the attached objects to the static or dynamic lists
   this->ogreNode->setStatic(_static);
+  if (_static && this->scene)
+    this->scene->OgreSceneManager()->notifyStaticDirty(this->ogreNode);
 }
 
 //////////////////////////////////////////////////
@@ -182,6 +314,18 @@ bool Ogre2Visual::AttachGeometry(GeometryPtr _geometry)
   derived->SetParent(this->SharedThis());
   this->ogreNode->attachObject(ogreObj);
 
+  // Objects are created dynamic. Match the node so that geometries of
+  // static visuals skip the per frame transform and bounds updates too.
+  if (ogreObj->isStatic() != this->ogreNode->isStatic())
+  {
+    ogreObj->setStatic(this->ogreNode->isStatic());
+    if (this->scene && this->ogreNode->isStatic())
+      this->scene->OgreSceneManager()->notifyStaticDirty(this->ogreNode);
+  }
+
+  if (this->scene)
+    this->scene->SetVisualsDirty();
+
   return true;
 }
 
@@ -208,6 +352,8 @@ bool Ogre2Visual::DetachGeometry(GeometryPtr _geometry)
   if (nullptr != derived->OgreObject())
     this->ogreNode->detachObject(derived->OgreObject());
   derived->SetParent(nullptr);
+  if (this->scene)
+    this->scene->SetVisualsDirty();
   return true;
 }
 
@@ -17,6 +17,11 @@
 
 #include "gz/rendering/ogre2/Ogre2WideAngleCamera.hh"
 
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <vector>
+
 #include "gz/rendering/CameraLens.hh"
 #include "gz/rendering/ogre2/Ogre2Conversions.hh"
 #include "gz/rendering/ogre2/Ogre2RenderEngine.hh"
@@ -117,6 +122,14 @@ class gz::rendering::Ogre2WideAngleCamera::Implementation
   /// \brief Compositor workspace. Does all the work. One for each face
   public: Ogre::CompositorWorkspace *ogreCompositorWorkspace[6];
 
+  /// \brief Indices of the cubemap faces sampled by the final pass. Only
+  /// these faces are rendered
+  public: std::set<uint32_t> cubeFaceIdx;
+
+  /// \brief Lens, field of view and resolutions cubeFaceIdx was computed
+  /// for
+  public: std::vector<double> cubeFaceIdxParams;
+
   /// \brief Compositor workspace. Converts the cubemap into a "fish eye"
   public: Ogre::CompositorWorkspace *ogreCompositorFinalPass = nullptr;
 
@@ -166,6 +179,16 @@ class gz::rendering::Ogre2WideAngleCamera::Implementation
   {
   }
   // clang-format on
+
+  /// \brief Find the cubemap faces sampled by the final pass, mirroring the
+  /// math in wide_lens_map_fp.glsl. Does nothing if the parameters have not
+  /// changed since the last call.
+  /// \param[in] _lens Camera lens
+  /// \param[in] _hfov Horizontal field of view in radians
+  /// \param[in] _width Image width
+  /// \param[in] _height Image height
+  public: void UpdateCubeFaceIdx(const CameraLens &_lens, double _hfov,
+                                 uint32_t _width, uint32_t _height);
 };
 
 using namespace gz;
@@ -175,6 +198,104 @@ using namespace rendering;
 static constexpr uint32_t kWideAngleCameraCubemapPassId = 1276660u;
 static constexpr uint32_t kWideAngleCameraQuadPassId = 1276661u;
 
+//////////////////////////////////////////////////
+void Ogre2WideAngleCamera::Implementation::UpdateCubeFaceIdx(
+  const CameraLens &_lens, double _hfov, uint32_t _width, uint32_t _height)
+{
+  double f = _lens.F();
+  if (_lens.ScaleToHFOV())
+  {
+    double param = (_hfov / 2.0) / _lens.C2() + _lens.C3();
+    double funRes = _lens.ApplyMappingFunction(static_cast<float>(param));
+    f = 1.0 / (_lens.C1() * funRes);
+  }
+  const math::Vector3d fun = _lens.MappingFunctionAsVector3d();
+
+  std::vector<double> params = {
+    _lens.C1(), _lens.C2(), _lens.C3(), f, fun.X(), fun.Y(), fun.Z(),
+    _lens.CutOffAngle(), static_cast<double>(_width),
+    static_cast<double>(_height), static_cast<double>(this->envTextureSize)
+  };
+  if (params == this->cubeFaceIdxParams)
+    return;
+  this->cubeFaceIdxParams = params;
+  this->cubeFaceIdx.clear();
+
+  // Pixels beyond this radius are blacked out, so what they sample does
+  // not matter
+  const double cutOffParam = _lens.CutOffAngle() / _lens.C2() + _lens.C3();
+  const double cutRadius = _lens.C1() * f *
+    (fun.X() * std::sin(cutOffParam) + fun.Y() * std::tan(cutOffParam) +
+     fun.Z() * cutOffParam);
+
+  // Cubemap sampling blends texels across the edges of the faces. Also
+  // add the neighbour face of directions that are a couple of texels away
+  // from an edge
+  const double edgeMargin =
+    1.0 - 4.0 / static_cast<double>(std::max(this->envTextureSize, 4u));
+
+  const double ratio = static_cast<double>(_width) /
+                       static_cast<double>(_height);
+  for (uint32_t v = 0u; v < _height; ++v)
+  {
+    // fragPos in wide_lens_map_vs. Its y flip only undoes the flipped clip
+    // space y of render targets, so fragPos.y is positive at the top of
+    // the image with every render system (see the Metal version).
+    const double ndcY = 1.0 - 2.0 * (v + 0.5) / _height;
+    for (uint32_t u = 0u; u < _width; ++u)
+    {
+      const double ndcX = 2.0 * (u + 0.5) / _width - 1.0;
+      const double x = -ndcX;
+      const double y = ndcY / ratio;
+      const double r = std::sqrt(x * x + y * y);
+      if (r >= cutRadius)
+        continue;
+
+      // angle from optical axis based on the mapping function
+      const double param = r / (_lens.C1() * f);
+      double theta = 0.0;
+      if (fun.X() > 0)
+        theta = std::asin(param);
+      else if (fun.Y() > 0)
+        theta = std::atan(param);
+      else if (fun.Z() > 0)
+        theta = param;
+      theta = (theta - _lens.C3()) * _lens.C2();
+      if (!std::isfinite(theta))
+        continue;
+
+      // direction vector used to sample from the cubemap
+      double dir[3] = {0.0, 0.0, std::cos(theta)};
+      if (r > 0.0)
+      {
+        dir[0] = -std::sin(theta) * x / r;
+        dir[1] = std::sin(theta) * y / r;
+      }
+
+      // faces are ordered +X, -X, +Y, -Y, +Z, -Z
+      uint32_t major = 0u;
+      for (uint32_t a = 1u; a < 3u; ++a)
+      {
+        if (std::fabs(dir[a]) > std::fabs(dir[major]))
+          major = a;
+      }
+      const double majorAbs = std::fabs(dir[major]);
+      for (uint32_t a = 0u; a < 3u; ++a)
+      {
+        if (a == major || std::fabs(dir[a]) >= majorAbs * edgeMargin)
+          this->cubeFaceIdx.insert(a * 2u + (dir[a] < 0.0 ? 1u : 0u));
+      }
+    }
+  }
+
+  // Should not happen with a valid lens. Fall back to rendering everything
+  if (this->cubeFaceIdx.empty())
+  {
+    for (uint32_t i = 0u; i < kWideAngleNumCubemapFaces; ++i)
+      this->cubeFaceIdx.insert(i);
+  }
+}
+
 //////////////////////////////////////////////////
 Ogre2WideAngleCamera::Ogre2WideAngleCamera() :
   dataPtr(utils::MakeUniqueImpl<Implementation>(*this))
@@ -1029,7 +1150,12 @@ void Ogre2WideAngleCamera::Render()
   const Ogre::Quaternion oldCameraOrientation(
     this->dataPtr->ogreCamera->getOrientation());
 
-  for (size_t i = 0u; i < kWideAngleNumCubemapFaces; ++i)
+  // Skip the faces the lens never looks at, e.g. the back face of
+  // fisheye lenses. Their contents are never sampled in the final pass
+  this->dataPtr->UpdateCubeFaceIdx(this->Lens(), this->HFOV().Radian(),
+                                   this->ImageWidth(), this->ImageHeight());
+
+  for (uint32_t i : this->dataPtr->cubeFaceIdx)
   {
     this->dataPtr->ogreCompositorWorkspace[i]->setEnabled(true);
 
@@ -1064,8 +1190,8 @@ void Ogre2WideAngleCamera::Render()
     this->dataPtr->ogreCompositorFinalPass->setEnabled(false);
   }
 
-  this->scene->FlushGpuCommandsAndStartNewFrame(kWideAngleNumCubemapFaces,
-                                                false);
+  this->scene->FlushGpuCommandsAndStartNewFrame(
+    static_cast<uint8_t>(this->dataPtr->cubeFaceIdx.size()), false);
 }
 
 //////////////////////////////////////////////////
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#version ogre_glsl_ver_330
+
+// xyz: direction of the ray
+// w: point of the ray, 0: start, 1: end, 2: origin of the rays
+vulkan_layout( OGRE_POSITION ) in vec4 vertex;
+// range of the ray
+vulkan_layout( OGRE_TEXCOORD0 ) in float uv0;
+
+vulkan( layout( ogre_P0 ) uniform Params { )
+  uniform mat4 worldViewProj;
+  // xyz: origin of the rays
+  // w: end of a ray that hit nothing, 0: start of the ray,
+  // 1: max range, 2: not drawn
+  uniform vec4 rayOrigin;
+  // x: min range, y: max range, z: point size
+  uniform vec4 rayParams;
+vulkan( }; )
+
+out gl_PerVertex
+{
+  vec4 gl_Position;
+  float gl_PointSize;
+};
+
+void main()
+{
+  float minRange = rayParams.x;
+  float maxRange = rayParams.y;
+  bool noHit = isinf(uv0) || uv0 >= maxRange;
+
+  float dist = minRange;
+  if (vertex.w > 1.5)
+  {
+    dist = 0.0;
+  }
+  else if (vertex.w > 0.5)
+  {
+    if (!noHit)
+      dist = uv0;
+    else if (rayOrigin.w > 0.5)
+      dist = maxRange;
+  }
+
+  gl_PointSize = rayParams.z;
+  if (noHit && vertex.w > 0.5 && vertex.w < 1.5 && rayOrigin.w > 1.5)
+  {
+    // outside of the clip volume
+    gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+    return;
+  }
+
+  gl_Position = worldViewProj * vec4(rayOrigin.xyz + vertex.xyz * dist, 1.0);
+}
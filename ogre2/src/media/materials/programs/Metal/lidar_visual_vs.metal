@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <metal_stdlib>
+using namespace metal;
+
+struct VS_INPUT
+{
+  // xyz: direction of the ray
+  // w: point of the ray, 0: start, 1: end, 2: origin of the rays
+  float4 position [[attribute(VES_POSITION)]];
+  // range of the ray
+  float range     [[attribute(VES_TEXTURE_COORDINATES0)]];
+};
+
+struct PS_INPUT
+{
+  float4 gl_Position  [[position]];
+  float  gl_PointSize [[point_size]];
+};
+
+struct Params
+{
+  float4x4 worldViewProj;
+  // xyz: origin of the rays
+  // w: end of a ray that hit nothing, 0: start of the ray,
+  // 1: max range, 2: not drawn
+  float4 rayOrigin;
+  // x: min range, y: max range, z: point size
+  float4 rayParams;
+};
+
+vertex PS_INPUT main_metal
+(
+  VS_INPUT input [[stage_in]],
+  constant Params &p [[buffer(PARAMETER_SLOT)]]
+)
+{
+  PS_INPUT outVs;
+
+  float minRange = p.rayParams.x;
+  float maxRange = p.rayParams.y;
+  bool noHit = isinf(input.range) || input.range >= maxRange;
+
+  float dist = minRange;
+  if (input.position.w > 1.5)
+  {
+    dist = 0.0;
+  }
+  else if (input.position.w > 0.5)
+  {
+    if (!noHit)
+      dist = input.range;
+    else if (p.rayOrigin.w > 0.5)
+      dist = maxRange;
+  }
+
+  outVs.gl_PointSize = p.rayParams.z;
+  if (noHit && input.position.w > 0.5 && input.position.w < 1.5 &&
+      p.rayOrigin.w > 1.5)
+  {
+    // outside of the clip volume
+    outVs.gl_Position = float4(2.0, 2.0, 2.0, 1.0);
+    return outVs;
+  }
+
+  outVs.gl_Position = p.worldViewProj *
+      float4(p.rayOrigin.xyz + input.position.xyz * dist, 1.0);
+
+  return outVs;
+}
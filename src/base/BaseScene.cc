@@ -15,12 +15,15 @@
  *
  */
 
+#include <future>
 #include <sstream>
+#include <vector>
 
 #include <gz/math/Helpers.hh>
 
 #include <gz/common/Console.hh>
 #include <gz/common/Mesh.hh>
+#include <gz/common/MeshManager.hh>
 
 #include "gz/rendering/ArrowVisual.hh"
 #include "gz/rendering/AxisVisual.hh"
@@ -28,6 +31,7 @@
 #include "gz/rendering/COMVisual.hh"
 #include "gz/rendering/InertiaVisual.hh"
 #include "gz/rendering/InstallationDirectories.hh"
+#include "gz/rendering/InstancedVisual.hh"
 #include "gz/rendering/JointVisual.hh"
 #include "gz/rendering/LidarVisual.hh"
 #include "gz/rendering/LightVisual.hh"
@@ -1208,6 +1212,21 @@ MeshPtr BaseScene::CreateMesh(const MeshDescriptor &_desc)
   return this->CreateMeshImpl(objId, objName, _desc);
 }
 
+//////////////////////////////////////////////////
+std::future<MeshPtr> BaseScene::CreateMeshAsync(const MeshDescriptor &_desc)
+{
+  common::MeshManager *meshManager = common::MeshManager::Instance();
+  if (!_desc.mesh && !_desc.meshName.empty() &&
+      !meshManager->HasMesh(_desc.meshName))
+  {
+    meshManager->Load(_desc.meshName);
+  }
+
+  std::promise<MeshPtr> promise;
+  promise.set_value(this->CreateMesh(_desc));
+  return promise.get_future();
+}
+
 //////////////////////////////////////////////////
 HeightmapPtr BaseScene::CreateHeightmap(const HeightmapDescriptor &_desc)
 {
@@ -1262,6 +1281,36 @@ LidarVisualPtr BaseScene::CreateLidarVisual(unsigned int _id,
   return (result) ? lidar : nullptr;
 }
 
+//////////////////////////////////////////////////
+InstancedVisualPtr BaseScene::CreateInstancedVisual()
+{
+  unsigned int objId = this->CreateObjectId();
+  return this->CreateInstancedVisual(objId);
+}
+
+//////////////////////////////////////////////////
+InstancedVisualPtr BaseScene::CreateInstancedVisual(unsigned int _id)
+{
+  const std::string objName = this->CreateObjectName(_id, "InstancedVisual");
+  return this->CreateInstancedVisual(_id, objName);
+}
+
+//////////////////////////////////////////////////
+InstancedVisualPtr BaseScene::CreateInstancedVisual(const std::string &_name)
+{
+  unsigned int objId = this->CreateObjectId();
+  return this->CreateInstancedVisual(objId, _name);
+}
+
+//////////////////////////////////////////////////
+InstancedVisualPtr BaseScene::CreateInstancedVisual(unsigned int _id,
+    const std::string &_name)
+{
+  InstancedVisualPtr visual = this->CreateInstancedVisualImpl(_id, _name);
+  bool result = this->RegisterVisual(visual);
+  return (result) ? visual : nullptr;
+}
+
 //////////////////////////////////////////////////
 WireBoxPtr BaseScene::CreateWireBox()
 {
@@ -1514,6 +1563,75 @@ bool BaseScene::LegacyAutoGpuFlush() const
   return true;
 }
 
+//////////////////////////////////////////////////
+void BaseScene::SetTextureResidencyPolicy(
+    enum TextureResidencyPolicy /*_policy*/)
+{
+}
+
+//////////////////////////////////////////////////
+enum TextureResidencyPolicy BaseScene::TextureResidencyPolicy() const
+{
+  return TRP_BLOCK_ALWAYS;
+}
+
+//////////////////////////////////////////////////
+void BaseScene::SetTextureWarmUpFrameCount(unsigned int /*_frames*/)
+{
+}
+
+//////////////////////////////////////////////////
+unsigned int BaseScene::TextureWarmUpFrameCount() const
+{
+  return 0u;
+}
+
+//////////////////////////////////////////////////
+void BaseScene::PreloadTextures()
+{
+}
+
+//////////////////////////////////////////////////
+void BaseScene::SetAutoStaticFrameCount(unsigned int /*_frames*/)
+{
+}
+
+//////////////////////////////////////////////////
+unsigned int BaseScene::AutoStaticFrameCount() const
+{
+  return 0u;
+}
+
+//////////////////////////////////////////////////
+void BaseScene::RenderCameras(const std::vector<CameraPtr> &_cameras)
+{
+  std::vector<CameraPtr> cameras;
+  cameras.reserve(_cameras.size());
+  for (const auto &camera : _cameras)
+  {
+    if (!camera)
+      continue;
+    if (camera->Scene().get() != this)
+    {
+      gzerr << "Camera [" << camera->Name() << "] does not belong to scene ["
+            << this->Name() << "]. It will not be rendered." << std::endl;
+      continue;
+    }
+    cameras.push_back(camera);
+  }
+
+  if (cameras.empty())
+    return;
+
+  this->PreRender();
+  for (const auto &camera : cameras)
+    camera->Render();
+  for (const auto &camera : cameras)
+    camera->PostRender();
+  if (!this->LegacyAutoGpuFlush())
+    this->PostRender();
+}
+
 //////////////////////////////////////////////////
 void BaseScene::Clear()
 {
@@ -17,10 +17,14 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstring>
+
 #include "CommonRenderingTest.hh"
 
 #include "gz/rendering/Camera.hh"
 #include "gz/rendering/GaussianNoisePass.hh"
+#include "gz/rendering/Image.hh"
 #include "gz/rendering/RenderPassSystem.hh"
 #include "gz/rendering/Scene.hh"
 #include "gz/rendering/Utils.hh"
@@ -300,6 +304,54 @@ TEST_F(CameraTest, VisibilityMask)
   engine->DestroyScene(scene);
 }
 
+/////////////////////////////////////////////////
+TEST_F(CameraTest, ReadbackLatency)
+{
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  VisualPtr root = scene->RootVisual();
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(2.0, 0.0, 0.0);
+  root->AddChild(box);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(32u);
+  camera->SetImageHeight(32u);
+  root->AddChild(camera);
+
+  // check initial value
+  EXPECT_EQ(0u, camera->ReadbackLatency());
+
+  // render synchronously as reference
+  Image syncImage = camera->CreateImage();
+  camera->Capture(syncImage);
+
+  camera->SetReadbackLatency(2u);
+  EXPECT_EQ(2u, camera->ReadbackLatency());
+
+  // no frame is available until latency + 1 frames have been rendered
+  Image asyncImage = camera->CreateImage();
+  memset(asyncImage.Data<unsigned char>(), 0, camera->ImageMemorySize());
+  camera->Capture(asyncImage);
+  camera->Capture(asyncImage);
+  unsigned char *data = asyncImage.Data<unsigned char>();
+  EXPECT_TRUE(std::all_of(data, data + camera->ImageMemorySize(),
+      [](unsigned char _c) { return _c == 0u; }));
+
+  // the scene is static so the delayed frame matches the synchronous one
+  camera->Capture(asyncImage);
+  EXPECT_EQ(0, memcmp(syncImage.Data<unsigned char>(), data,
+      camera->ImageMemorySize()));
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
+
 /////////////////////////////////////////////////
 TEST_F(CameraTest, IntrinsicMatrix)
 {
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "CommonRenderingTest.hh"
+
+#include "gz/rendering/InstancedVisual.hh"
+#include "gz/rendering/Scene.hh"
+
+using namespace gz;
+using namespace rendering;
+
+class InstancedVisualTest : public CommonRenderingTest
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(InstancedVisualTest, InstancedVisual)
+{
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  InstancedVisualPtr visual = scene->CreateInstancedVisual();
+  ASSERT_NE(nullptr, visual);
+  EXPECT_EQ(0u, visual->InstanceCount());
+
+  MeshDescriptor desc("unit_box");
+  visual->SetMesh(desc);
+  EXPECT_EQ("unit_box", visual->Descriptor().meshName);
+
+  MaterialPtr material = scene->CreateMaterial();
+  material->SetDiffuse(0.2, 0.3, 0.4);
+  visual->SetMaterial(material);
+  scene->RootVisual()->AddChild(visual);
+
+  // set poses
+  std::vector<math::Pose3d> poses;
+  for (unsigned int i = 0; i < 10u; ++i)
+    poses.push_back(math::Pose3d(i * 2.0, 0, 0, 0, 0, 0));
+  visual->SetInstancePoses(poses);
+  ASSERT_EQ(10u, visual->InstanceCount());
+  EXPECT_EQ(poses[3], visual->InstancePose(3));
+  EXPECT_EQ(math::Pose3d::Zero, visual->InstancePose(10));
+
+  // update a range of poses
+  std::vector<math::Pose3d> updated(2u, math::Pose3d(0, 5, 0, 0, 0, 0));
+  visual->UpdateInstancePoses(4u, updated.data(), updated.size());
+  EXPECT_EQ(updated[0], visual->InstancePose(4));
+  EXPECT_EQ(updated[1], visual->InstancePose(5));
+  EXPECT_EQ(poses[6], visual->InstancePose(6));
+
+  // out of range update is ignored
+  visual->UpdateInstancePoses(9u, updated.data(), updated.size());
+  EXPECT_EQ(poses[9], visual->InstancePose(9));
+
+  // colors
+  EXPECT_EQ(material->Diffuse(), visual->InstanceColor(0));
+  visual->SetInstanceColor(0u, math::Color::Red);
+  visual->SetInstanceColor(1u, math::Color::Red);
+  visual->SetInstanceColor(2u, math::Color::Green);
+  EXPECT_EQ(math::Color::Red, visual->InstanceColor(0));
+  EXPECT_EQ(math::Color::Green, visual->InstanceColor(2));
+  visual->ClearInstanceColor(1u);
+  EXPECT_EQ(material->Diffuse(), visual->InstanceColor(1));
+
+  // labels
+  EXPECT_FALSE(visual->HasInstanceLabel(0));
+  EXPECT_EQ(0, visual->InstanceLabel(0));
+  visual->SetInstanceLabel(0u, 5);
+  EXPECT_TRUE(visual->HasInstanceLabel(0));
+  EXPECT_EQ(5, visual->InstanceLabel(0));
+  visual->ClearInstanceLabel(0u);
+  EXPECT_FALSE(visual->HasInstanceLabel(0));
+
+  // apply the changes and check the bounds cover every instance
+  scene->PreRender();
+  math::AxisAlignedBox box = visual->LocalBoundingBox();
+  EXPECT_NEAR(-0.5, box.Min().X(), 1e-3);
+  EXPECT_NEAR(18.5, box.Max().X(), 1e-3);
+  EXPECT_NEAR(5.5, box.Max().Y(), 1e-3);
+
+  // shrink the number of instances
+  poses.resize(3u);
+  visual->SetInstancePoses(poses);
+  EXPECT_EQ(3u, visual->InstanceCount());
+  EXPECT_EQ(math::Color::Red, visual->InstanceColor(0));
+  scene->PreRender();
+  box = visual->LocalBoundingBox();
+  EXPECT_NEAR(4.5, box.Max().X(), 1e-3);
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
@@ -15,6 +15,7 @@
 */
 
 #include <gtest/gtest.h>
+#include <vector>
 
 #include "CommonRenderingTest.hh"
 
@@ -104,6 +105,22 @@ TEST_F(LidarVisualTest, LidarVisual)
   lidar->ClearPoints();
   EXPECT_EQ(lidar->PointCount(), 0u);
 
+  // set points from a 3 channel gpu rays frame
+  lidar->SetVerticalRayCount(2);
+  lidar->SetHorizontalRayCount(3);
+  std::vector<float> frame{10.0f, 0, 0, 15.0f, 0, 0, INFINITY, 0, 0,
+                           3.5f, 0, 0, 12.0f, 0, 0, INFINITY, 0, 0};
+  lidar->SetPoints(frame.data(), 6u, 3u);
+  ASSERT_EQ(6u, lidar->PointCount());
+  EXPECT_DOUBLE_EQ(15.0, lidar->Points()[1]);
+  EXPECT_DOUBLE_EQ(3.5, lidar->Points()[3]);
+  EXPECT_NO_THROW(lidar->Update());
+  lidar->SetType(LVT_POINTS);
+  lidar->SetPoints(frame.data(), 6u, 3u);
+  EXPECT_NO_THROW(lidar->Update());
+  lidar->ClearPoints();
+  EXPECT_EQ(lidar->PointCount(), 0u);
+
   // Clean up
   engine->DestroyScene(scene);
 }
@@ -15,6 +15,8 @@
 */
 
 #include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
 
 #include "CommonRenderingTest.hh"
 
@@ -85,10 +87,48 @@ TEST_F(MarkerTest, Marker)
   EXPECT_EQ(MarkerType::MT_TRIANGLE_FAN, marker->Type());
 
   // exercise point api
-  EXPECT_NO_THROW(marker->AddPoint(math::Vector3d(0, 1, 2),
-      math::Color::White));
-  EXPECT_NO_THROW(marker->SetPoint(0, math::Vector3d(3, 1, 2)));
-  EXPECT_NO_THROW(marker->ClearPoints());
+  marker->AddPoint(math::Vector3d(0, 1, 2), math::Color::White);
+  ASSERT_EQ(1u, marker->PointCount());
+  EXPECT_EQ(math::Vector3d(0, 1, 2), marker->Point(0));
+  marker->SetPoint(0, math::Vector3d(3, 1, 2));
+  EXPECT_EQ(math::Vector3d(3, 1, 2), marker->Point(0));
+  marker->ClearPoints();
+  EXPECT_EQ(0u, marker->PointCount());
+
+  // exercise bulk point api
+  std::vector<float> xyz = {0, 0, 0, 1, 0, 0, 2, 0, 0, 3, 0, 0};
+  std::vector<uint32_t> rgba(4u, math::Color::Red.AsRGBA());
+  marker->SetType(MarkerType::MT_POINTS);
+  marker->SetPoints(xyz.data(), rgba.data(), 4u);
+  ASSERT_EQ(4u, marker->PointCount());
+  for (unsigned int i = 0; i < 4u; ++i)
+    EXPECT_EQ(math::Vector3d(i, 0, 0), marker->Point(i));
+  VisualPtr visual = scene->CreateVisual();
+  visual->AddGeometry(marker);
+  scene->RootVisual()->AddChild(visual);
+  scene->PreRender();
+  scene->PostRender();
+
+  // update the positions of a range, keeping the colors
+  std::vector<float> updated = {0, 5, 0, 0, 6, 0};
+  marker->UpdatePoints(1u, updated.data(), nullptr, 2u);
+  ASSERT_EQ(4u, marker->PointCount());
+  EXPECT_EQ(math::Vector3d(0, 0, 0), marker->Point(0));
+  EXPECT_EQ(math::Vector3d(0, 5, 0), marker->Point(1));
+  EXPECT_EQ(math::Vector3d(0, 6, 0), marker->Point(2));
+  EXPECT_EQ(math::Vector3d(3, 0, 0), marker->Point(3));
+
+  // update the colors of a range, keeping the positions
+  marker->UpdatePoints(3u, nullptr, rgba.data(), 1u);
+  ASSERT_EQ(4u, marker->PointCount());
+  EXPECT_EQ(math::Vector3d(3, 0, 0), marker->Point(3));
+  scene->PreRender();
+  scene->PostRender();
+
+  marker->SetPoints(nullptr, nullptr, 0u);
+  EXPECT_EQ(0u, marker->PointCount());
+  scene->PreRender();
+  scene->PostRender();
 
   EXPECT_DOUBLE_EQ(1.0, marker->Size());
   marker->SetSize(3.0);
@@ -21,13 +21,16 @@
 
 #include "CommonRenderingTest.hh"
 
+#include <gz/common/Mesh.hh>
 #include <gz/common/MeshManager.hh>
 #include <gz/common/Skeleton.hh>
 #include <gz/common/SkeletonAnimation.hh>
+#include <gz/common/SubMesh.hh>
 
 #include "gz/rendering/Camera.hh"
 #include "gz/rendering/Mesh.hh"
 #include "gz/rendering/Scene.hh"
+#include "gz/rendering/Visual.hh"
 
 using namespace gz;
 using namespace rendering;
@@ -312,3 +315,103 @@ TEST_F(MeshTest, MeshClone)
   // Clean up
   engine->DestroyScene(scene);
 }
+
+/////////////////////////////////////////////////
+TEST_F(MeshTest, MeshPrimitiveSubMeshes)
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  // mesh with an indexed, textured triangle submesh and a non-indexed line
+  // submesh without normals nor texture coordinates
+  common::Mesh *commonMesh = new common::Mesh();
+  commonMesh->SetName("mesh_primitive_submeshes");
+
+  common::SubMesh triangles;
+  triangles.SetName("triangles");
+  triangles.SetPrimitiveType(common::SubMesh::TRIANGLES);
+  triangles.AddVertex(math::Vector3d(1, 1, 0));
+  triangles.AddVertex(math::Vector3d(2, 1, 0));
+  triangles.AddVertex(math::Vector3d(1, 2, 0));
+  for (unsigned int i = 0; i < 3; ++i)
+    triangles.AddNormal(math::Vector3d::UnitZ);
+  triangles.AddTexCoord(math::Vector2d(0, 0));
+  triangles.AddTexCoord(math::Vector2d(1, 0));
+  triangles.AddTexCoord(math::Vector2d(0, 1));
+  triangles.AddIndex(0);
+  triangles.AddIndex(1);
+  triangles.AddIndex(2);
+  commonMesh->AddSubMesh(triangles);
+
+  common::SubMesh lines;
+  lines.SetName("lines");
+  lines.SetPrimitiveType(common::SubMesh::LINES);
+  lines.AddVertex(math::Vector3d(0, 0, 0));
+  lines.AddVertex(math::Vector3d(0, 0, 1));
+  commonMesh->AddSubMesh(lines);
+
+  common::MeshManager::Instance()->AddMesh(commonMesh);
+
+  MeshDescriptor descriptor("mesh_primitive_submeshes");
+  MeshPtr mesh = scene->CreateMesh(descriptor);
+  ASSERT_NE(nullptr, mesh);
+  EXPECT_EQ(2u, mesh->SubMeshCount());
+
+  // load a single centered submesh
+  descriptor.subMeshName = "triangles";
+  descriptor.centerSubMesh = true;
+  MeshPtr subMesh = scene->CreateMesh(descriptor);
+  ASSERT_NE(nullptr, subMesh);
+  EXPECT_EQ(1u, subMesh->SubMeshCount());
+
+  // loading the same descriptor again reuses the loaded mesh
+  MeshPtr subMesh2 = scene->CreateMesh(descriptor);
+  ASSERT_NE(nullptr, subMesh2);
+  EXPECT_EQ(1u, subMesh2->SubMeshCount());
+
+  // render the meshes to make sure their vertex layouts are usable
+  VisualPtr visual = scene->CreateVisual();
+  ASSERT_NE(nullptr, visual);
+  visual->AddGeometry(mesh);
+  scene->RootVisual()->AddChild(visual);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(32);
+  camera->SetImageHeight(32);
+  camera->SetLocalPosition(-5, 0, 0);
+  scene->RootVisual()->AddChild(camera);
+  camera->Update();
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshTest, CompactVertexFormat)
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  MeshDescriptor descriptor("unit_box");
+  EXPECT_FALSE(descriptor.compactVertexFormat);
+  MeshPtr mesh = scene->CreateMesh(descriptor);
+  ASSERT_NE(nullptr, mesh);
+
+  // the same mesh in compact formats is loaded separately
+  descriptor.compactVertexFormat = true;
+  MeshPtr compactMesh = scene->CreateMesh(descriptor);
+  ASSERT_NE(nullptr, compactMesh);
+  EXPECT_TRUE(compactMesh->Descriptor().compactVertexFormat);
+  EXPECT_EQ(mesh->SubMeshCount(), compactMesh->SubMeshCount());
+
+  // both meshes should render with the same footprint
+  VisualPtr visual = scene->CreateVisual();
+  ASSERT_NE(nullptr, visual);
+  visual->AddGeometry(compactMesh);
+  scene->RootVisual()->AddChild(visual);
+  EXPECT_EQ(math::Vector3d(1, 1, 1), visual->LocalBoundingBox().Size());
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
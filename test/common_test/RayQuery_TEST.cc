@@ -17,11 +17,14 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include "CommonRenderingTest.hh"
 
 #include "gz/rendering/Camera.hh"
 #include "gz/rendering/RayQuery.hh"
 #include "gz/rendering/Scene.hh"
+#include "gz/rendering/Visual.hh"
 
 using namespace gz;
 using namespace rendering;
@@ -111,3 +114,128 @@ TEST_F(RayQueryTest, RayQuery)
   // Clean up
   engine->DestroyScene(scene);
 }
+
+/////////////////////////////////////////////////
+TEST_F(RayQueryTest, Intersection)
+{
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  VisualPtr root = scene->RootVisual();
+
+  // two boxes along the x axis, the farther one scaled
+  VisualPtr box1 = scene->CreateVisual("box1");
+  box1->AddGeometry(scene->CreateBox());
+  box1->SetLocalPosition(5.0, 0.0, 0.0);
+  root->AddChild(box1);
+
+  VisualPtr box2 = scene->CreateVisual("box2");
+  box2->AddGeometry(scene->CreateBox());
+  box2->SetLocalPosition(10.0, 0.0, 0.0);
+  box2->SetLocalScale(2.0, 2.0, 2.0);
+  root->AddChild(box2);
+
+  RayQueryPtr rayQuery = scene->CreateRayQuery();
+  ASSERT_NE(nullptr, rayQuery);
+  rayQuery->SetPreferGpu(false);
+  rayQuery->SetOrigin(math::Vector3d::Zero);
+  rayQuery->SetDirection(math::Vector3d::UnitX);
+
+  RayQueryResult result = rayQuery->ClosestPoint(true);
+  EXPECT_TRUE(result);
+  EXPECT_NEAR(4.5, result.distance, 1e-4);
+  EXPECT_EQ(box1->Id(), result.objectId);
+  EXPECT_TRUE(math::Vector3d(4.5, 0.0, 0.0).Equal(result.point, 1e-4));
+
+  // the distance of a hit on a scaled mesh is in world units, and so is
+  // the distance of a query with a non unit direction
+  box1->SetVisible(false);
+  rayQuery->SetDirection(math::Vector3d(2.0, 0.0, 0.0));
+  result = rayQuery->ClosestPoint(true);
+  EXPECT_TRUE(result);
+  EXPECT_NEAR(9.0, result.distance, 1e-4);
+  EXPECT_EQ(box2->Id(), result.objectId);
+  EXPECT_TRUE(math::Vector3d(9.0, 0.0, 0.0).Equal(result.point, 1e-4));
+
+  // a ray pointing away from both boxes
+  rayQuery->SetDirection(-math::Vector3d::UnitX);
+  result = rayQuery->ClosestPoint(true);
+  EXPECT_FALSE(result);
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(RayQueryTest, ClosestPoints)
+{
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  VisualPtr root = scene->RootVisual();
+
+  // a grid of boxes on the z = 0 plane
+  for (int i = 0; i < 5; ++i)
+  {
+    for (int j = 0; j < 5; ++j)
+    {
+      VisualPtr box = scene->CreateVisual();
+      box->AddGeometry(scene->CreateBox());
+      box->SetLocalPosition(i * 2.0, j * 2.0, 0.0);
+      root->AddChild(box);
+    }
+  }
+
+  RayQueryPtr rayQuery = scene->CreateRayQuery();
+  ASSERT_NE(nullptr, rayQuery);
+  rayQuery->SetPreferGpu(false);
+
+  // rays pointing down from a grid above the boxes, half of them
+  // between boxes
+  std::vector<math::Vector3d> origins;
+  std::vector<math::Vector3d> directions;
+  for (int i = 0; i < 20; ++i)
+  {
+    for (int j = 0; j < 20; ++j)
+    {
+      origins.emplace_back(i * 0.5 + 0.25, j * 0.5 + 0.25, 5.0);
+      directions.push_back(-math::Vector3d::UnitZ);
+    }
+  }
+
+  // a ray starting inside a box, which is ignored by both paths
+  origins.emplace_back(0.0, 0.0, 0.0);
+  directions.push_back(math::Vector3d::UnitX);
+
+  std::vector<RayQueryResult> results;
+  rayQuery->ClosestPoints(origins, directions, results);
+  ASSERT_EQ(origins.size(), results.size());
+
+  // batched results must match one query per ray
+  unsigned int hitCount = 0u;
+  for (std::size_t i = 0u; i < origins.size(); ++i)
+  {
+    rayQuery->SetOrigin(origins[i]);
+    rayQuery->SetDirection(directions[i]);
+    RayQueryResult expected = rayQuery->ClosestPoint(false);
+    EXPECT_EQ(static_cast<bool>(expected), static_cast<bool>(results[i]));
+    if (!expected)
+      continue;
+    ++hitCount;
+    EXPECT_NEAR(expected.distance, results[i].distance, 1e-4);
+    EXPECT_TRUE(expected.point.Equal(results[i].point, 1e-4));
+    EXPECT_EQ(expected.objectId, results[i].objectId);
+  }
+  EXPECT_LT(0u, hitCount);
+  EXPECT_GT(origins.size(), hitCount);
+
+  // mismatched input sizes
+  directions.pop_back();
+  rayQuery->ClosestPoints(origins, directions, results);
+  EXPECT_TRUE(results.empty());
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
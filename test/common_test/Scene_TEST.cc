@@ -17,10 +17,22 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <future>
+#include <string>
+#include <vector>
+
+#include <gz/common/Filesystem.hh>
+#include <gz/common/MeshManager.hh>
+
 #include "CommonRenderingTest.hh"
 
+#include "gz/rendering/Camera.hh"
+#include "gz/rendering/Image.hh"
+#include "gz/rendering/Mesh.hh"
 #include "gz/rendering/RenderTarget.hh"
 #include "gz/rendering/Scene.hh"
+#include "gz/rendering/ShaderParams.hh"
 
 using namespace gz;
 using namespace rendering;
@@ -751,3 +763,365 @@ TEST_F(SceneTest, Sky)
   // Clean up
   engine->DestroyScene(scene);
 }
+
+/////////////////////////////////////////////////
+TEST_F(SceneTest, RenderCameras)
+{
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetBackgroundColor(1.0, 0.0, 0.0);
+  scene->SetCameraPassCountPerGpuFlush(6u);
+
+  VisualPtr root = scene->RootVisual();
+
+  std::vector<CameraPtr> cameras;
+  for (unsigned int i = 0; i < 2u; ++i)
+  {
+    CameraPtr camera = scene->CreateCamera();
+    ASSERT_NE(nullptr, camera);
+    camera->SetImageWidth(32u);
+    camera->SetImageHeight(32u);
+    camera->SetImageFormat(PF_R8G8B8);
+    root->AddChild(camera);
+    cameras.push_back(camera);
+  }
+
+  // null cameras are skipped
+  cameras.push_back(nullptr);
+
+  scene->RenderCameras(cameras);
+
+  // every camera should have rendered the background
+  for (unsigned int i = 0; i < 2u; ++i)
+  {
+    Image image = cameras[i]->CreateImage();
+    cameras[i]->Copy(image);
+    const unsigned char *data = image.Data<unsigned char>();
+    ASSERT_NE(nullptr, data);
+    EXPECT_EQ(255u, data[0]);
+    EXPECT_EQ(0u, data[1]);
+    EXPECT_EQ(0u, data[2]);
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(SceneTest, TextureResidency)
+{
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetAmbientLight(1.0, 1.0, 1.0);
+
+  EXPECT_EQ(TRP_BLOCK_ALWAYS, scene->TextureResidencyPolicy());
+  scene->SetTextureResidencyPolicy(TRP_BLOCK_WARM_UP);
+  EXPECT_EQ(TRP_BLOCK_WARM_UP, scene->TextureResidencyPolicy());
+  scene->SetTextureWarmUpFrameCount(2u);
+  EXPECT_EQ(2u, scene->TextureWarmUpFrameCount());
+
+  const std::string texturesPath = common::joinPaths(
+      std::string(PROJECT_SOURCE_PATH), "test", "media", "materials",
+      "textures");
+  auto createTexturedMaterial = [&](const std::string &_texture)
+  {
+    MaterialPtr material = scene->CreateMaterial();
+    material->SetAmbient(1.0, 1.0, 1.0);
+    material->SetDiffuse(1.0, 1.0, 1.0);
+    material->SetSpecular(0.0, 0.0, 0.0);
+    material->SetTexture(common::joinPaths(texturesPath, _texture));
+    return material;
+  };
+
+  // textured box filling the view of the camera
+  VisualPtr root = scene->RootVisual();
+  VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetMaterial(createTexturedMaterial("red_texture.png"));
+  box->SetLocalPosition(1.0, 0.0, 0.0);
+  root->AddChild(box);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(32u);
+  camera->SetImageHeight(32u);
+  camera->SetImageFormat(PF_R8G8B8);
+  root->AddChild(camera);
+
+  // Check that the center of the image has _channel as dominant color,
+  // which is only the case once the texture is loaded. Placeholder
+  // textures are not colored.
+  Image image = camera->CreateImage();
+  auto expectTextured = [&](unsigned int _channel, const std::string &_what)
+  {
+    camera->Capture(image);
+    const unsigned char *data = image.Data<unsigned char>();
+    ASSERT_NE(nullptr, data);
+    const unsigned int idx = (16u * 32u + 16u) * 3u;
+    for (unsigned int c = 0u; c < 3u; ++c)
+    {
+      if (c != _channel)
+        EXPECT_GT(data[idx + _channel], data[idx + c] + 50) << _what;
+    }
+  };
+
+  // preloading makes the textures resident, so that the first frame is
+  // complete even though no render blocks
+  scene->SetTextureWarmUpFrameCount(0u);
+  scene->PreloadTextures();
+  expectTextured(0u, "preloaded");
+
+  // blocking on visible textures waits for the texture of a material
+  // assigned to an object in view
+  scene->SetTextureResidencyPolicy(TRP_BLOCK_VISIBLE);
+  EXPECT_EQ(TRP_BLOCK_VISIBLE, scene->TextureResidencyPolicy());
+  box->SetMaterial(createTexturedMaterial("blue_texture.png"));
+  expectTextured(2u, "visible");
+
+  // and keeps rendering it once loaded
+  expectTextured(2u, "visible, loaded");
+
+  scene->SetTextureResidencyPolicy(TRP_BLOCK_ALWAYS);
+  EXPECT_EQ(TRP_BLOCK_ALWAYS, scene->TextureResidencyPolicy());
+  expectTextured(2u, "always");
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(SceneTest, AutoStatic)
+{
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  EXPECT_EQ(0u, scene->AutoStaticFrameCount());
+
+  VisualPtr root = scene->RootVisual();
+
+  VisualPtr parent = scene->CreateVisual();
+  parent->AddGeometry(scene->CreateBox());
+  root->AddChild(parent);
+
+  VisualPtr child = scene->CreateVisual();
+  child->AddGeometry(scene->CreateBox());
+  parent->AddChild(child);
+
+  VisualPtr userStatic = scene->CreateVisual();
+  root->AddChild(userStatic);
+  userStatic->SetStatic(true);
+
+  auto renderFrames = [&scene](unsigned int _count)
+  {
+    for (unsigned int i = 0u; i < _count; ++i)
+    {
+      scene->PreRender();
+      scene->PostRender();
+    }
+  };
+
+  // disabled by default
+  renderFrames(3u);
+  EXPECT_FALSE(parent->Static());
+  EXPECT_FALSE(child->Static());
+
+  scene->SetAutoStaticFrameCount(2u);
+  EXPECT_EQ(2u, scene->AutoStaticFrameCount());
+
+  // a child is made static once its parent is
+  renderFrames(3u);
+  EXPECT_TRUE(parent->Static());
+  renderFrames(1u);
+  EXPECT_TRUE(child->Static());
+
+  // setting the same pose is not a move
+  parent->SetLocalPose(parent->LocalPose());
+  EXPECT_TRUE(parent->Static());
+
+  // moving a visual makes it and its descendants dynamic again
+  parent->SetLocalPosition(1.0, 0.0, 0.0);
+  EXPECT_FALSE(parent->Static());
+  EXPECT_FALSE(child->Static());
+  EXPECT_TRUE(userStatic->Static());
+
+  renderFrames(3u);
+  EXPECT_TRUE(parent->Static());
+
+  // disabling gives back the visuals made static by the scene only
+  scene->SetAutoStaticFrameCount(0u);
+  EXPECT_FALSE(parent->Static());
+  EXPECT_FALSE(child->Static());
+  EXPECT_TRUE(userStatic->Static());
+
+  // moving a static visual is still reflected in its world pose
+  userStatic->SetLocalPosition(0.0, 2.0, 0.0);
+  renderFrames(1u);
+  EXPECT_EQ(math::Vector3d(0.0, 2.0, 0.0), userStatic->WorldPosition());
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(SceneTest, PreRenderSkippedSubtree)
+{
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  VisualPtr root = scene->RootVisual();
+
+  // plain visuals and meshes, which are skipped once pre-rendered
+  MaterialPtr material = scene->CreateMaterial();
+  VisualPtr parent = scene->CreateVisual();
+  root->AddChild(parent);
+  VisualPtr child = scene->CreateVisual();
+  child->AddGeometry(scene->CreateBox());
+  child->SetMaterial(material, false);
+  parent->AddChild(child);
+
+  auto renderFrames = [&scene](unsigned int _count)
+  {
+    for (unsigned int i = 0u; i < _count; ++i)
+    {
+      scene->PreRender();
+      scene->PostRender();
+    }
+  };
+  renderFrames(2u);
+
+  std::string vertexShaderFile;
+  std::string fragmentShaderFile;
+  if (engine->GraphicsAPI() == GraphicsAPI::METAL)
+  {
+    vertexShaderFile = "simple_color_vs.metal";
+    fragmentShaderFile = "simple_color_fs.metal";
+  }
+  else
+  {
+    vertexShaderFile = "simple_color_330_vs.glsl";
+    fragmentShaderFile = "simple_color_330_fs.glsl";
+  }
+  const std::string programsPath = common::joinPaths(
+      std::string(PROJECT_SOURCE_PATH), "test", "media", "materials",
+      "programs");
+
+  // giving the material of a skipped mesh shader parameters must get them
+  // applied by the next pre-render
+  material->SetVertexShader(
+      common::joinPaths(programsPath, vertexShaderFile));
+  material->SetFragmentShader(
+      common::joinPaths(programsPath, fragmentShaderFile));
+  ShaderParamsPtr params = material->VertexShaderParams();
+  ASSERT_NE(nullptr, params);
+  (*params)["worldviewproj_matrix"] = 1;
+  EXPECT_TRUE(params->IsDirty());
+  renderFrames(1u);
+  EXPECT_FALSE(params->IsDirty());
+
+  // and in later frames, once the subtree is no longer static
+  (*params)["worldviewproj_matrix"] = 1;
+  EXPECT_TRUE(params->IsDirty());
+  renderFrames(1u);
+  EXPECT_FALSE(params->IsDirty());
+
+  // a child added to a skipped subtree is pre-rendered in the next frame
+  MaterialPtr plain = scene->CreateMaterial();
+  child->SetMaterial(plain, false);
+  renderFrames(2u);
+
+  MaterialPtr grandChildMaterial = scene->CreateMaterial();
+  grandChildMaterial->SetVertexShader(
+      common::joinPaths(programsPath, vertexShaderFile));
+  grandChildMaterial->SetFragmentShader(
+      common::joinPaths(programsPath, fragmentShaderFile));
+  ShaderParamsPtr grandChildParams =
+      grandChildMaterial->VertexShaderParams();
+  ASSERT_NE(nullptr, grandChildParams);
+  (*grandChildParams)["worldviewproj_matrix"] = 1;
+
+  VisualPtr grandChild = scene->CreateVisual();
+  grandChild->AddGeometry(scene->CreateBox());
+  grandChild->SetMaterial(grandChildMaterial, false);
+  child->AddChild(grandChild);
+  EXPECT_TRUE(grandChildParams->IsDirty());
+  renderFrames(1u);
+  EXPECT_FALSE(grandChildParams->IsDirty());
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+TEST_F(SceneTest, CreateMeshAsync)
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  // meshes are created on the render thread, keep rendering frames until
+  // all of them are ready
+  auto renderUntilReady = [&](std::vector<std::future<MeshPtr>> &_futures)
+  {
+    for (unsigned int i = 0u; i < 1000u; ++i)
+    {
+      bool ready = true;
+      for (auto &future : _futures)
+      {
+        ready = ready && future.wait_for(std::chrono::milliseconds(1)) ==
+            std::future_status::ready;
+      }
+      if (ready)
+        break;
+
+      scene->PreRender();
+      scene->PostRender();
+    }
+    for (auto &future : _futures)
+    {
+      ASSERT_EQ(std::future_status::ready,
+          future.wait_for(std::chrono::seconds(0)));
+    }
+  };
+
+  std::vector<std::future<MeshPtr>> futures;
+  futures.push_back(scene->CreateMeshAsync(MeshDescriptor("unit_box")));
+  futures.push_back(scene->CreateMeshAsync(MeshDescriptor("unit_sphere")));
+  futures.push_back(scene->CreateMeshAsync(MeshDescriptor("unit_box")));
+  ASSERT_NO_FATAL_FAILURE(renderUntilReady(futures));
+
+  std::vector<MeshPtr> meshes;
+  for (auto &future : futures)
+  {
+    MeshPtr mesh = future.get();
+    ASSERT_NE(nullptr, mesh);
+    EXPECT_EQ(1u, mesh->SubMeshCount());
+    meshes.push_back(mesh);
+  }
+  EXPECT_NE(meshes[0], meshes[2]);
+
+  // a mesh file that the mesh manager didn't load yet is loaded too
+  futures.clear();
+  const std::string meshFile = common::joinPaths(
+      std::string(PROJECT_SOURCE_PATH), "test", "media", "meshes",
+      "mesh.dae");
+  futures.push_back(scene->CreateMeshAsync(MeshDescriptor(meshFile)));
+
+  // a mesh that doesn't exist resolves to null
+  futures.push_back(scene->CreateMeshAsync(MeshDescriptor("no_such_mesh")));
+  ASSERT_NO_FATAL_FAILURE(renderUntilReady(futures));
+
+  MeshPtr fileMesh = futures[0].get();
+  ASSERT_NE(nullptr, fileMesh);
+  EXPECT_LT(0u, fileMesh->SubMeshCount());
+  EXPECT_TRUE(common::MeshManager::Instance()->HasMesh(meshFile));
+  EXPECT_EQ(nullptr, futures[1].get());
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
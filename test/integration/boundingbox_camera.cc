@@ -17,6 +17,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+
 #include "CommonRenderingTest.hh"
 
 #include <gz/common/Filesystem.hh>
@@ -369,3 +372,170 @@ TEST_F(BoundingBoxCameraTest, Oriented3dBoxes)
   // Clean up
   engine->DestroyScene(scene);
 }
+
+//////////////////////////////////////////////////
+TEST_F(BoundingBoxCameraTest, FullBoxOfMesh)
+{
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  // accepted error with +/- in pixels in comparing the box coordinates
+  double marginError = 2.0;
+
+  gz::rendering::ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  // A sphere's box is not given by the corners of its local bounding box,
+  // which would project to a larger box
+  rendering::VisualPtr sphere = scene->CreateVisual();
+  sphere->AddGeometry(scene->CreateSphere());
+  sphere->SetLocalPosition(3, 0, 0);
+  sphere->SetLocalRotation(0.3, 0.2, 0.5);
+  sphere->SetUserData("label", 1);
+  scene->RootVisual()->AddChild(sphere);
+
+  auto camera = scene->CreateBoundingBoxCamera("BoundingBoxCamera");
+  ASSERT_NE(camera, nullptr);
+
+  camera->SetLocalPosition(0.0, 0.0, 0.0);
+  camera->SetLocalRotation(0.0, 0.0, 0.0);
+
+  unsigned int width = 320;
+  unsigned int height = 240;
+
+  camera->SetImageWidth(width);
+  camera->SetImageHeight(height);
+  camera->SetAspectRatio(1.333);
+  camera->SetHFOV(GZ_PI / 2);
+  camera->SetBoundingBoxType(BoundingBoxType::BBT_FULLBOX2D);
+  scene->RootVisual()->AddChild(camera);
+
+  gz::common::ConnectionPtr connection =
+    camera->ConnectNewBoundingBoxes(
+      std::bind(OnNewBoundingBoxes, std::placeholders::_1));
+  EXPECT_NE(nullptr, connection);
+
+  // size in pixels of the silhouette of a sphere of radius 0.5 seen at
+  // _distance by a camera with a focal length of 160 pixels
+  auto expectedSize = [](double _distance)
+  {
+    return 2.0 * 160.0 * std::tan(std::asin(0.5 / _distance));
+  };
+
+  camera->Update();
+
+  g_mutex.lock();
+  ASSERT_EQ(g_boxes.size(), size_t(1));
+  EXPECT_NEAR(g_boxes[0].Center().X(), 159.5, marginError);
+  EXPECT_NEAR(g_boxes[0].Center().Y(), 119.5, marginError);
+  EXPECT_NEAR(g_boxes[0].Size().X(), expectedSize(3.0), marginError);
+  EXPECT_NEAR(g_boxes[0].Size().Y(), expectedSize(3.0), marginError);
+  EXPECT_EQ(g_boxes[0].Label(), 1u);
+  g_mutex.unlock();
+
+  // The cached mesh points must follow the new pose
+  sphere->SetLocalPosition(2, 0, 0);
+  sphere->SetLocalRotation(-0.4, 0.1, 1.2);
+  camera->Update();
+
+  g_mutex.lock();
+  ASSERT_EQ(g_boxes.size(), size_t(1));
+  EXPECT_NEAR(g_boxes[0].Center().X(), 159.5, marginError);
+  EXPECT_NEAR(g_boxes[0].Center().Y(), 119.5, marginError);
+  EXPECT_NEAR(g_boxes[0].Size().X(), expectedSize(2.0), marginError);
+  EXPECT_NEAR(g_boxes[0].Size().Y(), expectedSize(2.0), marginError);
+  g_mutex.unlock();
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
+
+//////////////////////////////////////////////////
+TEST_F(BoundingBoxCameraTest, OverlappingBoxes)
+{
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  // accepted error with +/- in pixels in comparing the box coordinates
+  double marginError = 2.0;
+
+  gz::rendering::ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  // Thin boxes facing the camera, so that their projections are rectangles.
+  // With a focal length of 160 pixels, a point at (x, y, z) projects to
+  // u = 160 - 160 * y / x, v = 120 - 160 * z / x
+  auto addPlane = [&scene](const math::Vector3d &_position,
+      double _width, double _height, int _label)
+  {
+    rendering::VisualPtr visual = scene->CreateVisual();
+    visual->AddGeometry(scene->CreateBox());
+    visual->SetLocalPosition(_position);
+    visual->SetLocalScale(0.01, _width, _height);
+    visual->SetUserData("label", _label);
+    scene->RootVisual()->AddChild(visual);
+  };
+
+  // back: u [80, 240], v [80, 160]
+  addPlane(math::Vector3d(4, 0, 0), 4.0, 2.0, 1);
+  // middle, covers the left of the back plane: u [56, 120], v [72, 152]
+  addPlane(math::Vector3d(3, 1.35, 0.15), 1.2, 1.5, 2);
+  // front, covers the bottom of both: u [60, 260], v [140, 180]
+  addPlane(math::Vector3d(2, 0, -0.5), 2.5, 0.5, 3);
+
+  auto camera = scene->CreateBoundingBoxCamera("BoundingBoxCamera");
+  ASSERT_NE(camera, nullptr);
+
+  camera->SetLocalPosition(0.0, 0.0, 0.0);
+  camera->SetLocalRotation(0.0, 0.0, 0.0);
+  camera->SetImageWidth(320);
+  camera->SetImageHeight(240);
+  camera->SetAspectRatio(1.333);
+  camera->SetHFOV(GZ_PI / 2);
+  camera->SetBoundingBoxType(BoundingBoxType::BBT_VISIBLEBOX2D);
+  scene->RootVisual()->AddChild(camera);
+
+  gz::common::ConnectionPtr connection =
+    camera->ConnectNewBoundingBoxes(
+      std::bind(OnNewBoundingBoxes, std::placeholders::_1));
+  EXPECT_NE(nullptr, connection);
+
+  // check the box with the given label against its pixel extents
+  auto expectBox = [&](unsigned int _label, double _minU, double _maxU,
+      double _minV, double _maxV)
+  {
+    auto it = std::find_if(g_boxes.begin(), g_boxes.end(),
+        [&](const BoundingBox &_box) { return _box.Label() == _label; });
+    ASSERT_NE(g_boxes.end(), it) << "label " << _label;
+    EXPECT_NEAR(it->Center().X(), 0.5 * (_minU + _maxU), marginError)
+        << "label " << _label;
+    EXPECT_NEAR(it->Center().Y(), 0.5 * (_minV + _maxV), marginError)
+        << "label " << _label;
+    EXPECT_NEAR(it->Size().X(), _maxU - _minU, marginError)
+        << "label " << _label;
+    EXPECT_NEAR(it->Size().Y(), _maxV - _minV, marginError)
+        << "label " << _label;
+  };
+
+  camera->Update();
+
+  // visible boxes are trimmed by the planes in front of them
+  g_mutex.lock();
+  EXPECT_EQ(g_boxes.size(), size_t(3));
+  expectBox(1, 120, 240, 80, 140);
+  expectBox(2, 56, 120, 72, 140);
+  expectBox(3, 60, 260, 140, 180);
+  g_mutex.unlock();
+
+  camera->SetBoundingBoxType(BoundingBoxType::BBT_FULLBOX2D);
+  camera->Update();
+
+  // full boxes are not
+  g_mutex.lock();
+  EXPECT_EQ(g_boxes.size(), size_t(3));
+  expectBox(1, 80, 240, 80, 160);
+  expectBox(2, 56, 120, 72, 152);
+  expectBox(3, 60, 260, 140, 180);
+  g_mutex.unlock();
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
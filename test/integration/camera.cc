@@ -510,6 +510,101 @@ TEST_F(CameraTest, GZ_UTILS_TEST_DISABLED_ON_WIN32(Visibility))
   engine->DestroyScene(scene);
 }
 
+/////////////////////////////////////////////////
+TEST_F(CameraTest, GZ_UTILS_TEST_DISABLED_ON_WIN32(ModifyClonedMaterial))
+{
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetBackgroundColor(0, 0, 0);
+  scene->SetAmbientLight(1, 1, 1);
+
+  VisualPtr root = scene->RootVisual();
+  ASSERT_NE(nullptr, root);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetWorldPosition(-2, 0, 0);
+  camera->SetImageWidth(320);
+  camera->SetImageHeight(240);
+  camera->SetHFOV(GZ_PI / 2);
+  root->AddChild(camera);
+
+  // both visuals get their own clone of the same material, which the
+  // render engine may render with a single datablock
+  MaterialPtr red = scene->CreateMaterial();
+  red->SetDiffuse(1.0, 0.0, 0.0);
+  red->SetSpecular(1.0, 0.0, 0.0);
+
+  // visualA is on the left half of the image, visualB on the right half
+  VisualPtr visualA = scene->CreateVisual();
+  visualA->AddGeometry(scene->CreateBox());
+  visualA->SetWorldPosition(0.0, 0.75, 0.0);
+  visualA->SetMaterial(red);
+  root->AddChild(visualA);
+
+  VisualPtr visualB = scene->CreateVisual();
+  visualB->AddGeometry(scene->CreateBox());
+  visualB->SetWorldPosition(0.0, -0.75, 0.0);
+  visualB->SetMaterial(red);
+  root->AddChild(visualB);
+
+  Image image = camera->CreateImage();
+  unsigned int width = camera->ImageWidth();
+  unsigned int height = camera->ImageHeight();
+  unsigned int bpp = PixelUtil::BytesPerPixel(camera->ImageFormat());
+
+  // sum the red and green values of the middle row of each image half
+  auto sumColors = [&](unsigned int _start, unsigned int _end,
+      unsigned int &_r, unsigned int &_g)
+  {
+    _r = 0u;
+    _g = 0u;
+    unsigned char *data = image.Data<unsigned char>();
+    for (unsigned int i = _start; i < _end; ++i)
+    {
+      unsigned int idx = ((height / 2) * width + i) * bpp;
+      _r += data[idx];
+      _g += data[idx + 1];
+    }
+  };
+
+  unsigned int rA = 0u;
+  unsigned int gA = 0u;
+  unsigned int rB = 0u;
+  unsigned int gB = 0u;
+
+  camera->Capture(image);
+  sumColors(0u, width / 2, rA, gA);
+  sumColors(width / 2, width, rB, gB);
+  EXPECT_GT(rA, gA);
+  EXPECT_GT(rB, gB);
+
+  // modifying the material of visualB must not change visualA
+  MaterialPtr materialB = visualB->GeometryByIndex(0u)->Material();
+  ASSERT_NE(nullptr, materialB);
+  materialB->SetDiffuse(0.0, 1.0, 0.0);
+  materialB->SetSpecular(0.0, 1.0, 0.0);
+
+  camera->Capture(image);
+  sumColors(0u, width / 2, rA, gA);
+  sumColors(width / 2, width, rB, gB);
+  EXPECT_GT(rA, gA);
+  EXPECT_GT(gB, rB);
+
+  // and switching it back renders it red again
+  materialB->SetDiffuse(1.0, 0.0, 0.0);
+  materialB->SetSpecular(1.0, 0.0, 0.0);
+
+  camera->Capture(image);
+  sumColors(0u, width / 2, rA, gA);
+  sumColors(width / 2, width, rB, gB);
+  EXPECT_GT(rA, gA);
+  EXPECT_GT(rB, gB);
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
+
 /////////////////////////////////////////////////
 TEST_F(CameraTest, GZ_UTILS_TEST_DISABLED_ON_WIN32(ShaderSelection))
 {
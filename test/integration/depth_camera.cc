@@ -17,6 +17,10 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstring>
+#include <vector>
+
 #include "CommonRenderingTest.hh"
 
 #include <gz/common/Filesystem.hh>
@@ -735,3 +739,116 @@ TEST_F(DepthCameraTest, DepthCameraParticles)
 
   engine->DestroyScene(scene);
 }
+
+/////////////////////////////////////////////////
+TEST_F(DepthCameraTest, GZ_UTILS_TEST_DISABLED_ON_WIN32(PointCloudOnly))
+{
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  unsigned int imgWidth = 256;
+  unsigned int imgHeight = 256;
+  double hfov = 1.05;
+  double boxSize = 1.0;
+
+  gz::rendering::ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetBackgroundColor(1.0, 0.0, 0.0);
+  scene->SetAmbientLight(1.0, 1.0, 1.0);
+
+  gz::rendering::MaterialPtr blue = scene->CreateMaterial();
+  blue->SetAmbient(0.0, 0.0, 1.0);
+  blue->SetDiffuse(0.0, 0.0, 1.0);
+  blue->SetSpecular(0.0, 0.0, 1.0);
+
+  gz::rendering::VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(1.8, 0.0, 0.0);
+  box->SetMaterial(blue);
+  scene->RootVisual()->AddChild(box);
+
+  auto depthCamera = scene->CreateDepthCamera("DepthCamera");
+  ASSERT_NE(depthCamera, nullptr);
+  depthCamera->SetImageWidth(imgWidth);
+  depthCamera->SetImageHeight(imgHeight);
+  depthCamera->SetFarClipPlane(10.0);
+  depthCamera->SetNearClipPlane(0.15);
+  depthCamera->SetAspectRatio(1.0);
+  depthCamera->SetHFOV(hfov);
+  depthCamera->CreateDepthTexture();
+  scene->RootVisual()->AddChild(depthCamera);
+
+  // Only a point cloud listener, so the depth image is never extracted
+  unsigned int channelCount = 4u;
+  std::vector<float> pointCloudData(imgWidth * imgHeight * channelCount);
+  gz::common::ConnectionPtr connection =
+    depthCamera->ConnectNewRgbPointCloud(
+        std::bind(&::OnNewRgbPointCloud, pointCloudData.data(),
+          std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
+          std::placeholders::_4, std::placeholders::_5));
+
+  // focal length in pixels
+  double focal = 0.5 * imgWidth / std::tan(0.5 * hfov);
+
+  // Check every point against the front face of the box, at _faceX
+  auto checkPointCloud = [&](double _faceX)
+  {
+    // halfway between pixels, so that rounding the box edges to pixels
+    // doesn't matter
+    double halfExtent = 0.5 * boxSize / _faceX * focal;
+    unsigned int onBox = 0u;
+    for (unsigned int i = 0; i < imgHeight; ++i)
+    {
+      for (unsigned int j = 0; j < imgWidth; ++j)
+      {
+        unsigned int idx = (i * imgWidth + j) * channelCount;
+        float x = pointCloudData[idx];
+        float y = pointCloudData[idx + 1];
+        float z = pointCloudData[idx + 2];
+
+        // pixel center relative to the image center
+        double u = j + 0.5 - 0.5 * imgWidth;
+        double v = i + 0.5 - 0.5 * imgHeight;
+        if (std::abs(u) > halfExtent + 1.0 || std::abs(v) > halfExtent + 1.0)
+        {
+          EXPECT_FLOAT_EQ(gz::math::INF_D, x) << i << " " << j;
+          continue;
+        }
+        if (std::abs(u) < halfExtent - 1.0 && std::abs(v) < halfExtent - 1.0)
+        {
+          EXPECT_NEAR(_faceX, x, DEPTH_TOL) << i << " " << j;
+          EXPECT_NEAR(-u / focal * _faceX, y, 0.01) << i << " " << j;
+          EXPECT_NEAR(-v / focal * _faceX, z, 0.01) << i << " " << j;
+
+          float color = pointCloudData[idx + 3];
+          uint32_t *rgba = reinterpret_cast<uint32_t *>(&color);
+          EXPECT_EQ(0u, *rgba >> 24 & 0xFF);
+          EXPECT_EQ(0u, *rgba >> 16 & 0xFF);
+          EXPECT_GT(*rgba >> 8 & 0xFF, 0u);
+          ++onBox;
+        }
+      }
+    }
+    EXPECT_GT(onBox, 0u);
+  };
+
+  g_pointCloudCounter = 0u;
+  depthCamera->Update();
+  EXPECT_EQ(1u, g_pointCloudCounter);
+  checkPointCloud(1.8 - 0.5 * boxSize);
+
+  // the camera keeps returning the same data
+  ASSERT_NE(nullptr, depthCamera->DepthData());
+  EXPECT_EQ(0, memcmp(pointCloudData.data(), depthCamera->DepthData(),
+      pointCloudData.size() * sizeof(float)));
+
+  // new frames are not stale
+  box->SetLocalPosition(2.3, 0.0, 0.0);
+  depthCamera->Update();
+  EXPECT_EQ(2u, g_pointCloudCounter);
+  checkPointCloud(2.3 - 0.5 * boxSize);
+  EXPECT_EQ(0, memcmp(pointCloudData.data(), depthCamera->DepthData(),
+      pointCloudData.size() * sizeof(float)));
+
+  connection.reset();
+  engine->DestroyScene(scene);
+}
@@ -17,6 +17,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <vector>
+
 #include "CommonRenderingTest.hh"
 
 #include <gz/common/Image.hh>
@@ -130,6 +133,12 @@ TEST_F(GpuRaysTest, Configure)
     gpuRays->SetVerticalResolution(-0.8);
     EXPECT_DOUBLE_EQ(2.4, gpuRays->HorizontalResolution());
     EXPECT_DOUBLE_EQ(0.8, gpuRays->VerticalResolution());
+
+    EXPECT_DOUBLE_EQ(0.0, gpuRays->CubemapSharingTolerance());
+    gpuRays->SetCubemapSharingTolerance(0.05);
+    EXPECT_DOUBLE_EQ(0.05, gpuRays->CubemapSharingTolerance());
+    gpuRays->SetCubemapSharingTolerance(-1.0);
+    EXPECT_DOUBLE_EQ(0.0, gpuRays->CubemapSharingTolerance());
   }
 
   // Clean up
@@ -1027,3 +1036,188 @@ TEST_F(GpuRaysTest, GZ_UTILS_TEST_DISABLED_ON_WIN32(Heightmap))
   // Clean up
   engine->DestroyScene(scene);
 }
+
+/////////////////////////////////////////////////
+/// \brief Test that the raw RGBA frame matches the RGB frame
+TEST_F(GpuRaysTest, GZ_UTILS_TEST_DISABLED_ON_WIN32(RawFrame))
+{
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  const double hMinAngle = -GZ_PI/2.0;
+  const double hMaxAngle = GZ_PI/2.0;
+  const double minRange = 0.1;
+  const double maxRange = 10.0;
+  const unsigned int hRayCount = 321;
+  const unsigned int vRayCount = 4;
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  VisualPtr root = scene->RootVisual();
+
+  GpuRaysPtr gpuRays = scene->CreateGpuRays("gpu_rays");
+  gpuRays->SetWorldPosition(0, 0, 0.1);
+  gpuRays->SetNearClipPlane(minRange);
+  gpuRays->SetFarClipPlane(maxRange);
+  gpuRays->SetAngleMin(hMinAngle);
+  gpuRays->SetAngleMax(hMaxAngle);
+  gpuRays->SetRayCount(hRayCount);
+  gpuRays->SetVerticalRayCount(vRayCount);
+  gpuRays->SetVerticalAngleMin(-0.1);
+  gpuRays->SetVerticalAngleMax(0.1);
+  root->AddChild(gpuRays);
+
+  VisualPtr visualBox = scene->CreateVisual("UnitBox");
+  visualBox->AddGeometry(scene->CreateBox());
+  visualBox->SetWorldPosition(3, 0, 0.5);
+  visualBox->SetUserData("laser_retro", 1500.0);
+  root->AddChild(visualBox);
+
+  unsigned int channels = gpuRays->Channels();
+  std::vector<float> scan(hRayCount * vRayCount * channels);
+  common::ConnectionPtr c =
+    gpuRays->ConnectNewGpuRaysFrame(
+        std::bind(&::OnNewGpuRaysFrame, scan.data(),
+          std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
+          std::placeholders::_4, std::placeholders::_5));
+
+  // copy the relevant channels of the raw frame out of the callback since
+  // the data is only valid while it runs
+  std::vector<float> rawScan(hRayCount * vRayCount * channels);
+  unsigned int rawChannels = 0u;
+  common::ConnectionPtr cRaw =
+    gpuRays->ConnectNewGpuRaysRawFrame(
+        [&](const float *_frame, unsigned int _width, unsigned int _height,
+            unsigned int _channels, unsigned int _rowStride,
+            const std::string &_format)
+        {
+          EXPECT_EQ(hRayCount, _width);
+          EXPECT_EQ(vRayCount, _height);
+          EXPECT_GE(_rowStride, _width * _channels);
+          EXPECT_EQ("PF_FLOAT32_RGBA", _format);
+          rawChannels = _channels;
+          for (unsigned int i = 0; i < _height; ++i)
+          {
+            for (unsigned int j = 0; j < _width; ++j)
+            {
+              for (unsigned int k = 0; k < channels; ++k)
+              {
+                rawScan[(i * _width + j) * channels + k] =
+                    _frame[i * _rowStride + j * _channels + k];
+              }
+            }
+          }
+        });
+  ASSERT_NE(nullptr, cRaw);
+
+  gpuRays->Update();
+
+  EXPECT_EQ(4u, rawChannels);
+  for (unsigned int i = 0; i < scan.size(); ++i)
+  {
+    if (std::isinf(scan[i]))
+      EXPECT_TRUE(std::isinf(rawScan[i]));
+    else
+      EXPECT_FLOAT_EQ(scan[i], rawScan[i]);
+  }
+
+  c.reset();
+  cRaw.reset();
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
+
+/////////////////////////////////////////////////
+/// \brief Test sensors close to each other sharing a cubemap
+TEST_F(GpuRaysTest, GZ_UTILS_TEST_DISABLED_ON_WIN32(ShareCubemap))
+{
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  const double hMinAngle = -GZ_PI;
+  const double hMaxAngle = GZ_PI;
+  const double minRange = 0.1;
+  const double maxRange = 10.0;
+  const unsigned int hRayCount = 361;
+  const unsigned int vRayCount = 1;
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  VisualPtr root = scene->RootVisual();
+
+  auto createGpuRays = [&](const std::string &_name,
+      const math::Pose3d &_pose)
+  {
+    GpuRaysPtr gpuRays = scene->CreateGpuRays(_name);
+    gpuRays->SetWorldPosition(_pose.Pos());
+    gpuRays->SetWorldRotation(_pose.Rot());
+    gpuRays->SetNearClipPlane(minRange);
+    gpuRays->SetFarClipPlane(maxRange);
+    gpuRays->SetAngleMin(hMinAngle);
+    gpuRays->SetAngleMax(hMaxAngle);
+    gpuRays->SetRayCount(hRayCount);
+    gpuRays->SetVerticalRayCount(vRayCount);
+    root->AddChild(gpuRays);
+    return gpuRays;
+  };
+
+  // the second sensor is slightly in front of the first one and looks to
+  // the left, so its ray at -90 degrees points to the box
+  GpuRaysPtr gpuRays = createGpuRays("gpu_rays_1",
+      math::Pose3d(0, 0, 0.1, 0, 0, 0));
+  GpuRaysPtr gpuRays2 = createGpuRays("gpu_rays_2",
+      math::Pose3d(0.05, 0, 0.1, 0, 0, GZ_PI / 2.0));
+  gpuRays2->SetCubemapSharingTolerance(0.1);
+
+  VisualPtr visualBox = scene->CreateVisual("UnitBox");
+  visualBox->AddGeometry(scene->CreateBox());
+  visualBox->SetWorldPosition(3, 0, 0.5);
+  root->AddChild(visualBox);
+
+  // render both sensors in the same frame
+  auto renderFrame = [&]()
+  {
+    scene->PreRender();
+    gpuRays->Render();
+    gpuRays->PostRender();
+    gpuRays2->Render();
+    gpuRays2->PostRender();
+    scene->PostRender();
+  };
+
+  std::vector<float> scan(hRayCount * vRayCount * 3);
+  std::vector<float> scan2(hRayCount * vRayCount * 3);
+  const unsigned int front = hRayCount / 2 * 3;
+  const unsigned int right = hRayCount / 4 * 3;
+
+  // the second sensor samples the cubemap of the first one, so it measures
+  // the range from the origin of the first sensor
+  renderFrame();
+  gpuRays->Copy(scan.data());
+  gpuRays2->Copy(scan2.data());
+  EXPECT_NEAR(2.5, scan[front], LASER_TOL);
+  EXPECT_NEAR(2.5, scan2[right], LASER_TOL);
+  EXPECT_FLOAT_EQ(math::INF_F, scan2[0]);
+
+  // out of tolerance the second sensor renders its own cubemap
+  gpuRays2->SetWorldPosition(0.5, 0, 0.1);
+  renderFrame();
+  gpuRays2->Copy(scan2.data());
+  EXPECT_NEAR(2.0, scan2[right], LASER_TOL);
+
+  // and shares it again once back within tolerance
+  gpuRays2->SetWorldPosition(0.05, 0, 0.1);
+  renderFrame();
+  gpuRays2->Copy(scan2.data());
+  EXPECT_NEAR(2.5, scan2[right], LASER_TOL);
+
+  // sensors can be destroyed while another one samples their cubemap
+  scene->DestroySensor(gpuRays);
+  gpuRays2->Update();
+  gpuRays2->Copy(scan2.data());
+  EXPECT_NEAR(2.45, scan2[right], LASER_TOL);
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
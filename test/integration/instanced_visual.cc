@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "CommonRenderingTest.hh"
+
+#include <gz/common/Event.hh>
+#include <gz/math/Color.hh>
+#include <gz/math/Pose3.hh>
+
+#include "gz/rendering/Camera.hh"
+#include "gz/rendering/Image.hh"
+#include "gz/rendering/InstancedVisual.hh"
+#include "gz/rendering/PixelFormat.hh"
+#include "gz/rendering/Scene.hh"
+#include "gz/rendering/SegmentationCamera.hh"
+
+using namespace gz;
+using namespace rendering;
+
+//////////////////////////////////////////////////
+class InstancedVisualTest: public CommonRenderingTest
+{
+};
+
+//////////////////////////////////////////////////
+TEST_F(InstancedVisualTest, Render)
+{
+  // Render three instances of a box side by side with a regular camera and
+  // a segmentation camera, and check their colors, poses and labels
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetAmbientLight(0.5, 0.5, 0.5);
+  scene->SetBackgroundColor(0.0, 0.0, 0.0);
+
+  VisualPtr root = scene->RootVisual();
+
+  DirectionalLightPtr light = scene->CreateDirectionalLight();
+  light->SetDirection(1.0, 0.0, 0.0);
+  light->SetDiffuseColor(1.0, 1.0, 1.0);
+  light->SetSpecularColor(0.0, 0.0, 0.0);
+  root->AddChild(light);
+
+  MaterialPtr material = scene->CreateMaterial();
+  material->SetAmbient(1.0, 1.0, 1.0);
+  material->SetDiffuse(1.0, 1.0, 1.0);
+  material->SetSpecular(0.0, 0.0, 0.0);
+
+  // left, middle and right instances, as seen from the camera
+  InstancedVisualPtr visual = scene->CreateInstancedVisual();
+  ASSERT_NE(nullptr, visual);
+  visual->SetMesh(MeshDescriptor("unit_box"));
+  visual->SetMaterial(material);
+  visual->SetUserData("label", 1);
+  visual->SetInstancePoses({
+      math::Pose3d(3, 1.5, 0, 0, 0, 0),
+      math::Pose3d(3, 0, 0, 0, 0, 0),
+      math::Pose3d(3, -1.5, 0, 0, 0, 0)});
+  visual->SetInstanceColor(0u, math::Color::Red);
+  visual->SetInstanceColor(2u, math::Color::Green);
+  visual->SetInstanceLabel(2u, 7);
+  root->AddChild(visual);
+
+  const unsigned int width = 320u;
+  const unsigned int height = 240u;
+  const double aspectRatio = static_cast<double>(width) / height;
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(width);
+  camera->SetImageHeight(height);
+  camera->SetAspectRatio(aspectRatio);
+  camera->SetHFOV(GZ_PI / 2);
+  camera->SetImageFormat(PF_R8G8B8);
+  root->AddChild(camera);
+
+  const int backgroundLabel = 23;
+  SegmentationCameraPtr segmentationCamera =
+      scene->CreateSegmentationCamera();
+  ASSERT_NE(nullptr, segmentationCamera);
+  segmentationCamera->SetSegmentationType(SegmentationType::ST_SEMANTIC);
+  segmentationCamera->EnableColoredMap(false);
+  segmentationCamera->SetBackgroundLabel(backgroundLabel);
+  segmentationCamera->SetImageWidth(width);
+  segmentationCamera->SetImageHeight(height);
+  segmentationCamera->SetAspectRatio(aspectRatio);
+  segmentationCamera->SetHFOV(GZ_PI / 2);
+  root->AddChild(segmentationCamera);
+
+  std::vector<uint8_t> labels(width * height * 3);
+  common::ConnectionPtr connection =
+      segmentationCamera->ConnectNewSegmentationFrame(
+      [&labels](const uint8_t *_data, unsigned int _width,
+                unsigned int _height, unsigned int /*_channels*/,
+                const std::string &/*_format*/)
+      {
+        std::memcpy(labels.data(), _data, _width * _height * 3);
+      });
+  ASSERT_NE(nullptr, connection);
+
+  // index of the center pixel of each instance
+  const unsigned int left = ((height / 2) * width + width / 4) * 3;
+  const unsigned int middle = ((height / 2) * width + width / 2) * 3;
+  const unsigned int right = ((height / 2) * width + width * 3 / 4) * 3;
+
+  Image image = camera->CreateImage();
+  camera->Capture(image);
+  const unsigned char *data = image.Data<unsigned char>();
+
+  // instances with a color are shaded with it, the others with the
+  // material of the visual
+  EXPECT_GT(data[left], data[left + 1] + 50);
+  EXPECT_GT(data[left], data[left + 2] + 50);
+  EXPECT_GT(data[right + 1], data[right] + 50);
+  EXPECT_GT(data[right + 1], data[right + 2] + 50);
+  EXPECT_GT(data[middle], 50);
+  EXPECT_NEAR(data[middle], data[middle + 1], 5);
+  EXPECT_NEAR(data[middle], data[middle + 2], 5);
+
+  // instances with a label use it, the others use the label of the visual
+  segmentationCamera->Update();
+  EXPECT_EQ(1, labels[left]);
+  EXPECT_EQ(1, labels[middle]);
+  EXPECT_EQ(7, labels[right]);
+  EXPECT_EQ(backgroundLabel, labels[0]);
+
+  // move the left instance out of view and change the middle one
+  std::vector<math::Pose3d> poses = {
+      math::Pose3d(3, 1.5, 5, 0, 0, 0),
+      math::Pose3d(3, 0, 0, 0, 0, 0)};
+  visual->UpdateInstancePoses(0u, poses.data(), poses.size());
+  visual->SetInstanceColor(1u, math::Color::Blue);
+  visual->SetInstanceLabel(1u, 9);
+  visual->ClearInstanceLabel(2u);
+
+  camera->Capture(image);
+  data = image.Data<unsigned char>();
+  EXPECT_EQ(0u, data[left]);
+  EXPECT_EQ(0u, data[left + 1]);
+  EXPECT_EQ(0u, data[left + 2]);
+  EXPECT_GT(data[middle + 2], data[middle] + 50);
+  EXPECT_GT(data[middle + 2], data[middle + 1] + 50);
+  EXPECT_GT(data[right + 1], data[right] + 50);
+
+  segmentationCamera->Update();
+  EXPECT_EQ(backgroundLabel, labels[left]);
+  EXPECT_EQ(9, labels[middle]);
+  EXPECT_EQ(1, labels[right]);
+
+  // Clean up
+  connection.reset();
+  engine->DestroyScene(scene);
+}
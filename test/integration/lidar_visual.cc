@@ -17,13 +17,20 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <limits>
+#include <vector>
+
 #include "CommonRenderingTest.hh"
 
 #include <gz/common/Image.hh>
 #include <gz/common/Filesystem.hh>
 
+#include "gz/rendering/Camera.hh"
 #include "gz/rendering/GpuRays.hh"
+#include "gz/rendering/Image.hh"
 #include "gz/rendering/LidarVisual.hh"
+#include "gz/rendering/PixelFormat.hh"
 #include "gz/rendering/Scene.hh"
 
 #include <gz/utils/ExtraTestMacros.hh>
@@ -507,3 +514,143 @@ TEST_F(LidarVisualTest, GZ_UTILS_TEST_DISABLED_ON_WIN32(LaserVertical))
   // Clean up
   engine->DestroyScene(scene);
 }
+
+/////////////////////////////////////////////////
+/// \brief Render the lidar visual from above and check where it is drawn
+/// for every visual type, with and without rays that hit nothing
+TEST_F(LidarVisualTest, GZ_UTILS_TEST_DISABLED_ON_WIN32(Render))
+{
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  #ifdef __APPLE__
+    GTEST_SKIP() << "Unsupported on apple, see issue #35.";
+  #endif
+
+  // Rays fan out in front of the lidar. The ones on its right (y < 0) hit
+  // something at hitRange, the ones on its left hit nothing.
+  const double hMinAngle = -GZ_PI/3.0;
+  const double hMaxAngle = GZ_PI/3.0;
+  const double minRange = 0.1;
+  const double maxRange = 3.0;
+  const double hitRange = 2.0;
+  const unsigned int hRayCount = 121u;
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetBackgroundColor(0.0, 0.0, 0.0);
+
+  VisualPtr root = scene->RootVisual();
+  ASSERT_NE(nullptr, root);
+
+  LidarVisualPtr lidarVis = scene->CreateLidarVisual();
+  ASSERT_NE(nullptr, lidarVis);
+  lidarVis->SetMinRange(minRange);
+  lidarVis->SetMaxRange(maxRange);
+  lidarVis->SetMinHorizontalAngle(hMinAngle);
+  lidarVis->SetMaxHorizontalAngle(hMaxAngle);
+  lidarVis->SetHorizontalRayCount(hRayCount);
+  lidarVis->SetVerticalRayCount(1u);
+  lidarVis->SetSize(4.0);
+  root->AddChild(lidarVis);
+
+  std::vector<double> ranges(hRayCount);
+  for (unsigned int i = 0; i < hRayCount; ++i)
+  {
+    ranges[i] = (i < hRayCount / 2) ? hitRange :
+        std::numeric_limits<double>::infinity();
+  }
+
+  // camera looking down on the lidar, the top of the image is +x and the
+  // left of the image is +y
+  const unsigned int size = 256u;
+  const double height = 6.0;
+  const double centerX = 1.5;
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(size);
+  camera->SetImageHeight(size);
+  camera->SetAspectRatio(1.0);
+  camera->SetImageFormat(PF_R8G8B8);
+  camera->SetLocalPosition(centerX, 0.0, height);
+  camera->SetLocalRotation(0.0, GZ_PI/2.0, 0.0);
+  root->AddChild(camera);
+  const double metersPerPixel =
+      2.0 * height * std::tan(camera->HFOV().Radian() / 2.0) / size;
+
+  // Count the drawn pixels between two distances from the lidar, on its
+  // left or right side
+  Image image = camera->CreateImage();
+  auto countDrawn = [&](double _minDist, double _maxDist, bool _left)
+  {
+    const unsigned char *data = image.Data<unsigned char>();
+    unsigned int count = 0u;
+    for (unsigned int r = 0; r < size; ++r)
+    {
+      for (unsigned int c = 0; c < size; ++c)
+      {
+        const double x = centerX + (size / 2.0 - r - 0.5) * metersPerPixel;
+        const double y = (size / 2.0 - c - 0.5) * metersPerPixel;
+        const double dist = std::hypot(x, y);
+        if (dist < _minDist || dist > _maxDist || x < 0.0 ||
+            (y > 0.0) != _left || std::abs(y) < 0.2)
+        {
+          continue;
+        }
+        const unsigned int idx = (r * size + c) * 3u;
+        if (data[idx] > 20u || data[idx + 1] > 20u || data[idx + 2] > 20u)
+          ++count;
+      }
+    }
+    return count;
+  };
+
+  auto render = [&](LidarVisualType _type, bool _displayNonHitting)
+  {
+    lidarVis->SetType(_type);
+    lidarVis->SetDisplayNonHitting(_displayNonHitting);
+    lidarVis->SetPoints(ranges);
+    lidarVis->Update();
+    camera->Capture(image);
+  };
+
+  // regions along the hit rays, past the hits, and along the rays that
+  // hit nothing, short of the max range
+  const double margin = 0.15;
+  for (bool displayNonHitting : {true, false})
+  {
+    SCOPED_TRACE(displayNonHitting ? "display non hitting" :
+        "hide non hitting");
+
+    // rays are drawn up to their hit, and up to the max range when they
+    // hit nothing only if asked to
+    render(LVT_RAY_LINES, displayNonHitting);
+    EXPECT_LT(10u, countDrawn(minRange + margin, hitRange - margin, false));
+    EXPECT_EQ(0u, countDrawn(hitRange + margin, maxRange + margin, false));
+    if (displayNonHitting)
+      EXPECT_LT(10u, countDrawn(hitRange + margin, maxRange - margin, true));
+    else
+      EXPECT_EQ(0u, countDrawn(minRange + margin, maxRange + margin, true));
+
+    // strips fill the area covered by the rays the same way
+    render(LVT_TRIANGLE_STRIPS, displayNonHitting);
+    EXPECT_LT(100u, countDrawn(minRange + margin, hitRange - margin, false));
+    EXPECT_EQ(0u, countDrawn(hitRange + margin, maxRange + margin, false));
+    if (displayNonHitting)
+      EXPECT_LT(100u, countDrawn(hitRange + margin, maxRange - margin, true));
+    else
+      EXPECT_EQ(0u, countDrawn(minRange + margin, maxRange + margin, true));
+
+    // points are only drawn at the end of the rays
+    render(LVT_POINTS, displayNonHitting);
+    EXPECT_EQ(0u, countDrawn(minRange + margin, hitRange - margin, false));
+    EXPECT_LT(10u, countDrawn(hitRange - margin, hitRange + margin, false));
+    EXPECT_EQ(0u, countDrawn(minRange + margin, maxRange - margin, true));
+    if (displayNonHitting)
+      EXPECT_LT(10u, countDrawn(maxRange - margin, maxRange + margin, true));
+    else
+      EXPECT_EQ(0u, countDrawn(maxRange - margin, maxRange + margin, true));
+  }
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
@@ -16,8 +16,23 @@
  */
 
 #include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <gz/common/Filesystem.hh>
+#include <gz/common/MeshManager.hh>
+#include <gz/common/TempDirectory.hh>
+#include <gz/math/AxisAlignedBox.hh>
 #include <gz/utils/ExtraTestMacros.hh>
 
+#include "gz/rendering/Camera.hh"
+#include "gz/rendering/Mesh.hh"
+#include "gz/rendering/Scene.hh"
+#include "gz/rendering/Visual.hh"
+
 #include "CommonRenderingTest.hh"
 
 class LoadUnloadTest : public testing::Test
@@ -57,4 +72,160 @@ TEST_F(LoadUnloadTest, GZ_UTILS_TEST_DISABLED_ON_MAC(Thread))
   std::this_thread::sleep_for(std::chrono::milliseconds(100));
 }
 
+/////////////////////////////////////////////////
+TEST_F(LoadUnloadTest, GZ_UTILS_TEST_DISABLED_ON_MAC(ShaderCache))
+{
+  auto [envEngine, envBackend, envHeadless] = GetTestParams();
+  if (envEngine != "ogre2")
+  {
+    GTEST_SKIP() << "Shader cache is only supported by ogre2";
+  }
+
+  gz::common::TempDirectory cacheDir("shader_cache", "gz_rendering", true);
+  ASSERT_TRUE(cacheDir.Valid());
 
+  auto engineParams = GetEngineParams(envEngine, envBackend, envHeadless);
+  engineParams["shaderCachePath"] = cacheDir.Path();
+  gz::rendering::RenderEngine *engine =
+      gz::rendering::engine(envEngine, engineParams);
+  if (!engine)
+  {
+    GTEST_SKIP() << "Engine '" << envEngine << "' could not be loaded"
+                 << std::endl;
+  }
+
+  // render something so that shaders get compiled
+  gz::rendering::ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  gz::rendering::VisualPtr box = scene->CreateVisual();
+  box->AddGeometry(scene->CreateBox());
+  box->SetLocalPosition(2.0, 0.0, 0.0);
+  scene->RootVisual()->AddChild(box);
+  gz::rendering::CameraPtr camera = scene->CreateCamera();
+  camera->SetImageWidth(32u);
+  camera->SetImageHeight(32u);
+  scene->RootVisual()->AddChild(camera);
+  camera->Update();
+  engine->DestroyScene(scene);
+
+  // caches are written when the engine is unloaded, in a folder specific
+  // to this GPU and driver
+  gz::rendering::unloadEngine(envEngine);
+
+  bool foundKey = false;
+  for (gz::common::DirIter it(cacheDir.Path()); it != gz::common::DirIter();
+       ++it)
+  {
+    if (gz::common::isDirectory(*it) &&
+        gz::common::exists(gz::common::joinPaths(*it, "key.txt")))
+    {
+      foundKey = true;
+    }
+  }
+  EXPECT_TRUE(foundKey);
+}
+
+/////////////////////////////////////////////////
+TEST_F(LoadUnloadTest, GZ_UTILS_TEST_DISABLED_ON_MAC(MeshCache))
+{
+  auto [envEngine, envBackend, envHeadless] = GetTestParams();
+  if (envEngine != "ogre2")
+  {
+    GTEST_SKIP() << "Mesh cache is only supported by ogre2";
+  }
+
+  gz::common::TempDirectory cacheDir("mesh_cache", "gz_rendering", true);
+  ASSERT_TRUE(cacheDir.Valid());
+
+  // copy the mesh so that its modification time can be changed
+  gz::common::TempDirectory meshDir("mesh_cache_source", "gz_rendering",
+      true);
+  ASSERT_TRUE(meshDir.Valid());
+  const std::string meshFile = gz::common::joinPaths(meshDir.Path(),
+      "mesh.dae");
+  ASSERT_TRUE(gz::common::copyFile(gz::common::joinPaths(
+      std::string(PROJECT_SOURCE_PATH), "test", "media", "meshes",
+      "mesh.dae"), meshFile));
+  ASSERT_NE(nullptr, gz::common::MeshManager::Instance()->Load(meshFile));
+
+  auto countCacheFiles = [&]()
+  {
+    unsigned int count = 0u;
+    for (gz::common::DirIter it(cacheDir.Path());
+         it != gz::common::DirIter(); ++it)
+    {
+      if (gz::common::isFile(*it))
+        ++count;
+    }
+    return count;
+  };
+
+  auto cacheFile = [&]()
+  {
+    gz::common::DirIter it(cacheDir.Path());
+    return it != gz::common::DirIter() ? *it : std::string();
+  };
+
+  // load the same mesh three times: the first load fills the cache, the
+  // second one reads from it and the third one misses it because the
+  // source file changed
+  std::vector<std::string> subMeshNames;
+  gz::math::AxisAlignedBox box;
+  const auto oldTime = std::filesystem::file_time_type::clock::now() -
+      std::chrono::hours(24);
+  for (unsigned int i = 0u; i < 3u; ++i)
+  {
+    auto engineParams = GetEngineParams(envEngine, envBackend, envHeadless);
+    engineParams["meshCachePath"] = cacheDir.Path();
+    gz::rendering::RenderEngine *engine =
+        gz::rendering::engine(envEngine, engineParams);
+    if (!engine)
+    {
+      GTEST_SKIP() << "Engine '" << envEngine << "' could not be loaded"
+                   << std::endl;
+    }
+
+    gz::rendering::ScenePtr scene = engine->CreateScene("scene");
+    ASSERT_NE(nullptr, scene);
+    gz::rendering::MeshDescriptor descriptor(meshFile);
+    gz::rendering::MeshPtr mesh = scene->CreateMesh(descriptor);
+    ASSERT_NE(nullptr, mesh);
+    EXPECT_LT(0u, mesh->SubMeshCount());
+    ASSERT_EQ(i < 2u ? 1u : 2u, countCacheFiles());
+
+    gz::rendering::VisualPtr visual = scene->CreateVisual();
+    visual->AddGeometry(mesh);
+    scene->RootVisual()->AddChild(visual);
+
+    if (i == 0u)
+    {
+      for (unsigned int j = 0u; j < mesh->SubMeshCount(); ++j)
+        subMeshNames.push_back(mesh->SubMeshByIndex(j)->Name());
+      box = visual->LocalBoundingBox();
+
+      // Backdate the cache file. A cache miss would write it again.
+      std::filesystem::last_write_time(cacheFile(), oldTime);
+    }
+    else
+    {
+      // both a cache hit and a miss give the same mesh
+      ASSERT_EQ(subMeshNames.size(), mesh->SubMeshCount());
+      for (unsigned int j = 0u; j < mesh->SubMeshCount(); ++j)
+        EXPECT_EQ(subMeshNames[j], mesh->SubMeshByIndex(j)->Name());
+      EXPECT_EQ(box, visual->LocalBoundingBox());
+    }
+
+    if (i == 1u)
+    {
+      // a cache hit leaves the file untouched
+      EXPECT_LT(std::filesystem::last_write_time(cacheFile()),
+          oldTime + std::chrono::hours(1));
+
+      // Modify the source file. It must not be served from the cache.
+      std::filesystem::last_write_time(meshFile, oldTime);
+    }
+
+    engine->DestroyScene(scene);
+    gz::rendering::unloadEngine(envEngine);
+  }
+}
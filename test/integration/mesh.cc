@@ -17,6 +17,7 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdlib>
 #include <string>
 #include <memory>
 
@@ -175,3 +176,100 @@ TEST_F(MeshTest, NormalMapWithoutTexCoord)
   // Clean up
   engine->DestroyScene(scene);
 }
+
+/////////////////////////////////////////////////
+TEST_F(MeshTest, CompactVertexFormat)
+{
+  // Render a lit sphere with full precision vertex formats and with compact
+  // formats, which encode normals as QTangents and may use half precision
+  // positions and 16 bit indices. Both images should match.
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetAmbientLight(0.1, 0.1, 0.1);
+  scene->SetBackgroundColor(0.0, 0.0, 0.0);
+
+  VisualPtr root = scene->RootVisual();
+  ASSERT_NE(nullptr, root);
+
+  // light from the side so the shading depends on the normals
+  DirectionalLightPtr light0 = scene->CreateDirectionalLight();
+  light0->SetDirection(0.5, 1.0, -0.5);
+  light0->SetDiffuseColor(1.0, 1.0, 1.0);
+  light0->SetSpecularColor(1.0, 1.0, 1.0);
+  root->AddChild(light0);
+
+  MaterialPtr material = scene->CreateMaterial();
+  material->SetDiffuse(0.8, 0.8, 0.8);
+  material->SetSpecular(0.5, 0.5, 0.5);
+
+  MeshDescriptor descriptor("unit_sphere");
+  MeshPtr mesh = scene->CreateMesh(descriptor);
+  ASSERT_NE(nullptr, mesh);
+  descriptor.compactVertexFormat = true;
+  MeshPtr compactMesh = scene->CreateMesh(descriptor);
+  ASSERT_NE(nullptr, compactMesh);
+
+  VisualPtr visual = scene->CreateVisual();
+  visual->AddGeometry(mesh);
+  visual->SetMaterial(material);
+  visual->SetLocalPosition(1.5, 0.0, 0.0);
+  root->AddChild(visual);
+
+  VisualPtr compactVisual = scene->CreateVisual();
+  compactVisual->AddGeometry(compactMesh);
+  compactVisual->SetMaterial(material);
+  compactVisual->SetLocalPosition(1.5, 0.0, 0.0);
+  compactVisual->SetVisible(false);
+  root->AddChild(compactVisual);
+
+  CameraPtr camera = scene->CreateCamera();
+  ASSERT_NE(nullptr, camera);
+  camera->SetImageWidth(64);
+  camera->SetImageHeight(64);
+  camera->SetImageFormat(PF_R8G8B8);
+  root->AddChild(camera);
+
+  Image image = camera->CreateImage();
+  camera->Capture(image);
+
+  visual->SetVisible(false);
+  compactVisual->SetVisible(true);
+  Image compactImage = camera->CreateImage();
+  camera->Capture(compactImage);
+
+  unsigned int height = camera->ImageHeight();
+  unsigned int width = camera->ImageWidth();
+  unsigned char *data = image.Data<unsigned char>();
+  unsigned char *compactData = compactImage.Data<unsigned char>();
+
+  // the sphere is in the middle of the image and is shaded
+  unsigned int center = (height / 2 * width + width / 2) * 3;
+  EXPECT_GT(data[center], 0u);
+
+  // Pixels may differ slightly because of the precision of the compact
+  // normals. Half precision positions may also move the silhouette by less
+  // than a pixel, so allow a few pixels along the edge to differ more.
+  unsigned int shaded = 0u;
+  unsigned int mismatches = 0u;
+  for (unsigned int i = 0; i < width * height * 3; i += 3)
+  {
+    if (data[i] > 0u)
+      ++shaded;
+    for (unsigned int c = 0; c < 3; ++c)
+    {
+      if (std::abs(static_cast<int>(data[i + c]) -
+          static_cast<int>(compactData[i + c])) > 3)
+      {
+        ++mismatches;
+        break;
+      }
+    }
+  }
+  EXPECT_GT(shaded, width * height / 8);
+  EXPECT_LE(mismatches, width);
+
+  // Clean up
+  engine->DestroyScene(scene);
+}
@@ -17,6 +17,9 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <vector>
+
 #include "CommonRenderingTest.hh"
 
 #include <gz/common/Filesystem.hh>
@@ -215,3 +218,71 @@ TEST_F(SegmentationCameraTest, SegmentationCameraBoxes)
   // Clean up
   engine->DestroyScene(scene);
 }
+
+//////////////////////////////////////////////////
+TEST_F(SegmentationCameraTest, LabelChange)
+{
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  gz::rendering::ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  BuildScene(scene);
+
+  int width = 320;
+  int height = 240;
+
+  // two cameras with the same settings share the segmentation colors
+  std::vector<SegmentationCameraPtr> cameras;
+  for (const std::string name : {"SegmentationCamera0", "SegmentationCamera1"})
+  {
+    auto camera = scene->CreateSegmentationCamera(name);
+    ASSERT_NE(nullptr, camera);
+    camera->SetSegmentationType(SegmentationType::ST_SEMANTIC);
+    camera->EnableColoredMap(false);
+    camera->SetBackgroundLabel(23);
+    camera->SetAspectRatio(static_cast<double>(width) / height);
+    camera->SetImageWidth(width);
+    camera->SetImageHeight(height);
+    camera->SetHFOV(GZ_PI / 2);
+    scene->RootVisual()->AddChild(camera);
+    cameras.push_back(camera);
+  }
+
+  std::vector<gz::common::ConnectionPtr> connections;
+  for (auto &camera : cameras)
+  {
+    connections.push_back(camera->ConnectNewSegmentationFrame(
+        std::bind(OnNewSegmentationFrame,
+        std::placeholders::_1, std::placeholders::_2, std::placeholders::_3,
+        std::placeholders::_4, std::placeholders::_5)));
+  }
+
+  auto middleIndex = static_cast<uint32_t>(
+      ((height / 2) * width + width / 2) * 3);
+
+  for (auto &camera : cameras)
+  {
+    camera->Update();
+    EXPECT_EQ(2, g_buffer[middleIndex]);
+  }
+
+  // changing the label must be picked up by both cameras
+  scene->VisualByName("box_mid")->SetUserData("label", 5);
+  for (auto &camera : cameras)
+  {
+    camera->Update();
+    EXPECT_EQ(5, g_buffer[middleIndex]);
+  }
+
+  // so must removing the geometry
+  scene->VisualByName("box_mid")->RemoveGeometries();
+  for (auto &camera : cameras)
+  {
+    camera->Update();
+    EXPECT_EQ(23, g_buffer[middleIndex]);
+  }
+
+  // Clean up
+  connections.clear();
+  engine->DestroyScene(scene);
+}
@@ -24,6 +24,7 @@
 
 #include <gz/math/Color.hh>
 
+#include "gz/rendering/Material.hh"
 #include "gz/rendering/ParticleEmitter.hh"
 #include "gz/rendering/PixelFormat.hh"
 #include "gz/rendering/Scene.hh"
@@ -169,6 +170,35 @@ TEST_F(ThermalCameraTest,
     EXPECT_FLOAT_EQ(thermalData[right], thermalData[left]);
     EXPECT_NEAR(boxTemp, thermalData[mid] * linearResolution, boxTempRange);
 
+    // change the box temperature and verify it is picked up by the next
+    // frame
+    float newBoxTemp = 330.0;
+    box->SetUserData("temperature", newBoxTemp);
+    thermalCamera->Update();
+    EXPECT_NEAR(newBoxTemp, thermalData[mid] * linearResolution,
+        boxTempRange);
+    EXPECT_NEAR(ambientTemp, thermalData[left] * linearResolution,
+        ambientTempRange);
+    box->SetUserData("temperature", boxTemp);
+
+    // without a temperature the box color is converted to temperature in
+    // ogre2, verify that material changes are picked up by the next frame
+    if (this->engine->Name() == "ogre2")
+    {
+      gz::rendering::MaterialPtr boxMaterial = scene->CreateMaterial();
+      boxMaterial->SetDiffuse(1.0, 1.0, 1.0);
+      box->SetMaterial(boxMaterial, false);
+      box->SetUserData("temperature", gz::rendering::Variant());
+      thermalCamera->Update();
+      const uint16_t whiteBoxData = thermalData[mid];
+      boxMaterial->SetDiffuse(0.0, 0.0, 0.0);
+      thermalCamera->Update();
+      EXPECT_LT(thermalData[mid], whiteBoxData);
+      EXPECT_NEAR(ambientTemp, thermalData[mid] * linearResolution,
+          ambientTempRange);
+      box->SetUserData("temperature", boxTemp);
+    }
+
     // move box in front of near clip plane and verify the thermal
     // image returns all box temperature values
     gz::math::Vector3d boxPositionNear(
@@ -17,6 +17,11 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
 #include "CommonRenderingTest.hh"
 
 #include <gz/common/Filesystem.hh>
@@ -342,6 +347,149 @@ TEST_F(WideAngleCameraTest, GZ_UTILS_TEST_DISABLED_ON_WIN32(WideAngleCamera))
   engine->DestroyScene(scene);
 }
 
+//////////////////////////////////////////////////
+TEST_F(WideAngleCameraTest, GZ_UTILS_TEST_DISABLED_ON_WIN32(UpAndDownFaces))
+{
+  CHECK_SUPPORTED_ENGINE("ogre2");
+
+  gz::rendering::ScenePtr scene = engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+  scene->SetAmbientLight(1.0, 1.0, 1.0);
+  scene->SetBackgroundColor(0.0, 0.0, 0.0);
+
+  rendering::VisualPtr root = scene->RootVisual();
+
+  // red ceiling above the cameras and green floor below them. Only the up
+  // and down faces of the cubemap see them near the top and bottom of the
+  // images
+  MaterialPtr red = scene->CreateMaterial();
+  red->SetAmbient(0.3, 0.0, 0.0);
+  red->SetDiffuse(0.8, 0.0, 0.0);
+  VisualPtr ceilingVisual = scene->CreateVisual();
+  ceilingVisual->AddGeometry(scene->CreateBox());
+  ceilingVisual->SetLocalPosition(0, 0, 1);
+  ceilingVisual->SetLocalScale(30, 30, 0.1);
+  ceilingVisual->SetMaterial(red);
+  root->AddChild(ceilingVisual);
+
+  MaterialPtr green = scene->CreateMaterial();
+  green->SetAmbient(0.0, 0.3, 0.0);
+  green->SetDiffuse(0.0, 0.8, 0.0);
+  VisualPtr floorVisual = scene->CreateVisual();
+  floorVisual->AddGeometry(scene->CreateBox());
+  floorVisual->SetLocalPosition(0, 0, -1);
+  floorVisual->SetLocalScale(30, 30, 0.1);
+  floorVisual->SetMaterial(green);
+  root->AddChild(floorVisual);
+
+  // A narrow, tall image. Its top and bottom rows are more than 45 degrees
+  // away from the optical axis so they sample the up and down faces, while
+  // the left and right faces are never needed.
+  unsigned int width = 120u;
+  unsigned int height = 320u;
+  double hfov = GZ_PI / 3.0;
+  double aspectRatio = static_cast<double>(width) / height;
+
+  auto camera = scene->CreateWideAngleCamera("WideAngleCamera");
+  ASSERT_NE(camera, nullptr);
+  CameraLens lens;
+  lens.SetType(MFT_GNOMONIC);
+  lens.SetCutOffAngle(1.2);
+  camera->SetLens(lens);
+  camera->SetHFOV(hfov);
+  camera->SetImageWidth(width);
+  camera->SetImageHeight(height);
+  camera->SetAspectRatio(aspectRatio);
+  root->AddChild(camera);
+
+  // a gnomonic lens is a pinhole camera, use one as reference
+  CameraPtr cameraRegular = scene->CreateCamera();
+  ASSERT_NE(nullptr, cameraRegular);
+  cameraRegular->SetImageWidth(width);
+  cameraRegular->SetImageHeight(height);
+  cameraRegular->SetAspectRatio(aspectRatio);
+  cameraRegular->SetHFOV(hfov);
+  root->AddChild(cameraRegular);
+  Image imageRegular = cameraRegular->CreateImage();
+
+  std::vector<unsigned char> buffer(width * height * 3u);
+  unsigned int counter = 0u;
+  gz::common::ConnectionPtr connection =
+      camera->ConnectNewWideAngleFrame(
+      [&](const unsigned char *_data, unsigned int _width,
+          unsigned int _height, unsigned int _channels, const std::string &)
+      {
+        ASSERT_EQ(buffer.size(), _width * _height * _channels);
+        memcpy(buffer.data(), _data, buffer.size());
+        ++counter;
+      });
+  ASSERT_NE(nullptr, connection);
+
+  // Check that the rows of both images in [_begin, _end) have _channel as
+  // dominant color
+  auto checkRows = [&](unsigned int _begin, unsigned int _end,
+      unsigned int _channel, const std::string &_what)
+  {
+    const unsigned char *dataRegular = imageRegular.Data<unsigned char>();
+    for (unsigned int i = _begin; i < _end; ++i)
+    {
+      for (unsigned int j = 0; j < width; ++j)
+      {
+        unsigned int idx = (i * width + j) * 3u;
+        for (unsigned int c = 0; c < 3u; ++c)
+        {
+          if (c == _channel)
+            continue;
+          EXPECT_GT(buffer[idx + _channel], buffer[idx + c])
+              << _what << " " << i << " " << j;
+          EXPECT_GT(dataRegular[idx + _channel], dataRegular[idx + c])
+              << _what << " " << i << " " << j;
+        }
+      }
+    }
+  };
+
+  // Sum the difference between the images
+  auto imageDifference = [&]()
+  {
+    const unsigned char *dataRegular = imageRegular.Data<unsigned char>();
+    double diff = 0.0;
+    for (size_t i = 0; i < buffer.size(); ++i)
+      diff += std::abs(static_cast<int>(buffer[i]) - dataRegular[i]);
+    return diff / buffer.size();
+  };
+
+  // level: ceiling at the top, floor at the bottom
+  camera->Update();
+  cameraRegular->Capture(imageRegular);
+  EXPECT_EQ(1u, counter);
+  checkRows(0, 20, 0, "level top");
+  checkRows(height - 20, height, 1, "level bottom");
+  EXPECT_LT(imageDifference(), 10.0);
+
+  // aimed up, the ceiling fills the top half of the image
+  camera->SetLocalRotation(0.0, -0.9, 0.0);
+  cameraRegular->SetLocalRotation(0.0, -0.9, 0.0);
+  camera->Update();
+  cameraRegular->Capture(imageRegular);
+  EXPECT_EQ(2u, counter);
+  checkRows(0, height / 2, 0, "up");
+  EXPECT_LT(imageDifference(), 10.0);
+
+  // aimed down, the floor fills the bottom half of the image
+  camera->SetLocalRotation(0.0, 0.9, 0.0);
+  cameraRegular->SetLocalRotation(0.0, 0.9, 0.0);
+  camera->Update();
+  cameraRegular->Capture(imageRegular);
+  EXPECT_EQ(3u, counter);
+  checkRows(height / 2, height, 1, "down");
+  EXPECT_LT(imageDifference(), 10.0);
+
+  // Clean up
+  connection.reset();
+  engine->DestroyScene(scene);
+}
+
 //////////////////////////////////////////////////
 TEST_F(WideAngleCameraTest, GZ_UTILS_TEST_DISABLED_ON_WIN32(Projection))
 {
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2026 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "CommonRenderingTest.hh"
+
+#include "gz/rendering/Scene.hh"
+#include "gz/rendering/Visual.hh"
+
+using namespace gz;
+using namespace rendering;
+
+/// \brief Profile creating, looking up and destroying a large number of
+/// nodes through the scene object stores
+class SceneStoreTest: public CommonRenderingTest
+{
+};
+
+/////////////////////////////////////////////////
+/// \brief Return the time elapsed since _start in milliseconds
+double elapsedMs(const std::chrono::steady_clock::time_point &_start)
+{
+  return std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - _start).count();
+}
+
+/////////////////////////////////////////////////
+TEST_F(SceneStoreTest, CreateLookupDestroy)
+{
+  auto scene = this->engine->CreateScene("scene");
+  ASSERT_NE(nullptr, scene);
+
+  const unsigned int numVisuals = 100000;
+  std::vector<unsigned int> ids;
+  ids.reserve(numVisuals);
+
+  // create
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < numVisuals; ++i)
+  {
+    VisualPtr visual = scene->CreateVisual("visual_" + std::to_string(i));
+    ASSERT_NE(nullptr, visual);
+    ids.push_back(visual->Id());
+  }
+  gzdbg << "Created " << numVisuals << " visuals in " << elapsedMs(start)
+        << " ms" << std::endl;
+  EXPECT_EQ(numVisuals, scene->VisualCount());
+
+  // lookup by id
+  start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < numVisuals; ++i)
+  {
+    VisualPtr visual = scene->VisualById(ids[i]);
+    ASSERT_NE(nullptr, visual);
+    EXPECT_EQ(ids[i], visual->Id());
+  }
+  gzdbg << "Looked up " << numVisuals << " visuals by id in "
+        << elapsedMs(start) << " ms" << std::endl;
+
+  // lookup by name
+  start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < numVisuals; ++i)
+  {
+    EXPECT_TRUE(scene->HasVisualName("visual_" + std::to_string(i)));
+  }
+  gzdbg << "Looked up " << numVisuals << " visuals by name in "
+        << elapsedMs(start) << " ms" << std::endl;
+
+  // destroy every other visual by id, looking up a visual by index every
+  // batchSize removals so that the store is compacted while it still holds
+  // most of the visuals
+  const unsigned int batchSize = 100u;
+  start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < numVisuals; i += 2)
+  {
+    scene->DestroyVisualById(ids[i]);
+    if ((i / 2) % batchSize == batchSize - 1)
+    {
+      // visuals 0, 2, ..., i are gone so index i / 2 holds visual i + 1
+      VisualPtr visual = scene->VisualByIndex(i / 2);
+      ASSERT_NE(nullptr, visual);
+      EXPECT_EQ(ids[i + 1], visual->Id());
+    }
+  }
+  EXPECT_EQ(numVisuals / 2, scene->VisualCount());
+  VisualPtr first = scene->VisualByIndex(0u);
+  ASSERT_NE(nullptr, first);
+  EXPECT_EQ(ids[1], first->Id());
+  gzdbg << "Destroyed " << numVisuals / 2 << " visuals by id in "
+        << elapsedMs(start) << " ms" << std::endl;
+
+  // destroy the rest
+  start = std::chrono::steady_clock::now();
+  scene->DestroyVisuals();
+  EXPECT_EQ(0u, scene->VisualCount());
+  gzdbg << "Destroyed remaining visuals in " << elapsedMs(start)
+        << " ms" << std::endl;
+
+  // Clean up
+  this->engine->DestroyScene(scene);
+}